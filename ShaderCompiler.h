@@ -73,6 +73,7 @@ namespace ShaderCompiler {
         // Mesh shaders
         success &= compileShaderIfNeeded("shaders/workbench.vert", "shaders/compiled/workbench.vert.spv");
         success &= compileShaderIfNeeded("shaders/workbench.frag", "shaders/compiled/workbench.frag.spv");
+        success &= compileShaderIfNeeded("shaders/workbench_packed.vert", "shaders/compiled/workbench_packed.vert.spv");
 
         // Grid shaders
         success &= compileShaderIfNeeded("shaders/grid.vert", "shaders/compiled/grid.vert.spv");
@@ -0,0 +1,49 @@
+#version 450
+
+// workbench.vert for PackedVertex meshes (see src/mesh/VertexPacking.h).
+// Attribute formats do the unorm/snorm/half conversion; this shader only
+// dequantizes the position and decodes the octahedral normal.
+
+// Scene-wide data (must match C++ UniformBufferObject struct!)
+layout(binding = 0) uniform UniformBufferObject {
+    mat4 view;
+    mat4 projection;
+    vec3 lightDir;
+    float _pad1;
+    vec3 viewPos;
+    float _pad2;
+} ubo;
+
+// Per-object data (must match C++ PushConstants struct!)
+layout(push_constant) uniform PushConstants {
+    mat4 model;
+    vec4 positionOffset;
+    vec4 positionScale;
+} push;
+
+layout(location = 0) in vec4 inPosition;    // R16G16B16A16_UNORM
+layout(location = 1) in vec2 inNormal;      // R16G16_SNORM, octahedral
+layout(location = 2) in vec4 inColor;       // R8G8B8A8_UNORM
+layout(location = 3) in vec2 inUV;          // R16G16_SFLOAT (unused by workbench shading)
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec3 fragPos;
+
+vec3 decodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+void main() {
+    vec3 position = push.positionOffset.xyz + inPosition.xyz * push.positionScale.xyz;
+    vec4 worldPos = push.model * vec4(position, 1.0);
+    gl_Position = ubo.projection * ubo.view * worldPos;
+
+    fragPos = worldPos.xyz;
+    fragNormal = mat3(transpose(inverse(push.model))) * decodeOctahedral(inNormal);
+    fragColor = inColor.rgb;
+}
@@ -0,0 +1,45 @@
+#include "Benchmarks.h"
+#include <iostream>
+
+namespace libre::bench {
+
+    static volatile float sink = 0.0f;
+
+    void consume(float value) {
+        sink = sink + value;
+    }
+
+    void runAll(const std::string& filter) {
+        std::cout << "\n=== Benchmarks ===" << std::endl;
+
+        auto wants = [&filter](const char* name) {
+            return filter.empty() || filter == name;
+        };
+
+        if (wants("transform")) runTransformKernels();
+        if (wants("constraints")) runConstraints();
+        if (wants("compositor")) runCompositor();
+        if (wants("groups")) runGroups();
+        if (wants("bvh")) {
+            runSceneBVH();
+            runSceneBVHDrag();
+        }
+        if (wants("meshpick")) runMeshPick();
+        if (wants("culling")) runFrustumCull();
+        if (wants("marquee")) runMarquee();
+        if (wants("occlusion")) runOcclusion();
+        if (wants("proximity")) runProximity();
+        if (wants("hover")) runHover();
+        if (wants("lod")) runLOD();
+        if (wants("halfedge")) runHalfEdge();
+        if (wants("meshopt")) runMeshOptimize();
+        if (wants("packing")) runVertexPacking();
+        if (wants("meshlets")) runMeshlets();
+        if (wants("simplify")) runSimplifier();
+        if (wants("primitives")) runPrimitives();
+        if (wants("normals")) runNormals();
+
+        std::cout << "==================\n" << std::endl;
+    }
+
+} // namespace libre::bench
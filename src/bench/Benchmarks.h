@@ -0,0 +1,59 @@
+// src/bench/Benchmarks.h
+// Microbenchmarks for the hot CPU paths
+//
+// Run with:  LibreDCC.exe --bench [name]
+// Each benchmark prints its own "[Bench]" lines and compares the optimized
+// path against the straightforward one it replaced.
+
+#pragma once
+
+#include <chrono>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace libre::bench {
+
+    // Best-of-N wall time of func() in milliseconds
+    template<typename Func>
+    double measureMs(int iterations, Func&& func) {
+        double best = 1e30;
+        for (int i = 0; i < iterations; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            func();
+            auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+        }
+        return best;
+    }
+
+    // Keeps the optimizer from discarding benchmark results
+    void consume(float value);
+
+    // Individual benchmarks
+    void runTransformKernels(size_t count = 100000);
+    void runConstraints(size_t rigCount = 10000);
+    void runCompositor(uint32_t size = 16384, uint32_t layerCount = 50);
+    void runGroups(size_t memberCount = 200000);
+    void runSceneBVH(size_t objectCount = 1000000);
+    void runSceneBVHDrag(size_t objectCount = 1000000, size_t draggedCount = 10000);
+    void runMeshPick(size_t triangleCount = 5000000);
+    void runFrustumCull(size_t objectCount = 1000000);
+    void runMarquee(size_t objectCount = 1000000);
+    void runOcclusion(size_t objectCount = 200000);
+    void runProximity(size_t objectCount = 1000000);
+    void runHover(size_t objectCount = 20000);
+    void runLOD(size_t objectCount = 20000);
+    void runHalfEdge(size_t faceCount = 10000000);
+    void runMeshOptimize(size_t triangleCount = 1000000);
+    void runVertexPacking(size_t triangleCount = 1000000);
+    void runMeshlets(size_t triangleCount = 1000000);
+    void runSimplifier(size_t triangleCount = 2000000);
+    void runPrimitives(size_t count = 10000);
+    void runNormals(size_t vertexCount = 10000000);
+
+    // Runs every benchmark, or only the one matching 'filter'
+    void runAll(const std::string& filter = "");
+
+} // namespace libre::bench
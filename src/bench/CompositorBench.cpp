@@ -0,0 +1,81 @@
+#include "Benchmarks.h"
+#include "../world/World.h"
+#include "../world/LayerCompositor.h"
+#include "../components/CoreComponents.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace libre::bench {
+
+    void runCompositor(uint32_t size, uint32_t layerCount) {
+        std::cout << "[Bench] Compositor: " << size << "x" << size << " canvas, " << layerCount
+            << " layers (" << BlendKernels::getKernelName() << " kernels)" << std::endl;
+
+        World world;
+        LayerCompositor compositor;
+
+        EntityID document = world.createEntity("Canvas").getID();
+        CanvasComponent canvas;
+        canvas.width = size;
+        canvas.height = size;
+        world.addComponent<CanvasComponent>(document, canvas);
+
+        std::vector<EntityID> layers;
+        for (uint32_t i = 0; i < layerCount; ++i) {
+            EntityID layer = world.createEntity("Layer").getID();
+            LayerComponent settings;
+            settings.blendMode = static_cast<BlendMode>(i % 3);
+            settings.opacity = 0.9f;
+            world.addComponent<LayerComponent>(layer, settings);
+
+            Relationship rel;
+            rel.type = RelationType::LayerStack;
+            rel.from = document;
+            rel.to = layer;
+            rel.order = static_cast<int32_t>(i);
+            world.getRelationships().add(rel);
+            layers.push_back(layer);
+        }
+
+        // Scattered content: a few blocks per layer
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> pos(0, static_cast<int>(size) - 512);
+        for (EntityID layer : layers) {
+            for (int b = 0; b < 2; ++b) {
+                compositor.fillRect(world, layer, pos(rng), pos(rng), 512, 512, 0xC0406080u);
+            }
+        }
+
+        double fullMs = measureMs(1, [&]() { compositor.update(world); });
+        size_t fullTiles = compositor.getStats().tilesComposited;
+
+        // One brush stroke on a middle layer: 32px dabs along a diagonal
+        EntityID painted = layers[layers.size() / 2];
+        auto stroke = [&](int offset) {
+            for (int d = 0; d < 40; ++d) {
+                int x = 1000 + offset + d * 12;
+                int y = 2000 + d * 8;
+                compositor.fillRect(world, painted, x, y, 32, 32, 0x80FF2010u);
+            }
+        };
+
+        const int strokes = 10;
+        double strokeMs = 0.0;
+        for (int s = 0; s < strokes; ++s) {
+            stroke(s * 4);
+            strokeMs += measureMs(1, [&]() { compositor.update(world); });
+        }
+        const auto& stats = compositor.getStats();
+
+        std::cout << "[Bench]   full recomposite: " << fullMs << " ms (" << fullTiles << " tiles)" << std::endl;
+        std::cout << "[Bench]   brush stroke:     " << (strokeMs / strokes) << " ms (" << stats.tilesComposited
+            << " tiles, " << stats.pixelsComposited << " px)" << std::endl;
+        std::cout << "[Bench]   composite tiles allocated: " << compositor.getComposite(document)->getAllocatedTileCount()
+            << " / " << compositor.getComposite(document)->getTileCount() << std::endl;
+
+        consume(static_cast<float>(compositor.getComposite(document)->getPixel(1010, 2010)));
+    }
+
+} // namespace libre::bench
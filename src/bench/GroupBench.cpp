@@ -0,0 +1,57 @@
+#include "Benchmarks.h"
+#include "../world/World.h"
+
+#include <iostream>
+#include <vector>
+
+namespace libre::bench {
+
+    void runGroups(size_t memberCount) {
+        std::cout << "[Bench] Groups: hide/show a " << memberCount << "-member group" << std::endl;
+
+        World world;
+        EntityID group = world.createEntity("Group").getID();
+        EntityID other = world.createEntity("Other").getID();
+
+        // Interleave members of two groups so neither is one solid slot run
+        for (size_t i = 0; i < memberCount; ++i) {
+            EntityID member = world.createEntity("Member").getID();
+            Relationship rel;
+            rel.type = RelationType::GroupMember;
+            rel.from = (i % 8 == 7) ? other : group;
+            rel.to = member;
+            world.getRelationships().add(rel);
+        }
+
+        size_t groupSize = world.getGroupMembers(group)->count();
+
+        // Before: copy every GroupMember relationship, filter, set per entity
+        bool hidden = false;
+        double filterMs = measureMs(5, [&]() {
+            hidden = !hidden;
+            for (const Relationship& rel : world.getRelationships().getByType(RelationType::GroupMember)) {
+                if (rel.from == group) world.setFlag(rel.to, EntityFlags::Hidden, hidden);
+            }
+            });
+
+        double maskMs = measureMs(20, [&]() {
+            hidden = !hidden;
+            world.setGroupFlag(group, EntityFlags::Hidden, hidden);
+            });
+
+        // Set algebra on the membership bitsets
+        const SlotSet& a = *world.getGroupMembers(group);
+        const SlotSet& b = *world.getGroupMembers(other);
+        size_t unionCount = 0;
+        double unionMs = measureMs(20, [&]() { unionCount = SlotSet::unite(a, b).count(); });
+
+        std::cout << "[Bench]   filter relationships: " << filterMs << " ms" << std::endl;
+        std::cout << "[Bench]   bitset mask write:    " << (maskMs * 1000.0) << " us ("
+            << groupSize << " members, " << (filterMs / maskMs) << "x)" << std::endl;
+        std::cout << "[Bench]   union of two groups:  " << (unionMs * 1000.0) << " us ("
+            << unionCount << " slots)" << std::endl;
+
+        consume(static_cast<float>(world.isVisible(world.getGroupEntities(group).front())));
+    }
+
+} // namespace libre::bench
@@ -0,0 +1,703 @@
+#include "Benchmarks.h"
+#include "../components/CoreComponents.h"
+#include "../mesh/HalfEdgeMesh.h"
+#include "../mesh/MeshOptimizer.h"
+#include "../mesh/UploadOptimizer.h"
+#include "../mesh/VertexPacking.h"
+#include "../mesh/Meshlets.h"
+#include "../mesh/Simplifier.h"
+#include "../mesh/NormalKernels.h"
+#include "../world/World.h"
+#include "../world/LODGenerator.h"
+#include "../world/Primitives.h"
+#include "../world/PrimitiveCache.h"
+#include "../spatial/ClusterCuller.h"
+#include "../spatial/Frustum.h"
+#include "../core/JobSystem.h"
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <thread>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace libre::bench {
+
+    namespace {
+
+        // Indexed grid of size x size quads, two triangles each, on a gentle wave
+        MeshComponent makeGrid(uint32_t size) {
+            MeshComponent mesh;
+            uint32_t row = size + 1;
+            mesh.vertices.resize(static_cast<size_t>(row) * row);
+            for (uint32_t y = 0; y <= size; ++y) {
+                for (uint32_t x = 0; x <= size; ++x) {
+                    MeshVertex& v = mesh.vertices[static_cast<size_t>(y) * row + x];
+                    v.position = glm::vec3(float(x), 0.2f * std::sin(x * 0.1f) * std::cos(y * 0.1f), float(y));
+                    v.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+                    v.color = glm::vec3(0.8f);
+                    v.uv = glm::vec2(float(x) / size, float(y) / size);
+                }
+            }
+            mesh.indices.reserve(static_cast<size_t>(size) * size * 6);
+            for (uint32_t y = 0; y < size; ++y) {
+                for (uint32_t x = 0; x < size; ++x) {
+                    uint32_t a = y * row + x, b = a + row;
+                    mesh.indices.insert(mesh.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+                }
+            }
+            mesh.calculateBounds();
+            return mesh;
+        }
+
+        // UV sphere, rows in scanline order like Primitives::createSphere
+        MeshComponent makeSphere(uint32_t segments, uint32_t rings) {
+            MeshComponent mesh;
+            for (uint32_t r = 0; r <= rings; ++r) {
+                float theta = 3.14159265f * r / rings;
+                for (uint32_t s = 0; s <= segments; ++s) {
+                    float phi = 6.2831853f * s / segments;
+                    MeshVertex v{};
+                    v.normal = glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+                    v.position = v.normal;
+                    v.color = glm::vec3(0.8f);
+                    mesh.vertices.push_back(v);
+                }
+            }
+            for (uint32_t r = 0; r < rings; ++r) {
+                for (uint32_t s = 0; s < segments; ++s) {
+                    uint32_t a = r * (segments + 1) + s, b = a + segments + 1;
+                    mesh.indices.insert(mesh.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+                }
+            }
+            mesh.calculateBounds();
+            return mesh;
+        }
+
+        // Primitives' sphere before PrimitiveCache: trig per vertex, one
+        // thread (wound counter-clockwise from outside, as the cache winds it)
+        MeshComponent makeSpherePerVertex(float radius, int segments, int rings) {
+            MeshComponent mesh;
+            for (int y = 0; y <= rings; y++) {
+                for (int x = 0; x <= segments; x++) {
+                    float xSeg = static_cast<float>(x) / segments;
+                    float ySeg = static_cast<float>(y) / rings;
+                    float xPos = std::cos(xSeg * 2.0f * 3.14159265f) * std::sin(ySeg * 3.14159265f);
+                    float yPos = std::cos(ySeg * 3.14159265f);
+                    float zPos = std::sin(xSeg * 2.0f * 3.14159265f) * std::sin(ySeg * 3.14159265f);
+
+                    MeshVertex v;
+                    v.position = glm::vec3(xPos, yPos, zPos) * radius;
+                    v.normal = glm::normalize(v.position);
+                    v.color = glm::vec3(0.8f);
+                    v.uv = glm::vec2(xSeg, ySeg);
+                    mesh.vertices.push_back(v);
+                }
+            }
+            for (int y = 0; y < rings; y++) {
+                for (int x = 0; x < segments; x++) {
+                    uint32_t i0 = y * (segments + 1) + x;
+                    uint32_t i2 = i0 + segments + 1;
+                    mesh.indices.insert(mesh.indices.end(), { i0, i0 + 1, i2, i0 + 1, i2 + 1, i2 });
+                }
+            }
+            mesh.calculateBounds();
+            return mesh;
+        }
+
+    } // namespace
+
+    void runHalfEdge(size_t faceCount) {
+        uint32_t size = static_cast<uint32_t>(std::sqrt(faceCount / 2.0));
+        MeshComponent grid = makeGrid(size);
+        std::cout << "[Bench] Half-edge mesh: " << grid.getTriangleCount() << " triangles ("
+            << size << "x" << size << " grid)" << std::endl;
+
+        HalfEdgeMesh mesh;
+        double fromMs = measureMs(1, [&]() { mesh.fromMeshComponent(grid); });
+        std::cout << "[Bench]   from MeshComponent: " << fromMs << " ms | " << mesh.getVertexCount() << " vertices, "
+            << mesh.getEdgeCount() << " edges, " << mesh.getFaceCount() << " faces" << std::endl;
+
+        // One-ring sweep: average neighbor position of every vertex
+        double ringMs = measureMs(3, [&]() {
+            float sum = 0.0f;
+            for (uint32_t v = 0; v < mesh.getVertexCapacity(); ++v) {
+                glm::vec3 center(0.0f);
+                uint32_t n = 0;
+                mesh.forEachNeighbor(v, [&](uint32_t u) { center += mesh.getPosition(u); ++n; });
+                if (n) sum += center.y / n;
+            }
+            consume(sum);
+            });
+        std::cout << "[Bench]   one-ring sweep: " << ringMs << " ms (" << ringMs * 1e6 / mesh.getVertexCount()
+            << " ns per vertex)" << std::endl;
+
+        // Loop through a horizontal edge in the middle row: straight across
+        // the grid. Before: test every edge for lying on that row.
+        uint32_t start = mesh.findHalfEdge((size / 2) * (size + 1) + size / 2, (size / 2) * (size + 1) + size / 2 + 1);
+        float rowZ = mesh.getPosition(mesh.origin(start)).z;
+        std::vector<uint32_t> loop;
+        double loopMs = measureMs(5, [&]() {
+            loop.clear();
+            mesh.selectEdgeLoop(HalfEdgeMesh::edge(start), loop);
+            });
+
+        size_t scanned = 0;
+        double scanMs = measureMs(1, [&]() {
+            scanned = 0;
+            for (uint32_t e = 0; e < mesh.getEdgeCapacity(); ++e) {
+                uint32_t h = HalfEdgeMesh::edgeHalfEdge(e);
+                scanned += mesh.getPosition(mesh.origin(h)).z == rowZ && mesh.getPosition(mesh.target(h)).z == rowZ;
+            }
+            });
+        std::cout << "[Bench]   edge loop: " << loopMs << " ms (" << loop.size() << " edges) | edge scan: "
+            << scanMs << " ms (" << scanned << " edges)" << std::endl;
+
+        // Punch a hole and fill it again: faces and edges come off the free lists
+        uint32_t faceCapacity = mesh.getFaceCapacity(), edgeCapacity = mesh.getEdgeCapacity();
+        std::vector<uint32_t> removed;
+        for (uint32_t f = 0; f < 2000 && f * 7 < faceCapacity; ++f) {
+            uint32_t h = mesh.faceHalfEdge(f * 7);
+            removed.push_back(mesh.origin(h));
+            removed.push_back(mesh.target(h));
+            removed.push_back(mesh.target(mesh.next(h)));
+            mesh.deleteFace(f * 7, false);
+        }
+        size_t refilled = 0;
+        for (size_t i = 0; i < removed.size(); i += 3) refilled += mesh.addFace(&removed[i], 3) != HalfEdgeMesh::INVALID;
+        std::cout << "[Bench]   delete + re-add " << removed.size() / 3 << " faces: " << refilled << " added, capacity "
+            << (mesh.getFaceCapacity() == faceCapacity && mesh.getEdgeCapacity() == edgeCapacity ? "unchanged" : "grew")
+            << std::endl;
+
+        MeshComponent out;
+        double toMs = measureMs(1, [&]() { mesh.toMeshComponent(out); });
+        std::cout << "[Bench]   to MeshComponent: " << toMs << " ms | " << out.getVertexCount() << " vertices, "
+            << out.getTriangleCount() << " triangles (round trip "
+            << (out.getTriangleCount() == grid.getTriangleCount() ? "ok" : "MISMATCH")
+            << ")" << std::endl;
+
+        consume(static_cast<float>(loop.size() + scanned));
+    }
+
+    void runMeshOptimize(size_t triangleCount) {
+        uint32_t segments = static_cast<uint32_t>(std::sqrt(triangleCount));
+        MeshComponent sphere = makeSphere(segments, std::max<uint32_t>(2, static_cast<uint32_t>(triangleCount / (2 * segments))));
+        std::cout << "[Bench] Mesh optimization: " << sphere.getTriangleCount() << "-triangle sphere, FIFO cache of "
+            << MeshOptimizer::CACHE_SIZE << std::endl;
+
+        // The same sphere as an import might deliver it: triangles in random order
+        MeshComponent shuffled = sphere;
+        {
+            std::vector<uint32_t> order(shuffled.getTriangleCount());
+            for (size_t t = 0; t < order.size(); ++t) order[t] = static_cast<uint32_t>(t);
+            std::shuffle(order.begin(), order.end(), std::mt19937(11));
+            for (size_t t = 0; t < order.size(); ++t) {
+                for (int k = 0; k < 3; ++k) shuffled.indices[t * 3 + k] = sphere.indices[order[t] * 3 + k];
+            }
+        }
+
+        auto run = [&](const char* name, const MeshComponent& mesh) {
+            size_t vertexCount = mesh.getVertexCount();
+            float before = MeshOptimizer::computeACMR(mesh.indices.data(), mesh.indices.size(), vertexCount);
+
+            std::vector<uint32_t> indices = mesh.indices;
+            double cacheMs = measureMs(1, [&]() {
+                MeshOptimizer::optimizeVertexCache(indices.data(), indices.size(), vertexCount);
+                });
+            float tipsify = MeshOptimizer::computeACMR(indices.data(), indices.size(), vertexCount);
+
+            double overdrawMs = measureMs(1, [&]() {
+                MeshOptimizer::optimizeOverdraw(indices.data(), indices.size(), &mesh.vertices[0].position,
+                    sizeof(MeshVertex), vertexCount);
+                });
+            float overdraw = MeshOptimizer::computeACMR(indices.data(), indices.size(), vertexCount);
+
+            std::vector<uint32_t> remap;
+            double fetchMs = measureMs(1, [&]() {
+                MeshOptimizer::optimizeVertexFetch(indices.data(), indices.size(), vertexCount, remap);
+                });
+
+            // Vertex fetch: 64-byte lines through a 4 KB FIFO cache, as
+            // bytes fetched per byte of vertex data
+            auto overfetch = [&](const std::vector<uint32_t>& list, size_t count) {
+                const uint32_t LINES = 64;
+                std::vector<uint32_t> stamp(count * sizeof(MeshVertex) / 64 + 2, 0);
+                uint32_t time = LINES + 1;
+                size_t fetched = 0;
+                for (uint32_t v : list) {
+                    size_t first = v * sizeof(MeshVertex) / 64, last = ((v + 1) * sizeof(MeshVertex) - 1) / 64;
+                    for (size_t line = first; line <= last; ++line) {
+                        if (time - stamp[line] > LINES) {
+                            stamp[line] = time++;
+                            ++fetched;
+                        }
+                    }
+                }
+                return double(fetched * 64) / double(count * sizeof(MeshVertex));
+            };
+
+            std::cout << "[Bench]   " << name << ": ACMR " << before << " -> " << tipsify << " (Tipsify, "
+                << cacheMs << " ms) -> " << overdraw << " (overdraw clusters, " << overdrawMs << " ms) | overfetch "
+                << overfetch(mesh.indices, vertexCount) << " -> " << overfetch(indices, vertexCount) << " (" << fetchMs << " ms)" << std::endl;
+        };
+        run("scanline", sphere);
+        run("shuffled", shuffled);
+
+        // Upload stage: 100 instances of the shuffled sphere share one job
+        UploadOptimizer uploads;
+        const size_t INSTANCES = 100;
+        std::vector<uint8_t> delivered(INSTANCES + 1, 0);
+        size_t ready = 0;
+        int polls = 0;
+        double readyMs = measureMs(1, [&]() {
+            while (ready < INSTANCES) {
+                for (MeshHandle handle = 1; handle <= INSTANCES; ++handle) {
+                    MeshUploadData upload;
+                    if (delivered[handle] || !uploads.prepare(handle, shuffled.vertices, shuffled.indices, 0, upload)) continue;
+                    delivered[handle] = 1;
+                    ++ready;
+                }
+                ++polls;
+                if (ready < INSTANCES) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            });
+        const auto& stats = uploads.getStats();
+        std::cout << "[Bench]   upload stage, " << INSTANCES << " instances: all ready after " << polls << " polls ("
+            << readyMs << " ms) | " << stats.optimized << " optimized, " << stats.cacheHits << " cache hits | ACMR "
+            << stats.acmrBefore << " -> " << stats.acmrAfter << std::endl;
+    }
+
+    void runVertexPacking(size_t triangleCount) {
+        uint32_t segments = static_cast<uint32_t>(std::sqrt(triangleCount));
+        MeshComponent sphere = makeSphere(segments, std::max<uint32_t>(2, static_cast<uint32_t>(triangleCount / (2 * segments))));
+        MeshComponent grid = makeGrid(100);
+
+        // Colors and UVs worth checking (the sphere has neither)
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f), tiling(-8.0f, 8.0f);
+        for (auto& v : sphere.vertices) {
+            v.color = glm::vec3(unit(rng), unit(rng), unit(rng));
+            v.uv = glm::vec2(tiling(rng), tiling(rng));
+        }
+        std::cout << "[Bench] Vertex packing: " << sphere.getVertexCount() << "-vertex sphere, "
+            << grid.getVertexCount() << "-vertex grid" << std::endl;
+
+        auto run = [&](const char* name, const MeshComponent& mesh) {
+            MeshUploadData packed;
+            double packMs = measureMs(3, [&]() {
+                VertexPacking::pack(mesh.vertices.data(), mesh.vertices.size(), mesh.indices.data(), mesh.indices.size(), packed);
+                });
+
+            // Tolerance against the float path (what the old upload sent)
+            glm::vec3 step = packed.positionScale / 65535.0f;
+            float positionError = 0.0f, normalDegrees = 0.0f, colorError = 0.0f, uvError = 0.0f;
+            for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+                const MeshVertex& original = mesh.vertices[i];
+                MeshVertex decoded = VertexPacking::unpack(packed.vertices[i], packed.positionOffset, packed.positionScale);
+
+                glm::vec3 delta = glm::abs(decoded.position - original.position);
+                for (int a = 0; a < 3; ++a) {
+                    if (step[a] > 0.0f) positionError = std::max(positionError, delta[a] / step[a]);
+                }
+                // Angle from the chord: acos of a float dot is too coarse near 1
+                float chord = glm::length(decoded.normal - glm::normalize(original.normal));
+                normalDegrees = std::max(normalDegrees, 2.0f * std::asin(0.5f * chord) * 57.2957795f);
+                glm::vec3 colorDelta = glm::abs(decoded.color - original.color);
+                colorError = std::max({ colorError, colorDelta.x, colorDelta.y, colorDelta.z });
+                glm::vec2 uvDelta = glm::abs(decoded.uv - original.uv) / glm::max(glm::abs(original.uv), glm::vec2(1.0f));
+                uvError = std::max({ uvError, uvDelta.x, uvDelta.y });
+            }
+            // Half a quantization step, plus float rounding in the reconstruction
+            bool pass = positionError <= 0.51f && normalDegrees < 0.01f && colorError <= 0.5f / 255.0f + 1e-6f
+                && uvError <= 1.0f / 2048.0f;
+
+            // Bytes against the float Vertex (3 x vec3) with 32-bit indices
+            size_t floatBytes = mesh.vertices.size() * 36 + mesh.indices.size() * sizeof(uint32_t);
+            size_t packedBytes = packed.vertices.size() * sizeof(PackedVertex)
+                + packed.indices.size() * sizeof(uint32_t) + packed.indices16.size() * sizeof(uint16_t);
+
+            std::cout << "[Bench]   " << name << ": packed in " << packMs << " ms | " << sizeof(PackedVertex)
+                << " B/vertex, " << (packed.indices16.empty() ? 32 : 16) << "-bit indices | " << floatBytes / 1024 << " KB -> "
+                << packedBytes / 1024 << " KB (" << 100.0 * packedBytes / floatBytes << "%) | max error: position "
+                << positionError << " steps, normal " << normalDegrees << " deg, color " << colorError * 255.0f
+                << "/255, uv " << uvError << " (relative) | " << (pass ? "PASS" : "FAIL") << std::endl;
+        };
+        run("sphere", sphere);
+        run("grid", grid);
+
+        // Round trips the encoder has to get exactly right
+        bool halfExact = true;
+        for (float f : { 0.0f, -0.0f, 1.0f, -2.5f, 65504.0f, 6.1035156e-5f, 5.9604645e-8f, 0.333251953125f }) {
+            halfExact &= VertexPacking::halfToFloat(VertexPacking::floatToHalf(f)) == f;
+        }
+        halfExact &= std::isinf(VertexPacking::halfToFloat(VertexPacking::floatToHalf(1.0e6f)));
+        std::cout << "[Bench]   half float round trips: " << (halfExact ? "PASS" : "FAIL") << std::endl;
+    }
+
+    void runMeshlets(size_t triangleCount) {
+        uint32_t segments = static_cast<uint32_t>(std::sqrt(triangleCount));
+        MeshComponent sphere = makeSphere(segments, std::max<uint32_t>(2, static_cast<uint32_t>(triangleCount / (2 * segments))));
+        MeshComponent grid = makeGrid(static_cast<uint32_t>(std::sqrt(triangleCount / 2.0)));
+        std::cout << "[Bench] Meshlets: " << sphere.getTriangleCount() << "-triangle sphere, " << grid.getTriangleCount()
+            << "-triangle grid, " << Meshlets::MAX_VERTICES << " vertices / " << Meshlets::MAX_TRIANGLES << " triangles" << std::endl;
+
+        auto triangleSet = [](const std::vector<uint32_t>& indices) {
+            std::vector<std::array<uint32_t, 3>> set(indices.size() / 3);
+            for (size_t t = 0; t < set.size(); ++t) {
+                const uint32_t* tri = &indices[t * 3];
+                int k = static_cast<int>(std::min_element(tri, tri + 3) - tri);     // Rotation keeps the winding
+                set[t] = { tri[k], tri[(k + 1) % 3], tri[(k + 2) % 3] };
+            }
+            std::sort(set.begin(), set.end());
+            return set;
+        };
+
+        struct View {
+            const char* name;
+            glm::vec3 eye, target;
+            glm::mat4 model;
+        };
+
+        auto run = [&](const char* name, MeshComponent& mesh, const std::vector<View>& views) {
+            MeshOptimizer::optimizeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.getVertexCount());
+            auto before = triangleSet(mesh.indices);
+
+            MeshletData data;
+            double buildMs = measureMs(1, [&]() {
+                data = Meshlets::build(mesh.indices.data(), mesh.indices.size(), &mesh.vertices[0].position,
+                    sizeof(MeshVertex), mesh.getVertexCount());
+                });
+            bool preserved = triangleSet(mesh.indices) == before;
+
+            size_t vertexSum = 0, full = 0, cones = 0;
+            float spread = 0.0f;
+            for (size_t m = 0; m < data.meshlets.size(); ++m) {
+                vertexSum += data.meshlets[m].vertexCount;
+                full += data.meshlets[m].indexCount == Meshlets::MAX_TRIANGLES * 3;
+                if (data.bounds[m].coneCutoff < 1.0f) {
+                    ++cones;
+                    spread += std::asin(data.bounds[m].coneCutoff) * 57.2957795f;
+                }
+            }
+            std::cout << "[Bench]   " << name << ": built in " << buildMs << " ms | " << data.meshlets.size() << " meshlets, "
+                << double(data.getTriangleCount()) / data.meshlets.size() << " triangles / "
+                << double(vertexSum) / data.meshlets.size() << " vertices avg, " << 100.0 * full / data.meshlets.size()
+                << "% full | " << (data.closed ? "closed" : "open") << ", " << cones << " cones, " << (cones ? spread / cones : 0.0f)
+                << " deg avg spread | triangles " << (preserved ? "preserved" : "CHANGED") << std::endl;
+
+            // The outward side of each triangle, as the cull sees it
+            double volume = 0.0;
+            for (size_t t = 0; t < mesh.indices.size() / 3; ++t) {
+                const uint32_t* tri = &mesh.indices[t * 3];
+                volume += glm::dot(mesh.vertices[tri[0]].position, glm::cross(mesh.vertices[tri[1]].position, mesh.vertices[tri[2]].position));
+            }
+            float outward = volume < 0.0 ? -1.0f : 1.0f;
+
+            glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.05f, 100.0f);
+            for (const View& view : views) {
+                glm::mat4 viewProjection = projection * glm::lookAt(view.eye, view.target, glm::vec3(0.0f, 1.0f, 0.0f));
+                ClusterCuller::Stats stats;
+                std::vector<DrawRange> ranges;
+                bool visible = true;
+                const int ITERATIONS = 100;
+                double cullMs = measureMs(ITERATIONS, [&]() {
+                    ranges.clear();
+                    visible = ClusterCuller::cullMeshlets(data, view.model, viewProjection, view.eye, ranges, &stats);
+                    });
+
+                // Every triangle left out must be outside one plane (all three
+                // corners) or face away from the eye
+                std::vector<uint8_t> drawn(mesh.indices.size() / 3, ranges.empty() && visible);
+                for (const DrawRange& range : ranges) {
+                    std::fill(drawn.begin() + range.firstIndex / 3, drawn.begin() + (range.firstIndex + range.indexCount) / 3, 1);
+                }
+                Frustum frustum = Frustum::fromMatrix(viewProjection);
+                size_t culled = 0, wrong = 0;
+                for (size_t t = 0; t < drawn.size(); ++t) {
+                    if (drawn[t]) continue;
+                    ++culled;
+                    glm::vec3 p[3];
+                    for (int k = 0; k < 3; ++k) p[k] = glm::vec3(view.model * glm::vec4(mesh.vertices[mesh.indices[t * 3 + k]].position, 1.0f));
+
+                    bool outside = false;
+                    for (const glm::vec4& plane : frustum.planes) {
+                        bool all = true;
+                        for (int k = 0; k < 3; ++k) all &= glm::dot(glm::vec3(plane), p[k]) + plane.w < 0.0f;
+                        outside |= all;
+                    }
+                    glm::vec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]) * outward;
+                    if (glm::determinant(glm::mat3(view.model)) < 0.0f) normal = -normal;
+                    bool away = glm::dot(p[0] - view.eye, normal) >= 0.0f;
+                    if (!outside && !away) ++wrong;
+                }
+
+                std::cout << "[Bench]     " << view.name << ": " << cullMs * 1000.0 << " us | " << 100.0 * culled / drawn.size()
+                    << "% triangles culled (" << stats.outsideFrustum / ITERATIONS << " meshlets outside, "
+                    << stats.backFacing / ITERATIONS << " back-facing) | " << ranges.size() << " draw ranges"
+                    << (visible ? "" : " (nothing drawn)") << " | " << wrong << " visible triangles culled" << std::endl;
+            }
+        };
+
+        glm::mat4 identity(1.0f);
+        glm::mat4 squashed = glm::scale(identity, glm::vec3(2.0f, 1.0f, -0.5f));
+        run("sphere", sphere, {
+            { "whole in view", glm::vec3(0.0f, 0.5f, 3.0f), glm::vec3(0.0f), identity },
+            { "close up", glm::vec3(0.3f, 0.2f, 1.3f), glm::vec3(0.6f, 0.0f, 0.0f), identity },
+            { "mirrored, scaled", glm::vec3(0.0f, 0.5f, 3.0f), glm::vec3(0.0f), squashed },
+            { "behind the eye", glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f, 0.0f, 6.0f), identity },
+            });
+        float extent = std::sqrt(triangleCount / 2.0f);
+        run("grid", grid, {
+            { "corner", glm::vec3(-5.0f, 20.0f, -5.0f), glm::vec3(extent * 0.2f, 0.0f, extent * 0.2f), identity },
+            { "from above", glm::vec3(extent * 0.5f, 80.0f, extent * 0.5f), glm::vec3(extent * 0.5f, 0.0f, extent * 0.5f + 0.01f), identity },
+            });
+    }
+
+    void runSimplifier(size_t triangleCount) {
+        uint32_t segments = static_cast<uint32_t>(std::sqrt(triangleCount));
+        MeshComponent sphere = makeSphere(segments, std::max<uint32_t>(2, static_cast<uint32_t>(triangleCount / (2 * segments))));
+        MeshComponent grid = makeGrid(static_cast<uint32_t>(std::sqrt(triangleCount / 2.0)));
+        size_t workers = JobSystem::instance().getWorkerCount();
+        std::cout << "[Bench] Simplifier: " << sphere.getTriangleCount() << "-triangle sphere, " << grid.getTriangleCount()
+            << "-triangle grid, levels at 50/25/10%, " << workers << " workers" << std::endl;
+
+        // 'deviation' measures a triangle's centroid against the true surface;
+        // 'up' is the side its normal should face
+        auto run = [&](const char* name, const MeshComponent& mesh,
+            const std::function<float(const glm::vec3&)>& deviation, const std::function<glm::vec3(const glm::vec3&)>& up) {
+            size_t indexCount = mesh.indices.size();
+            std::vector<Simplifier::Level> levels;
+            std::atomic<float> progress{ 0.0f };
+            double ms = measureMs(1, [&]() {
+                levels = Simplifier::simplify(mesh.vertices.data(), mesh.getVertexCount(), mesh.indices.data(), indexCount,
+                    { indexCount / 2, indexCount / 4, indexCount / 10 }, {}, &progress);
+                });
+            std::cout << "[Bench]   " << name << ": " << ms << " ms for " << levels.size() << " levels (progress "
+                << progress.load() << ")" << std::endl;
+
+            // Projected area on the plane the surface faces, against the original
+            auto projectedArea = [&](const std::vector<uint32_t>& indices) {
+                double area = 0.0;
+                for (size_t t = 0; t < indices.size() / 3; ++t) {
+                    glm::vec3 p[3];
+                    for (int k = 0; k < 3; ++k) p[k] = mesh.vertices[indices[t * 3 + k]].position;
+                    glm::vec3 centroid = (p[0] + p[1] + p[2]) / 3.0f;
+                    area += 0.5 * glm::dot(glm::cross(p[1] - p[0], p[2] - p[0]), glm::normalize(up(centroid)));
+                }
+                return area;
+            };
+            double fullArea = projectedArea(mesh.indices);
+
+            for (const Simplifier::Level& level : levels) {
+                float maxDeviation = 0.0f;
+                size_t flipped = 0;
+                for (size_t t = 0; t < level.indices.size() / 3; ++t) {
+                    glm::vec3 p[3];
+                    for (int k = 0; k < 3; ++k) p[k] = mesh.vertices[level.indices[t * 3 + k]].position;
+                    glm::vec3 centroid = (p[0] + p[1] + p[2]) / 3.0f;
+                    maxDeviation = std::max(maxDeviation, deviation(centroid));
+                    flipped += glm::dot(glm::cross(p[1] - p[0], p[2] - p[0]), up(centroid)) <= 0.0f;
+                }
+                consume(maxDeviation);
+                std::cout << "[Bench]     " << level.indices.size() / 3 << " triangles: error " << level.error
+                    << " (of extent) | max deviation " << maxDeviation << " | " << flipped << " flipped | projected area "
+                    << 100.0 * projectedArea(level.indices) / fullArea << "%" << std::endl;
+            }
+        };
+
+        // makeSphere winds inward; makeGrid faces up
+        run("sphere", sphere,
+            [](const glm::vec3& p) { return std::abs(1.0f - glm::length(p)); },
+            [](const glm::vec3& p) { return -p; });
+        run("grid", grid,
+            [](const glm::vec3& p) { return std::abs(p.y - 0.2f * std::sin(p.x * 0.1f) * std::cos(p.z * 0.1f)); },
+            [](const glm::vec3&) { return glm::vec3(0.0f, 1.0f, 0.0f); });
+
+        // Generator stage: 100 instances of one mesh share one background job
+        uint32_t smallSegments = segments / 4;
+        MeshComponent rock = makeSphere(smallSegments, std::max<uint32_t>(2, smallSegments / 2));
+        World world;
+        const size_t INSTANCES = 100;
+        for (size_t i = 0; i < INSTANCES; ++i) {
+            EntityID id = world.createEntity("Rock").getID();
+            world.addComponent<MeshComponent>(id, rock);
+            LODComponent lod;
+            lod.generateRatios = { 0.5f, 0.25f, 0.1f };
+            world.addComponent<LODComponent>(id, lod);
+        }
+
+        LODGenerator generator;
+        int polls = 0;
+        float lastProgress = 0.0f;
+        bool monotonic = true;
+        double readyMs = measureMs(1, [&]() {
+            do {
+                generator.update(world);
+                float progress = generator.getProgress();
+                if (progress >= 0.0f) {
+                    monotonic &= progress >= lastProgress;
+                    lastProgress = progress;
+                }
+                ++polls;
+                if (generator.getStats().pending > 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            } while (generator.getStats().pending > 0);
+            });
+
+        size_t served = 0;
+        std::string thresholds;
+        world.forEach<LODComponent>([&](EntityID, LODComponent& lod) {
+            served += !lod.levels.empty() && lod.generateRatios.empty();
+            if (!thresholds.empty() || lod.levels.empty()) return;
+            for (const LODLevel& level : lod.levels) {
+                thresholds += " " + std::to_string(level.getTriangleCount()) + "@" + std::to_string(level.screenSize);
+            }
+        });
+        const auto& stats = generator.getStats();
+        std::cout << "[Bench]   generator, " << INSTANCES << " instances of " << rock.getTriangleCount() << " triangles: "
+            << served << " served after " << polls << " polls (" << readyMs << " ms) | " << stats.generated << " generated, "
+            << stats.cacheHits << " cache hits | progress " << (monotonic ? "monotonic" : "NOT MONOTONIC")
+            << " | levels (triangles@screenSize):" << thresholds << std::endl;
+    }
+
+    void runPrimitives(size_t count) {
+        PrimitiveCache& cache = PrimitiveCache::instance();
+        cache.clear();
+        size_t workers = JobSystem::instance().getWorkerCount();
+        std::cout << "[Bench] Primitives: " << count << " identical spheres (32x16), " << workers << " workers" << std::endl;
+
+        // Spawning: before, every entity tessellated its own sphere
+        double beforeMs = measureMs(1, [&]() {
+            World world;
+            for (size_t i = 0; i < count; ++i) {
+                EntityID id = world.createEntity("Sphere", "mesh").getID();
+                world.addComponent<MeshComponent>(id, makeSpherePerVertex(1.0f, 32, 16));
+            }
+            });
+        PrimitiveCache::Stats before = cache.getStats();
+        double afterMs = measureMs(1, [&]() {
+            World world;
+            for (size_t i = 0; i < count; ++i) Primitives::createSphere(world, 1.0f, 32, 16);
+            });
+        PrimitiveCache::Stats stats = cache.getStats();
+        std::cout << "[Bench]   spawn: " << beforeMs << " ms per-vertex trig -> " << afterMs << " ms cached (entity, render and bounds"
+            << " components included) | " << stats.generated - before.generated << " generated, " << stats.cacheHits - before.cacheHits
+            << " cache hits"
+            << std::endl;
+
+        // One large tessellation: sin/cos tables and parallel rows
+        const int SEGMENTS = 2048, RINGS = 1024;
+        MeshComponent reference;
+        double serialMs = measureMs(3, [&]() { reference = makeSpherePerVertex(2.0f, SEGMENTS, RINGS); });
+        MeshComponent generated;
+        PrimitiveCache::Key key;
+        key.type = PrimitiveCache::Type::Sphere;
+        key.size = 2.0f;
+        key.segments = SEGMENTS;
+        key.rings = RINGS;
+        double tableMs = measureMs(3, [&]() { generated = PrimitiveCache::generate(key); });
+
+        float maxDelta = 0.0f;
+        bool sameTopology = generated.indices == reference.indices && generated.vertices.size() == reference.vertices.size();
+        for (size_t i = 0; sameTopology && i < generated.vertices.size(); ++i) {
+            glm::vec3 d = glm::abs(generated.vertices[i].position - reference.vertices[i].position);
+            maxDelta = std::max(maxDelta, std::max(d.x, std::max(d.y, d.z)));
+        }
+        consume(maxDelta);
+        std::cout << "[Bench]   " << SEGMENTS << "x" << RINGS << " sphere (" << generated.getTriangleCount() << " triangles): "
+            << serialMs << " ms per-vertex trig -> " << tableMs << " ms tables + rows (" << serialMs / tableMs << "x) | "
+            << (sameTopology ? "same indices" : "INDICES DIFFER") << ", max position delta " << maxDelta << std::endl;
+        cache.clear();
+    }
+
+    void runNormals(size_t vertexCount) {
+        uint32_t size = static_cast<uint32_t>(std::sqrt(static_cast<double>(vertexCount))) - 1;
+        MeshComponent grid = makeGrid(size);
+        size_t workers = JobSystem::instance().getWorkerCount();
+        std::cout << "[Bench] Normals: " << grid.getVertexCount() << " vertices, " << grid.getTriangleCount() << " triangles, "
+            << NormalKernels::getKernelName() << ", " << workers << " workers" << std::endl;
+
+        // Before: nothing recomputed normals; the straightforward serial scatter
+        std::vector<glm::vec3> reference;
+        double scatterMs = measureMs(3, [&]() {
+            reference.assign(grid.vertices.size(), glm::vec3(0.0f));
+            for (size_t t = 0; t < grid.indices.size(); t += 3) {
+                const uint32_t* tri = &grid.indices[t];
+                glm::vec3 p0 = grid.vertices[tri[0]].position;
+                glm::vec3 n = glm::cross(grid.vertices[tri[1]].position - p0, grid.vertices[tri[2]].position - p0);
+                for (int k = 0; k < 3; ++k) reference[tri[k]] += n;
+            }
+            for (glm::vec3& n : reference) n = glm::normalize(n);
+            });
+
+        NormalKernels::Adjacency adjacency;
+        double buildMs = measureMs(1, [&]() { NormalKernels::buildAdjacency(grid, adjacency); });
+        double gatherMs = measureMs(3, [&]() { NormalKernels::recomputeNormals(grid, adjacency); });
+
+        float maxError = 0.0f;
+        for (size_t v = 0; v < grid.vertices.size(); ++v) {
+            maxError = std::max(maxError, glm::length(grid.vertices[v].normal - reference[v]));
+        }
+        std::cout << "[Bench]   adjacency (once per topology): " << buildMs << " ms" << std::endl;
+        std::cout << "[Bench]   all: " << scatterMs << " ms serial scatter -> " << gatherMs << " ms gather ("
+            << scatterMs / gatherMs << "x) | max difference " << maxError << std::endl;
+
+        // Sculpt stroke: a bump of radius size / 20 at the centre
+        std::vector<uint32_t> moved;
+        glm::vec2 centre(size * 0.5f);
+        float radius = size / 20.0f;
+        for (uint32_t v = 0; v < grid.vertices.size(); ++v) {
+            glm::vec3& p = grid.vertices[v].position;
+            float d = glm::length(glm::vec2(p.x, p.z) - centre) / radius;
+            if (d >= 1.0f) continue;
+            p.y += radius * 0.2f * (1.0f - d * d);
+            moved.push_back(v);
+        }
+        double regionMs = measureMs(3, [&]() {
+            NormalKernels::recomputeNormals(grid, adjacency, moved.data(), moved.size());
+            });
+        std::vector<glm::vec3> regionNormals(grid.vertices.size());
+        for (size_t v = 0; v < grid.vertices.size(); ++v) regionNormals[v] = grid.vertices[v].normal;
+        NormalKernels::recomputeNormals(grid, adjacency);
+        float regionError = 0.0f;
+        for (size_t v = 0; v < grid.vertices.size(); ++v) {
+            regionError = std::max(regionError, glm::length(grid.vertices[v].normal - regionNormals[v]));
+        }
+        std::cout << "[Bench]   region, " << moved.size() << " moved vertices: " << regionMs << " ms ("
+            << gatherMs / regionMs << "x less than all) | max difference to all " << regionError << std::endl;
+
+        std::vector<glm::vec4> tangents;
+        double tangentMs = measureMs(1, [&]() { NormalKernels::computeTangents(grid, adjacency, tangents); });
+        float maxDot = 0.0f;
+        size_t offAxis = 0;
+        for (size_t v = 0; v < grid.vertices.size(); ++v) {
+            maxDot = std::max(maxDot, std::abs(glm::dot(glm::vec3(tangents[v]), grid.vertices[v].normal)));
+            offAxis += tangents[v].x < 0.5f || tangents[v].w != -1.0f;
+        }
+        std::cout << "[Bench]   tangents: " << tangentMs << " ms | max |dot(normal, tangent)| " << maxDot << ", "
+            << offAxis << " not along +u" << std::endl;
+
+        // Seams smooth, hard edges stay: a UV sphere's seam and poles, the
+        // cube's faces, the cylinder's rims. Against the primitives' own normals.
+        auto primitiveError = [](const PrimitiveCache::Key& key) {
+            MeshComponent mesh = PrimitiveCache::generate(key);
+            std::vector<MeshVertex> before = mesh.vertices;
+            NormalKernels::Adjacency primitiveAdjacency;
+            NormalKernels::recomputeNormals(mesh, primitiveAdjacency);
+            float error = 0.0f;
+            for (size_t v = 0; v < mesh.vertices.size(); ++v) {
+                error = std::max(error, glm::length(mesh.vertices[v].normal - before[v].normal));
+            }
+            return error;
+        };
+        std::cout << "[Bench]   primitives, max difference to their analytic normals (area weighted): sphere 32x16 "
+            << primitiveError({ PrimitiveCache::Type::Sphere, 1.0f, 0.0f, 32, 16 }) << " | cube "
+            << primitiveError({ PrimitiveCache::Type::Cube, 1.0f, 0.0f, 0, 0 }) << " | cylinder 32 "
+            << primitiveError({ PrimitiveCache::Type::Cylinder, 0.5f, 2.0f, 32, 0 }) << std::endl;
+    }
+
+} // namespace libre::bench
@@ -0,0 +1,843 @@
+#include "Benchmarks.h"
+#include "../world/World.h"
+#include "../world/TransformSystem.h"
+#include "../world/LODSystem.h"
+#include "../spatial/SceneBVH.h"
+#include "../spatial/Frustum.h"
+#include "../spatial/OcclusionCuller.h"
+#include "../spatial/SpatialHash.h"
+#include "../world/Primitives.h"
+#include "../core/Selection.h"
+#include "../core/HoverSystem.h"
+#include "../core/JobSystem.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+
+namespace libre::bench {
+
+    void runSceneBVH(size_t objectCount) {
+        std::cout << "[Bench] Scene BVH: " << objectCount << " objects, picking rays" << std::endl;
+
+        World world;
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> size(0.2f, 2.0f);
+
+        for (size_t i = 0; i < objectCount; ++i) {
+            EntityID id = world.createEntity("Box").getID();
+            glm::vec3 center(position(rng), position(rng), position(rng));
+            glm::vec3 half(size(rng) * 0.5f);
+
+            BoundsComponent bounds;
+            bounds.setWorldBounds(center - half, center + half);
+            world.addComponent<BoundsComponent>(id, bounds);
+        }
+
+        SceneBVH bvh;
+        bvh.update(world, {});
+        std::cout << "[Bench]   build: " << bvh.getStats().lastBuildMs << " ms ("
+            << bvh.getStats().nodeCount << " nodes)" << std::endl;
+
+        // Rays from outside the scene towards random points inside it
+        const int rayCount = 200;
+        std::vector<glm::vec3> origins(rayCount), directions(rayCount);
+        for (int r = 0; r < rayCount; ++r) {
+            origins[r] = glm::vec3(0.0f, 0.0f, 900.0f);
+            directions[r] = glm::normalize(glm::vec3(position(rng), position(rng), position(rng)) - origins[r]);
+        }
+
+        auto pickable = [&](EntityID id) { return world.isVisible(id) && world.isSelectable(id); };
+
+        // Before: every BoundsComponent, metadata check and 1/dir per test
+        size_t linearHits = 0;
+        double linearMs = measureMs(1, [&]() {
+            for (int r = 0; r < 10; ++r) {
+                EntityID best = INVALID_ENTITY;
+                float bestT = std::numeric_limits<float>::max();
+                world.forEach<BoundsComponent>([&](EntityID id, BoundsComponent& bounds) {
+                    if (!pickable(id)) return;
+                    float tMin, tMax;
+                    if (bounds.intersectsRay(origins[r], directions[r], tMin, tMax) && tMin > 0 && tMin < bestT) {
+                        bestT = tMin;
+                        best = id;
+                    }
+                    });
+                linearHits += best != INVALID_ENTITY;
+            }
+            }) / 10.0;
+
+        size_t bvhHits = 0;
+        double closestMs = measureMs(5, [&]() {
+            bvhHits = 0;
+            for (int r = 0; r < rayCount; ++r) {
+                bvhHits += bvh.raycast(origins[r], directions[r], std::numeric_limits<float>::max(), pickable).hit();
+            }
+            }) / rayCount;
+
+        size_t anyHits = 0;
+        double anyMs = measureMs(5, [&]() {
+            anyHits = 0;
+            for (int r = 0; r < rayCount; ++r) {
+                anyHits += bvh.anyHit(origins[r], directions[r]);
+            }
+            }) / rayCount;
+
+        // Cross-check a few rays against the linear scan
+        size_t mismatches = 0;
+        for (int r = 0; r < 10; ++r) {
+            EntityID best = INVALID_ENTITY;
+            float bestT = std::numeric_limits<float>::max();
+            world.forEach<BoundsComponent>([&](EntityID id, BoundsComponent& bounds) {
+                float tMin, tMax;
+                if (bounds.intersectsRay(origins[r], directions[r], tMin, tMax) && tMin > 0 && tMin < bestT) {
+                    bestT = tMin;
+                    best = id;
+                }
+                });
+            mismatches += bvh.raycast(origins[r], directions[r]).entity != best;
+        }
+
+        std::cout << "[Bench]   linear pick:  " << (linearMs * 1000.0) << " us/ray" << std::endl;
+        std::cout << "[Bench]   BVH closest:  " << (closestMs * 1000.0) << " us/ray (" << bvhHits << "/" << rayCount
+            << " hit, " << (linearMs / closestMs) << "x)" << std::endl;
+        std::cout << "[Bench]   BVH any-hit:  " << (anyMs * 1000.0) << " us/ray (" << anyHits << " hit)"
+            << " | mismatches vs linear: " << mismatches << std::endl;
+
+        consume(static_cast<float>(linearHits + bvhHits + anyHits));
+    }
+
+    void runSceneBVHDrag(size_t objectCount, size_t draggedCount) {
+        std::cout << "[Bench] Scene BVH drag: " << draggedCount << " of " << objectCount
+            << " objects moving every frame" << std::endl;
+
+        World world;
+        TransformSystem transforms;
+        SceneBVH bvh;
+
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+
+        std::vector<EntityID> entities;
+        entities.reserve(objectCount);
+        for (size_t i = 0; i < objectCount; ++i) {
+            EntityID id = world.createEntity("Box").getID();
+            world.getComponent<TransformComponent>(id)->position = glm::vec3(position(rng), position(rng), position(rng));
+            world.addComponent<BoundsComponent>(id);
+            entities.push_back(id);
+        }
+
+        transforms.update(world);
+        bvh.update(world, transforms.getMovedBounds());
+        transforms.clearMovedBounds();
+        bvh.finishRebuild();
+
+        // The selection: a random subset, dragged together
+        std::shuffle(entities.begin(), entities.end(), rng);
+        entities.resize(draggedCount);
+
+        const int frames = 60;
+        double transformMs = 0.0, syncMs = 0.0, pickMs = 0.0;
+        size_t hits = 0;
+        for (int f = 0; f < frames; ++f) {
+            transformMs += measureMs(1, [&]() {
+                for (EntityID id : entities) {
+                    auto* t = world.getComponent<TransformComponent>(id);
+                    t->position += glm::vec3(2.0f, 0.5f, -1.0f);
+                    world.markTransformDirty(id);
+                }
+                transforms.update(world);
+                });
+
+            syncMs += measureMs(1, [&]() {
+                bvh.update(world, transforms.getMovedBounds());
+                transforms.clearMovedBounds();
+                });
+
+            // Pick one of the dragged objects from above
+            const glm::vec3 target(world.getComponent<BoundsComponent>(entities[f % entities.size()])->worldCenter);
+            const glm::vec3 origin = target + glm::vec3(0.0f, 1000.0f, 0.0f);
+            pickMs += measureMs(1, [&]() {
+                hits += bvh.raycast(origin, glm::vec3(0.0f, -1.0f, 0.0f)).hit();
+                });
+        }
+
+        const auto& stats = bvh.getStats();
+        std::cout << "[Bench]   transforms: " << (transformMs / frames) << " ms/frame"
+            << " | BVH refit: " << (syncMs / frames) << " ms/frame"
+            << " | pick: " << (pickMs / frames * 1000.0) << " us (" << hits << "/" << frames << " hit)" << std::endl;
+        std::cout << "[Bench]   degradation: " << stats.degradation
+            << " | background rebuilds swapped in: " << stats.backgroundRebuildCount
+            << " | in flight: " << (bvh.isRebuilding() ? "yes" : "no") << std::endl;
+
+        // Delete a slab of the scene: whole leaves empty out and are refit
+        // to inverted boxes, which must leave the tracked cost finite
+        bvh.finishRebuild();
+        std::vector<EntityID> removed;
+        world.forEach<BoundsComponent>([&](EntityID id, BoundsComponent& bounds) {
+            if (bounds.worldCenter.x < -450.0f) removed.push_back(id);
+            });
+        for (EntityID id : removed) world.removeComponent<BoundsComponent>(id);
+        double removeMs = measureMs(1, [&]() {
+            bvh.update(world, {});
+            });
+        hits = 0;
+        int picks = 0;
+        for (int f = 0; f < frames; ++f) {
+            const auto* bounds = world.getComponent<BoundsComponent>(entities[f % entities.size()]);
+            if (!bounds) continue;
+            hits += bvh.raycast(bounds->worldCenter + glm::vec3(0.0f, 1000.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f)).hit();
+            ++picks;
+        }
+        std::cout << "[Bench]   remove " << removed.size() << " + refit: " << removeMs << " ms | degradation: "
+            << stats.degradation << (std::isfinite(stats.degradation) ? "" : " (NOT FINITE)")
+            << " | rebuild " << (bvh.isRebuilding() ? "started" : "not needed")
+            << " | pick: " << hits << "/" << picks << " hit" << std::endl;
+
+        consume(static_cast<float>(hits));
+    }
+
+    void runMeshPick(size_t triangleCount) {
+        std::cout << "[Bench] Mesh picking: ~" << triangleCount << " triangles, kernel "
+            << MeshBVH::getKernelName() << std::endl;
+
+        // A bumpy UV sphere, so box hits and surface hits disagree
+        uint32_t segments = static_cast<uint32_t>(std::sqrt(triangleCount));
+        uint32_t rings = std::max<uint32_t>(2, static_cast<uint32_t>(triangleCount / (2 * segments)));
+        MeshComponent mesh;
+        mesh.vertices.reserve(static_cast<size_t>(rings + 1) * (segments + 1));
+        for (uint32_t r = 0; r <= rings; ++r) {
+            float theta = 3.14159265f * r / rings;
+            for (uint32_t s = 0; s <= segments; ++s) {
+                float phi = 6.2831853f * s / segments;
+                glm::vec3 dir(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+                float radius = 1.0f + 0.05f * std::sin(theta * 40.0f) * std::cos(phi * 40.0f);
+                MeshVertex v{};
+                v.position = dir * radius;
+                v.normal = dir;
+                mesh.vertices.push_back(v);
+            }
+        }
+        mesh.indices.reserve(static_cast<size_t>(rings) * segments * 6);
+        for (uint32_t r = 0; r < rings; ++r) {
+            for (uint32_t s = 0; s < segments; ++s) {
+                uint32_t a = r * (segments + 1) + s, b = a + segments + 1;
+                mesh.indices.insert(mesh.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+            }
+        }
+        mesh.calculateBounds();
+
+        World world;
+        EntityID id = world.createEntity("Sphere").getID();
+        auto* transform = world.getComponent<TransformComponent>(id);
+        transform->position = glm::vec3(3.0f, 1.0f, -2.0f);
+        transform->scale = glm::vec3(10.0f);
+        transform->worldMatrix = transform->getLocalMatrix();
+
+        BoundsComponent bounds;
+        bounds.localMin = mesh.boundsMin;
+        bounds.localMax = mesh.boundsMax;
+        bounds.updateWorldBounds(transform->worldMatrix);
+        world.addComponent<BoundsComponent>(id, bounds);
+        world.addComponent<MeshComponent>(id, std::move(mesh));
+
+        SceneBVH scene;
+        scene.update(world, {});
+
+        // Rays aimed near the sphere's silhouette: many miss the surface but hit the box
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> offset(-11.0f, 11.0f);
+        const int rayCount = 1000;
+        std::vector<Ray> rays(rayCount);
+        for (auto& ray : rays) {
+            ray.origin = glm::vec3(3.0f, 1.0f, 40.0f);
+            ray.direction = glm::normalize(glm::vec3(3.0f + offset(rng), 1.0f + offset(rng), -2.0f) - ray.origin);
+        }
+
+        double firstMs = measureMs(1, [&]() {
+            consume(SelectionSystem::raycast(scene, world, rays[0]).distance);
+            });
+
+        size_t boxHits = 0, surfaceHits = 0;
+        double boxMs = measureMs(3, [&]() {
+            boxHits = 0;
+            for (const Ray& ray : rays) boxHits += scene.raycast(ray.origin, ray.direction).hit();
+            }) / rayCount;
+        double pickMs = measureMs(3, [&]() {
+            surfaceHits = 0;
+            for (const Ray& ray : rays) surfaceHits += SelectionSystem::raycast(scene, world, ray).hit();
+            }) / rayCount;
+
+        // Cross-check against every triangle, in world space
+        const auto& m = *world.getComponent<MeshComponent>(id);
+        const glm::mat4& matrix = world.getComponent<TransformComponent>(id)->worldMatrix;
+        size_t mismatches = 0;
+        for (int r = 0; r < 5; ++r) {
+            const Ray& ray = rays[r];
+            float bestT = std::numeric_limits<float>::max();
+            uint32_t best = MeshBVH::INVALID;
+            for (size_t t = 0; t < m.getTriangleCount(); ++t) {
+                glm::vec3 p0 = glm::vec3(matrix * glm::vec4(m.vertices[m.indices[t * 3]].position, 1.0f));
+                glm::vec3 e1 = glm::vec3(matrix * glm::vec4(m.vertices[m.indices[t * 3 + 1]].position, 1.0f)) - p0;
+                glm::vec3 e2 = glm::vec3(matrix * glm::vec4(m.vertices[m.indices[t * 3 + 2]].position, 1.0f)) - p0;
+                glm::vec3 p = glm::cross(ray.direction, e2);
+                float det = glm::dot(e1, p);
+                if (det == 0.0f) continue;
+                glm::vec3 sv = ray.origin - p0;
+                float u = glm::dot(sv, p) / det;
+                glm::vec3 q = glm::cross(sv, e1);
+                float v = glm::dot(ray.direction, q) / det;
+                float dist = glm::dot(e2, q) / det;
+                if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && dist > 0.0f && dist < bestT) {
+                    bestT = dist;
+                    best = static_cast<uint32_t>(t);
+                }
+            }
+            HitResult hit = SelectionSystem::raycast(scene, world, ray);
+            bool same = hit.triangle == best ||
+                (best != MeshBVH::INVALID && hit.hit() && std::abs(hit.distance - bestT) < 1e-3f * bestT);
+            mismatches += !same;
+        }
+
+        std::cout << "[Bench]   first pick (builds the mesh BVH): " << firstMs << " ms ("
+            << m.pickBVH->getTree().getNodeCount() << " nodes)" << std::endl;
+        std::cout << "[Bench]   box pick:     " << (boxMs * 1000.0) << " us/ray (" << boxHits << "/" << rayCount << " hit)" << std::endl;
+        std::cout << "[Bench]   surface pick: " << (pickMs * 1000.0) << " us/ray (" << surfaceHits << "/" << rayCount
+            << " hit) | mismatches vs brute force: " << mismatches << std::endl;
+
+        consume(static_cast<float>(boxHits + surfaceHits));
+    }
+
+    void runFrustumCull(size_t objectCount) {
+        std::cout << "[Bench] Frustum culling: " << objectCount << " objects, kernel "
+            << FrustumCuller::getKernelName() << std::endl;
+
+        World world;
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> size(0.2f, 8.0f);
+        for (size_t i = 0; i < objectCount; ++i) {
+            EntityID id = world.createEntity("Box").getID();
+            glm::vec3 center(position(rng), position(rng), position(rng));
+            glm::vec3 half(size(rng) * 0.5f);
+
+            BoundsComponent bounds;
+            bounds.setWorldBounds(center - half, center + half);
+            world.addComponent<BoundsComponent>(id, bounds);
+        }
+
+        // Viewport camera at the edge of the scene looking in
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 50.0f, 600.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+        Frustum frustum = Frustum::fromMatrix(projection * view);
+
+        // Before: nothing was culled, every object went to the render thread
+        size_t scalarVisible = 0;
+        double scalarMs = measureMs(5, [&]() {
+            scalarVisible = 0;
+            world.forEach<BoundsComponent>([&](EntityID, BoundsComponent& b) {
+                scalarVisible += frustum.intersectsSphere(b.worldCenter, b.worldRadius) &&
+                    frustum.intersectsAABB(b.worldMin, b.worldMax);
+                });
+            });
+
+        FrustumCuller culler;
+        double cullMs = measureMs(5, [&]() { culler.cull(world, frustum); });
+
+        // Per-entity lookups agree with the scalar reference
+        size_t mismatches = 0;
+        world.forEach<BoundsComponent>([&](EntityID id, BoundsComponent& b) {
+            bool expected = frustum.intersectsSphere(b.worldCenter, b.worldRadius) &&
+                frustum.intersectsAABB(b.worldMin, b.worldMax);
+            mismatches += culler.isVisible(world, id) != expected;
+            });
+
+        const auto& stats = culler.getStats();
+        std::cout << "[Bench]   scalar sphere+box: " << scalarMs << " ms" << std::endl;
+        std::cout << "[Bench]   culler:            " << cullMs << " ms (" << (scalarMs / cullMs) << "x) | visible "
+            << stats.visible << ", culled " << stats.culled << ", box tests " << stats.boxTests
+            << " | mismatches: " << mismatches << std::endl;
+
+        consume(static_cast<float>(scalarVisible + stats.visible));
+    }
+
+    void runMarquee(size_t objectCount) {
+        std::cout << "[Bench] Marquee selection: " << objectCount << " objects" << std::endl;
+
+        World world;
+        std::mt19937 rng(13);
+        std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> size(0.2f, 8.0f);
+        for (size_t i = 0; i < objectCount; ++i) {
+            EntityID id = world.createEntity("Box").getID();
+            glm::vec3 center(position(rng), position(rng), position(rng));
+            glm::vec3 half(size(rng) * 0.5f);
+
+            BoundsComponent bounds;
+            bounds.setWorldBounds(center - half, center + half);
+            world.addComponent<BoundsComponent>(id, bounds);
+        }
+
+        SceneBVH bvh;
+        bvh.update(world, {});
+
+        const int width = 1920, height = 1080;
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 50.0f, 600.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 viewProj = glm::perspective(glm::radians(45.0f), float(width) / height, 0.1f, 2000.0f) * view;
+        const float x1 = 700.0f, y1 = 300.0f, x2 = 1100.0f, y2 = 650.0f;
+        Frustum frustum = Frustum::fromScreenRect(viewProj, x1, y1, x2, y2, float(width), float(height));
+
+        auto pickable = [&](EntityID id) { return world.isVisible(id) && world.isSelectable(id); };
+        auto pickableSlot = [&](EntityID id) { return SelectionSystem::isPickable(world, id); };
+
+        // Before: project each center to screen, metadata check per entity
+        size_t centerCount = 0;
+        double centerMs = measureMs(3, [&]() {
+            centerCount = 0;
+            world.forEach<BoundsComponent>([&](EntityID id, BoundsComponent& bounds) {
+                if (!pickable(id)) return;
+                glm::vec4 clip = viewProj * glm::vec4(bounds.worldCenter, 1.0f);
+                if (clip.w <= 0.0f) return;
+                float sx = (clip.x / clip.w + 1.0f) * 0.5f * width;
+                float sy = (1.0f - clip.y / clip.w) * 0.5f * height;
+                centerCount += sx >= x1 && sx <= x2 && sy >= y1 && sy <= y2;
+                });
+            });
+
+        for (FrustumTest test : { FrustumTest::Touching, FrustumTest::Inside }) {
+            std::vector<EntityID> batch, tree, candidates;
+
+            double batchMs = measureMs(3, [&]() {
+                FrustumCuller culler;
+                culler.cull(world, frustum, test);
+                candidates.clear();
+                culler.collectVisible(world, candidates);
+                batch.clear();
+                for (EntityID id : candidates) {
+                    if (pickableSlot(id)) batch.push_back(id);
+                }
+                });
+
+            double treeMs = measureMs(3, [&]() {
+                tree.clear();
+                bvh.queryFrustum(frustum, test, [&](EntityID id) {
+                    if (pickableSlot(id)) tree.push_back(id);
+                    });
+                });
+
+            // Both paths against the scalar box test, as sets
+            std::vector<EntityID> reference;
+            world.forEach<BoundsComponent>([&](EntityID id, BoundsComponent& b) {
+                if (frustum.testAABB(b.worldMin, b.worldMax, test)) reference.push_back(id);
+                });
+            std::sort(reference.begin(), reference.end());
+            std::sort(batch.begin(), batch.end());
+            std::sort(tree.begin(), tree.end());
+
+            std::cout << "[Bench]   " << (test == FrustumTest::Inside ? "inside:  " : "touching:")
+                << " SIMD batch " << batchMs << " ms | BVH " << treeMs << " ms | "
+                << tree.size() << " selected (centers: " << centerCount << " in " << centerMs << " ms)"
+                << " | match: " << (batch == reference && tree == reference ? "yes" : "NO") << std::endl;
+        }
+
+        consume(static_cast<float>(centerCount));
+    }
+
+    void runOcclusion(size_t objectCount) {
+        std::cout << "[Bench] Occlusion culling: " << objectCount << " objects behind walls, kernel "
+            << OcclusionCuller::getKernelName() << std::endl;
+
+        World world;
+
+        // Two walls across the view, each with a doorway
+        std::vector<AABB> walls = {
+            { glm::vec3(-200.0f, -10.0f, 19.5f), glm::vec3(-4.0f, 40.0f, 20.5f) },
+            { glm::vec3(4.0f, -10.0f, 19.5f), glm::vec3(200.0f, 40.0f, 20.5f) },
+            { glm::vec3(-200.0f, -10.0f, -60.5f), glm::vec3(30.0f, 40.0f, -59.5f) },
+            { glm::vec3(40.0f, -10.0f, -60.5f), glm::vec3(200.0f, 40.0f, -59.5f) },
+        };
+        for (const AABB& wall : walls) {
+            EntityID id = Primitives::createCube(world, 1.0f, "Wall").getID();
+            auto* transform = world.getComponent<TransformComponent>(id);
+            transform->position = (wall.min + wall.max) * 0.5f;
+            transform->scale = wall.max - wall.min;
+            transform->worldMatrix = transform->getLocalMatrix();
+            world.getComponent<BoundsComponent>(id)->updateWorldBounds(transform->worldMatrix);
+        }
+
+        std::mt19937 rng(17);
+        std::uniform_real_distribution<float> x(-150.0f, 150.0f), y(0.0f, 20.0f), z(-300.0f, 10.0f);
+        std::uniform_real_distribution<float> size(0.2f, 3.0f);
+        for (size_t i = 0; i < objectCount; ++i) {
+            EntityID id = world.createEntity("Box").getID();
+            glm::vec3 center(x(rng), y(rng), z(rng));
+            glm::vec3 half(size(rng) * 0.5f);
+
+            BoundsComponent bounds;
+            bounds.setWorldBounds(center - half, center + half);
+            world.addComponent<BoundsComponent>(id, bounds);
+        }
+
+        const glm::vec3 eye(0.0f, 2.0f, 60.0f);
+        glm::mat4 view = glm::lookAt(eye, glm::vec3(0.0f, 2.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 viewProj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f) * view;
+
+        // Before: everything in the frustum was drawn
+        FrustumCuller frustum;
+        double frustumMs = measureMs(5, [&]() { frustum.cull(world, Frustum::fromMatrix(viewProj)); });
+
+        OcclusionCuller occlusion;
+        double occlusionMs = measureMs(5, [&]() { occlusion.cull(world, viewProj, frustum); });
+        const auto& stats = occlusion.getStats();
+
+        // Every hidden box: no sample point in view may see the eye past the walls
+        auto inView = [&](const glm::vec3& p) {
+            glm::vec4 c = viewProj * glm::vec4(p, 1.0f);
+            return c.w > 0.0f && std::abs(c.x) <= c.w && std::abs(c.y) <= c.w && c.z >= 0.0f && c.z <= c.w;
+        };
+        auto blocked = [&](const glm::vec3& p) {
+            BVHRay ray(eye, p - eye, 1.0f);
+            for (const AABB& wall : walls) {
+                float t;
+                if (ray.intersects(wall, t) && t > 0.0f && t < 1.0f) return true;
+            }
+            return false;
+        };
+        size_t leaks = 0, hidden = 0;
+        world.forEach<BoundsComponent>([&](EntityID id, BoundsComponent& b) {
+            if (!occlusion.isOccluded(world, id)) return;
+            ++hidden;
+            for (int s = 0; s < 27; ++s) {
+                glm::vec3 f(float(s % 3) * 0.5f, float((s / 3) % 3) * 0.5f, float(s / 9) * 0.5f);
+                glm::vec3 p = b.worldMin + (b.worldMax - b.worldMin) * f;
+                if (inView(p) && !blocked(p)) {
+                    ++leaks;
+                    break;
+                }
+            }
+            });
+
+        size_t inFrustum = frustum.getStats().visible;
+        std::cout << "[Bench]   frustum: " << frustumMs << " ms | " << inFrustum << " in view" << std::endl;
+        std::cout << "[Bench]   occlusion: " << occlusionMs << " ms (raster " << stats.rasterMs << " ms, "
+            << stats.occluders << " occluders, " << stats.occluderTriangles << " triangles; test "
+            << stats.testMs << " ms) | occluded " << stats.occluded << ", drawn " << (inFrustum - stats.occluded)
+            << std::endl;
+        std::cout << "[Bench]   hidden boxes with a sample in sight: " << leaks << " of " << hidden << std::endl;
+
+        consume(static_cast<float>(stats.occluded));
+    }
+
+    void runProximity(size_t objectCount) {
+        std::cout << "[Bench] Proximity queries: " << objectCount << " objects" << std::endl;
+
+        World world;
+        std::mt19937 rng(19);
+        std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> size(0.2f, 8.0f);
+        std::vector<EntityID> ids;
+        ids.reserve(objectCount);
+        for (size_t i = 0; i < objectCount; ++i) {
+            EntityID id = world.createEntity("Box").getID();
+            glm::vec3 center(position(rng), position(rng), position(rng));
+            // A few terrain-sized boxes land on the upper levels
+            glm::vec3 half(i % 100000 == 0 ? 300.0f : size(rng) * 0.5f);
+
+            BoundsComponent bounds;
+            bounds.setWorldBounds(center - half, center + half);
+            world.addComponent<BoundsComponent>(id, bounds);
+            ids.push_back(id);
+        }
+
+        SpatialHash hash(16.0f);
+        double buildMs = measureMs(1, [&]() { hash.update(world, {}); });
+        std::cout << "[Bench]   insert all: " << buildMs << " ms (" << hash.getStats().cellCount << " cells)" << std::endl;
+
+        // Before: every proximity query scanned all bounds
+        auto bruteSphere = [&](const glm::vec3& center, float radius) {
+            std::vector<EntityID> found;
+            world.forEach<BoundsComponent>([&](EntityID id, BoundsComponent& b) {
+                AABB box;
+                box.min = b.worldMin;
+                box.max = b.worldMax;
+                if (SpatialHash::distanceSq(center, box) <= radius * radius) found.push_back(id);
+                });
+            std::sort(found.begin(), found.end());
+            return found;
+        };
+        auto hashSphere = [&](const glm::vec3& center, float radius) {
+            std::vector<EntityID> found;
+            hash.querySphere(center, radius, [&](EntityID id) { found.push_back(id); });
+            std::sort(found.begin(), found.end());
+            return found;
+        };
+
+        const int queryCount = 1000, checkedCount = 20;
+        const float radius = 10.0f;
+        std::vector<glm::vec3> centers(queryCount);
+        for (auto& c : centers) c = glm::vec3(position(rng), position(rng), position(rng));
+
+        size_t mismatches = 0;
+        double bruteMs = measureMs(1, [&]() {
+            for (int q = 0; q < checkedCount; ++q) mismatches += bruteSphere(centers[q], radius) != hashSphere(centers[q], radius);
+            }) / checkedCount;
+
+        size_t hits = 0;
+        double sphereMs = measureMs(3, [&]() {
+            hits = 0;
+            for (const auto& c : centers) hash.querySphere(c, radius, [&](EntityID) { ++hits; });
+            }) / queryCount;
+        std::cout << "[Bench]   sphere r=" << radius << ": scan " << bruteMs * 1000.0 << " us | hash "
+            << sphereMs * 1000.0 << " us (" << (bruteMs / sphereMs) << "x, " << double(hits) / queryCount
+            << " hits avg) | mismatches: " << mismatches << std::endl;
+
+        // k nearest, against sorting every distance
+        const size_t k = 8;
+        std::vector<SpatialHash::Neighbor> nearest;
+        size_t knnMismatches = 0;
+        for (int q = 0; q < checkedCount; ++q) {
+            std::vector<float> all;
+            all.reserve(objectCount);
+            world.forEach<BoundsComponent>([&](EntityID, BoundsComponent& b) {
+                AABB box;
+                box.min = b.worldMin;
+                box.max = b.worldMax;
+                all.push_back(std::sqrt(SpatialHash::distanceSq(centers[q], box)));
+                });
+            std::partial_sort(all.begin(), all.begin() + k, all.end());
+            hash.queryNearest(centers[q], k, nearest);
+            for (size_t i = 0; i < k; ++i) knnMismatches += nearest.size() != k || nearest[i].distance != all[i];
+        }
+        double knnMs = measureMs(3, [&]() {
+            for (const auto& c : centers) hash.queryNearest(c, k, nearest);
+            }) / queryCount;
+        std::cout << "[Bench]   " << k << " nearest: " << knnMs * 1000.0 << " us | mismatches: " << knnMismatches << std::endl;
+
+        // Drag 1% of the objects a little each frame
+        std::uniform_int_distribution<size_t> pick(0, objectCount - 1);
+        std::uniform_real_distribution<float> nudge(-2.0f, 2.0f);
+        std::vector<EntityID> moved(objectCount / 100);
+        for (auto& id : moved) id = ids[pick(rng)];
+        double moveMs = measureMs(5, [&]() {
+            for (EntityID id : moved) {
+                auto* b = world.getComponent<BoundsComponent>(id);
+                glm::vec3 offset(nudge(rng), nudge(rng), nudge(rng));
+                b->setWorldBounds(b->worldMin + offset, b->worldMax + offset);
+            }
+            hash.update(world, moved);
+            });
+
+        size_t movedMismatches = 0;
+        for (int q = 0; q < checkedCount; ++q) {
+            glm::vec3 c = world.getComponent<BoundsComponent>(moved[q])->worldCenter;
+            movedMismatches += bruteSphere(c, radius) != hashSphere(c, radius);
+        }
+        std::cout << "[Bench]   move " << moved.size() << ": " << moveMs << " ms per frame ("
+            << hash.getStats().lastUpdateMs << " ms in update) | mismatches: " << movedMismatches << std::endl;
+
+        // Readers on every worker at once
+        hits = 0;
+        for (const auto& c : centers) hash.querySphere(c, radius, [&](EntityID) { ++hits; });
+        std::atomic<size_t> parallelHits{ 0 };
+        double parallelMs = measureMs(3, [&]() {
+            parallelHits = 0;
+            JobSystem::instance().parallelFor(centers.size(), 16, [&](size_t begin, size_t end) {
+                size_t local = 0;
+                for (size_t q = begin; q < end; ++q) hash.querySphere(centers[q], radius, [&](EntityID) { ++local; });
+                parallelHits.fetch_add(local, std::memory_order_relaxed);
+                });
+            });
+        std::cout << "[Bench]   " << queryCount << " queries over the JobSystem: " << parallelMs << " ms | same hits: "
+            << (parallelHits.load() == hits ? "yes" : "no") << std::endl;
+
+        consume(static_cast<float>(hits));
+    }
+
+    void runHover(size_t objectCount) {
+        std::cout << "[Bench] Hover: " << objectCount << " sphere meshes" << std::endl;
+
+        World world;
+        std::mt19937 rng(23);
+        std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+        std::uniform_real_distribution<float> size(0.5f, 3.0f);
+        for (size_t i = 0; i < objectCount; ++i) {
+            EntityID id = Primitives::createSphere(world, 0.5f, 32, 16, "Sphere").getID();
+            auto* transform = world.getComponent<TransformComponent>(id);
+            transform->position = glm::vec3(position(rng), position(rng), position(rng));
+            transform->scale = glm::vec3(size(rng));
+            transform->worldMatrix = transform->getLocalMatrix();
+            world.getComponent<BoundsComponent>(id)->updateWorldBounds(transform->worldMatrix);
+        }
+
+        SceneBVH bvh;
+        bvh.update(world, {});
+
+        const int width = 1920, height = 1080;
+        Camera camera;
+        camera.setProjectionMatrix(glm::perspective(glm::radians(45.0f), float(width) / height, 0.1f, 1000.0f));
+        auto placeCamera = [&](float degrees) {
+            float a = glm::radians(degrees);
+            glm::vec3 eye(std::sin(a) * 150.0f, 40.0f, std::cos(a) * 150.0f);
+            camera.setPosition(eye);
+            camera.setViewMatrix(glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+        };
+
+        // Three phases of FRAMES frames: the cursor sweeps, everything
+        // rests, the camera orbits under a still cursor
+        const int FRAMES = 240;
+        struct Frame { float x, y, degrees; };
+        std::vector<Frame> frames;
+        for (int f = 0; f < FRAMES; ++f) frames.push_back({ 600.0f + 3.0f * f, 300.0f + 2.0f * f, 0.0f });
+        for (int f = 0; f < FRAMES; ++f) frames.push_back(frames.back());
+        for (int f = 0; f < FRAMES; ++f) frames.push_back({ frames.back().x, frames.back().y, 0.5f * (f + 1) });
+
+        // Builds the per-mesh BVHs the picks will use
+        for (const Frame& f : frames) {
+            placeCamera(f.degrees);
+            SelectionSystem::raycast(bvh, world, SelectionSystem::screenToRay(camera, f.x, f.y, width, height));
+        }
+
+        // Before: a full pick every frame
+        std::vector<EntityID> reference(frames.size());
+        double naiveMs = measureMs(3, [&]() {
+            for (size_t i = 0; i < frames.size(); ++i) {
+                placeCamera(frames[i].degrees);
+                Ray ray = SelectionSystem::screenToRay(camera, frames[i].x, frames[i].y, width, height);
+                reference[i] = SelectionSystem::raycast(bvh, world, ray).entity;
+            }
+            });
+
+        std::vector<EntityID> hovered(frames.size());
+        std::vector<uint8_t> pending(frames.size());
+        HoverSystem::Stats stats;
+        double hoverMs = measureMs(3, [&]() {
+            HoverSystem hover;
+            for (size_t i = 0; i < frames.size(); ++i) {
+                placeCamera(frames[i].degrees);
+                hover.update(world, bvh, camera, frames[i].x, frames[i].y, width, height, false);
+                hovered[i] = hover.getHovered();
+                pending[i] = hover.isPending();
+            }
+            stats = hover.getStats();
+            hover.clear(world);
+            });
+
+        size_t mismatches = 0, pendingFrames = 0;
+        for (size_t i = 0; i < frames.size(); ++i) {
+            if (pending[i]) ++pendingFrames;
+            else mismatches += hovered[i] != reference[i];
+        }
+
+        std::cout << "[Bench]   pick every frame: " << naiveMs << " ms for " << frames.size() << " frames" << std::endl;
+        std::cout << "[Bench]   hover system: " << hoverMs << " ms | " << stats.picks << " picks, "
+            << stats.skipped << " skipped, " << stats.retestHits << "/" << stats.retests << " re-tests hit, "
+            << stats.deferred << " deferred (" << stats.averagePickMs << " ms per pick)" << std::endl;
+        std::cout << "[Bench]   settled frames differing from a full pick: " << mismatches
+            << " (" << pendingFrames << " pending)" << std::endl;
+
+        consume(static_cast<float>(mismatches));
+    }
+
+    void runLOD(size_t objectCount) {
+        std::cout << "[Bench] LOD selection: " << objectCount << " spheres over 1 km" << std::endl;
+
+        // Full sphere plus three coarser levels
+        MeshComponent levels[4];
+        const int segments[4] = { 32, 16, 8, 4 }, rings[4] = { 16, 8, 4, 3 };
+        const float screenSize[3] = { 0.08f, 0.03f, 0.01f };
+        {
+            World scratch;
+            for (int l = 0; l < 4; ++l) {
+                EntityID id = Primitives::createSphere(scratch, 1.0f, segments[l], rings[l]).getID();
+                levels[l] = *scratch.getComponent<MeshComponent>(id);
+            }
+        }
+
+        World world;
+        std::mt19937 rng(29);
+        std::uniform_real_distribution<float> ground(-500.0f, 500.0f), scale(1.0f, 4.0f);
+        for (size_t i = 0; i < objectCount; ++i) {
+            EntityID id = world.createEntity("Tree").getID();
+            world.addComponent<MeshComponent>(id, levels[0]);
+
+            LODComponent lod;
+            for (int l = 1; l < 4; ++l) lod.addLevel(levels[l].vertices, levels[l].indices, screenSize[l - 1]);
+            world.addComponent<LODComponent>(id, lod);
+
+            glm::vec3 center(ground(rng), 0.0f, ground(rng));
+            glm::vec3 half(scale(rng));
+            BoundsComponent bounds;
+            bounds.setWorldBounds(center - half, center + half);
+            world.addComponent<BoundsComponent>(id, bounds);
+        }
+
+        // The camera walks into the forest; every frame culls, then selects
+        const int FRAMES = 120;
+        auto cameraAt = [&](int frame) {
+            CameraData camera;
+            camera.position = glm::vec3(0.0f, 10.0f, 550.0f - 4.0f * frame);
+            camera.viewMatrix = glm::lookAt(camera.position, camera.position + glm::vec3(0.0f, -0.05f, -1.0f),
+                glm::vec3(0.0f, 1.0f, 0.0f));
+            camera.projectionMatrix = glm::perspective(glm::radians(camera.fov), 16.0f / 9.0f, 0.1f, 2000.0f);
+            return camera;
+        };
+
+        auto walk = [&](float hysteresis, double& selectMs, double& saved, double& switches, double& fraction) {
+            world.forEach<LODComponent>([&](EntityID, LODComponent& lod) {
+                lod.hysteresis = hysteresis;
+                lod.current = 0;
+            });
+            FrustumCuller culler;
+            LODSystem lodSystem;
+            selectMs = saved = switches = fraction = 0.0;
+            for (int f = 0; f < FRAMES; ++f) {
+                CameraData camera = cameraAt(f);
+                culler.cull(world, Frustum::fromMatrix(camera.projectionMatrix * camera.viewMatrix));
+                lodSystem.select(world, camera, &culler);
+                const auto& stats = lodSystem.getStats();
+                selectMs += stats.lastSelectMs;
+                saved += static_cast<double>(stats.trianglesSaved());
+                switches += f > 0 ? static_cast<double>(stats.switches) : 0.0;
+                fraction += stats.fullTriangles ? double(stats.drawnTriangles) / double(stats.fullTriangles) : 1.0;
+            }
+            selectMs /= FRAMES;
+            saved /= FRAMES;
+            switches /= FRAMES - 1;
+            fraction /= FRAMES;
+        };
+
+        double selectMs, saved, switches, fraction;
+        walk(0.15f, selectMs, saved, switches, fraction);
+        std::cout << "[Bench]   select: " << selectMs << " ms per frame | " << saved
+            << " triangles saved per frame (" << fraction * 100.0 << "% of full detail drawn) | "
+            << switches << " switches per frame" << std::endl;
+
+        double plainMs, plainSaved, plainSwitches, plainFraction;
+        walk(0.0f, plainMs, plainSaved, plainSwitches, plainFraction);
+        std::cout << "[Bench]   without hysteresis: " << plainSwitches << " switches per frame" << std::endl;
+
+        // An object resting on a threshold while the camera breathes by 2%
+        LODComponent lod;
+        lod.addLevel({}, {}, 0.05f);
+        size_t flips[2] = { 0, 0 };
+        for (int run = 0; run < 2; ++run) {
+            lod.hysteresis = run == 0 ? 0.15f : 0.0f;
+            lod.current = 0;
+            for (int f = 0; f < 1000; ++f) {
+                float size = 0.05f * (1.0f + 0.02f * std::sin(f * 0.7f));
+                uint32_t level = LODSystem::chooseLevel(lod, size);
+                flips[run] += level != lod.current;
+                lod.current = level;
+            }
+        }
+        std::cout << "[Bench]   at a threshold, 1000 frames: " << flips[0] << " switches (hysteresis) vs "
+            << flips[1] << " (none)" << std::endl;
+
+        consume(static_cast<float>(saved + plainSaved));
+    }
+
+} // namespace libre::bench
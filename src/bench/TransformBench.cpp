@@ -0,0 +1,128 @@
+#include "Benchmarks.h"
+#include "../world/TransformKernels.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <limits>
+
+namespace libre::bench {
+
+    // The per-entity paths the kernels replaced
+    static glm::mat4 referenceLocalMatrix(const glm::vec3& p, const glm::quat& q, const glm::vec3& s) {
+        glm::mat4 t = glm::translate(glm::mat4(1.0f), p);
+        glm::mat4 r = glm::mat4_cast(q);
+        glm::mat4 sc = glm::scale(glm::mat4(1.0f), s);
+        return t * r * sc;
+    }
+
+    static void referenceWorldBounds(const glm::mat4& m, const glm::vec3& lo, const glm::vec3& hi,
+        glm::vec3& outMin, glm::vec3& outMax) {
+        outMin = glm::vec3(std::numeric_limits<float>::max());
+        outMax = glm::vec3(std::numeric_limits<float>::lowest());
+        for (int c = 0; c < 8; ++c) {
+            glm::vec3 corner((c & 1) ? hi.x : lo.x, (c & 2) ? hi.y : lo.y, (c & 4) ? hi.z : lo.z);
+            glm::vec3 p = glm::vec3(m * glm::vec4(corner, 1.0f));
+            outMin = glm::min(outMin, p);
+            outMax = glm::max(outMax, p);
+        }
+    }
+
+    void runTransformKernels(size_t count) {
+        std::cout << "[Bench] Transform kernels: " << count << " entities, kernel="
+            << TransformKernels::getKernelName() << std::endl;
+
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> scl(0.1f, 4.0f);
+
+        // SoA inputs
+        std::vector<float> px(count), py(count), pz(count);
+        std::vector<float> qx(count), qy(count), qz(count), qw(count);
+        std::vector<float> sx(count), sy(count), sz(count);
+        std::vector<float> minX(count), minY(count), minZ(count);
+        std::vector<float> maxX(count), maxY(count), maxZ(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            px[i] = pos(rng); py[i] = pos(rng); pz[i] = pos(rng);
+            glm::quat q = glm::normalize(glm::quat(unit(rng), unit(rng), unit(rng), unit(rng)));
+            qx[i] = q.x; qy[i] = q.y; qz[i] = q.z; qw[i] = q.w;
+            sx[i] = scl(rng); sy[i] = scl(rng); sz[i] = scl(rng);
+
+            float a = unit(rng), b = unit(rng), c = unit(rng);
+            minX[i] = a - 1.0f; minY[i] = b - 1.0f; minZ[i] = c - 1.0f;
+            maxX[i] = a + 1.0f; maxY[i] = b + 1.0f; maxZ[i] = c + 1.0f;
+        }
+
+        std::vector<glm::mat4> reference(count), batched(count);
+
+        // --------------------------------------------------------------------
+        // TRS -> matrix
+        // --------------------------------------------------------------------
+        double glmMs = measureMs(10, [&]() {
+            for (size_t i = 0; i < count; ++i) {
+                reference[i] = referenceLocalMatrix(
+                    glm::vec3(px[i], py[i], pz[i]),
+                    glm::quat(qw[i], qx[i], qy[i], qz[i]),
+                    glm::vec3(sx[i], sy[i], sz[i]));
+            }
+            });
+
+        TRSBatch trs{ px.data(), py.data(), pz.data(),
+            qx.data(), qy.data(), qz.data(), qw.data(),
+            sx.data(), sy.data(), sz.data(), count };
+
+        double kernelMs = measureMs(10, [&]() {
+            TransformKernels::composeTRS(trs, batched.data());
+            });
+
+        float maxError = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            for (int c = 0; c < 4; ++c) {
+                for (int r = 0; r < 4; ++r) {
+                    maxError = std::max(maxError, std::abs(reference[i][c][r] - batched[i][c][r]));
+                }
+            }
+        }
+
+        std::cout << "[Bench]   TRS->mat4   glm: " << glmMs << " ms | batch: " << kernelMs
+            << " ms | speedup: " << (glmMs / std::max(kernelMs, 1e-6))
+            << "x | max error: " << maxError << std::endl;
+
+        // --------------------------------------------------------------------
+        // World AABB
+        // --------------------------------------------------------------------
+        std::vector<glm::vec3> refMin(count), refMax(count);
+        glmMs = measureMs(10, [&]() {
+            for (size_t i = 0; i < count; ++i) {
+                referenceWorldBounds(batched[i],
+                    glm::vec3(minX[i], minY[i], minZ[i]), glm::vec3(maxX[i], maxY[i], maxZ[i]),
+                    refMin[i], refMax[i]);
+            }
+            });
+
+        std::vector<float> oMinX(count), oMinY(count), oMinZ(count);
+        std::vector<float> oMaxX(count), oMaxY(count), oMaxZ(count);
+        AABBBatch boxes{ minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data(), count };
+        AABBBatchOut out{ oMinX.data(), oMinY.data(), oMinZ.data(), oMaxX.data(), oMaxY.data(), oMaxZ.data() };
+
+        kernelMs = measureMs(10, [&]() {
+            TransformKernels::transformAABBs(batched.data(), boxes, out);
+            });
+
+        maxError = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            maxError = std::max(maxError, glm::length(refMin[i] - glm::vec3(oMinX[i], oMinY[i], oMinZ[i])));
+            maxError = std::max(maxError, glm::length(refMax[i] - glm::vec3(oMaxX[i], oMaxY[i], oMaxZ[i])));
+        }
+
+        std::cout << "[Bench]   World AABB  8-corner: " << glmMs << " ms | Arvo batch: " << kernelMs
+            << " ms | speedup: " << (glmMs / std::max(kernelMs, 1e-6))
+            << "x | max error: " << maxError << std::endl;
+
+        consume(batched[count / 2][3][0] + oMaxX[count / 2] + refMax[count / 2].x);
+    }
+
+} // namespace libre::bench
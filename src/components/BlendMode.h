@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+namespace libre {
+
+    // How a layer combines with what is below it (see BlendKernels for the
+    // pixel math). Kept apart so components need not include the kernels.
+    enum class BlendMode : uint8_t {
+        Normal,     // Source over destination
+        Add,        // Saturating add
+        Multiply,   // src * dst, plus each side where the other is transparent
+    };
+
+} // namespace libre
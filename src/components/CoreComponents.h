@@ -2,16 +2,23 @@
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include "../world/TransformKernels.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include "BlendMode.h"
+
 #include <vector>
 #include <cstdint>
 #include <string>
+#include <memory>
+#include <future>
 
 namespace libre {
 
+    class MeshBVH;
+
     // ============================================================================
     // TRANSFORM COMPONENT
     // ============================================================================
@@ -23,39 +30,11 @@ namespace libre {
 
         // Cached world matrix
         glm::mat4 worldMatrix = glm::mat4(1.0f);
-        bool dirty = true;
+        bool dirty = true;  // Queue changes with World::markTransformDirty; the flag is not scanned
 
-        // Compute local transform matrix
+        // Compute local transform matrix (T * R * S, built directly)
         glm::mat4 getLocalMatrix() const {
-            glm::mat4 t = glm::translate(glm::mat4(1.0f), position);
-            glm::mat4 r = glm::mat4_cast(rotation);
-            glm::mat4 s = glm::scale(glm::mat4(1.0f), scale);
-            return t * r * s;
-        }
-
-        // Helper setters
-        void setPosition(float x, float y, float z) {
-            position = glm::vec3(x, y, z);
-            dirty = true;
-        }
-
-        void setRotationEuler(float pitch, float yaw, float roll) {
-            rotation = glm::quat(glm::vec3(
-                glm::radians(pitch),
-                glm::radians(yaw),
-                glm::radians(roll)
-            ));
-            dirty = true;
-        }
-
-        void setScale(float uniform) {
-            scale = glm::vec3(uniform);
-            dirty = true;
-        }
-
-        void setScale(float x, float y, float z) {
-            scale = glm::vec3(x, y, z);
-            dirty = true;
+            return TransformKernels::composeTRS(position, rotation, scale);
         }
     };
 
@@ -82,6 +61,20 @@ namespace libre {
         uint64_t vertexBufferHandle = 0;
         uint64_t indexBufferHandle = 0;
         bool gpuDirty = true;
+        uint64_t geometryVersion = 0;   // Bumped by markGeometryDirty (cached upload geometry is rebuilt)
+
+        // Triangle BVH for picking (built on demand by MeshBVH::get, shared
+        // by copies; dropped by markGeometryDirty)
+        std::shared_ptr<const MeshBVH> pickBVH;
+        std::shared_future<std::shared_ptr<const MeshBVH>> pickBVHBuild;   // MeshBVH::getAsync in flight
+
+        // Vertices or indices were edited in place
+        void markGeometryDirty() {
+            gpuDirty = true;
+            ++geometryVersion;
+            pickBVH.reset();
+            pickBVHBuild = {};
+        }
 
         // Calculate bounds from vertices
         void calculateBounds() {
@@ -112,6 +105,55 @@ namespace libre {
         size_t getTriangleCount() const { return indices.size() / 3; }
     };
 
+    // ============================================================================
+    // OCCLUDER COMPONENT - Simplified stand-in for software occlusion
+    // ============================================================================
+    // Object-space triangles OcclusionCuller rasterizes instead of the
+    // entity's MeshComponent. The proxy must stay inside the rendered
+    // surface, or objects behind its excess are culled wrongly.
+
+    struct OccluderComponent {
+        std::vector<glm::vec3> vertices;
+        std::vector<uint32_t> indices;
+        bool enabled = true;            // false: never an occluder
+    };
+
+    // ============================================================================
+    // LOD COMPONENT - Coarser geometry for distant rendering
+    // ============================================================================
+    // Level 0 is the entity's MeshComponent; levels[i] is level i + 1, each
+    // coarser than the one before. A level is drawn once the entity's
+    // projected size (bounding sphere diameter over viewport height) drops
+    // below its screenSize. LODSystem selects 'current' every frame.
+    // Levels can also be generated: LODGenerator fills them from
+    // generateRatios in the background.
+
+    struct LODLevel {
+        std::vector<MeshVertex> vertices;
+        std::vector<uint32_t> indices;
+        float screenSize = 0.0f;        // Drawn below this projected size
+        bool gpuDirty = true;
+
+        size_t getTriangleCount() const { return indices.size() / 3; }
+    };
+
+    struct LODComponent {
+        std::vector<LODLevel> levels;   // Decreasing screenSize
+        float hysteresis = 0.15f;       // Switch only this far past a threshold (relative)
+        uint32_t current = 0;           // Selected level, 0 = MeshComponent
+        std::vector<float> generateRatios;  // Triangle fractions still to generate (levels empty)
+
+        void addLevel(std::vector<MeshVertex> vertices, std::vector<uint32_t> indices, float screenSize) {
+            LODLevel level;
+            level.vertices = std::move(vertices);
+            level.indices = std::move(indices);
+            level.screenSize = screenSize;
+            levels.push_back(std::move(level));
+        }
+
+        uint32_t getLevelCount() const { return static_cast<uint32_t>(levels.size()) + 1; }
+    };
+
     // ============================================================================
     // RENDER COMPONENT - Visual properties
     // ============================================================================
@@ -161,28 +203,15 @@ namespace libre {
 
         // Update world bounds from transform
         void updateWorldBounds(const glm::mat4& worldMatrix) {
-            // Transform all 8 corners of local AABB
-            glm::vec3 corners[8] = {
-                glm::vec3(localMin.x, localMin.y, localMin.z),
-                glm::vec3(localMax.x, localMin.y, localMin.z),
-                glm::vec3(localMin.x, localMax.y, localMin.z),
-                glm::vec3(localMax.x, localMax.y, localMin.z),
-                glm::vec3(localMin.x, localMin.y, localMax.z),
-                glm::vec3(localMax.x, localMin.y, localMax.z),
-                glm::vec3(localMin.x, localMax.y, localMax.z),
-                glm::vec3(localMax.x, localMax.y, localMax.z),
-            };
-
-            worldMin = glm::vec3(std::numeric_limits<float>::max());
-            worldMax = glm::vec3(std::numeric_limits<float>::lowest());
-
-            for (int i = 0; i < 8; ++i) {
-                glm::vec4 transformed = worldMatrix * glm::vec4(corners[i], 1.0f);
-                glm::vec3 p = glm::vec3(transformed);
-                worldMin = glm::min(worldMin, p);
-                worldMax = glm::max(worldMax, p);
-            }
+            glm::vec3 newMin, newMax;
+            TransformKernels::transformAABB(worldMatrix, localMin, localMax, newMin, newMax);
+            setWorldBounds(newMin, newMax);
+        }
 
+        // Store an already transformed box (batch kernels write through this)
+        void setWorldBounds(const glm::vec3& newMin, const glm::vec3& newMax) {
+            worldMin = newMin;
+            worldMax = newMax;
             worldCenter = (worldMin + worldMax) * 0.5f;
             worldRadius = glm::length(worldMax - worldCenter);
             dirty = false;
@@ -232,6 +261,68 @@ namespace libre {
         }
     };
 
+    // ============================================================================
+    // GRAPH NODE COMPONENT - Node in a procedural/material graph
+    // ============================================================================
+    // Inputs are NodeConnection relationships: from = upstream node, to = this
+    // node, order = input socket. Evaluated by NodeGraphSystem; call its
+    // markDirty after changing op or params.
+
+    struct GraphNodeComponent {
+        uint32_t op = 0;                // Operation id from NodeGraphSystem::registerOp
+        std::vector<float> params;
+    };
+
+    // ============================================================================
+    // CONSTRAINT COMPONENT - IK chain or copy-transform on the owning entity
+    // ============================================================================
+    // The target is the 'from' side of a Constraint relationship whose 'to' is
+    // the owner. For IK the owner is the end effector; the chain runs
+    // chainLength parents up the hierarchy. Solved by ConstraintSystem.
+
+    struct ConstraintComponent {
+        enum class Type : uint8_t {
+            IKChain,
+            CopyTransform,
+        };
+
+        enum class Solver : uint8_t {
+            FABRIK,
+            CCD,
+        };
+
+        Type type = Type::IKChain;
+        Solver solver = Solver::FABRIK;
+        uint32_t chainLength = 2;       // Bones above the effector (IK)
+        uint32_t iterations = 10;       // Max solver iterations (IK)
+        float tolerance = 0.001f;       // Stop when the effector is this close (IK)
+        float influence = 1.0f;         // 0 = no effect, 1 = fully constrained
+
+        bool copyPosition = true;       // CopyTransform channels
+        bool copyRotation = true;
+        bool copyScale = false;
+
+        bool enabled = true;
+    };
+
+    // ============================================================================
+    // CANVAS / LAYER COMPONENTS - 2D documents
+    // ============================================================================
+    // A canvas owns its layers through LayerStack relationships: from = canvas,
+    // to = layer, order = stacking position (lowest is at the bottom).
+    // Pixels live in LayerCompositor, not in the component.
+
+    struct CanvasComponent {
+        uint32_t width = 1920;
+        uint32_t height = 1080;
+    };
+
+    struct LayerComponent {
+        BlendMode blendMode = BlendMode::Normal;
+        float opacity = 1.0f;
+        bool visible = true;
+    };
+
     // ============================================================================
     // NAME COMPONENT - Simple name storage
     // ============================================================================
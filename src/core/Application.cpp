@@ -4,10 +4,23 @@
 #include "Application.h"
 #include "Editor.h"
 #include "FrameData.h"
+#include "HoverSystem.h"
 #include "../render/RenderThread.h"
 #include "../render/VulkanContext.h"  // Need full definition for vkDeviceWaitIdle
 #include "../render/Mesh.h"
 #include "../world/Primitives.h"
+#include "../world/TransformSystem.h"
+#include "../world/NodeGraph.h"
+#include "../world/ConstraintSystem.h"
+#include "../world/LayerCompositor.h"
+#include "../world/LODSystem.h"
+#include "../world/LODGenerator.h"
+#include "../spatial/SceneBVH.h"
+#include "../spatial/Frustum.h"
+#include "../spatial/OcclusionCuller.h"
+#include "../spatial/ClusterCuller.h"
+#include "../spatial/SpatialHash.h"
+#include "../mesh/UploadOptimizer.h"
 #include "../components/CoreComponents.h"  // For MeshComponent, TransformComponent, etc.
 #include "../ui/UI.h"
 #include "../ui/Widgets.h"
@@ -59,6 +72,21 @@ void Application::init() {
     // Initialize Editor singleton
     libre::Editor::instance().initialize();
 
+    // Main-thread systems
+    transformSystem = std::make_unique<libre::TransformSystem>();
+    nodeGraphSystem = std::make_unique<libre::NodeGraphSystem>();
+    constraintSystem = std::make_unique<libre::ConstraintSystem>();
+    layerCompositor = std::make_unique<libre::LayerCompositor>();
+    sceneBVH = std::make_unique<libre::SceneBVH>();
+    spatialHash = std::make_unique<libre::SpatialHash>();
+    frustumCuller = std::make_unique<libre::FrustumCuller>();
+    occlusionCuller = std::make_unique<libre::OcclusionCuller>();
+    clusterCuller = std::make_unique<libre::ClusterCuller>();
+    lodGenerator = std::make_unique<libre::LODGenerator>();
+    lodSystem = std::make_unique<libre::LODSystem>();
+    hoverSystem = std::make_unique<libre::HoverSystem>();
+    uploadOptimizer = std::make_unique<libre::UploadOptimizer>();
+
     // Create camera (Main Thread owns this)
     camera = std::make_unique<Camera>();
     camera->setAspectRatio(static_cast<float>(WINDOW_WIDTH) / static_cast<float>(WINDOW_HEIGHT));
@@ -200,6 +228,11 @@ void Application::setupUI() {
     // FIXED: Use setMenuBar() instead of non-existent createWidget()
     uiManager->setMenuBar(std::move(menuBar));
 
+    // Background LOD generation (hidden while idle)
+    auto progressBar = std::make_unique<ProgressBar>("Generating LODs");
+    lodProgress = progressBar.get();
+    uiManager->addWidget(std::move(progressBar));
+
     // Initial layout
     int w, h;
     glfwGetFramebufferSize(window->getHandle(), &w, &h);
@@ -230,8 +263,22 @@ void Application::cleanup() {
     if (uiManager) {
         uiManager->cleanup();
         uiManager.reset();
+        lodProgress = nullptr;
     }
 
+    uploadOptimizer.reset();
+    hoverSystem.reset();
+    lodSystem.reset();
+    lodGenerator.reset();
+    clusterCuller.reset();
+    occlusionCuller.reset();
+    frustumCuller.reset();
+    spatialHash.reset();
+    sceneBVH.reset();
+    layerCompositor.reset();
+    constraintSystem.reset();
+    nodeGraphSystem.reset();
+    transformSystem.reset();
     camera.reset();
     inputManager.reset();
     window.reset();
@@ -247,7 +294,7 @@ void Application::mainLoop() {
     std::cout << "[MainLoop] Starting main loop (render thread architecture)" << std::endl;
 
     // Track which entities have pending uploads
-    std::unordered_set<libre::EntityID> pendingUploads;
+    std::unordered_set<libre::MeshHandle> pendingUploads;
     uint64_t lastProcessedFrame = 0;
 
     while (!window->shouldClose()) {
@@ -317,7 +364,16 @@ void Application::mainLoop() {
         if (lastCompleted > lastProcessedFrame && !pendingUploads.empty()) {
             // Render thread processed our frame - safe to clear gpuDirty
             auto& world = libre::Editor::instance().getWorld();
-            for (libre::EntityID id : pendingUploads) {
+            for (libre::MeshHandle handle : pendingUploads) {
+                // Coarser LOD levels upload under their own handle
+                uint32_t level = libre::LODSystem::getHandleLevel(handle);
+                libre::EntityID id = libre::LODSystem::getHandleEntity(handle);
+                uploadOptimizer->release(handle);
+                if (level > 0) {
+                    auto* lod = world.getComponent<libre::LODComponent>(id);
+                    if (lod && level <= lod->levels.size()) lod->levels[level - 1].gpuDirty = false;
+                    continue;
+                }
                 if (auto* mesh = world.getComponent<libre::MeshComponent>(id)) {
                     mesh->gpuDirty = false;
                     if (lastProcessedFrame <= 10) {
@@ -491,6 +547,15 @@ void Application::handleKeyboardShortcuts() {
         if (camera) camera->setTop();
     }
 
+    // Select the active entity with all of its children (Shift: add to selection)
+    if (inputManager->isKeyJustPressed(GLFW_KEY_RIGHT_BRACKET)) {
+        auto& editor = libre::Editor::instance();
+        libre::EntityID active = editor.getActiveEntity();
+        if (active != libre::INVALID_ENTITY) {
+            editor.selectHierarchy(active, shiftHeld);
+        }
+    }
+
     // Forward key events to UI
     if (uiManager) {
         // Forward escape key
@@ -505,7 +570,13 @@ void Application::handleKeyboardShortcuts() {
 // ============================================================================
 
 void Application::update(float dt) {
+    // Re-cook procedural/material graphs touched by edits
+    nodeGraphSystem->update(libre::Editor::instance().getWorld());
+
     updateTransforms();
+
+    // Recomposite the tiles painted since last frame
+    layerCompositor->update(libre::Editor::instance().getWorld());
 }
 
 // ============================================================================
@@ -515,26 +586,37 @@ void Application::update(float dt) {
 void Application::updateTransforms() {
     auto& world = libre::Editor::instance().getWorld();
 
-    world.forEach<libre::TransformComponent>([&](libre::EntityID id, libre::TransformComponent& t) {
-        if (t.dirty) {
-            if (world.getParent(id) == libre::INVALID_ENTITY) {
-                t.worldMatrix = t.getLocalMatrix();
-            }
-            else {
-                auto* parentT = world.getComponent<libre::TransformComponent>(world.getParent(id));
-                if (parentT) {
-                    t.worldMatrix = parentT->worldMatrix * t.getLocalMatrix();
-                }
-            }
+    // Depth-ordered: parents always resolve before children, and a moved
+    // parent re-evaluates its whole subtree in the same pass
+    transformSystem->update(world);
 
-            auto* bounds = world.getComponent<libre::BoundsComponent>(id);
-            if (bounds) {
-                bounds->updateWorldBounds(t.worldMatrix);
-            }
+    // Constraints read the propagated pose; whatever they rewrite is
+    // propagated again (only the affected subtrees)
+    if (constraintSystem->solve(world)) {
+        transformSystem->update(world);
+    }
 
-            t.dirty = false;
-        }
-        });
+    // Picking and proximity structures follow every bounds change of this frame
+    sceneBVH->update(world, transformSystem->getMovedBounds());
+    spatialHash->update(world, transformSystem->getMovedBounds());
+    updateHover(!transformSystem->getMovedBounds().empty());
+    transformSystem->clearMovedBounds();
+}
+
+// ============================================================================
+// UPDATE HOVER
+// ============================================================================
+
+void Application::updateHover(bool sceneChanged) {
+    auto& world = libre::Editor::instance().getWorld();
+    if (!camera || !inputManager) return;
+
+    // Cursor positions are in window coordinates, not framebuffer pixels
+    int w, h;
+    glfwGetWindowSize(window->getHandle(), &w, &h);
+    hoverSystem->update(world, *sceneBVH, *camera,
+        static_cast<float>(inputManager->getMouseX()), static_cast<float>(inputManager->getMouseY()),
+        w, h, sceneChanged);
 }
 
 // ============================================================================
@@ -591,6 +673,52 @@ libre::FrameData Application::prepareFrameData() {
     // Diagnostic counters
     size_t totalMeshComponents = 0;
     size_t meshesNeedingUpload = 0;
+    size_t meshesOptimizing = 0;
+    size_t meshesCulled = 0;
+
+    // Cull every bounded object against the view once, then against the
+    // largest occluders; offscreen or hidden meshes are neither uploaded nor
+    // drawn (they upload when they come into view)
+    const bool cullToView = camera != nullptr;
+    size_t meshesOccluded = 0;
+    glm::mat4 viewProjection = data.camera.projectionMatrix * data.camera.viewMatrix;
+    if (cullToView) {
+        frustumCuller->cull(world, libre::Frustum::fromMatrix(viewProjection));
+        occlusionCuller->cull(world, viewProjection, *frustumCuller);
+    }
+
+    // Meshlets of the surviving large meshes are culled one by one. Meshes
+    // and LOD levels that went away since the last frame drop theirs.
+    clusterCuller->beginFrame();
+    auto* meshStorage = world.getStorage<libre::MeshComponent>();
+    auto* lodStorage = world.getStorage<libre::LODComponent>();
+    uint64_t membershipVersion = (meshStorage ? meshStorage->getVersion() : 0) + (lodStorage ? lodStorage->getVersion() : 0);
+    if (membershipVersion != meshMembershipVersion) {
+        auto gone = [&](libre::MeshHandle handle) {
+            libre::EntityID id = libre::LODSystem::getHandleEntity(handle);
+            uint32_t level = libre::LODSystem::getHandleLevel(handle);
+            if (level == 0) return !world.hasComponent<libre::MeshComponent>(id);
+            auto* lod = world.getComponent<libre::LODComponent>(id);
+            return !lod || level > lod->levels.size();
+        };
+        clusterCuller->prune(gone);
+        for (auto it = residentMeshes.begin(); it != residentMeshes.end();) {
+            it = gone(*it) ? residentMeshes.erase(it) : std::next(it);
+        }
+        meshMembershipVersion = membershipVersion;
+    }
+    size_t meshesClusterCulled = 0;
+
+    // Generated LOD chains arrive here; pick each LOD entity's level from
+    // its projected size (in-view only)
+    lodGenerator->update(world);
+    if (lodProgress) lodProgress->value.store(lodGenerator->getProgress(), std::memory_order_relaxed);
+    lodSystem->select(world, data.camera, cullToView ? frustumCuller.get() : nullptr);
+    data.stats.lodSelected = static_cast<uint32_t>(lodSystem->getStats().selected);
+    data.stats.lodSwitches = static_cast<uint32_t>(lodSystem->getStats().switches);
+
+    // Hover was resolved in update(); meshes only compare against it
+    data.hoveredEntity = hoverSystem->getHovered();
 
     // Iterate over all entities with MeshComponent
     world.forEach<libre::MeshComponent>([&](libre::EntityID id, libre::MeshComponent& meshComp) {
@@ -601,6 +729,15 @@ libre::FrameData Application::prepareFrameData() {
 
         if (!transform) return;
         if (render && !render->visible) return;
+        if (!world.isVisible(id)) return;
+        if (cullToView && !frustumCuller->isVisible(world, id)) {
+            meshesCulled++;
+            return;
+        }
+        if (cullToView && occlusionCuller->isOccluded(world, id)) {
+            meshesOccluded++;
+            return;
+        }
 
         // Diagnostic logging (first 10 frames)
         if (data.frameNumber <= 10) {
@@ -615,42 +752,79 @@ libre::FrameData Application::prepareFrameData() {
 
 
 
-        // If mesh needs GPU upload
-        if (meshComp.gpuDirty && !meshComp.vertices.empty()) {
-            meshesNeedingUpload++;
+        // Distant objects draw a coarser level, uploaded under its own handle
+        auto* lod = world.getComponent<libre::LODComponent>(id);
+        uint32_t lodLevel = lod ? std::min(lod->current, static_cast<uint32_t>(lod->levels.size())) : 0;
+        size_t triangles = meshComp.getTriangleCount();
+        if (lodLevel > 0) {
+            libre::LODLevel& level = lod->levels[lodLevel - 1];
+            triangles = level.getTriangleCount();
+
+            if (level.gpuDirty && !level.vertices.empty()) {
+                libre::MeshHandle handle = libre::LODSystem::getMeshHandle(id, lodLevel);
+                libre::MeshUploadData upload;
+                std::shared_ptr<const libre::MeshletData> meshlets;
+                if (uploadOptimizer->prepare(handle, level.vertices, level.indices, 0, upload, &meshlets)) {
+                    clusterCuller->setMeshlets(handle, std::move(meshlets));
+                    residentMeshes.insert(handle);
+                    meshesNeedingUpload++;
+                    data.meshUploads.push_back(std::move(upload));
+                }
+                else {
+                    // The previous upload (and its meshlets) draws meanwhile
+                    meshesOptimizing++;
+                    if (!residentMeshes.count(handle)) return;
+                }
+            }
+        }
 
+        // If mesh needs GPU upload
+        else if (meshComp.gpuDirty && !meshComp.vertices.empty()) {
+            // Reordered for the vertex caches. An edited mesh keeps drawing
+            // its previous upload (and meshlets) until then; a new one has
+            // nothing to draw yet.
             libre::MeshUploadData upload;
-            upload.entityId = id;
-            upload.vertices.reserve(meshComp.vertices.size());
-
-            // Convert MeshVertex to UploadVertex
-            for (const auto& v : meshComp.vertices) {
-                libre::UploadVertex uv;
-                uv.position = v.position;
-                uv.normal = v.normal;
-                uv.color = v.color;
-                upload.vertices.push_back(uv);
+            std::shared_ptr<const libre::MeshletData> meshlets;
+            if (uploadOptimizer->prepare(id, meshComp.vertices, meshComp.indices, meshComp.geometryVersion, upload, &meshlets)) {
+                clusterCuller->setMeshlets(id, std::move(meshlets));
+                residentMeshes.insert(id);
+                meshesNeedingUpload++;
+                data.meshUploads.push_back(std::move(upload));
+
+                // Mark as uploaded (will be set to false by render thread)
+                //remove -->  meshComp.gpuDirty = false;
+
+                if (data.frameNumber <= 5) {
+                    std::cout << "[prepareFrameData] >>> QUEUED upload for entity "
+                        << id << " (" << meshComp.vertices.size() << " verts, "
+                        << meshComp.indices.size() << " indices)" << std::endl;
+                }
             }
-            upload.indices = meshComp.indices;
-
-            data.meshUploads.push_back(std::move(upload));
-
-            // Mark as uploaded (will be set to false by render thread)
-            //remove -->  meshComp.gpuDirty = false;
-
-            if (data.frameNumber <= 5) {
-                std::cout << "[prepareFrameData] >>> QUEUED upload for entity "
-                    << id << " (" << meshComp.vertices.size() << " verts, "
-                    << meshComp.indices.size() << " indices)" << std::endl;
+            else {
+                meshesOptimizing++;
+                if (!residentMeshes.count(id)) return;
             }
         }
 
         // Add to render list
         libre::RenderableMesh rm;
-        rm.meshHandle = static_cast<libre::MeshHandle>(id);
+        rm.meshHandle = libre::LODSystem::getMeshHandle(id, lodLevel);
+        rm.lodLevel = lodLevel;
         rm.modelMatrix = transform->worldMatrix;
         rm.entityId = id;
+
+        // Only the meshlets in view and facing the camera
+        if (cullToView) {
+            size_t firstRange = data.drawRanges.size();
+            if (!clusterCuller->cull(rm.meshHandle, rm.modelMatrix, viewProjection, data.camera.position, data.drawRanges)) {
+                meshesClusterCulled++;
+                return;
+            }
+            rm.firstDrawRange = static_cast<uint32_t>(firstRange);
+            rm.drawRangeCount = static_cast<uint32_t>(data.drawRanges.size() - firstRange);
+        }
         rm.isSelected = editor.isSelected(id);
+        rm.isHovered = id == data.hoveredEntity;
 
         // Get color from render component or use default
         if (render) {
@@ -663,14 +837,31 @@ libre::FrameData Application::prepareFrameData() {
         }
 
         data.meshes.push_back(rm);
+        data.stats.trianglesRendered += triangles;
+        data.stats.lodTrianglesSaved += meshComp.getTriangleCount() - std::min(meshComp.getTriangleCount(), triangles);
         });
 
+    data.stats.meshComponents = static_cast<uint32_t>(totalMeshComponents);
+    data.stats.renderables = static_cast<uint32_t>(data.meshes.size());
+    data.stats.culled = static_cast<uint32_t>(meshesCulled);
+    data.stats.occluded = static_cast<uint32_t>(meshesOccluded);
+    data.stats.clusterCulled = static_cast<uint32_t>(meshesClusterCulled);
+
     // Diagnostic: Print frame summary (first 5 frames only)
     if (data.frameNumber <= 5) {
         std::cout << "[prepareFrameData] Frame " << data.frameNumber
-            << " | MeshComponents: " << totalMeshComponents
+            << " | MeshComponents: " << data.stats.meshComponents
             << " | NeedUpload: " << meshesNeedingUpload
-            << " | Renderables: " << data.meshes.size() << std::endl;
+            << " | Optimizing: " << meshesOptimizing
+            << " | Renderables: " << data.stats.renderables
+            << " | Culled: " << data.stats.culled
+            << " | Occluded: " << data.stats.occluded
+            << " | Clusters culled: " << clusterCuller->getStats().outsideFrustum + clusterCuller->getStats().backFacing
+            << " (" << data.stats.clusterCulled << " meshes)"
+            << " | Triangles: " << data.stats.trianglesRendered
+            << " | LOD saved: " << data.stats.lodTrianglesSaved << " tris"
+            << " | ACMR: " << uploadOptimizer->getStats().acmrBefore << " -> " << uploadOptimizer->getStats().acmrAfter
+            << std::endl;
     }
 
     return data;
@@ -710,14 +901,17 @@ void Application::createDefaultScene() {
     auto sphere = libre::Primitives::createSphere(world, 1.0f, 32, 16, "Sphere");
     if (auto* t = sphere.get<libre::TransformComponent>()) {
         t->position = glm::vec3(3.0f, 0.0f, 0.0f);
-        t->dirty = true;
+        world.markTransformDirty(sphere.getID());
     }
+    libre::LODComponent sphereLod;
+    sphereLod.generateRatios = { 0.5f, 0.25f, 0.1f };
+    sphere.add<libre::LODComponent>(sphereLod);
 
     // Create a cylinder at a different position
     auto cylinder = libre::Primitives::createCylinder(world, 0.5f, 2.0f, 32, "Cylinder");
     if (auto* t = cylinder.get<libre::TransformComponent>()) {
         t->position = glm::vec3(-3.0f, 0.0f, 0.0f);
-        t->dirty = true;
+        world.markTransformDirty(cylinder.getID());
     }
 
     std::cout << "[OK] Default scene created with "
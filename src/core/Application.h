@@ -10,14 +10,29 @@
 #include <memory>
 #include <chrono>
 #include <atomic>
+#include <unordered_set>
 
 // Forward declarations
 namespace libre {
     class RenderThread;
+    class TransformSystem;
+    class NodeGraphSystem;
+    class ConstraintSystem;
+    class LayerCompositor;
+    class SceneBVH;
+    class SpatialHash;
+    class FrustumCuller;
+    class OcclusionCuller;
+    class ClusterCuller;
+    class HoverSystem;
+    class LODGenerator;
+    class LODSystem;
+    class UploadOptimizer;
 }
 
 namespace libre::ui {
     class UIManager;
+    class ProgressBar;
 }
 
 class Application {
@@ -56,6 +71,9 @@ private:
     // Update transform hierarchy
     void updateTransforms();
 
+    // Re-pick the hovered entity when the cursor, view or scene moved
+    void updateHover(bool sceneChanged);
+
     // Prepare frame data for render thread
     libre::FrameData prepareFrameData();
 
@@ -76,6 +94,26 @@ private:
     std::unique_ptr<InputManager> inputManager;
     std::unique_ptr<Camera> camera;
     std::unique_ptr<libre::ui::UIManager> uiManager;
+    libre::ui::ProgressBar* lodProgress = nullptr;     // Owned by uiManager
+
+    // ========================================================================
+    // SYSTEMS (Main Thread)
+    // ========================================================================
+    std::unique_ptr<libre::TransformSystem> transformSystem;
+    std::unique_ptr<libre::NodeGraphSystem> nodeGraphSystem;
+    std::unique_ptr<libre::ConstraintSystem> constraintSystem;
+    std::unique_ptr<libre::LayerCompositor> layerCompositor;
+    std::unique_ptr<libre::SceneBVH> sceneBVH;
+    std::unique_ptr<libre::SpatialHash> spatialHash;
+    std::unique_ptr<libre::FrustumCuller> frustumCuller;
+    std::unique_ptr<libre::OcclusionCuller> occlusionCuller;
+    std::unique_ptr<libre::ClusterCuller> clusterCuller;
+    std::unique_ptr<libre::LODGenerator> lodGenerator;
+    std::unique_ptr<libre::LODSystem> lodSystem;
+    std::unique_ptr<libre::HoverSystem> hoverSystem;
+    std::unique_ptr<libre::UploadOptimizer> uploadOptimizer;
+    uint64_t meshMembershipVersion = ~0ull;   // Mesh + LOD storage versions at the last ClusterCuller prune
+    std::unordered_set<libre::MeshHandle> residentMeshes;   // Uploaded at least once (drawable while a re-upload optimizes)
 
     // ========================================================================
     // RENDER THREAD (Owns all Vulkan objects)
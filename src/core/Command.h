@@ -70,8 +70,8 @@ namespace libre {
             if (auto* meta = world.getMetadata(entityId_)) {
                 savedName_ = meta->name;
                 savedType_ = meta->type;
-                savedFlags_ = meta->flags;
             }
+            savedFlags_ = world.getFlags(entityId_);
             savedParent_ = world.getParent(entityId_);
 
             if (auto* t = world.getComponent<TransformComponent>(entityId_)) {
@@ -86,9 +86,7 @@ namespace libre {
             auto handle = world.createEntity(savedName_, savedType_);
             entityId_ = handle.getID();
 
-            if (auto* meta = world.getMetadata(entityId_)) {
-                meta->flags = savedFlags_;
-            }
+            world.setFlags(entityId_, savedFlags_);
 
             if (savedParent_ != INVALID_ENTITY) {
                 world.setParent(entityId_, savedParent_);
@@ -135,7 +133,7 @@ namespace libre {
             t->position = position_;
             t->rotation = rotation_;
             t->scale = scale_;
-            t->dirty = true;
+            world.markTransformDirty(entityId_);
         }
 
         void undo(World& world) override {
@@ -145,7 +143,7 @@ namespace libre {
             t->position = oldPosition_;
             t->rotation = oldRotation_;
             t->scale = oldScale_;
-            t->dirty = true;
+            world.markTransformDirty(entityId_);
         }
 
         bool canMergeWith(const Command& other) const override {
@@ -1,5 +1,7 @@
 #include "Editor.h"
 #include <iostream>
+#include <unordered_set>
+#include <algorithm>
 
 namespace libre {
 
@@ -129,6 +131,36 @@ namespace libre {
         EventBus::instance().publish(event);
     }
 
+    void Editor::selectHierarchy(EntityID root, bool addToSelection) {
+        // Walk the child lists rather than getSubtree: right after edits that
+        // would renumber the whole hierarchy for one subtree
+        std::vector<EntityID> newSelection;
+        std::unordered_set<EntityID> already;
+        if (addToSelection) {
+            newSelection = world_->getSelection();
+            already.insert(newSelection.begin(), newSelection.end());
+        }
+
+        HierarchyTraversal walk;
+        for (const auto& visit : walk.preOrder(world_->getHierarchy(), root)) {
+            if (already.insert(visit.entity).second) {
+                newSelection.push_back(visit.entity);
+            }
+        }
+
+        // Root last so it becomes the active entity
+        auto rootIt = std::find(newSelection.begin(), newSelection.end(), root);
+        if (rootIt != newSelection.end()) {
+            std::iter_swap(rootIt, newSelection.end() - 1);
+        }
+        world_->setSelection(newSelection);
+
+        SelectionChangedEvent event;
+        event.selectedEntities = world_->getSelection();
+        event.activeEntity = world_->getActiveEntity();
+        EventBus::instance().publish(event);
+    }
+
     const std::vector<EntityID>& Editor::getSelection() const {
         return world_->getSelection();
     }
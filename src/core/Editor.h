@@ -43,6 +43,7 @@ namespace libre {
         void selectAll();
         void deselectAll();
         void invertSelection();
+        void selectHierarchy(EntityID root, bool addToSelection = false);
 
         const std::vector<EntityID>& getSelection() const;
         EntityID getActiveEntity() const;
@@ -39,18 +39,26 @@ namespace libre {
     // MESH UPLOAD DATA - For uploading new meshes to GPU
     // ============================================================================
 
-    // Vertex data for GPU upload - matches renderer's Vertex struct
-    struct UploadVertex {
-        glm::vec3 position;
-        glm::vec3 normal;
-        glm::vec3 color;
+    // Compact vertex for GPU upload - matches workbench_packed.vert (20 bytes
+    // against 36 for the renderer's float Vertex). Written by VertexPacking.
+    struct PackedVertex {
+        uint16_t position[4];   // unorm16 across the mesh bounds (w unused)
+        int16_t normal[2];      // Octahedral, snorm16
+        uint8_t color[4];       // RGBA8 unorm
+        uint16_t uv[2];         // Half floats
     };
 
     // Data needed to upload a new mesh to GPU
     struct MeshUploadData {
-        uint64_t entityId = 0;
-        std::vector<UploadVertex> vertices;
-        std::vector<uint32_t> indices;
+        uint64_t entityId = 0;          // Mesh handle: entity id, LOD level in the top bits
+        uint64_t geometryKey = 0;       // Same key, same contents: a repeated upload keeps the GPU mesh
+        std::vector<PackedVertex> vertices;
+        glm::vec3 positionOffset = glm::vec3(0.0f);     // position = offset + unorm * scale
+        glm::vec3 positionScale = glm::vec3(1.0f);
+        std::vector<uint32_t> indices;                  // Meshes of 65,536 vertices or more
+        std::vector<uint16_t> indices16;                // Smaller meshes
+
+        size_t getIndexCount() const { return indices16.empty() ? indices.size() : indices16.size(); }
     };
 
     // ============================================================================
@@ -58,9 +66,19 @@ namespace libre {
     // ============================================================================
     // Represents one object to be drawn. Uses handles, not pointers.
 
+    // Part of a mesh's index buffer: a run of meshlets that survived
+    // ClusterCuller
+    struct DrawRange {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+    };
+
     struct RenderableMesh {
-        MeshHandle meshHandle = INVALID_MESH_HANDLE;    // GPU mesh to draw
+        MeshHandle meshHandle = INVALID_MESH_HANDLE;    // GPU mesh to draw (entity id, LOD level in the top bits)
+        uint32_t lodLevel = 0;                          // 0 = full MeshComponent
         glm::mat4 modelMatrix = glm::mat4(1.0f);        // World transform
+        uint32_t firstDrawRange = 0;                    // Into FrameData::drawRanges
+        uint32_t drawRangeCount = 0;                    // 0 = the whole mesh
         glm::vec4 color = glm::vec4(0.8f, 0.8f, 0.8f, 1.0f);  // Base color/tint
         MaterialHandle material = INVALID_MATERIAL_HANDLE;     // Material (future)
 
@@ -162,6 +180,23 @@ namespace libre {
         glm::vec3 brushNormal = glm::vec3(0.0f, 1.0f, 0.0f);
     };
 
+    // ============================================================================
+    // FRAME STATS - What the main thread culled and drew this frame
+    // ============================================================================
+    // Filled every frame by prepareFrameData, for overlays and logging.
+
+    struct FrameStats {
+        uint32_t meshComponents = 0;
+        uint32_t renderables = 0;
+        uint32_t culled = 0;            // Outside the view
+        uint32_t occluded = 0;
+        uint32_t clusterCulled = 0;     // Every meshlet culled
+        uint64_t trianglesRendered = 0; // Renderables at their LOD level, before meshlet culling
+        uint64_t lodTrianglesSaved = 0; // Against drawing those renderables at level 0
+        uint32_t lodSelected = 0;       // LOD entities in view (LODSystem)
+        uint32_t lodSwitches = 0;       // LOD level changes (LODSystem)
+    };
+
     // ============================================================================
     // FRAME DATA - The main structure passed to render thread
     // ============================================================================
@@ -184,6 +219,12 @@ namespace libre {
         // Objects to render (copied each frame)
         std::vector<RenderableMesh> meshes;
 
+        // Index ranges of partially culled meshes (RenderableMesh::firstDrawRange)
+        std::vector<DrawRange> drawRanges;
+
+        // Entity under the cursor (0 = none); its mesh has isHovered set
+        uint64_t hoveredEntity = 0;
+
         // Meshes that need to be uploaded to GPU this frame
         std::vector<MeshUploadData> meshUploads;
 
@@ -196,6 +237,9 @@ namespace libre {
         // Gizmos/Debug visualization
         GizmoData gizmo;
 
+        // Counters of this frame
+        FrameStats stats;
+
         // Render flags
         bool wireframeMode = false;
         bool showNormals = false;       // Debug: show vertex normals
@@ -207,8 +251,10 @@ namespace libre {
 
         void clear() {
             meshes.clear();
+            drawRanges.clear();
             meshUploads.clear();
             dirtyRegions.clear();
+            stats = FrameStats{};
             frameNumber = 0;
         }
 
@@ -0,0 +1,115 @@
+#include "HoverSystem.h"
+#include "../world/World.h"
+#include "../components/CoreComponents.h"
+#include "../spatial/SceneBVH.h"
+
+#include <chrono>
+#include <algorithm>
+
+namespace libre {
+
+    HoverSystem::HoverSystem(double budgetMs)
+        : budgetMs_(budgetMs) {
+    }
+
+    void HoverSystem::update(World& world, const SceneBVH& bvh, const Camera& camera,
+        float mouseX, float mouseY, int viewportWidth, int viewportHeight, bool sceneChanged) {
+        ++stats_.updates;
+        creditMs_ = std::min(creditMs_ + budgetMs_, budgetMs_ * MAX_SAVED_UPDATES);
+
+        // A hovered entity that was destroyed, hidden or made unselectable
+        // goes right away; whatever is behind it needs a pick
+        if (hit_.hit() && (!world.entityExists(hit_.entity) || !SelectionSystem::isPickable(world, hit_.entity))) {
+            setHovered(world, HitResult());
+            pending_ = true;
+        }
+
+        glm::mat4 viewProjection = camera.getProjectionMatrix() * camera.getViewMatrix();
+        bool changed = !hasInputs_ || sceneChanged ||
+            mouseX != mouseX_ || mouseY != mouseY_ ||
+            viewportWidth != viewportWidth_ || viewportHeight != viewportHeight_ ||
+            viewProjection != viewProjection_;
+        if (!changed && !pending_) {
+            ++stats_.skipped;
+            return;
+        }
+
+        viewProjection_ = viewProjection;
+        mouseX_ = mouseX;
+        mouseY_ = mouseY;
+        viewportWidth_ = viewportWidth;
+        viewportHeight_ = viewportHeight;
+        hasInputs_ = true;
+
+        if (viewportWidth <= 0 || viewportHeight <= 0 ||
+            mouseX < 0.0f || mouseY < 0.0f || mouseX >= viewportWidth || mouseY >= viewportHeight) {
+            setHovered(world, HitResult());
+            pending_ = false;
+            return;
+        }
+
+        Ray ray = SelectionSystem::screenToRay(camera, mouseX, mouseY, viewportWidth, viewportHeight);
+
+        // Coherence: the cursor usually stays on the same surface. A hit on
+        // it stands unless another pickable box lies in front; then only
+        // the space in front needs the full pick.
+        HitResult previous;
+        float maxDistance = std::numeric_limits<float>::max();
+        if (hit_.hit()) {
+            ++stats_.retests;
+            if (SelectionSystem::raycastSurface(world, hit_.entity, ray, previous,
+                std::numeric_limits<float>::max(), MeshPick::Background)) {
+                ++stats_.retestHits;
+                EntityID self = previous.entity;
+                bool blocked = bvh.anyHit(ray.origin, ray.direction, previous.distance, [&](EntityID id) {
+                    return id != self && SelectionSystem::isPickable(world, id);
+                    });
+                if (!blocked) {
+                    setHovered(world, previous);
+                    pending_ = SelectionSystem::isProvisional(world, previous);
+                    return;
+                }
+                maxDistance = previous.distance * 1.0001f + 1e-5f;
+            }
+        }
+
+        if (creditMs_ <= 0.0) {
+            // Over budget: keep what the re-test confirmed, pick later
+            ++stats_.deferred;
+            setHovered(world, previous);
+            pending_ = true;
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        HitResult hit = SelectionSystem::raycast(bvh, world, ray, maxDistance, MeshPick::Background);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        creditMs_ -= ms;
+        ++stats_.picks;
+        stats_.lastPickMs = ms;
+        stats_.averagePickMs = stats_.picks == 1 ? ms : stats_.averagePickMs * 0.9 + ms * 0.1;
+
+        setHovered(world, hit.hit() ? hit : previous);
+        pending_ = SelectionSystem::isProvisional(world, hit_);
+    }
+
+    void HoverSystem::clear(World& world) {
+        setHovered(world, HitResult());
+        pending_ = false;
+        hasInputs_ = false;
+    }
+
+    void HoverSystem::setHovered(World& world, const HitResult& hit) {
+        if (hit.entity != hit_.entity) {
+            if (hit_.hit()) {
+                if (auto* render = world.getComponent<RenderComponent>(hit_.entity)) render->isHovered = false;
+            }
+            if (hit.hit()) {
+                if (auto* render = world.getComponent<RenderComponent>(hit.entity)) render->isHovered = true;
+            }
+        }
+        hit_ = hit;
+    }
+
+} // namespace libre
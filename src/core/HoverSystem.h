@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Selection.h"
+
+#include <glm/glm.hpp>
+
+namespace libre {
+
+    class World;
+    class SceneBVH;
+
+    // ============================================================================
+    // HOVER SYSTEM - The entity under the cursor, carried across frames
+    // ============================================================================
+    // Hover is only recomputed when one of its inputs changed: the cursor,
+    // the view (view-projection or viewport), or the scene's bounds. Then:
+    // 1. The previous hover is re-tested alone (mesh triangles, or its box).
+    //    If it is still hit and no other pickable box lies in front of the
+    //    hit, it stands; otherwise the full pick searches only in front.
+    // 2. The full pick runs through the scene BVH when the pick budget
+    //    allows. The budget is refilled by budgetMs every update and spent
+    //    by each pick's measured cost; a pick it cannot pay for stays
+    //    pending (retried next update even if nothing moves) and the
+    //    re-tested hover stands in until then.
+    //
+    // Hover never builds a mesh's triangle BVH on the frame: a mesh without
+    // one starts a background build (MeshPick::Background) and is hit by
+    // its box meanwhile. Such a hover stays pending, so the exact pick
+    // replaces it once the tree is in.
+    //
+    // Hover changes are written to RenderComponent::isHovered of the two
+    // entities involved; a frame compares against getHovered() per mesh.
+
+    class HoverSystem {
+    public:
+        struct Stats {
+            size_t updates = 0;
+            size_t skipped = 0;         // Nothing changed, nothing pending
+            size_t retests = 0;         // Previous hover re-tested
+            size_t retestHits = 0;
+            size_t picks = 0;           // Full BVH picks
+            size_t deferred = 0;        // Picks postponed by the budget
+            double lastPickMs = 0.0;
+            double averagePickMs = 0.0;
+        };
+
+        static constexpr double DEFAULT_BUDGET_MS = 0.5;
+
+        // Unspent budget carried over while idle, in updates
+        static constexpr double MAX_SAVED_UPDATES = 4.0;
+
+        explicit HoverSystem(double budgetMs = DEFAULT_BUDGET_MS);
+
+        // Cursor in the same pixel space as the viewport size. 'sceneChanged'
+        // is true when any world bounds moved since the last update.
+        void update(World& world, const SceneBVH& bvh, const Camera& camera,
+            float mouseX, float mouseY, int viewportWidth, int viewportHeight, bool sceneChanged);
+
+        // Drop the hover (e.g. the cursor left the viewport)
+        void clear(World& world);
+
+        EntityID getHovered() const { return hit_.entity; }
+        const HitResult& getHit() const { return hit_; }
+
+        // Whether the current hover still waits for a full pick
+        bool isPending() const { return pending_; }
+
+        void setBudget(double budgetMs) { budgetMs_ = budgetMs; }
+        double getBudget() const { return budgetMs_; }
+
+        const Stats& getStats() const { return stats_; }
+
+    private:
+        void setHovered(World& world, const HitResult& hit);
+
+        HitResult hit_;
+
+        // Inputs of the last pick
+        glm::mat4 viewProjection_ = glm::mat4(1.0f);
+        float mouseX_ = 0.0f;
+        float mouseY_ = 0.0f;
+        int viewportWidth_ = 0;
+        int viewportHeight_ = 0;
+        bool hasInputs_ = false;
+
+        bool pending_ = false;
+        double budgetMs_;
+        double creditMs_ = 0.0;
+
+        Stats stats_;
+    };
+
+} // namespace libre
@@ -0,0 +1,76 @@
+#include "JobSystem.h"
+#include <iostream>
+#include <algorithm>
+
+namespace libre {
+
+    JobSystem::JobSystem() {
+        // Leave one hardware thread for the main thread and one for rendering
+        unsigned hw = std::thread::hardware_concurrency();
+        size_t workerCount = hw > 2 ? hw - 2 : 1;
+
+        workers_.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; ++i) {
+            workers_.emplace_back(&JobSystem::workerMain, this);
+        }
+
+        std::cout << "[JobSystem] Started " << workerCount << " worker threads" << std::endl;
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shutdown_ = true;
+        }
+        wake_.notify_all();
+
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    void JobSystem::workerMain() {
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this]() {
+                    return shutdown_ || !chunks_.empty() || !background_.empty();
+                    });
+
+                // Chunks first - someone is blocked waiting on them
+                auto& source = !chunks_.empty() ? chunks_ : background_;
+                if (source.empty()) return;  // Shutdown with nothing left
+
+                job = std::move(source.front());
+                source.pop_front();
+            }
+            job();
+        }
+    }
+
+    bool JobSystem::runOneChunk() {
+        Job job;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (chunks_.empty()) return false;
+            job = std::move(chunks_.front());
+            chunks_.pop_front();
+        }
+        job();
+        return true;
+    }
+
+    void JobSystem::waitFor(const std::atomic<size_t>& remaining) {
+        // Help drain the queue instead of sleeping - this is what keeps
+        // nested parallelFor calls from starving the pool
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (!runOneChunk()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+} // namespace libre
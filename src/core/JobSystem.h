@@ -0,0 +1,134 @@
+// src/core/JobSystem.h
+// Worker thread pool for data-parallel main-thread work
+//
+// The main thread owns the ECS. Systems that need to chew through large
+// component arrays (transforms, culling, mesh processing) split the work into
+// chunks and hand them to the pool. The calling thread always helps execute
+// queued chunks while it waits, so nested parallelFor calls cannot deadlock.
+// Background jobs live in a separate queue that waiting threads never pick
+// up, so a long BVH rebuild can't stall the main thread inside parallelFor.
+//
+// Usage:
+//   JobSystem::instance().parallelFor(count, 256, [&](size_t begin, size_t end) {
+//       for (size_t i = begin; i < end; ++i) { ... }
+//   });
+//
+//   auto done = JobSystem::instance().submit([] { ... });  // Background job
+//   done.wait();
+
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <type_traits>
+#include <algorithm>
+
+namespace libre {
+
+    class JobSystem {
+    public:
+        using Job = std::function<void()>;
+
+        // Singleton access
+        static JobSystem& instance() {
+            static JobSystem system;
+            return system;
+        }
+
+        // Non-copyable, non-movable
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        // Number of worker threads (excluding the calling thread)
+        size_t getWorkerCount() const { return workers_.size(); }
+
+        // ====================================================================
+        // DATA PARALLEL
+        // ====================================================================
+
+        // Split [0, count) into chunks of at least 'grain' items and run
+        // func(begin, end) on each chunk. Blocks until every chunk finished.
+        template<typename Func>
+        void parallelFor(size_t count, size_t grain, Func&& func) {
+            if (count == 0) return;
+            if (grain == 0) grain = 1;
+
+            size_t maxChunks = (workers_.size() + 1) * 4;
+            size_t chunkSize = std::max(grain, (count + maxChunks - 1) / maxChunks);
+            size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+            // Small workloads are cheaper inline than through the queue
+            if (chunkCount <= 1 || workers_.empty()) {
+                func(size_t(0), count);
+                return;
+            }
+
+            auto remaining = std::make_shared<std::atomic<size_t>>(chunkCount - 1);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (size_t c = 1; c < chunkCount; ++c) {
+                    size_t begin = c * chunkSize;
+                    size_t end = std::min(count, begin + chunkSize);
+                    chunks_.emplace_back([&func, begin, end, remaining]() {
+                        func(begin, end);
+                        remaining->fetch_sub(1, std::memory_order_acq_rel);
+                    });
+                }
+            }
+            wake_.notify_all();
+
+            // Calling thread takes the first chunk itself
+            func(size_t(0), std::min(count, chunkSize));
+
+            waitFor(*remaining);
+        }
+
+        // ====================================================================
+        // BACKGROUND JOBS
+        // ====================================================================
+
+        // Run a job on a worker thread. The future carries the result.
+        template<typename Func>
+        auto submit(Func&& func) -> std::future<std::invoke_result_t<std::decay_t<Func>>> {
+            using Result = std::invoke_result_t<std::decay_t<Func>>;
+
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+            std::future<Result> result = task->get_future();
+
+            if (workers_.empty()) {
+                (*task)();
+                return result;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                background_.emplace_back([task]() { (*task)(); });
+            }
+            wake_.notify_one();
+            return result;
+        }
+
+    private:
+        JobSystem();
+        ~JobSystem();
+
+        void workerMain();
+        bool runOneChunk();
+        void waitFor(const std::atomic<size_t>& remaining);
+
+        std::vector<std::thread> workers_;
+        std::deque<Job> chunks_;        // parallelFor chunks (latency sensitive)
+        std::deque<Job> background_;    // submit() jobs
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        bool shutdown_ = false;
+    };
+
+} // namespace libre
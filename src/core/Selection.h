@@ -3,6 +3,9 @@
 #include "../world/World.h"
 #include "../components/CoreComponents.h"
 #include "Camera.h"
+#include "../spatial/SceneBVH.h"
+#include "../spatial/MeshBVH.h"
+#include "../spatial/Frustum.h"
 #include <glm/glm.hpp>
 #include <limits>
 
@@ -19,11 +22,21 @@ namespace libre {
         EntityID entity = INVALID_ENTITY;
         float distance = std::numeric_limits<float>::max();
         glm::vec3 point = glm::vec3(0.0f);
-        glm::vec3 normal = glm::vec3(0.0f);
+        glm::vec3 normal = glm::vec3(0.0f);     // Box-only hits: -ray.direction
+
+        // Mesh hits (triangle == INVALID for box-only hits)
+        uint32_t triangle = MeshBVH::INVALID;
+        glm::vec2 barycentric = glm::vec2(0.0f);    // Weights of vertex 1 and 2
 
         bool hit() const { return entity != INVALID_ENTITY; }
     };
 
+    // How a pick treats a mesh whose triangle BVH is not built yet
+    enum class MeshPick : uint8_t {
+        Build,      // Build it now (explicit clicks: exact, may take seconds on huge meshes)
+        Background  // Start a JobSystem build; the box stands in until it is done (hover)
+    };
+
     // Selection utilities
     class SelectionSystem {
     public:
@@ -59,9 +72,7 @@ namespace libre {
 
             world.forEach<BoundsComponent>([&](EntityID id, BoundsComponent& bounds) {
                 // Skip if no transform or not visible
-                auto* meta = world.getMetadata(id);
-                if (meta && !meta->isVisible()) return;
-                if (meta && !meta->isSelectable()) return;
+                if (!world.isVisible(id) || !world.isSelectable(id)) return;
 
                 float tMin, tMax;
                 if (bounds.intersectsRay(ray.origin, ray.direction, tMin, tMax)) {
@@ -78,6 +89,86 @@ namespace libre {
             return closest;
         }
 
+        // Raycast through the scene BVH: closest visible, selectable surface.
+        // Entities with a mesh are tested against its triangles (MeshBVH,
+        // built on first pick, see MeshPick); entities without one, or whose
+        // tree is still building, hit by their box.
+        static HitResult raycast(const SceneBVH& bvh, World& world, const Ray& ray,
+            float maxDistance = std::numeric_limits<float>::max(), MeshPick meshPick = MeshPick::Build) {
+            HitResult result;
+            bvh.raycastNarrow(ray.origin, ray.direction, maxDistance,
+                [&](EntityID id, float boxDistance, BVHRay& r) {
+                    if (!world.isVisible(id) || !world.isSelectable(id)) return false;
+
+                    auto* mesh = world.getComponent<MeshComponent>(id);
+                    auto* transform = world.getComponent<TransformComponent>(id);
+                    std::shared_ptr<const MeshBVH> meshBVH;
+                    if (mesh && transform && mesh->getTriangleCount() > 0) meshBVH = getMeshBVH(*mesh, meshPick);
+                    if (!meshBVH) {
+                        if (boxDistance <= 0.0f) return false;
+                        r.tMax = boxDistance;
+                        result.entity = id;
+                        result.distance = boxDistance;
+                        result.point = ray.origin + ray.direction * boxDistance;
+                        result.normal = -ray.direction;
+                        result.triangle = MeshBVH::INVALID;
+                        return true;
+                    }
+                    return raycastMesh(*meshBVH, transform->worldMatrix, id, ray, r, result);
+                });
+            return result;
+        }
+
+        static std::shared_ptr<const MeshBVH> getMeshBVH(MeshComponent& mesh, MeshPick meshPick) {
+            return meshPick == MeshPick::Build ? MeshBVH::get(mesh) : MeshBVH::getAsync(mesh);
+        }
+
+        // Whether 'hit' stands in for a mesh whose triangle BVH is still building
+        static bool isProvisional(World& world, const HitResult& hit) {
+            if (!hit.hit() || hit.triangle != MeshBVH::INVALID) return false;
+            auto* mesh = world.getComponent<MeshComponent>(hit.entity);
+            return mesh && mesh->getTriangleCount() > 0 && world.hasComponent<TransformComponent>(hit.entity);
+        }
+
+        // Triangle test in object space. The direction is transformed without
+        // renormalizing, so distances stay in world units.
+        static bool raycastMesh(const MeshBVH& meshBVH, const glm::mat4& worldMatrix, EntityID id,
+            const Ray& ray, BVHRay& worldRay, HitResult& result) {
+            glm::mat4 toObject = glm::inverse(worldMatrix);
+            BVHRay local(glm::vec3(toObject * glm::vec4(ray.origin, 1.0f)),
+                glm::vec3(toObject * glm::vec4(ray.direction, 0.0f)), worldRay.tMax);
+
+            MeshBVH::Hit hit;
+            if (!meshBVH.raycast(local, hit)) return false;
+
+            worldRay.tMax = hit.distance;
+            result.entity = id;
+            result.distance = hit.distance;
+            result.point = ray.origin + ray.direction * hit.distance;
+            result.normal = glm::normalize(glm::transpose(glm::mat3(toObject)) * hit.normal);
+            result.triangle = hit.triangle;
+            result.barycentric = glm::vec2(hit.u, hit.v);
+            return true;
+        }
+
+        // One entity by the same rules as the BVH pick: mesh triangles, or
+        // the box for entities without a mesh (or a tree still building)
+        static bool raycastSurface(World& world, EntityID entity, const Ray& ray, HitResult& result,
+            float maxDistance = std::numeric_limits<float>::max(), MeshPick meshPick = MeshPick::Build) {
+            auto* mesh = world.getComponent<MeshComponent>(entity);
+            auto* transform = world.getComponent<TransformComponent>(entity);
+            std::shared_ptr<const MeshBVH> meshBVH;
+            if (mesh && transform && mesh->getTriangleCount() > 0) meshBVH = getMeshBVH(*mesh, meshPick);
+            if (!meshBVH) {
+                HitResult boxHit;
+                if (!raycastEntity(world, entity, ray, boxHit) || boxHit.distance > maxDistance) return false;
+                result = boxHit;
+                return true;
+            }
+            BVHRay r(ray.origin, ray.direction, maxDistance);
+            return raycastMesh(*meshBVH, transform->worldMatrix, entity, ray, r, result);
+        }
+
         // Raycast against specific entity
         static bool raycastEntity(World& world, EntityID entity, const Ray& ray, HitResult& result) {
             auto* bounds = world.getComponent<BoundsComponent>(entity);
@@ -99,57 +190,58 @@ namespace libre {
 
         // Frustum culling helper (for selection boxes, etc.)
         static bool isInFrustum(const Camera& camera, const BoundsComponent& bounds) {
-            // Simple sphere check against camera frustum
-            // TODO: Implement proper frustum planes check
-            glm::vec3 toCenter = bounds.worldCenter - camera.getPosition();
-            float dist = glm::length(toCenter);
-
-            // Very basic check - is it roughly in front of camera and not too far?
-            glm::vec3 forward = glm::normalize(camera.getTarget() - camera.getPosition());
-            float dotProduct = glm::dot(glm::normalize(toCenter), forward);
-
-            return dotProduct > -0.2f && dist < 1000.0f;
+            Frustum frustum = Frustum::fromMatrix(camera.getProjectionMatrix() * camera.getViewMatrix());
+            return frustum.intersectsSphere(bounds.worldCenter, bounds.worldRadius) &&
+                frustum.intersectsAABB(bounds.worldMin, bounds.worldMax);
         }
 
-        // Box selection (marquee selection)
+        // Box selection (marquee selection): every visible, selectable entity
+        // whose world bounds touch (or, with FrustumTest::Inside, lie
+        // entirely inside) the sub-frustum behind the screen rectangle.
+        // Without a scene BVH the whole bounds array is tested in SIMD batches.
         static std::vector<EntityID> boxSelect(World& world, const Camera& camera,
             float x1, float y1, float x2, float y2,
-            int viewportWidth, int viewportHeight) {
-            std::vector<EntityID> selected;
-
-            // Normalize coordinates
-            float minX = std::min(x1, x2);
-            float maxX = std::max(x1, x2);
-            float minY = std::min(y1, y2);
-            float maxY = std::max(y1, y2);
-
-            glm::mat4 viewProj = camera.getProjectionMatrix() * camera.getViewMatrix();
-
-            world.forEach<BoundsComponent>([&](EntityID id, BoundsComponent& bounds) {
-                auto* meta = world.getMetadata(id);
-                if (meta && !meta->isVisible()) return;
-                if (meta && !meta->isSelectable()) return;
+            int viewportWidth, int viewportHeight, FrustumTest test = FrustumTest::Touching) {
+            Frustum frustum = marqueeFrustum(camera, x1, y1, x2, y2, viewportWidth, viewportHeight);
 
-                // Project world center to screen
-                glm::vec4 clipPos = viewProj * glm::vec4(bounds.worldCenter, 1.0f);
+            FrustumCuller culler;
+            culler.cull(world, frustum, test);
 
-                if (clipPos.w > 0) {  // In front of camera
-                    glm::vec3 ndc = glm::vec3(clipPos) / clipPos.w;
+            std::vector<EntityID> candidates, selected;
+            culler.collectVisible(world, candidates);
+            for (EntityID id : candidates) {
+                if (isPickable(world, id)) selected.push_back(id);
+            }
+            return selected;
+        }
 
-                    // Convert to screen coordinates
-                    float screenX = (ndc.x + 1.0f) * 0.5f * viewportWidth;
-                    float screenY = (1.0f - ndc.y) * 0.5f * viewportHeight;
+        // Same, through the scene BVH: subtrees outside the rectangle are
+        // skipped and subtrees entirely inside are taken without box tests
+        static std::vector<EntityID> boxSelect(const SceneBVH& bvh, const World& world, const Camera& camera,
+            float x1, float y1, float x2, float y2,
+            int viewportWidth, int viewportHeight, FrustumTest test = FrustumTest::Touching) {
+            Frustum frustum = marqueeFrustum(camera, x1, y1, x2, y2, viewportWidth, viewportHeight);
 
-                    // Check if in selection box
-                    if (screenX >= minX && screenX <= maxX &&
-                        screenY >= minY && screenY <= maxY) {
-                        selected.push_back(id);
-                    }
-                }
+            std::vector<EntityID> selected;
+            bvh.queryFrustum(frustum, test, [&](EntityID id) {
+                if (isPickable(world, id)) selected.push_back(id);
                 });
-
             return selected;
         }
+
+        // Visible, not Hidden, and Selectable, from one flags read. Only for
+        // live ids (box selection takes them from bounds storage).
+        static bool isPickable(const World& world, EntityID id) {
+            uint32_t flags = static_cast<uint32_t>(world.getSlotFlags(id));
+            uint32_t required = static_cast<uint32_t>(EntityFlags::Visible | EntityFlags::Selectable);
+            return (flags & (required | static_cast<uint32_t>(EntityFlags::Hidden))) == required;
+        }
+
+        static Frustum marqueeFrustum(const Camera& camera, float x1, float y1, float x2, float y2,
+            int viewportWidth, int viewportHeight) {
+            return Frustum::fromScreenRect(camera.getProjectionMatrix() * camera.getViewMatrix(),
+                x1, y1, x2, y2, static_cast<float>(viewportWidth), static_cast<float>(viewportHeight));
+        }
     };
 
 } // namespace libre
\ No newline at end of file
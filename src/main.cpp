@@ -1,9 +1,17 @@
 ﻿#include "core/Application.h"
+#include "bench/Benchmarks.h"
 #include <iostream>
 #include <stdexcept>
 #include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv) {
+    // --bench [name]: run CPU microbenchmarks and exit (no window, no GPU)
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        libre::bench::runAll(argc > 2 ? argv[2] : "");
+        return EXIT_SUCCESS;
+    }
 
-int main() {
     std::cout << "\n==================================" << std::endl;
     std::cout << "LIBRE DCC TOOL" << std::endl;
     std::cout << "Starting..." << std::endl;
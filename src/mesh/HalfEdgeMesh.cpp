@@ -0,0 +1,730 @@
+#include "HalfEdgeMesh.h"
+#include "../components/CoreComponents.h"
+#include "../core/JobSystem.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace libre {
+
+    namespace {
+
+        uint32_t hashUint(uint32_t x) {
+            x ^= x >> 16;
+            x *= 0x7feb352dU;
+            x ^= x >> 15;
+            x *= 0x846ca68bU;
+            x ^= x >> 16;
+            return x;
+        }
+
+        uint32_t hashPosition(const glm::vec3& p) {
+            // +0.0f folds -0 onto 0, which compares equal
+            uint32_t bits[3];
+            float values[3] = { p.x + 0.0f, p.y + 0.0f, p.z + 0.0f };
+            std::memcpy(bits, values, sizeof(bits));
+            return hashUint(bits[0] ^ hashUint(bits[1] ^ hashUint(bits[2])));
+        }
+
+        size_t bucketCountFor(size_t count) {
+            size_t buckets = 1;
+            while (buckets < count) buckets <<= 1;
+            return buckets;
+        }
+
+        // Counting sort of [0, count) into 'bucketCount' buckets by
+        // bucketOf(i). Bucket b is order[offsets[b], offsets[b + 1]),
+        // ascending within the bucket.
+        template<typename BucketOf>
+        void bucketSort(size_t count, size_t bucketCount, BucketOf&& bucketOf,
+            std::vector<uint32_t>& order, std::vector<uint32_t>& offsets) {
+            std::vector<uint32_t> buckets(count);
+            JobSystem::instance().parallelFor(count, 16384, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) buckets[i] = bucketOf(i);
+                });
+
+            offsets.assign(bucketCount + 1, 0);
+            for (size_t i = 0; i < count; ++i) ++offsets[buckets[i] + 1];
+            for (size_t b = 0; b < bucketCount; ++b) offsets[b + 1] += offsets[b];
+
+            order.resize(count);
+            std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < count; ++i) order[cursor[buckets[i]]++] = static_cast<uint32_t>(i);
+        }
+
+    } // namespace
+
+    // ========================================================================
+    // CONVERSION
+    // ========================================================================
+
+    void HalfEdgeMesh::fromMeshComponent(const MeshComponent& mesh) {
+        clear();
+        auto& jobs = JobSystem::instance();
+
+        const MeshVertex* soup = mesh.vertices.data();
+        const uint32_t* indices = mesh.indices.data();
+        size_t soupCount = mesh.vertices.size();
+        size_t triangleCount = mesh.indices.size() / 3;
+
+        std::vector<uint32_t> order, offsets;
+
+        // Weld: each soup vertex maps to the first one at its position
+        size_t weldBuckets = bucketCountFor(soupCount);
+        bucketSort(soupCount, weldBuckets, [&](size_t i) {
+            return hashPosition(soup[i].position) & static_cast<uint32_t>(weldBuckets - 1);
+            }, order, offsets);
+
+        std::vector<uint32_t> first(soupCount);
+        jobs.parallelFor(weldBuckets, 1024, [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; ++b) {
+                for (uint32_t k = offsets[b]; k < offsets[b + 1]; ++k) {
+                    uint32_t i = order[k];
+                    first[i] = i;
+                    for (uint32_t j = offsets[b]; j < k; ++j) {
+                        if (soup[order[j]].position == soup[i].position) {
+                            first[i] = first[order[j]];
+                            break;
+                        }
+                    }
+                }
+            }
+            });
+
+        // Lower soup indices come first in a bucket, so first[i] <= i
+        std::vector<uint32_t> welded(soupCount);
+        uint32_t vertexCount = 0;
+        for (size_t i = 0; i < soupCount; ++i) {
+            welded[i] = first[i] == i ? vertexCount++ : welded[first[i]];
+        }
+
+        positions_.resize(vertexCount);
+        vertexHalfEdge_.assign(vertexCount, INVALID);
+        vertexDeleted_.assign(vertexCount, 0);
+        jobs.parallelFor(soupCount, 16384, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (first[i] == i) positions_[welded[i]] = soup[i].position;
+            }
+            });
+
+        attributes_.resize(soupCount);
+        jobs.parallelFor(soupCount, 16384, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                attributes_[i].normal = soup[i].normal;
+                attributes_[i].color = soup[i].color;
+                attributes_[i].uv = soup[i].uv;
+            }
+            });
+
+        // Faces: triangles with three distinct welded vertices
+        std::vector<uint32_t> faceOf(triangleCount, INVALID);
+        uint32_t faceCount = 0;
+        for (size_t t = 0; t < triangleCount; ++t) {
+            uint32_t i0 = indices[t * 3], i1 = indices[t * 3 + 1], i2 = indices[t * 3 + 2];
+            if (i0 >= soupCount || i1 >= soupCount || i2 >= soupCount) continue;
+            uint32_t a = welded[i0], b = welded[i1], c = welded[i2];
+            if (a == b || b == c || c == a) continue;
+            faceOf[t] = faceCount++;
+        }
+
+        // Edges: corner c of triangle t runs from corner c to corner c + 1.
+        // Corners are sorted by their lower vertex, so those sharing an
+        // undirected edge meet in one run, where opposite directions pair
+        // up. The run stores the other end with the direction in bit 0.
+        size_t cornerCount = triangleCount * 3;
+        std::vector<uint32_t> cornerLow(cornerCount), cornerHigh(cornerCount);
+        jobs.parallelFor(triangleCount, 4096, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t) {
+                for (size_t k = 0; k < 3; ++k) {
+                    size_t c = t * 3 + k;
+                    if (faceOf[t] == INVALID) {
+                        cornerLow[c] = vertexCount;
+                        continue;
+                    }
+                    uint32_t a = welded[indices[c]], b = welded[indices[t * 3 + (k + 1) % 3]];
+                    cornerLow[c] = std::min(a, b);
+                    cornerHigh[c] = (std::max(a, b) << 1) | (a > b ? 1u : 0u);
+                }
+            }
+            });
+
+        std::vector<uint32_t> runOffset(static_cast<size_t>(vertexCount) + 2, 0);
+        for (size_t c = 0; c < cornerCount; ++c) ++runOffset[cornerLow[c] + 1];
+        for (uint32_t v = 0; v <= vertexCount; ++v) runOffset[v + 1] += runOffset[v];
+
+        std::vector<uint32_t> runCorner(runOffset[vertexCount]), runOther(runOffset[vertexCount]);
+        {
+            std::vector<uint32_t> cursor(runOffset.begin(), runOffset.end() - 2);
+            for (size_t c = 0; c < cornerCount; ++c) {
+                uint32_t v = cornerLow[c];
+                if (v == vertexCount) continue;
+                runCorner[cursor[v]] = static_cast<uint32_t>(c);
+                runOther[cursor[v]++] = cornerHigh[c];
+            }
+        }
+        cornerLow = std::vector<uint32_t>();
+        cornerHigh = std::vector<uint32_t>();
+
+        std::vector<uint32_t> partner(cornerCount, INVALID);
+        jobs.parallelFor(vertexCount, 4096, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v) {
+                for (uint32_t k = runOffset[v]; k < runOffset[v + 1]; ++k) {
+                    if (runOther[k] == INVALID) continue;
+                    for (uint32_t j = k + 1; j < runOffset[v + 1]; ++j) {
+                        if (runOther[j] == (runOther[k] ^ 1u)) {
+                            partner[runCorner[k]] = runCorner[j];
+                            partner[runCorner[j]] = runCorner[k];
+                            runOther[j] = INVALID;
+                            break;
+                        }
+                    }
+                }
+            }
+            });
+        runCorner = std::vector<uint32_t>();
+        runOther = std::vector<uint32_t>();
+
+        // Number the edges; unpaired corners get a boundary twin
+        std::vector<uint32_t> halfOf(cornerCount, INVALID);
+        uint32_t edgeCount = 0;
+        for (size_t c = 0; c < cornerCount; ++c) {
+            if (faceOf[c / 3] == INVALID || halfOf[c] != INVALID) continue;
+            halfOf[c] = edgeCount * 2;
+            if (partner[c] != INVALID) halfOf[partner[c]] = edgeCount * 2 + 1;
+            ++edgeCount;
+        }
+
+        size_t halfEdgeCount = static_cast<size_t>(edgeCount) * 2;
+        halfEdgeVertex_.resize(halfEdgeCount);
+        halfEdgeFace_.assign(halfEdgeCount, INVALID);
+        halfEdgeNext_.assign(halfEdgeCount, INVALID);
+        halfEdgePrev_.assign(halfEdgeCount, INVALID);
+        halfEdgeAttribute_.assign(halfEdgeCount, INVALID);
+        edgeDeleted_.assign(edgeCount, 0);
+        faceHalfEdge_.resize(faceCount);
+        faceDeleted_.assign(faceCount, 0);
+
+        jobs.parallelFor(triangleCount, 4096, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t) {
+                uint32_t f = faceOf[t];
+                if (f == INVALID) continue;
+                for (size_t k = 0; k < 3; ++k) {
+                    size_t c = t * 3 + k;
+                    size_t cNext = t * 3 + (k + 1) % 3;
+                    uint32_t h = halfOf[c];
+                    halfEdgeVertex_[h] = welded[indices[cNext]];
+                    halfEdgeFace_[h] = f;
+                    halfEdgeNext_[h] = halfOf[cNext];
+                    halfEdgePrev_[h] = halfOf[t * 3 + (k + 2) % 3];
+                    halfEdgeAttribute_[h] = indices[cNext];
+                    if (partner[c] == INVALID) halfEdgeVertex_[h ^ 1u] = welded[indices[c]];
+                }
+                faceHalfEdge_[f] = halfOf[t * 3];
+            }
+            });
+
+        // Boundary loops: at each vertex, the k-th boundary half-edge
+        // arriving continues with the k-th one leaving (one of each on a
+        // manifold boundary; any pairing keeps next a permutation)
+        std::vector<uint32_t> inOffset(vertexCount + 1, 0), outOffset(vertexCount + 1, 0);
+        for (size_t h = 0; h < halfEdgeCount; ++h) {
+            if (halfEdgeFace_[h] != INVALID) continue;
+            ++inOffset[halfEdgeVertex_[h] + 1];
+            ++outOffset[halfEdgeVertex_[h ^ 1u] + 1];
+        }
+        for (uint32_t v = 0; v < vertexCount; ++v) {
+            inOffset[v + 1] += inOffset[v];
+            outOffset[v + 1] += outOffset[v];
+        }
+        std::vector<uint32_t> inList(inOffset[vertexCount]), outList(outOffset[vertexCount]);
+        {
+            std::vector<uint32_t> inCursor(inOffset.begin(), inOffset.end() - 1);
+            std::vector<uint32_t> outCursor(outOffset.begin(), outOffset.end() - 1);
+            for (uint32_t h = 0; h < halfEdgeCount; ++h) {
+                if (halfEdgeFace_[h] != INVALID) continue;
+                inList[inCursor[halfEdgeVertex_[h]]++] = h;
+                outList[outCursor[halfEdgeVertex_[h ^ 1u]]++] = h;
+            }
+        }
+        for (uint32_t v = 0; v < vertexCount; ++v) {
+            for (uint32_t k = 0; k < inOffset[v + 1] - inOffset[v]; ++k) {
+                setNext(inList[inOffset[v] + k], outList[outOffset[v] + k]);
+            }
+        }
+
+        // Fans: the rotation h -> next(twin(h)) splits the half-edges
+        // leaving a vertex into cycles. Where fans only touch (a bowtie,
+        // two cones tip to tip) there are several, and a one-ring walk
+        // would see one of them; every further cycle gets its own copy of
+        // the vertex. Attributes used in more than one fan are copied too,
+        // as each belongs to one vertex.
+        size_t attributeCount = attributes_.size();
+        std::vector<uint32_t> attributeOwner(attributeCount, INVALID);
+        std::vector<uint32_t> copyOf(attributeCount, INVALID), copyOwner(attributeCount, INVALID);
+        std::vector<uint8_t> claimed(halfEdgeCount, 0);
+        for (uint32_t h = 0; h < halfEdgeCount; ++h) {
+            if (claimed[h]) continue;
+
+            uint32_t v = halfEdgeVertex_[h ^ 1u];
+            if (vertexHalfEdge_[v] != INVALID) {
+                v = static_cast<uint32_t>(positions_.size());
+                positions_.push_back(positions_[halfEdgeVertex_[h ^ 1u]]);
+                vertexHalfEdge_.push_back(INVALID);
+                vertexDeleted_.push_back(0);
+            }
+
+            // Claim the cycle; a boundary half-edge in it leads the vertex
+            uint32_t outgoing = h;
+            uint32_t k = h;
+            do {
+                claimed[k] = 1;
+                halfEdgeVertex_[k ^ 1u] = v;
+                if (halfEdgeFace_[k] == INVALID && halfEdgeFace_[outgoing] != INVALID) outgoing = k;
+
+                uint32_t corner = k ^ 1u;
+                uint32_t a = halfEdgeFace_[corner] != INVALID ? halfEdgeAttribute_[corner] : INVALID;
+                if (a != INVALID) {
+                    if (attributeOwner[a] == INVALID) {
+                        attributeOwner[a] = v;
+                    }
+                    else if (attributeOwner[a] != v) {
+                        if (copyOwner[a] != v) {
+                            copyOwner[a] = v;
+                            copyOf[a] = static_cast<uint32_t>(attributes_.size());
+                            attributes_.push_back(attributes_[a]);
+                        }
+                        halfEdgeAttribute_[corner] = copyOf[a];
+                    }
+                }
+                k = halfEdgeNext_[k ^ 1u];
+            } while (k != h);
+            vertexHalfEdge_[v] = outgoing;
+        }
+    }
+
+    void HalfEdgeMesh::toMeshComponent(MeshComponent& mesh) const {
+        auto& jobs = JobSystem::instance();
+        uint32_t vertexCapacity = getVertexCapacity();
+        uint32_t faceCapacity = getFaceCapacity();
+
+        // Output vertices per mesh vertex: one per attribute its corners
+        // use, plus one for corners without an attribute. Attributes belong
+        // to one vertex, so each vertex numbers its own without races.
+        std::vector<uint32_t> attributeSlot(attributes_.size(), INVALID);
+        std::vector<uint32_t> defaultSlot(vertexCapacity, INVALID);
+        std::vector<uint32_t> vertexBase(static_cast<size_t>(vertexCapacity) + 1, 0);
+
+        jobs.parallelFor(vertexCapacity, 4096, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v) {
+                if (vertexDeleted_[v]) continue;
+                uint32_t count = 0;
+                bool needsDefault = false;
+                forEachOutgoing(static_cast<uint32_t>(v), [&](uint32_t h) {
+                    uint32_t corner = h ^ 1u;
+                    if (halfEdgeFace_[corner] == INVALID) return;
+                    uint32_t a = halfEdgeAttribute_[corner];
+                    if (a == INVALID) needsDefault = true;
+                    else if (attributeSlot[a] == INVALID) attributeSlot[a] = count++;
+                    });
+                if (needsDefault) defaultSlot[v] = count++;
+                vertexBase[v + 1] = count;
+            }
+            });
+        for (uint32_t v = 0; v < vertexCapacity; ++v) vertexBase[v + 1] += vertexBase[v];
+
+        // INVALID for a corner its vertex's one-ring never reached (a
+        // broken rotation); triangles using one are dropped below
+        auto slotOf = [&](uint32_t corner) {
+            uint32_t v = halfEdgeVertex_[corner];
+            uint32_t a = halfEdgeAttribute_[corner];
+            uint32_t slot = a == INVALID ? defaultSlot[v] : attributeSlot[a];
+            return slot == INVALID ? INVALID : vertexBase[v] + slot;
+        };
+
+        mesh.vertices.resize(vertexBase[vertexCapacity]);
+        jobs.parallelFor(vertexCapacity, 4096, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v) {
+                if (vertexDeleted_[v] || vertexBase[v + 1] == vertexBase[v]) continue;
+                glm::vec3 position = positions_[v];
+                forEachOutgoing(static_cast<uint32_t>(v), [&](uint32_t h) {
+                    uint32_t corner = h ^ 1u;
+                    uint32_t a = halfEdgeAttribute_[corner];
+                    if (halfEdgeFace_[corner] == INVALID || a == INVALID) return;
+                    MeshVertex& out = mesh.vertices[slotOf(corner)];
+                    out.position = position;
+                    out.normal = attributes_[a].normal;
+                    out.color = attributes_[a].color;
+                    out.uv = attributes_[a].uv;
+                    });
+                if (defaultSlot[v] != INVALID) {
+                    glm::vec3 normal(0.0f);
+                    forEachVertexFace(static_cast<uint32_t>(v), [&](uint32_t f) { normal += getFaceNormal(f); });
+                    float length = glm::length(normal);
+
+                    MeshVertex& out = mesh.vertices[vertexBase[v] + defaultSlot[v]];
+                    out.position = position;
+                    out.normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+                    out.color = Attribute().color;
+                    out.uv = glm::vec2(0.0f);
+                }
+            }
+            });
+
+        // Triangles: a fan over each face
+        std::vector<uint32_t> triangleBase(static_cast<size_t>(faceCapacity) + 1, 0);
+        jobs.parallelFor(faceCapacity, 4096, [&](size_t begin, size_t end) {
+            for (size_t f = begin; f < end; ++f) {
+                triangleBase[f + 1] = faceDeleted_[f] ? 0 : getFaceSize(static_cast<uint32_t>(f)) - 2;
+            }
+            });
+        for (uint32_t f = 0; f < faceCapacity; ++f) triangleBase[f + 1] += triangleBase[f];
+
+        mesh.indices.resize(static_cast<size_t>(triangleBase[faceCapacity]) * 3);
+        jobs.parallelFor(faceCapacity, 4096, [&](size_t begin, size_t end) {
+            for (size_t f = begin; f < end; ++f) {
+                if (faceDeleted_[f]) continue;
+                uint32_t* out = mesh.indices.data() + static_cast<size_t>(triangleBase[f]) * 3;
+                uint32_t h0 = faceHalfEdge_[f];
+                uint32_t anchor = slotOf(h0);
+                for (uint32_t h = halfEdgeNext_[h0]; halfEdgeNext_[h] != h0; h = halfEdgeNext_[h]) {
+                    *out++ = anchor;
+                    *out++ = slotOf(h);
+                    *out++ = slotOf(halfEdgeNext_[h]);
+                }
+            }
+            });
+
+        // Never hand the GPU (or MeshBVH) an index past the vertices
+        size_t kept = 0;
+        for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+            if (mesh.indices[i] == INVALID || mesh.indices[i + 1] == INVALID || mesh.indices[i + 2] == INVALID) continue;
+            std::copy(mesh.indices.begin() + i, mesh.indices.begin() + i + 3, mesh.indices.begin() + kept);
+            kept += 3;
+        }
+        if (kept != mesh.indices.size()) {
+            std::cout << "[HalfEdgeMesh] Dropped " << (mesh.indices.size() - kept) / 3
+                << " triangles with corners outside their vertex's fan" << std::endl;
+            mesh.indices.resize(kept);
+        }
+
+        mesh.calculateBounds();
+        mesh.markGeometryDirty();
+    }
+
+    void HalfEdgeMesh::clear() {
+        positions_.clear();
+        vertexHalfEdge_.clear();
+        vertexDeleted_.clear();
+        halfEdgeVertex_.clear();
+        halfEdgeFace_.clear();
+        halfEdgeNext_.clear();
+        halfEdgePrev_.clear();
+        halfEdgeAttribute_.clear();
+        edgeDeleted_.clear();
+        faceHalfEdge_.clear();
+        faceDeleted_.clear();
+        attributes_.clear();
+        freeVertices_.clear();
+        freeEdges_.clear();
+        freeFaces_.clear();
+    }
+
+    // ========================================================================
+    // NAVIGATION
+    // ========================================================================
+
+    uint32_t HalfEdgeMesh::getValence(uint32_t v) const {
+        uint32_t valence = 0;
+        forEachOutgoing(v, [&](uint32_t) { ++valence; });
+        return valence;
+    }
+
+    uint32_t HalfEdgeMesh::getFaceSize(uint32_t f) const {
+        uint32_t size = 0;
+        forEachFaceHalfEdge(f, [&](uint32_t) { ++size; });
+        return size;
+    }
+
+    uint32_t HalfEdgeMesh::findHalfEdge(uint32_t from, uint32_t to) const {
+        uint32_t start = vertexHalfEdge_[from];
+        if (start == INVALID) return INVALID;
+        uint32_t h = start;
+        do {
+            if (halfEdgeVertex_[h] == to) return h;
+            h = halfEdgeNext_[h ^ 1u];
+        } while (h != start);
+        return INVALID;
+    }
+
+    glm::vec3 HalfEdgeMesh::getFaceNormal(uint32_t f) const {
+        glm::vec3 normal(0.0f);
+        forEachFaceHalfEdge(f, [&](uint32_t h) {
+            const glm::vec3& a = positions_[halfEdgeVertex_[h ^ 1u]];
+            const glm::vec3& b = positions_[halfEdgeVertex_[h]];
+            normal += glm::vec3((a.y - b.y) * (a.z + b.z), (a.z - b.z) * (a.x + b.x), (a.x - b.x) * (a.y + b.y));
+            });
+        return normal;
+    }
+
+    // ========================================================================
+    // EDITING
+    // ========================================================================
+
+    uint32_t HalfEdgeMesh::addVertex(const glm::vec3& position) {
+        uint32_t v;
+        if (!freeVertices_.empty()) {
+            v = freeVertices_.back();
+            freeVertices_.pop_back();
+            positions_[v] = position;
+            vertexHalfEdge_[v] = INVALID;
+            vertexDeleted_[v] = 0;
+        }
+        else {
+            v = getVertexCapacity();
+            positions_.push_back(position);
+            vertexHalfEdge_.push_back(INVALID);
+            vertexDeleted_.push_back(0);
+        }
+        return v;
+    }
+
+    uint32_t HalfEdgeMesh::newEdge(uint32_t from, uint32_t to) {
+        uint32_t e;
+        if (!freeEdges_.empty()) {
+            e = freeEdges_.back();
+            freeEdges_.pop_back();
+            edgeDeleted_[e] = 0;
+        }
+        else {
+            e = getEdgeCapacity();
+            for (int side = 0; side < 2; ++side) {
+                halfEdgeVertex_.push_back(INVALID);
+                halfEdgeFace_.push_back(INVALID);
+                halfEdgeNext_.push_back(INVALID);
+                halfEdgePrev_.push_back(INVALID);
+                halfEdgeAttribute_.push_back(INVALID);
+            }
+            edgeDeleted_.push_back(0);
+        }
+
+        uint32_t h = e * 2;
+        for (uint32_t side : { h, h + 1 }) {
+            halfEdgeFace_[side] = INVALID;
+            halfEdgeNext_[side] = INVALID;
+            halfEdgePrev_[side] = INVALID;
+            halfEdgeAttribute_[side] = INVALID;
+        }
+        halfEdgeVertex_[h] = to;
+        halfEdgeVertex_[h + 1] = from;
+        return h;
+    }
+
+    void HalfEdgeMesh::adjustOutgoing(uint32_t v) {
+        uint32_t start = vertexHalfEdge_[v];
+        if (start == INVALID) return;
+        uint32_t h = start;
+        do {
+            if (halfEdgeFace_[h] == INVALID) {
+                vertexHalfEdge_[v] = h;
+                return;
+            }
+            h = halfEdgeNext_[h ^ 1u];
+        } while (h != start);
+    }
+
+    uint32_t HalfEdgeMesh::addFace(const uint32_t* vertices, size_t count) {
+        if (count < 3) return INVALID;
+
+        std::vector<uint32_t> halfEdges(count);
+        std::vector<uint8_t> isNew(count), needsAdjust(count, 0);
+
+        // Every vertex must be free or on a boundary, every existing edge
+        // must be open on this side
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t v = vertices[i];
+            if (v >= getVertexCapacity() || vertexDeleted_[v] || !isBoundaryVertex(v)) return INVALID;
+            uint32_t w = vertices[(i + 1) % count];
+            if (w >= getVertexCapacity() || w == v) return INVALID;
+
+            halfEdges[i] = findHalfEdge(v, w);
+            isNew[i] = halfEdges[i] == INVALID;
+            if (!isNew[i] && !isBoundary(halfEdges[i])) return INVALID;
+        }
+
+        // Two existing edges meeting at a vertex must be consecutive in its
+        // boundary loop: move whatever lies between them elsewhere
+        for (size_t i = 0; i < count; ++i) {
+            size_t ii = (i + 1) % count;
+            if (isNew[i] || isNew[ii]) continue;
+
+            uint32_t innerPrev = halfEdges[i], innerNext = halfEdges[ii];
+            if (halfEdgeNext_[innerPrev] == innerNext) continue;
+
+            // Another gap in the boundary around the vertex
+            uint32_t boundaryPrev = twin(innerNext);
+            do {
+                boundaryPrev = twin(halfEdgeNext_[boundaryPrev]);
+            } while (!isBoundary(boundaryPrev) || boundaryPrev == innerPrev);
+            if (boundaryPrev == twin(innerNext)) return INVALID;
+
+            uint32_t boundaryNext = halfEdgeNext_[boundaryPrev];
+            uint32_t patchStart = halfEdgeNext_[innerPrev];
+            uint32_t patchEnd = halfEdgePrev_[innerNext];
+            setNext(boundaryPrev, patchStart);
+            setNext(patchEnd, boundaryNext);
+            setNext(innerPrev, innerNext);
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            if (isNew[i]) halfEdges[i] = newEdge(vertices[i], vertices[(i + 1) % count]);
+        }
+
+        uint32_t f;
+        if (!freeFaces_.empty()) {
+            f = freeFaces_.back();
+            freeFaces_.pop_back();
+            faceDeleted_[f] = 0;
+        }
+        else {
+            f = getFaceCapacity();
+            faceHalfEdge_.push_back(INVALID);
+            faceDeleted_.push_back(0);
+        }
+
+        // Link the face, splicing new edges into the boundary loops of the
+        // vertices they touch. Links are collected first: the splice reads
+        // prev/next of the loops as they were.
+        std::vector<std::pair<uint32_t, uint32_t>> links;
+        links.reserve(count * 3);
+        for (size_t i = 0; i < count; ++i) {
+            size_t ii = (i + 1) % count;
+            uint32_t v = vertices[ii];
+            uint32_t innerPrev = halfEdges[i], innerNext = halfEdges[ii];
+
+            if (isNew[i] || isNew[ii]) {
+                uint32_t outerPrev = twin(innerNext), outerNext = twin(innerPrev);
+                if (isNew[i] && !isNew[ii]) {
+                    links.emplace_back(halfEdgePrev_[innerNext], outerNext);
+                    vertexHalfEdge_[v] = outerNext;
+                }
+                else if (!isNew[i] && isNew[ii]) {
+                    uint32_t boundaryNext = halfEdgeNext_[innerPrev];
+                    links.emplace_back(outerPrev, boundaryNext);
+                    vertexHalfEdge_[v] = boundaryNext;
+                }
+                else if (vertexHalfEdge_[v] == INVALID) {
+                    vertexHalfEdge_[v] = outerNext;
+                    links.emplace_back(outerPrev, outerNext);
+                }
+                else {
+                    uint32_t boundaryNext = vertexHalfEdge_[v];
+                    uint32_t boundaryPrev = halfEdgePrev_[boundaryNext];
+                    links.emplace_back(boundaryPrev, outerNext);
+                    links.emplace_back(outerPrev, boundaryNext);
+                }
+                links.emplace_back(innerPrev, innerNext);
+            }
+            else {
+                needsAdjust[ii] = vertexHalfEdge_[v] == innerNext;
+            }
+            halfEdgeFace_[halfEdges[i]] = f;
+        }
+        for (const auto& link : links) setNext(link.first, link.second);
+
+        faceHalfEdge_[f] = halfEdges[count - 1];
+        for (size_t i = 0; i < count; ++i) {
+            if (needsAdjust[i]) adjustOutgoing(vertices[i]);
+        }
+        return f;
+    }
+
+    void HalfEdgeMesh::deleteFace(uint32_t f, bool deleteIsolatedVertices) {
+        if (f >= getFaceCapacity() || faceDeleted_[f]) return;
+
+        std::vector<uint32_t> deadEdges, faceVertices;
+        forEachFaceHalfEdge(f, [&](uint32_t h) {
+            halfEdgeFace_[h] = INVALID;
+            halfEdgeAttribute_[h] = INVALID;
+            if (isBoundary(twin(h))) deadEdges.push_back(edge(h));
+            faceVertices.push_back(halfEdgeVertex_[h]);
+            });
+
+        for (uint32_t e : deadEdges) {
+            uint32_t h0 = e * 2, h1 = h0 + 1;
+            uint32_t v0 = halfEdgeVertex_[h0], v1 = halfEdgeVertex_[h1];
+            uint32_t next0 = halfEdgeNext_[h0], prev0 = halfEdgePrev_[h0];
+            uint32_t next1 = halfEdgeNext_[h1], prev1 = halfEdgePrev_[h1];
+
+            setNext(prev0, next1);
+            setNext(prev1, next0);
+
+            // h1 leaves v0 and h0 leaves v1
+            if (vertexHalfEdge_[v0] == h1) vertexHalfEdge_[v0] = next0 == h1 ? INVALID : next0;
+            if (vertexHalfEdge_[v1] == h0) vertexHalfEdge_[v1] = next1 == h0 ? INVALID : next1;
+
+            edgeDeleted_[e] = 1;
+            freeEdges_.push_back(e);
+        }
+
+        faceDeleted_[f] = 1;
+        faceHalfEdge_[f] = INVALID;
+        freeFaces_.push_back(f);
+
+        for (uint32_t v : faceVertices) {
+            if (vertexHalfEdge_[v] == INVALID) {
+                if (deleteIsolatedVertices && !vertexDeleted_[v]) {
+                    vertexDeleted_[v] = 1;
+                    freeVertices_.push_back(v);
+                }
+            }
+            else {
+                adjustOutgoing(v);
+            }
+        }
+    }
+
+    void HalfEdgeMesh::deleteVertex(uint32_t v) {
+        if (v >= getVertexCapacity() || vertexDeleted_[v]) return;
+
+        std::vector<uint32_t> faces;
+        forEachVertexFace(v, [&](uint32_t f) { faces.push_back(f); });
+        for (uint32_t f : faces) deleteFace(f, true);
+
+        // Left without faces (or isolated from the start)
+        if (!vertexDeleted_[v]) {
+            vertexDeleted_[v] = 1;
+            vertexHalfEdge_[v] = INVALID;
+            freeVertices_.push_back(v);
+        }
+    }
+
+    // ========================================================================
+    // SELECTION
+    // ========================================================================
+
+    void HalfEdgeMesh::selectEdgeLoop(uint32_t e, std::vector<uint32_t>& out) const {
+        if (e >= getEdgeCapacity() || edgeDeleted_[e]) return;
+        out.push_back(e);
+
+        // Each step is a fixed rotation at one vertex, a bijection on
+        // half-edges, so a walk that never stops comes back to 'e'
+        for (uint32_t side = 0; side < 2; ++side) {
+            uint32_t h = e * 2 + side;
+            for (;;) {
+                uint32_t v = halfEdgeVertex_[h];
+                if (isBoundaryVertex(v)) break;
+                uint32_t valence = getValence(v);
+                if (valence < 4 || valence % 2 != 0) break;
+
+                uint32_t across = twin(h);
+                for (uint32_t k = 0; k < valence / 2; ++k) across = halfEdgeNext_[across ^ 1u];
+                if (edge(across) == e) return;
+
+                out.push_back(edge(across));
+                h = across;
+            }
+        }
+    }
+
+} // namespace libre
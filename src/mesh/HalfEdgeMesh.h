@@ -0,0 +1,222 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace libre {
+
+    struct MeshComponent;
+
+    // ============================================================================
+    // HALF-EDGE MESH - Editable polygon mesh with full adjacency
+    // ============================================================================
+    // Topology for edit-mode operations, kept as SoA arrays addressed by
+    // 32-bit indices (INVALID for none):
+    // - Vertex: position, one outgoing half-edge (a boundary one whenever the
+    //   vertex is on a boundary, so one-ring walks can start there)
+    // - Half-edge: target vertex, face (INVALID on a boundary), next, prev
+    // - Edge: implicit. Half-edges 2e and 2e + 1 are edge e and each other's
+    //   twin, so twin(h) = h ^ 1 and edge(h) = h / 2.
+    // - Face: one of its half-edges; faces are polygons of any size.
+    //
+    // Corner attributes (normal, color, uv) come from MeshComponent: every
+    // half-edge of a face points to the attribute of the corner at its
+    // target. An attribute belongs to exactly one vertex. Corners added by
+    // editing have none and get the vertex normal on export.
+    //
+    // Deleted elements are flagged and pushed on per-kind free lists; the
+    // next addVertex/addFace reuses them, so indices held by an editing
+    // session stay valid until their element is deleted.
+    //
+    // fromMeshComponent welds vertices by exact position and pairs edges
+    // over the JobSystem; toMeshComponent fan-triangulates in parallel.
+    // Edges shared by more than two faces (or by two faces with opposite
+    // winding) are split, and so are vertices where fans only touch (one
+    // vertex per fan), so the result is always a valid half-edge mesh.
+
+    class HalfEdgeMesh {
+    public:
+        static constexpr uint32_t INVALID = 0xFFFFFFFF;
+
+        struct Attribute {
+            glm::vec3 normal = glm::vec3(0.0f);
+            glm::vec3 color = glm::vec3(0.8f);
+            glm::vec2 uv = glm::vec2(0.0f);
+        };
+
+        // ====================================================================
+        // Conversion
+        // ====================================================================
+
+        // Replace the contents with the triangles of 'mesh' (degenerate and
+        // out-of-range triangles are skipped)
+        void fromMeshComponent(const MeshComponent& mesh);
+
+        // Triangulated copy of the live faces; resets the mesh's pick BVH
+        // and marks it gpuDirty
+        void toMeshComponent(MeshComponent& mesh) const;
+
+        void clear();
+
+        // ====================================================================
+        // Sizes (capacities include deleted elements)
+        // ====================================================================
+
+        size_t getVertexCount() const { return positions_.size() - freeVertices_.size(); }
+        size_t getEdgeCount() const { return halfEdgeVertex_.size() / 2 - freeEdges_.size(); }
+        size_t getFaceCount() const { return faceHalfEdge_.size() - freeFaces_.size(); }
+
+        uint32_t getVertexCapacity() const { return static_cast<uint32_t>(positions_.size()); }
+        uint32_t getHalfEdgeCapacity() const { return static_cast<uint32_t>(halfEdgeVertex_.size()); }
+        uint32_t getEdgeCapacity() const { return getHalfEdgeCapacity() / 2; }
+        uint32_t getFaceCapacity() const { return static_cast<uint32_t>(faceHalfEdge_.size()); }
+
+        bool isVertexDeleted(uint32_t v) const { return vertexDeleted_[v] != 0; }
+        bool isEdgeDeleted(uint32_t e) const { return edgeDeleted_[e] != 0; }
+        bool isFaceDeleted(uint32_t f) const { return faceDeleted_[f] != 0; }
+
+        // ====================================================================
+        // Navigation
+        // ====================================================================
+
+        static uint32_t twin(uint32_t h) { return h ^ 1u; }
+        static uint32_t edge(uint32_t h) { return h >> 1; }
+        static uint32_t edgeHalfEdge(uint32_t e, uint32_t side = 0) { return e * 2 + side; }
+
+        uint32_t next(uint32_t h) const { return halfEdgeNext_[h]; }
+        uint32_t prev(uint32_t h) const { return halfEdgePrev_[h]; }
+        uint32_t target(uint32_t h) const { return halfEdgeVertex_[h]; }
+        uint32_t origin(uint32_t h) const { return halfEdgeVertex_[h ^ 1u]; }
+        uint32_t face(uint32_t h) const { return halfEdgeFace_[h]; }
+        uint32_t attribute(uint32_t h) const { return halfEdgeAttribute_[h]; }
+
+        uint32_t vertexHalfEdge(uint32_t v) const { return vertexHalfEdge_[v]; }
+        uint32_t faceHalfEdge(uint32_t f) const { return faceHalfEdge_[f]; }
+
+        bool isBoundary(uint32_t h) const { return halfEdgeFace_[h] == INVALID; }
+        bool isBoundaryEdge(uint32_t e) const { return isBoundary(e * 2) || isBoundary(e * 2 + 1); }
+        bool isBoundaryVertex(uint32_t v) const {
+            uint32_t h = vertexHalfEdge_[v];
+            return h == INVALID || isBoundary(h);
+        }
+
+        const glm::vec3& getPosition(uint32_t v) const { return positions_[v]; }
+        void setPosition(uint32_t v, const glm::vec3& position) { positions_[v] = position; }
+
+        const Attribute& getAttribute(uint32_t a) const { return attributes_[a]; }
+
+        // func(h) for each half-edge leaving 'v'
+        template<typename Func>
+        void forEachOutgoing(uint32_t v, Func&& func) const {
+            uint32_t start = vertexHalfEdge_[v];
+            if (start == INVALID) return;
+            uint32_t h = start;
+            do {
+                func(h);
+                h = halfEdgeNext_[h ^ 1u];
+            } while (h != start);
+        }
+
+        // func(u) for each vertex sharing an edge with 'v'
+        template<typename Func>
+        void forEachNeighbor(uint32_t v, Func&& func) const {
+            forEachOutgoing(v, [&](uint32_t h) { func(halfEdgeVertex_[h]); });
+        }
+
+        // func(f) for each face around 'v'
+        template<typename Func>
+        void forEachVertexFace(uint32_t v, Func&& func) const {
+            forEachOutgoing(v, [&](uint32_t h) {
+                if (halfEdgeFace_[h] != INVALID) func(halfEdgeFace_[h]);
+                });
+        }
+
+        // func(h) for each half-edge of 'f', in winding order
+        template<typename Func>
+        void forEachFaceHalfEdge(uint32_t f, Func&& func) const {
+            uint32_t start = faceHalfEdge_[f];
+            uint32_t h = start;
+            do {
+                func(h);
+                h = halfEdgeNext_[h];
+            } while (h != start);
+        }
+
+        uint32_t getValence(uint32_t v) const;
+        uint32_t getFaceSize(uint32_t f) const;
+
+        // Half-edge from 'from' to 'to', or INVALID
+        uint32_t findHalfEdge(uint32_t from, uint32_t to) const;
+
+        // Newell normal, length = twice the polygon area
+        glm::vec3 getFaceNormal(uint32_t f) const;
+
+        // ====================================================================
+        // Editing
+        // ====================================================================
+
+        uint32_t addVertex(const glm::vec3& position);
+
+        // New face over 'count' vertices in winding order. Fails (INVALID)
+        // when a vertex is interior, an edge already has a face on this
+        // side, or the face would make a vertex non-manifold.
+        uint32_t addFace(const uint32_t* vertices, size_t count);
+
+        // Remove a face, leaving a hole. Edges without a face on either side
+        // go with it, and so do vertices left without edges when
+        // 'deleteIsolatedVertices' is set.
+        void deleteFace(uint32_t f, bool deleteIsolatedVertices = true);
+
+        // Remove a vertex and every face around it
+        void deleteVertex(uint32_t v);
+
+        // ====================================================================
+        // Selection
+        // ====================================================================
+
+        // The edge loop through 'e': at each interior vertex of even valence
+        // the loop continues along the edge straight across (valence / 2
+        // edges around); it stops at boundaries and odd valences. Appends
+        // edge indices to 'out', 'e' first.
+        void selectEdgeLoop(uint32_t e, std::vector<uint32_t>& out) const;
+
+    private:
+        uint32_t newEdge(uint32_t from, uint32_t to);
+        void setNext(uint32_t h, uint32_t n) {
+            halfEdgeNext_[h] = n;
+            halfEdgePrev_[n] = h;
+        }
+
+        // Point the vertex at a boundary half-edge, if it has one
+        void adjustOutgoing(uint32_t v);
+
+        // Vertices
+        std::vector<glm::vec3> positions_;
+        std::vector<uint32_t> vertexHalfEdge_;
+        std::vector<uint8_t> vertexDeleted_;
+
+        // Half-edges (edge e = half-edges 2e and 2e + 1)
+        std::vector<uint32_t> halfEdgeVertex_;      // Target
+        std::vector<uint32_t> halfEdgeFace_;
+        std::vector<uint32_t> halfEdgeNext_;
+        std::vector<uint32_t> halfEdgePrev_;
+        std::vector<uint32_t> halfEdgeAttribute_;   // Corner at the target
+        std::vector<uint8_t> edgeDeleted_;
+
+        // Faces
+        std::vector<uint32_t> faceHalfEdge_;
+        std::vector<uint8_t> faceDeleted_;
+
+        std::vector<Attribute> attributes_;
+
+        std::vector<uint32_t> freeVertices_;
+        std::vector<uint32_t> freeEdges_;
+        std::vector<uint32_t> freeFaces_;
+    };
+
+} // namespace libre
@@ -0,0 +1,314 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace libre {
+namespace MeshOptimizer {
+
+    namespace {
+
+        constexpr float WELD_CELL_TOLERANCES = 16.0f;     // Weld grid cell size
+        constexpr uint64_t EMPTY_CELL = ~0ULL;
+        constexpr uint64_t CELL_HASH = 0x9E3779B97F4A7C15ULL;
+
+        // FIFO post-transform cache as timestamps: a vertex is cached while
+        // fewer than 'size' misses happened since its own
+        struct CacheSim {
+            std::vector<uint32_t> stamp;
+            uint32_t time;
+            uint32_t size;
+
+            CacheSim(size_t vertexCount, uint32_t cacheSize)
+                : stamp(vertexCount, 0), time(cacheSize + 1), size(cacheSize) {
+            }
+
+            bool cached(uint32_t v) const { return time - stamp[v] <= size; }
+
+            uint32_t touch(const uint32_t* triangle) {
+                uint32_t misses = 0;
+                for (int k = 0; k < 3; ++k) {
+                    if (!cached(triangle[k])) {
+                        stamp[triangle[k]] = time++;
+                        ++misses;
+                    }
+                }
+                return misses;
+            }
+
+            // Everything falls out
+            void flush() { time += size + 1; }
+        };
+
+        bool indicesInRange(const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+            for (size_t i = 0; i < indexCount; ++i) {
+                if (indices[i] >= vertexCount) return false;
+            }
+            return true;
+        }
+
+        glm::vec3 positionAt(const glm::vec3* positions, size_t stride, uint32_t v) {
+            glm::vec3 p;
+            std::memcpy(&p, reinterpret_cast<const char*>(positions) + v * stride, sizeof(p));
+            return p;
+        }
+
+    } // namespace
+
+    float computeACMR(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+        size_t triangleCount = indexCount / 3;
+        if (triangleCount == 0 || !indicesInRange(indices, triangleCount * 3, vertexCount)) return 0.0f;
+
+        CacheSim cache(vertexCount, cacheSize);
+        size_t misses = 0;
+        for (size_t t = 0; t < triangleCount; ++t) misses += cache.touch(indices + t * 3);
+        return static_cast<float>(misses) / static_cast<float>(triangleCount);
+    }
+
+    void optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+        size_t triangleCount = indexCount / 3;
+        if (triangleCount == 0 || !indicesInRange(indices, triangleCount * 3, vertexCount)) return;
+
+        // Triangles around each vertex; 'live' counts the ones not emitted yet
+        std::vector<uint32_t> live(vertexCount, 0), offsets(vertexCount + 1, 0);
+        for (size_t i = 0; i < triangleCount * 3; ++i) ++live[indices[i]];
+        for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] = offsets[v] + live[v];
+
+        std::vector<uint32_t> adjacency(triangleCount * 3);
+        {
+            std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < triangleCount * 3; ++i) adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        std::vector<uint32_t> result(triangleCount * 3);
+        std::vector<uint8_t> emitted(triangleCount, 0);
+        std::vector<uint32_t> stamp(vertexCount, 0);
+        std::vector<uint32_t> deadEnd, candidates;
+        deadEnd.reserve(triangleCount * 3);
+        uint32_t time = cacheSize + 1;
+        size_t written = 0, scan = 0;
+
+        auto nextLive = [&]() -> uint32_t {
+            // Recently used vertices first, then the lowest index left
+            while (!deadEnd.empty()) {
+                uint32_t v = deadEnd.back();
+                deadEnd.pop_back();
+                if (live[v] > 0) return v;
+            }
+            for (; scan < vertexCount; ++scan) {
+                if (live[scan] > 0) return static_cast<uint32_t>(scan);
+            }
+            return INVALID;
+        };
+
+        uint32_t fan = nextLive();
+        while (fan != INVALID) {
+            candidates.clear();
+            for (uint32_t a = offsets[fan]; a < offsets[fan + 1]; ++a) {
+                uint32_t t = adjacency[a];
+                if (emitted[t]) continue;
+                emitted[t] = 1;
+                for (int k = 0; k < 3; ++k) {
+                    uint32_t v = indices[t * 3 + k];
+                    result[written++] = v;
+                    deadEnd.push_back(v);
+                    candidates.push_back(v);
+                    --live[v];
+                    if (time - stamp[v] > cacheSize) stamp[v] = time++;
+                }
+            }
+
+            // The oldest candidate that stays cached while it fans out
+            uint32_t best = INVALID;
+            int bestPriority = -1;
+            for (uint32_t v : candidates) {
+                if (live[v] == 0) continue;
+                int priority = 0;
+                if (time - stamp[v] + 2 * live[v] <= cacheSize) priority = static_cast<int>(time - stamp[v]);
+                if (priority > bestPriority) {
+                    bestPriority = priority;
+                    best = v;
+                }
+            }
+            fan = best != INVALID ? best : nextLive();
+        }
+
+        std::copy(result.begin(), result.end(), indices);
+    }
+
+    void optimizeOverdraw(uint32_t* indices, size_t indexCount, const glm::vec3* positions, size_t stride,
+        size_t vertexCount, float threshold, uint32_t cacheSize) {
+        size_t triangleCount = indexCount / 3;
+        if (triangleCount < 2 || !indicesInRange(indices, triangleCount * 3, vertexCount)) return;
+
+        // Hard boundaries: a triangle with no cached vertex starts a cluster
+        std::vector<uint32_t> hard;
+        {
+            CacheSim cache(vertexCount, cacheSize);
+            for (size_t t = 0; t < triangleCount; ++t) {
+                if (cache.touch(indices + t * 3) == 3) hard.push_back(static_cast<uint32_t>(t));
+            }
+        }
+        hard.push_back(static_cast<uint32_t>(triangleCount));
+
+        // Soft boundaries: cut a cluster once its running ACMR (from a cold
+        // cache) is back within 'threshold' of the whole cluster's
+        std::vector<uint32_t> clusters;
+        CacheSim cache(vertexCount, cacheSize);
+        for (size_t c = 0; c + 1 < hard.size(); ++c) {
+            uint32_t begin = hard[c], end = hard[c + 1];
+
+            cache.flush();
+            uint32_t misses = 0;
+            for (uint32_t t = begin; t < end; ++t) misses += cache.touch(indices + t * 3);
+            float limit = threshold * static_cast<float>(misses) / static_cast<float>(end - begin);
+
+            cache.flush();
+            clusters.push_back(begin);
+            uint32_t start = begin, running = 0;
+            for (uint32_t t = begin; t < end; ++t) {
+                running += cache.touch(indices + t * 3);
+                if (t + 1 < end && static_cast<float>(running) <= limit * static_cast<float>(t + 1 - start)) {
+                    clusters.push_back(t + 1);
+                    start = t + 1;
+                    running = 0;
+                    cache.flush();
+                }
+            }
+        }
+        clusters.push_back(static_cast<uint32_t>(triangleCount));
+
+        // Sort by how far each cluster faces out of the mesh's centroid
+        size_t clusterCount = clusters.size() - 1;
+        std::vector<glm::vec3> centroids(clusterCount), normals(clusterCount);
+        glm::vec3 meshCentroid(0.0f);
+        float meshArea = 0.0f;
+        for (size_t c = 0; c < clusterCount; ++c) {
+            glm::vec3 centroid(0.0f), normal(0.0f);
+            float area = 0.0f;
+            for (uint32_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+                glm::vec3 p0 = positionAt(positions, stride, indices[t * 3]);
+                glm::vec3 p1 = positionAt(positions, stride, indices[t * 3 + 1]);
+                glm::vec3 p2 = positionAt(positions, stride, indices[t * 3 + 2]);
+                glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+                float a = glm::length(n);
+                centroid += (p0 + p1 + p2) * (a / 3.0f);
+                normal += n;
+                area += a;
+            }
+            meshCentroid += centroid;
+            meshArea += area;
+            centroids[c] = area > 0.0f ? centroid / area : glm::vec3(0.0f);
+            normals[c] = normal;
+        }
+        if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+        std::vector<float> facing(clusterCount);
+        std::vector<uint32_t> order(clusterCount);
+        for (size_t c = 0; c < clusterCount; ++c) {
+            float length = glm::length(normals[c]);
+            facing[c] = length > 0.0f ? glm::dot(centroids[c] - meshCentroid, normals[c] / length) : 0.0f;
+            order[c] = static_cast<uint32_t>(c);
+        }
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return facing[a] > facing[b]; });
+
+        std::vector<uint32_t> result;
+        result.reserve(triangleCount * 3);
+        for (uint32_t c : order) {
+            result.insert(result.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+        }
+        std::copy(result.begin(), result.end(), indices);
+    }
+
+    size_t optimizeVertexFetch(uint32_t* indices, size_t indexCount, size_t vertexCount, std::vector<uint32_t>& remap) {
+        remap.assign(vertexCount, INVALID);
+        if (!indicesInRange(indices, indexCount, vertexCount)) {
+            for (size_t v = 0; v < vertexCount; ++v) remap[v] = static_cast<uint32_t>(v);
+            return vertexCount;
+        }
+
+        uint32_t next = 0;
+        for (size_t i = 0; i < indexCount; ++i) {
+            uint32_t& slot = remap[indices[i]];
+            if (slot == INVALID) slot = next++;
+            indices[i] = slot;
+        }
+        return next;
+    }
+
+    std::vector<uint32_t> weldPositions(const glm::vec3* positions, size_t stride, size_t vertexCount) {
+        glm::vec3 boundsMin(std::numeric_limits<float>::max()), boundsMax(-std::numeric_limits<float>::max());
+        for (size_t v = 0; v < vertexCount; ++v) {
+            glm::vec3 p = positionAt(positions, stride, static_cast<uint32_t>(v));
+            boundsMin = glm::min(boundsMin, p);
+            boundsMax = glm::max(boundsMax, p);
+        }
+        float tolerance = std::max(WELD_TOLERANCE * glm::length(boundsMax - boundsMin), std::numeric_limits<float>::min());
+        float inverseCell = 1.0f / (WELD_CELL_TOLERANCES * tolerance);
+        float margin = 1.0f / WELD_CELL_TOLERANCES;
+
+        // Cells span several tolerances, so only a vertex near a face (in
+        // cell units, within 'margin' of it) looks into the cell beyond
+        auto cellKey = [](int64_t x, int64_t y, int64_t z) {
+            return (uint64_t(x & 0x1FFFFF) << 42) | (uint64_t(y & 0x1FFFFF) << 21) | uint64_t(z & 0x1FFFFF);
+        };
+
+        // Cell -> most recent vertex in it: open addressing, linear probing,
+        // at most half full (keys use 63 bits, so EMPTY_CELL is never one)
+        struct Cell {
+            uint64_t key = EMPTY_CELL;
+            uint32_t head = INVALID;
+        };
+        int bits = 1;
+        while ((size_t(1) << bits) < vertexCount * 2) ++bits;
+        std::vector<Cell> cells(size_t(1) << bits);
+        size_t mask = cells.size() - 1;
+        auto slot = [&](uint64_t key) {
+            size_t i = static_cast<size_t>((key * CELL_HASH) >> (64 - bits));
+            while (cells[i].key != EMPTY_CELL && cells[i].key != key) i = (i + 1) & mask;
+            return i;
+        };
+
+        std::vector<uint32_t> canonical(vertexCount), next(vertexCount, INVALID);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            glm::vec3 p = positionAt(positions, stride, static_cast<uint32_t>(v));
+            glm::vec3 f = (p - boundsMin) * inverseCell;
+            int64_t cell[3], side[3];
+            for (int a = 0; a < 3; ++a) {
+                float c = std::floor(f[a]);
+                cell[a] = static_cast<int64_t>(c);
+                side[a] = f[a] - c < margin ? -1 : (f[a] - c > 1.0f - margin ? 1 : 0);
+            }
+
+            auto find = [&](uint32_t head) {
+                for (uint32_t u = head; u != INVALID; u = next[u]) {
+                    glm::vec3 d = positionAt(positions, stride, u) - p;
+                    if (glm::dot(d, d) <= tolerance * tolerance) {
+                        canonical[v] = canonical[u];
+                        return;
+                    }
+                }
+            };
+
+            canonical[v] = static_cast<uint32_t>(v);
+            Cell& own = cells[slot(cellKey(cell[0], cell[1], cell[2]))];
+            if (own.key != EMPTY_CELL) {
+                find(own.head);
+                next[v] = own.head;
+            }
+            own.key = cellKey(cell[0], cell[1], cell[2]);
+            own.head = static_cast<uint32_t>(v);
+            for (int n = 1; n < 8 && canonical[v] == v; ++n) {
+                if (((n & 1) && !side[0]) || ((n & 2) && !side[1]) || ((n & 4) && !side[2])) continue;
+                const Cell& beyond = cells[slot(cellKey(cell[0] + ((n & 1) ? side[0] : 0), cell[1] + ((n & 2) ? side[1] : 0),
+                    cell[2] + ((n & 4) ? side[2] : 0)))];
+                if (beyond.key != EMPTY_CELL) find(beyond.head);
+            }
+        }
+        return canonical;
+    }
+
+} // namespace MeshOptimizer
+} // namespace libre
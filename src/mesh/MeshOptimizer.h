@@ -0,0 +1,69 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace libre {
+
+    // ============================================================================
+    // MESH OPTIMIZER - Index and vertex order for the GPU's caches
+    // ============================================================================
+    // Reorders a triangle list without changing the surface:
+    // - optimizeVertexCache: Tipsify (Sander et al. 2007). Fans around one
+    //   vertex at a time, picking the next fanning vertex still in a
+    //   simulated FIFO cache, so most vertices are shaded once. Linear time.
+    // - optimizeOverdraw: splits the Tipsify order into clusters and draws
+    //   outward-facing clusters first, so they occlude the rest of the mesh
+    //   early. Clusters start where the cache simulation misses all three
+    //   vertices (Tipsify's dead ends), and are cut further wherever the
+    //   cut costs at most 'threshold' times the cluster's ACMR.
+    // - optimizeVertexFetch: renumbers vertices in first-use order, so the
+    //   vertex fetch walks memory forward (and unused vertices drop out).
+    //
+    // ACMR (average cache miss ratio) is vertex shader runs per triangle
+    // with a FIFO post-transform cache: 3 is worst, ~0.5 is the limit for
+    // large regular meshes.
+
+    namespace MeshOptimizer {
+
+        constexpr uint32_t CACHE_SIZE = 16;
+        constexpr uint32_t INVALID = 0xFFFFFFFF;
+        constexpr float WELD_TOLERANCE = 1e-6f;
+
+        float computeACMR(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = CACHE_SIZE);
+
+        // In place. Leaves the indices alone if any is out of range.
+        void optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = CACHE_SIZE);
+
+        // In place, on vertex cache optimized input. 'positions' is read
+        // with 'stride' bytes between vertices.
+        void optimizeOverdraw(uint32_t* indices, size_t indexCount, const glm::vec3* positions, size_t stride,
+            size_t vertexCount, float threshold = 1.05f, uint32_t cacheSize = CACHE_SIZE);
+
+        // Renumbers 'indices' in place; remap[old] = new vertex (or INVALID
+        // when unused). Returns the new vertex count.
+        size_t optimizeVertexFetch(uint32_t* indices, size_t indexCount, size_t vertexCount, std::vector<uint32_t>& remap);
+
+        // Maps each vertex to the first one within WELD_TOLERANCE of the
+        // bounding box diagonal (generated seams are rarely bit-exact), so
+        // vertices split only by attributes share one id
+        std::vector<uint32_t> weldPositions(const glm::vec3* positions, size_t stride, size_t vertexCount);
+
+        // Applies a remap from optimizeVertexFetch
+        template<typename Vertex>
+        std::vector<Vertex> remapVertices(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& remap, size_t newCount) {
+            std::vector<Vertex> result(newCount);
+            for (size_t i = 0; i < vertices.size() && i < remap.size(); ++i) {
+                if (remap[i] != INVALID) result[remap[i]] = vertices[i];
+            }
+            return result;
+        }
+
+    } // namespace MeshOptimizer
+
+} // namespace libre
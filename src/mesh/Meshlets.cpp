@@ -0,0 +1,282 @@
+#include "Meshlets.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace libre {
+namespace Meshlets {
+
+    namespace {
+
+        constexpr uint32_t INVALID = 0xFFFFFFFF;
+
+        bool indicesInRange(const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+            for (size_t i = 0; i < indexCount; ++i) {
+                if (indices[i] >= vertexCount) return false;
+            }
+            return true;
+        }
+
+        glm::vec3 positionAt(const glm::vec3* positions, size_t stride, uint32_t v) {
+            glm::vec3 p;
+            std::memcpy(&p, reinterpret_cast<const char*>(positions) + v * stride, sizeof(p));
+            return p;
+        }
+
+        // Sphere around the box of 'vertices'; cone over normals[first, first + count)
+        MeshletBounds computeBounds(const std::vector<uint32_t>& vertices, const std::vector<glm::vec3>& normals,
+            size_t firstTriangle, size_t triangleCount, const glm::vec3* positions, size_t stride) {
+            MeshletBounds bounds;
+
+            glm::vec3 boundsMin(std::numeric_limits<float>::max()), boundsMax(-std::numeric_limits<float>::max());
+            for (uint32_t v : vertices) {
+                glm::vec3 p = positionAt(positions, stride, v);
+                boundsMin = glm::min(boundsMin, p);
+                boundsMax = glm::max(boundsMax, p);
+            }
+            bounds.center = (boundsMin + boundsMax) * 0.5f;
+            for (uint32_t v : vertices) {
+                bounds.radius = std::max(bounds.radius, glm::length(positionAt(positions, stride, v) - bounds.center));
+            }
+
+            // Cone around the average unit normal (degenerate triangles have none)
+            glm::vec3 sum(0.0f);
+            for (size_t t = 0; t < triangleCount; ++t) sum += normals[firstTriangle + t];
+            float length = glm::length(sum);
+            if (!(length > 0.0f)) return bounds;
+
+            glm::vec3 axis = sum / length;
+            float minDot = 1.0f;
+            for (size_t t = 0; t < triangleCount; ++t) {
+                const glm::vec3& n = normals[firstTriangle + t];
+                if (n.x != 0.0f || n.y != 0.0f || n.z != 0.0f) minDot = std::min(minDot, glm::dot(n, axis));
+            }
+            bounds.coneAxis = axis;
+            bounds.coneCutoff = minDot > 0.0f ? std::sqrt(std::max(0.0f, 1.0f - minDot * minDot)) : 1.0f;
+            return bounds;
+        }
+
+        // Points each cone out of its closed part: the part's enclosed volume
+        // is negative when it is wound inward. Meshlets grow along shared
+        // vertices, so each lies within one part.
+        void orientCones(MeshletData& data, const std::vector<uint32_t>& welded, const glm::vec3* positions, size_t stride,
+            size_t vertexCount) {
+            std::vector<uint32_t> parent(vertexCount);
+            for (size_t v = 0; v < vertexCount; ++v) parent[v] = static_cast<uint32_t>(v);
+            auto find = [&](uint32_t v) {
+                while (parent[v] != v) v = parent[v] = parent[parent[v]];
+                return v;
+            };
+            for (size_t i = 0; i < welded.size(); i += 3) {
+                for (int k = 1; k < 3; ++k) {
+                    uint32_t a = find(welded[i]), b = find(welded[i + k]);
+                    if (a != b) parent[std::max(a, b)] = std::min(a, b);
+                }
+            }
+
+            std::vector<double> volume(vertexCount, 0.0);
+            for (size_t i = 0; i < welded.size(); i += 3) {
+                glm::vec3 p0 = positionAt(positions, stride, welded[i]);
+                glm::vec3 p1 = positionAt(positions, stride, welded[i + 1]);
+                glm::vec3 p2 = positionAt(positions, stride, welded[i + 2]);
+                volume[find(welded[i])] += glm::dot(p0, glm::cross(p1, p2));
+            }
+
+            for (size_t m = 0; m < data.meshlets.size(); ++m) {
+                double v = volume[find(welded[data.meshlets[m].firstIndex])];
+                MeshletBounds& bounds = data.bounds[m];
+                if (v < 0.0) bounds.coneAxis = -bounds.coneAxis;
+                else if (!(v > 0.0)) bounds.coneCutoff = 1.0f;
+            }
+        }
+
+    } // namespace
+
+    MeshletData build(uint32_t* indices, size_t indexCount, const glm::vec3* positions, size_t stride,
+        size_t vertexCount, uint32_t maxVertices, uint32_t maxTriangles) {
+        MeshletData data;
+        size_t triangleCount = indexCount / 3;
+        if (triangleCount == 0 || maxVertices < 3 || maxTriangles == 0 ||
+            !indicesInRange(indices, triangleCount * 3, vertexCount)) {
+            return data;
+        }
+
+        // Triangles around each vertex
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (size_t i = 0; i < triangleCount * 3; ++i) ++offsets[indices[i] + 1];
+        for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+        std::vector<uint32_t> adjacency(triangleCount * 3);
+        {
+            std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < triangleCount * 3; ++i) adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        std::vector<glm::vec3> normals(triangleCount), centroids(triangleCount);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            glm::vec3 p0 = positionAt(positions, stride, indices[t * 3]);
+            glm::vec3 p1 = positionAt(positions, stride, indices[t * 3 + 1]);
+            glm::vec3 p2 = positionAt(positions, stride, indices[t * 3 + 2]);
+            glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+            float length = glm::length(n);
+            normals[t] = length > 0.0f ? n / length : glm::vec3(0.0f);
+            centroids[t] = (p0 + p1 + p2) / 3.0f;
+        }
+
+        std::vector<uint32_t> result;
+        std::vector<glm::vec3> resultNormals;
+        result.reserve(triangleCount * 3);
+        resultNormals.reserve(triangleCount);
+        std::vector<uint8_t> emitted(triangleCount, 0);
+        std::vector<uint32_t> live(vertexCount);                // Triangles not emitted yet
+        for (size_t v = 0; v < vertexCount; ++v) live[v] = offsets[v + 1] - offsets[v];
+        std::vector<uint32_t> owner(vertexCount, INVALID);    // Meshlet a vertex is in
+        std::vector<uint32_t> vertices, candidates;
+
+        // Distinct vertices of triangle 't' not yet in meshlet 'id'
+        auto newVertexCount = [&](uint32_t t, uint32_t id) {
+            const uint32_t* tri = indices + t * 3;
+            uint32_t count = owner[tri[0]] != id;
+            count += owner[tri[1]] != id && tri[1] != tri[0];
+            count += owner[tri[2]] != id && tri[2] != tri[0] && tri[2] != tri[1];
+            return count;
+        };
+
+        size_t seed = 0;
+        uint32_t border = INVALID;      // Next to the previous meshlet
+        for (;;) {
+            while (seed < triangleCount && emitted[seed]) ++seed;
+            if (seed == triangleCount) break;
+
+            uint32_t id = static_cast<uint32_t>(data.meshlets.size());
+            Meshlet meshlet;
+            meshlet.firstIndex = static_cast<uint32_t>(result.size());
+            vertices.clear();
+            candidates.clear();
+            glm::vec3 normalSum(0.0f), centroidSum(0.0f);
+            uint32_t triangles = 0;
+
+            uint32_t next = border != INVALID ? border : static_cast<uint32_t>(seed);
+            while (next != INVALID) {
+                emitted[next] = 1;
+                ++triangles;
+                normalSum += normals[next];
+                centroidSum += centroids[next];
+                resultNormals.push_back(normals[next]);
+                for (int k = 0; k < 3; ++k) {
+                    uint32_t v = indices[next * 3 + k];
+                    result.push_back(v);
+                    --live[v];
+                    if (owner[v] == id) continue;
+                    owner[v] = id;
+                    vertices.push_back(v);
+                    for (uint32_t a = offsets[v]; a < offsets[v + 1]; ++a) {
+                        if (!emitted[adjacency[a]]) candidates.push_back(adjacency[a]);
+                    }
+                }
+                if (triangles == maxTriangles) break;
+
+                // Fewest new vertices, then nearest the cluster's centre,
+                // counted up to three times as far when facing away from it
+                float length = glm::length(normalSum);
+                glm::vec3 axis = length > 0.0f ? normalSum / length : glm::vec3(0.0f);
+                glm::vec3 center = centroidSum / static_cast<float>(triangles);
+                next = INVALID;
+                uint32_t bestNew = 4;
+                float bestCost = std::numeric_limits<float>::max();
+                size_t kept = 0;
+                for (size_t c = 0; c < candidates.size(); ++c) {
+                    uint32_t t = candidates[c];
+                    if (emitted[t]) continue;
+                    candidates[kept++] = t;
+
+                    uint32_t added = newVertexCount(t, id);
+                    if (vertices.size() + added > maxVertices || added > bestNew) continue;
+                    glm::vec3 offset = centroids[t] - center;
+                    uint32_t neighbours = live[indices[t * 3]] + live[indices[t * 3 + 1]] + live[indices[t * 3 + 2]];
+                    float cost = glm::dot(offset, offset) * (2.0f - glm::dot(normals[t], axis)) * static_cast<float>(neighbours);
+                    if (added < bestNew || cost < bestCost) {
+                        next = t;
+                        bestNew = added;
+                        bestCost = cost;
+                    }
+                }
+                candidates.resize(kept);
+            }
+
+            // The border triangle with the fewest live neighbours, so corners
+            // fill before they become islands
+            border = INVALID;
+            uint32_t fewest = INVALID;
+            for (uint32_t t : candidates) {
+                if (emitted[t]) continue;
+                uint32_t neighbours = live[indices[t * 3]] + live[indices[t * 3 + 1]] + live[indices[t * 3 + 2]];
+                if (neighbours < fewest) {
+                    fewest = neighbours;
+                    border = t;
+                }
+            }
+
+            meshlet.indexCount = static_cast<uint32_t>(result.size()) - meshlet.firstIndex;
+            meshlet.vertexCount = static_cast<uint32_t>(vertices.size());
+            data.meshlets.push_back(meshlet);
+            data.bounds.push_back(computeBounds(vertices, resultNormals, meshlet.firstIndex / 3, triangles, positions, stride));
+        }
+
+        std::copy(result.begin(), result.end(), indices);
+
+        // Seams (UV or normal splits) duplicate positions: weld for the test
+        std::vector<uint32_t> welded(indices, indices + triangleCount * 3);
+        {
+            std::vector<uint32_t> canonical = MeshOptimizer::weldPositions(positions, stride, vertexCount);
+            for (uint32_t& v : welded) v = canonical[v];
+        }
+        data.closed = isClosed(welded.data(), welded.size(), vertexCount);
+        if (data.closed) orientCones(data, welded, positions, stride, vertexCount);
+        return data;
+    }
+
+    bool isClosed(const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+        size_t triangleCount = indexCount / 3;
+        if (triangleCount == 0 || !indicesInRange(indices, triangleCount * 3, vertexCount)) return false;
+
+        // Edges bucketed by their lower vertex: (upper << 1 | direction)
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            for (int k = 0; k < 3; ++k) {
+                uint32_t a = indices[t * 3 + k], b = indices[t * 3 + (k + 1) % 3];
+                if (a != b) ++offsets[std::min(a, b) + 1];
+            }
+        }
+        for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+
+        std::vector<uint64_t> edges(offsets[vertexCount]);
+        {
+            std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+            for (size_t t = 0; t < triangleCount; ++t) {
+                for (int k = 0; k < 3; ++k) {
+                    uint32_t a = indices[t * 3 + k], b = indices[t * 3 + (k + 1) % 3];
+                    if (a == b) continue;
+                    edges[cursor[std::min(a, b)]++] = (uint64_t(std::max(a, b)) << 1) | (a > b ? 1 : 0);
+                }
+            }
+        }
+
+        // Within a bucket, each upper vertex needs as many a->b as b->a
+        for (size_t v = 0; v < vertexCount; ++v) {
+            auto begin = edges.begin() + offsets[v], end = edges.begin() + offsets[v + 1];
+            std::sort(begin, end);
+            for (auto run = begin; run != end;) {
+                uint64_t upper = *run >> 1;
+                int balance = 0;
+                for (; run != end && (*run >> 1) == upper; ++run) balance += (*run & 1) ? 1 : -1;
+                if (balance != 0) return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace Meshlets
+} // namespace libre
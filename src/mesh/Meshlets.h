@@ -0,0 +1,89 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace libre {
+
+    // ============================================================================
+    // MESHLETS - Small triangle clusters with culling bounds
+    // ============================================================================
+    // build() splits a triangle list into clusters of at most MAX_VERTICES
+    // distinct vertices and MAX_TRIANGLES triangles (the usual mesh shader
+    // limits). It reorders the index buffer so every meshlet is one
+    // contiguous index range, drawable on its own with vkCmdDrawIndexed.
+    //
+    // Clusters grow greedily from a seed triangle. Each step adds the
+    // adjacent triangle that brings the fewest new vertices, and among
+    // those the nearest to the cluster's centre, weighted against normals
+    // that turn away from the cluster's and towards triangles with few
+    // unclustered neighbours (so none are left stranded). Compact clusters
+    // fill up to the vertex limit, and their bounds and normal cones stay
+    // tight. The next seed is the previous cluster's border triangle with
+    // the fewest unclustered neighbours, so consecutive meshlets are
+    // neighbours and surviving ranges merge; without one, it is the first
+    // triangle left in input order.
+    //
+    // Each meshlet gets a bounding sphere and a normal cone. ClusterCuller
+    // culls on them. The cone is only meaningful on closed meshes: the mesh
+    // pipeline does not cull back faces, so a back-facing cluster of an
+    // open surface is still visible. For the same reason winding is not
+    // guaranteed to be outward: each closed part's cones are turned to
+    // point out of it, by the sign of its enclosed volume.
+
+    struct Meshlet {
+        uint32_t firstIndex = 0;        // Into the reordered index buffer
+        uint32_t indexCount = 0;        // 3 per triangle
+        uint32_t vertexCount = 0;       // Distinct vertices
+    };
+
+    struct MeshletBounds {
+        glm::vec3 center = glm::vec3(0.0f);     // Object space
+        float radius = 0.0f;
+        glm::vec3 coneAxis = glm::vec3(0.0f);   // Average face normal
+        float coneCutoff = 1.0f;                // Sine of the normals' spread from the axis; >= 1: no cone
+    };
+
+    struct MeshletData {
+        std::vector<Meshlet> meshlets;
+        std::vector<MeshletBounds> bounds;      // Per meshlet
+        bool closed = false;                    // Every edge has an opposite twin (positions welded)
+
+        size_t getTriangleCount() const {
+            return meshlets.empty() ? 0 : (meshlets.back().firstIndex + meshlets.back().indexCount) / 3;
+        }
+    };
+
+    namespace Meshlets {
+
+        constexpr uint32_t MAX_VERTICES = 64;
+        constexpr uint32_t MAX_TRIANGLES = 124;
+
+        // Reorders 'indices' in place ('positions' is read with 'stride'
+        // bytes between vertices). Returns no meshlets, and leaves the
+        // indices alone, if any index is out of range.
+        MeshletData build(uint32_t* indices, size_t indexCount, const glm::vec3* positions, size_t stride,
+            size_t vertexCount, uint32_t maxVertices = MAX_VERTICES, uint32_t maxTriangles = MAX_TRIANGLES);
+
+        // Whether every directed edge a->b is matched by exactly as many b->a
+        bool isClosed(const uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+        // All of the cluster faces away from 'viewer' (same space as the
+        // bounds). Every view ray into the sphere must lie within 90 degrees
+        // minus the spread of the axis: the sphere can tilt the ray by up to
+        // 'radius' and lengthen it by as much.
+        inline bool isBackFacing(const MeshletBounds& bounds, const glm::vec3& viewer) {
+            if (bounds.coneCutoff >= 1.0f) return false;
+            glm::vec3 toCluster = bounds.center - viewer;
+            return glm::dot(toCluster, bounds.coneAxis) >=
+                bounds.coneCutoff * glm::length(toCluster) + bounds.radius * (1.0f + bounds.coneCutoff);
+        }
+
+    } // namespace Meshlets
+
+} // namespace libre
@@ -0,0 +1,302 @@
+#include "NormalKernels.h"
+#include "MeshOptimizer.h"
+#include "../core/JobSystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LIBRE_KERNEL_SSE 1
+#endif
+
+#include <cmath>
+#include <algorithm>
+
+namespace libre::NormalKernels {
+
+    namespace {
+
+        constexpr uint32_t INVALID = 0xFFFFFFFF;
+
+        // Shorter sums have no direction worth keeping
+        constexpr float MIN_LENGTH2 = 1e-30f;
+
+        // Default when nothing around a vertex has area (as HalfEdgeMesh)
+        const glm::vec3 FALLBACK_NORMAL(0.0f, 1.0f, 0.0f);
+
+        bool smooths(const glm::vec3& a, const glm::vec3& b) {
+            float la = glm::length(a), lb = glm::length(b);
+            return la == 0.0f || lb == 0.0f || glm::dot(a, b) >= SMOOTH_DOT * la * lb;
+        }
+
+        // ====================================================================
+        // NORMALIZE (4 vectors, SoA lanes)
+        // ====================================================================
+
+#if LIBRE_KERNEL_SSE
+
+        void normalize4(float* x, float* y, float* z) {
+            __m128 vx = _mm_loadu_ps(x), vy = _mm_loadu_ps(y), vz = _mm_loadu_ps(z);
+            __m128 length2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+
+            // rsqrt is good to 12 bits; one Newton step takes it to ~23
+            __m128 r = _mm_rsqrt_ps(length2);
+            __m128 halfLength2 = _mm_mul_ps(_mm_set1_ps(0.5f), length2);
+            r = _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(halfLength2, _mm_mul_ps(r, r))));
+
+            __m128 valid = _mm_cmpgt_ps(length2, _mm_set1_ps(MIN_LENGTH2));
+            __m128 fallbackY = _mm_andnot_ps(valid, _mm_set1_ps(FALLBACK_NORMAL.y));
+            _mm_storeu_ps(x, _mm_and_ps(valid, _mm_mul_ps(vx, r)));
+            _mm_storeu_ps(y, _mm_or_ps(_mm_and_ps(valid, _mm_mul_ps(vy, r)), fallbackY));
+            _mm_storeu_ps(z, _mm_and_ps(valid, _mm_mul_ps(vz, r)));
+        }
+
+#else
+
+        void normalize4(float* x, float* y, float* z) {
+            for (int i = 0; i < 4; ++i) {
+                float length2 = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+                if (length2 > MIN_LENGTH2) {
+                    float r = 1.0f / std::sqrt(length2);
+                    x[i] *= r; y[i] *= r; z[i] *= r;
+                }
+                else {
+                    x[i] = FALLBACK_NORMAL.x; y[i] = FALLBACK_NORMAL.y; z[i] = FALLBACK_NORMAL.z;
+                }
+            }
+        }
+
+#endif
+
+        glm::vec3 faceNormal(const MeshComponent& mesh, size_t triangle) {
+            const uint32_t* t = mesh.indices.data() + triangle * 3;
+            size_t n = mesh.vertices.size();
+            if (t[0] >= n || t[1] >= n || t[2] >= n) return glm::vec3(0.0f);
+
+            glm::vec3 p0 = mesh.vertices[t[0]].position;
+            return glm::cross(mesh.vertices[t[1]].position - p0, mesh.vertices[t[2]].position - p0);
+        }
+
+        // Any unit vector at right angles to 'n'
+        glm::vec3 perpendicular(const glm::vec3& n) {
+            glm::vec3 axis = std::abs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+            return glm::normalize(glm::cross(axis, n));
+        }
+
+    } // namespace
+
+    const char* getKernelName() {
+#if LIBRE_KERNEL_SSE
+        return "SSE";
+#else
+        return "Scalar";
+#endif
+    }
+
+    void buildAdjacency(const MeshComponent& mesh, Adjacency& adjacency) {
+        size_t vertexCount = mesh.vertices.size();
+        size_t indexCount = mesh.indices.size() / 3 * 3;
+        adjacency.vertexCount = vertexCount;
+        adjacency.indexCount = mesh.indices.size();
+        adjacency.group.resize(vertexCount);
+        adjacency.offsets.assign(vertexCount + 1, 0);
+        adjacency.corners.clear();
+        if (vertexCount == 0) return;
+
+        // Vertices at one position join the first earlier group whose
+        // normal agrees; weld maps each vertex to the first at its position
+        std::vector<uint32_t> weld = MeshOptimizer::weldPositions(&mesh.vertices[0].position, sizeof(MeshVertex), vertexCount);
+        std::vector<uint32_t> nextGroup(vertexCount, INVALID);
+        for (uint32_t v = 0; v < vertexCount; ++v) {
+            uint32_t first = weld[v];
+            adjacency.group[v] = v;
+            if (first == v) continue;
+
+            const glm::vec3& normal = mesh.vertices[v].normal;
+            uint32_t last = first;
+            for (uint32_t g = first; g != INVALID; last = g, g = nextGroup[g]) {
+                if (smooths(normal, mesh.vertices[g].normal)) {
+                    adjacency.group[v] = g;
+                    break;
+                }
+            }
+            if (adjacency.group[v] == v) nextGroup[last] = v;
+        }
+
+        // Counting sort of the corners by group; triangles with an index out of range are left out
+        auto validTriangle = [&](size_t t) {
+            const uint32_t* tri = mesh.indices.data() + t * 3;
+            return tri[0] < vertexCount && tri[1] < vertexCount && tri[2] < vertexCount;
+        };
+        for (size_t t = 0; t < indexCount / 3; ++t) {
+            if (!validTriangle(t)) continue;
+            for (int k = 0; k < 3; ++k) ++adjacency.offsets[adjacency.group[mesh.indices[t * 3 + k]] + 1];
+        }
+        for (size_t g = 0; g < vertexCount; ++g) adjacency.offsets[g + 1] += adjacency.offsets[g];
+
+        adjacency.corners.resize(adjacency.offsets[vertexCount]);
+        std::vector<uint32_t> cursor(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+        for (size_t t = 0; t < indexCount / 3; ++t) {
+            if (!validTriangle(t)) continue;
+            for (int k = 0; k < 3; ++k) {
+                uint32_t corner = static_cast<uint32_t>(t * 3 + k);
+                adjacency.corners[cursor[adjacency.group[mesh.indices[corner]]]++] = corner;
+            }
+        }
+    }
+
+    void recomputeNormals(MeshComponent& mesh, Adjacency& adjacency) {
+        if (!adjacency.matches(mesh)) buildAdjacency(mesh, adjacency);
+
+        size_t vertexCount = mesh.vertices.size();
+        size_t triangleCount = mesh.indices.size() / 3;
+        JobSystem& jobs = JobSystem::instance();
+
+        adjacency.faceNormals.resize(triangleCount);
+        jobs.parallelFor(triangleCount, GRAIN, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t) adjacency.faceNormals[t] = faceNormal(mesh, t);
+        });
+
+        // Each vertex gathers its group's faces, 4 vertices per normalize
+        jobs.parallelFor((vertexCount + 3) / 4, GRAIN / 4, [&](size_t begin, size_t end) {
+            for (size_t block = begin; block < end; ++block) {
+                size_t first = block * 4;
+                size_t lanes = std::min<size_t>(4, vertexCount - first);
+                float x[4] = {}, y[4] = {}, z[4] = {};
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    uint32_t g = adjacency.group[first + lane];
+                    glm::vec3 sum(0.0f);
+                    for (uint32_t i = adjacency.offsets[g]; i < adjacency.offsets[g + 1]; ++i) sum += adjacency.faceNormals[adjacency.corners[i] / 3];
+                    x[lane] = sum.x; y[lane] = sum.y; z[lane] = sum.z;
+                }
+                normalize4(x, y, z);
+                for (size_t lane = 0; lane < lanes; ++lane) mesh.vertices[first + lane].normal = glm::vec3(x[lane], y[lane], z[lane]);
+            }
+        });
+
+        mesh.markGeometryDirty();
+    }
+
+    void recomputeNormals(MeshComponent& mesh, const Adjacency& adjacency, const uint32_t* moved, size_t movedCount) {
+        if (!adjacency.matches(mesh) || movedCount == 0) return;
+
+        // Groups that moved -> their triangles -> the groups of those
+        // triangles' vertices. A bit per group keeps both lists unique.
+        std::vector<uint64_t> seen((adjacency.vertexCount + 63) / 64, 0);
+        auto firstVisit = [&seen](uint32_t g) {
+            uint64_t bit = uint64_t(1) << (g & 63);
+            if (seen[g >> 6] & bit) return false;
+            seen[g >> 6] |= bit;
+            return true;
+        };
+
+        std::vector<uint32_t> movedGroups;
+        for (size_t i = 0; i < movedCount; ++i) {
+            if (moved[i] < adjacency.vertexCount && firstVisit(adjacency.group[moved[i]])) movedGroups.push_back(adjacency.group[moved[i]]);
+        }
+        std::fill(seen.begin(), seen.end(), 0);
+
+        std::vector<uint32_t> groups;
+        for (uint32_t g : movedGroups) {
+            for (uint32_t i = adjacency.offsets[g]; i < adjacency.offsets[g + 1]; ++i) {
+                const uint32_t* tri = mesh.indices.data() + adjacency.corners[i] / 3 * 3;
+                for (int k = 0; k < 3; ++k) {
+                    if (firstVisit(adjacency.group[tri[k]])) groups.push_back(adjacency.group[tri[k]]);
+                }
+            }
+        }
+
+        // A group's vertices are exactly the vertices of its corners, and
+        // belong to no other group: chunks never write the same vertex
+        JobSystem::instance().parallelFor((groups.size() + 3) / 4, GRAIN / 16, [&](size_t begin, size_t end) {
+            for (size_t block = begin; block < end; ++block) {
+                size_t first = block * 4;
+                size_t lanes = std::min<size_t>(4, groups.size() - first);
+                float x[4] = {}, y[4] = {}, z[4] = {};
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    uint32_t g = groups[first + lane];
+                    glm::vec3 sum(0.0f);
+                    for (uint32_t i = adjacency.offsets[g]; i < adjacency.offsets[g + 1]; ++i) sum += faceNormal(mesh, adjacency.corners[i] / 3);
+                    x[lane] = sum.x; y[lane] = sum.y; z[lane] = sum.z;
+                }
+                normalize4(x, y, z);
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    uint32_t g = groups[first + lane];
+                    glm::vec3 normal(x[lane], y[lane], z[lane]);
+                    for (uint32_t i = adjacency.offsets[g]; i < adjacency.offsets[g + 1]; ++i) {
+                        mesh.vertices[mesh.indices[adjacency.corners[i]]].normal = normal;
+                    }
+                }
+            }
+        });
+
+        mesh.markGeometryDirty();
+    }
+
+    void computeTangents(const MeshComponent& mesh, const Adjacency& adjacency, std::vector<glm::vec4>& tangents) {
+        size_t vertexCount = mesh.vertices.size();
+        size_t triangleCount = mesh.indices.size() / 3;
+        tangents.assign(vertexCount, glm::vec4(0.0f));
+        if (!adjacency.matches(mesh)) return;
+        JobSystem& jobs = JobSystem::instance();
+
+        // Per face: unit dP/du and the UV winding (w); zero when the UVs have no area
+        std::vector<glm::vec4> faceTangents(triangleCount);
+        jobs.parallelFor(triangleCount, GRAIN, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t) {
+                const uint32_t* tri = mesh.indices.data() + t * 3;
+                faceTangents[t] = glm::vec4(0.0f);
+                if (tri[0] >= vertexCount || tri[1] >= vertexCount || tri[2] >= vertexCount) continue;
+
+                const MeshVertex& a = mesh.vertices[tri[0]];
+                glm::vec3 e1 = mesh.vertices[tri[1]].position - a.position;
+                glm::vec3 e2 = mesh.vertices[tri[2]].position - a.position;
+                glm::vec2 d1 = mesh.vertices[tri[1]].uv - a.uv;
+                glm::vec2 d2 = mesh.vertices[tri[2]].uv - a.uv;
+                float area = d1.x * d2.y - d2.x * d1.y;
+                glm::vec3 tangent = (e1 * d2.y - e2 * d1.y) * (area < 0.0f ? -1.0f : 1.0f);
+                float length = glm::length(tangent);
+                if (area == 0.0f || length == 0.0f) continue;
+                faceTangents[t] = glm::vec4(tangent / length, area > 0.0f ? 1.0f : -1.0f);
+            }
+        });
+
+        // Per vertex: its own corners, each face tangent in the vertex's
+        // tangent plane weighted by the corner's angle in that plane
+        jobs.parallelFor(vertexCount, GRAIN, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; ++v) {
+                glm::vec3 n = mesh.vertices[v].normal;
+                float nLength = glm::length(n);
+                n = nLength > 0.0f ? n / nLength : FALLBACK_NORMAL;
+                auto project = [&n](const glm::vec3& d) { return d - n * glm::dot(n, d); };
+
+                glm::vec3 sum(0.0f);
+                float winding = 0.0f;
+                uint32_t g = adjacency.group[v];
+                for (uint32_t i = adjacency.offsets[g]; i < adjacency.offsets[g + 1]; ++i) {
+                    uint32_t corner = adjacency.corners[i];
+                    if (mesh.indices[corner] != v) continue;
+                    const glm::vec4& face = faceTangents[corner / 3];
+                    if (face.w == 0.0f) continue;
+
+                    uint32_t base = corner / 3 * 3;
+                    glm::vec3 p = mesh.vertices[v].position;
+                    glm::vec3 e1 = project(mesh.vertices[mesh.indices[base + (corner - base + 1) % 3]].position - p);
+                    glm::vec3 e2 = project(mesh.vertices[mesh.indices[base + (corner - base + 2) % 3]].position - p);
+                    float l1 = glm::length(e1), l2 = glm::length(e2);
+                    glm::vec3 tangent = project(glm::vec3(face));
+                    float tLength = glm::length(tangent);
+                    if (l1 == 0.0f || l2 == 0.0f || tLength == 0.0f) continue;
+
+                    float angle = std::acos(std::clamp(glm::dot(e1, e2) / (l1 * l2), -1.0f, 1.0f));
+                    sum += tangent * (angle / tLength);
+                    winding += face.w * angle;
+                }
+
+                sum = project(sum);
+                float length = glm::length(sum);
+                glm::vec3 tangent = length > 0.0f ? sum / length : perpendicular(n);
+                tangents[v] = glm::vec4(tangent, winding < 0.0f ? -1.0f : 1.0f);
+            }
+        });
+    }
+
+} // namespace libre::NormalKernels
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "../components/CoreComponents.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace libre {
+
+    // ============================================================================
+    // NORMAL KERNELS - Smooth vertex normals and tangents after deformation
+    // ============================================================================
+    // Area-weighted smooth normals (the sum of the unnormalized face
+    // normals around a vertex), recomputed in parallel over JobSystem:
+    // - Adjacency is built once per topology: every vertex's smoothing
+    //   group and the triangle corners around it (CSR). Vertices split only
+    //   by UV or colour (seams) share a group, so no seam shows in the
+    //   shading; vertices split with normals further apart than SMOOTH_DOT
+    //   (hard edges, e.g. a cube's faces) keep their own.
+    // - recomputeNormals is a gather, not a scatter: face normals are
+    //   written once, then each vertex sums its own group's corners. No
+    //   atomics, no per-thread buffers, and the result does not depend on
+    //   the thread count. Sums are normalized 4 at a time with SSE on x86
+    //   builds (rsqrt plus a Newton step), scalar elsewhere.
+    // - The region variant takes the vertices that moved and updates every
+    //   vertex of the triangles around them, touching nothing else.
+    //
+    // computeTangents follows MikkTSpace's conventions (per-face UV
+    // tangents weighted by corner angle, projected onto the vertex normal,
+    // w = bitangent sign), so normal maps baked against MikkTSpace match on
+    // ordinary meshes. Unlike MikkTSpace it does not split a vertex whose
+    // triangles disagree in UV handedness; the majority wins.
+
+    namespace NormalKernels {
+
+        // Split vertices at one position are smoothed together above this normal dot (60 degrees)
+        constexpr float SMOOTH_DOT = 0.5f;
+
+        // Items per JobSystem chunk
+        constexpr size_t GRAIN = 4096;
+
+        struct Adjacency {
+            std::vector<uint32_t> group;        // Per vertex: its smoothing group (the group's first vertex)
+            std::vector<uint32_t> offsets;      // Per group id, into corners (vertexCount + 1; empty unless a group)
+            std::vector<uint32_t> corners;      // Index buffer positions (triangle * 3 + k) around each group
+            std::vector<glm::vec3> faceNormals; // Scratch for recomputeNormals
+            size_t vertexCount = 0;
+            size_t indexCount = 0;
+
+            // Still describes the mesh's topology (same counts)
+            bool matches(const MeshComponent& mesh) const {
+                return vertexCount == mesh.vertices.size() && indexCount == mesh.indices.size();
+            }
+        };
+
+        // Name of the compiled-in normalize kernel ("SSE", "Scalar")
+        const char* getKernelName();
+
+        // Groups from positions and the current normals (a zero normal smooths with anything)
+        void buildAdjacency(const MeshComponent& mesh, Adjacency& adjacency);
+
+        // Every vertex normal (builds the adjacency first if it is stale)
+        void recomputeNormals(MeshComponent& mesh, Adjacency& adjacency);
+
+        // Normals affected by moving 'moved' (duplicates are fine); does
+        // nothing with a stale adjacency
+        void recomputeNormals(MeshComponent& mesh, const Adjacency& adjacency, const uint32_t* moved, size_t movedCount);
+
+        // xyz unit tangent, w = +-1 so that bitangent = w * cross(normal,
+        // tangent), against the current normals; zeros with a stale adjacency
+        void computeTangents(const MeshComponent& mesh, const Adjacency& adjacency, std::vector<glm::vec4>& tangents);
+
+    } // namespace NormalKernels
+
+} // namespace libre
@@ -0,0 +1,891 @@
+#include "Simplifier.h"
+#include "MeshOptimizer.h"
+#include "../core/JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace libre {
+namespace Simplifier {
+
+    namespace {
+
+        constexpr uint32_t INVALID = 0xFFFFFFFF;
+        constexpr uint32_t SHARED = 0xFFFFFFFE;        // Position used by several regions
+        constexpr uint32_t WHOLE_MESH = 0xFFFFFFFD;    // Pass over every region
+        constexpr size_t MAX_ATTRIBUTES = 8;            // Normal, UV, colour
+        constexpr float BORDER_WEIGHT = 10.0f;
+        constexpr size_t PROGRESS_INTERVAL = 4096;      // Triangles removed between progress updates
+        constexpr float MIN_NORMAL_DOT = 0.2f;          // Triangles may turn by up to ~80 degrees from their original
+
+        enum class Kind : uint8_t { Manifold, Border, Seam, Locked, Removed };
+
+        // error(p) = p'Ap + 2b'p + c, with A symmetric; w is the total weight
+        struct Quadric {
+            float a00 = 0.0f, a11 = 0.0f, a22 = 0.0f, a01 = 0.0f, a02 = 0.0f, a12 = 0.0f;
+            float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+            float c = 0.0f;
+            float w = 0.0f;
+
+            // weight * (n.p + d)^2, without adding to w
+            void addSquare(const glm::vec3& n, float d, float weight) {
+                a00 += weight * n.x * n.x;
+                a11 += weight * n.y * n.y;
+                a22 += weight * n.z * n.z;
+                a01 += weight * n.x * n.y;
+                a02 += weight * n.x * n.z;
+                a12 += weight * n.y * n.z;
+                b0 += weight * d * n.x;
+                b1 += weight * d * n.y;
+                b2 += weight * d * n.z;
+                c += weight * d * d;
+            }
+
+            void addPlane(const glm::vec3& n, float d, float weight) {
+                addSquare(n, d, weight);
+                w += weight;
+            }
+
+            void add(const Quadric& q) {
+                a00 += q.a00; a11 += q.a11; a22 += q.a22;
+                a01 += q.a01; a02 += q.a02; a12 += q.a12;
+                b0 += q.b0; b1 += q.b1; b2 += q.b2;
+                c += q.c;
+                w += q.w;
+            }
+
+            float evaluate(const glm::vec3& p) const {
+                float x = p.x, y = p.y, z = p.z;
+                return a00 * x * x + a11 * y * y + a22 * z * z
+                    + 2.0f * (a01 * x * y + a02 * x * z + a12 * y * z)
+                    + 2.0f * (b0 * x + b1 * y + b2 * z) + c;
+            }
+        };
+
+        // Weighted gradient and offset of one attribute: a(p) = g.p + d
+        struct Gradient {
+            glm::vec3 g = glm::vec3(0.0f);
+            float d = 0.0f;
+        };
+
+        // What a collapse looks up about each neighbour, in one cache line
+        struct alignas(64) VertexState {
+            glm::vec3 position = glm::vec3(0.0f);   // Scaled into the unit cube
+            uint32_t group = 0;                     // Welded position: its first vertex
+            uint32_t owner = WHOLE_MESH;            // Region that moves it (its position's)
+            Kind kind = Kind::Locked;
+            float attributes[MAX_ATTRIBUTES] = {};  // Weighted; the first attributeCount_ are used
+        };
+
+        // Triangle corner: its vertex, and the vertex's next corner
+        struct Corner {
+            uint32_t vertex;
+            uint32_t next = INVALID;
+        };
+
+        uint32_t nextCorner(uint32_t c) { return c % 3 == 2 ? c - 2 : c + 1; }
+        uint32_t prevCorner(uint32_t c) { return c % 3 == 0 ? c + 2 : c - 1; }
+
+        // ====================================================================
+        // COLLAPSER - Mesh state shared by the region and whole-mesh passes
+        // ====================================================================
+        // A pass only touches positions its region owns (every live triangle
+        // around them is in the region), so regions run side by side on one
+        // state without locks. The whole-mesh pass owns everything.
+
+        class Collapser {
+        public:
+            Collapser(const MeshVertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount,
+                const Options& options, std::atomic<float>* progress);
+
+            size_t getLiveTriangles() const { return live_; }
+            float getError() const { return std::sqrt(maxError_); }
+
+            // Total triangles the whole simplification removes (for progress)
+            void setWork(size_t triangles) { work_ = std::max<size_t>(triangles, 1); }
+
+            // Regions in parallel towards 'target', then the whole mesh to it
+            void runRegions(size_t target);
+            void runWholeMesh(size_t target);
+
+            void snapshot(std::vector<uint32_t>& indices) const;
+
+        private:
+            struct Entry {
+                float error;
+                uint32_t vertex;
+                uint32_t version;
+
+                bool operator<(const Entry& other) const { return error > other.error; }  // Cheapest on top
+            };
+
+            struct Candidate {
+                float error;
+                uint32_t target;
+
+                bool operator<(const Candidate& other) const { return error < other.error; }
+            };
+
+            struct Pass {
+                uint32_t region = WHOLE_MESH;
+                size_t live = 0;
+                size_t target = 0;
+                float maxError = 0.0f;
+                size_t unreported = 0;
+                std::priority_queue<Entry> heap;
+                std::vector<Candidate> candidates;
+                std::vector<uint32_t> ring, common, neighbours;
+            };
+
+            // Live corners of 'v'; dead ones are unlinked on the way
+            template<typename Func>
+            void forEachCorner(uint32_t v, Func&& func) {
+                uint32_t* link = &head_[v];
+                while (*link != INVALID) {
+                    uint32_t c = *link;
+                    if (dead_[c / 3]) {
+                        *link = corners_[c].next;
+                        continue;
+                    }
+                    func(c);
+                    link = &corners_[c].next;
+                }
+            }
+
+            bool owns(uint32_t region, uint32_t v) const {
+                return region == WHOLE_MESH || vertices_[v].owner == region;
+            }
+            bool isMovable(uint32_t region, uint32_t v) const {
+                return vertices_[v].kind <= Kind::Seam && owns(region, v);
+            }
+
+            bool hasWedgeEdge(uint32_t from, uint32_t to);
+            bool hasPositionEdge(uint32_t from, uint32_t to);
+            void classify(uint32_t root);
+            void accumulate(uint32_t v);
+
+            float positionError(uint32_t from, uint32_t to) const;
+            float attributeError(uint32_t from, uint32_t to) const;
+            bool canCollapse(uint32_t region, uint32_t from, uint32_t to) const;
+            float collapseError(uint32_t from, uint32_t to) const;
+            template<typename Func>
+            void forEachNeighbour(uint32_t v, Func&& func);
+            float computeCost(uint32_t region, uint32_t v, uint32_t& best);
+
+            bool isValid(Pass& pass, uint32_t from, uint32_t to);
+            size_t collapse(uint32_t from, uint32_t to);
+            size_t collapseWedge(uint32_t from, uint32_t to);
+            void update(Pass& pass, uint32_t v, uint32_t from, uint32_t to);
+
+            void run(Pass& pass);
+            void report(Pass& pass, bool flush);
+
+            size_t vertexCount_ = 0;
+            size_t attributeCount_ = 0;
+            float errorLimit_ = 0.0f;
+            bool lockBorders_ = false;
+
+            // Per vertex (position quadrics at the position's group id)
+            std::vector<VertexState> vertices_;
+            std::vector<uint32_t> sibling_;         // Ring of the vertices of one position
+            std::vector<uint32_t> openOut_, openIn_;    // Neighbours along the border or seam
+            std::vector<Quadric> positionQuadrics_, attributeQuadrics_;
+            std::vector<Gradient> gradients_;       // attributeCount_ per vertex
+            std::vector<uint32_t> head_;            // First corner
+            std::vector<uint32_t> version_;
+            std::vector<float> queued_;             // Cost of the vertex's live heap entry, or infinity
+            std::vector<uint32_t> best_;            // The collapse target that costs queued_
+            std::vector<uint32_t> stamp_;
+            uint32_t passStamp_ = 0;
+
+            // Per corner / triangle
+            std::vector<Corner> corners_;
+            std::vector<glm::vec3> normals_;        // Unit, as input (collapses keep triangle identity)
+            std::vector<uint8_t> dead_;
+
+            size_t live_ = 0;
+            float maxError_ = 0.0f;
+            size_t work_ = 1;
+            std::atomic<size_t> removed_{ 0 };
+            std::atomic<float>* progress_ = nullptr;
+        };
+
+        Collapser::Collapser(const MeshVertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount,
+            const Options& options, std::atomic<float>* progress)
+            : vertexCount_(vertexCount), lockBorders_(options.lockBorders), progress_(progress) {
+
+            JobSystem& jobs = JobSystem::instance();
+            float limit = std::min(options.targetError, 1e18f);
+            errorLimit_ = limit * limit;
+
+            // Positions into the unit cube, so errors are relative to the extent
+            glm::vec3 boundsMin = vertices[0].position, boundsMax = vertices[0].position;
+            for (size_t v = 1; v < vertexCount; ++v) {
+                boundsMin = glm::min(boundsMin, vertices[v].position);
+                boundsMax = glm::max(boundsMax, vertices[v].position);
+            }
+            glm::vec3 size = boundsMax - boundsMin;
+            float extent = std::max(size.x, std::max(size.y, size.z));
+            float scale = extent > 0.0f ? 1.0f / extent : 1.0f;
+
+            vertices_.resize(vertexCount);
+            for (size_t v = 0; v < vertexCount; ++v) vertices_[v].position = (vertices[v].position - boundsMin) * scale;
+
+            // Attributes that vary (constant ones cost nothing to keep)
+            struct Source { size_t offset; int components; float weight; };
+            Source sources[] = {
+                { offsetof(MeshVertex, normal), 3, options.normalWeight },
+                { offsetof(MeshVertex, uv), 2, options.uvWeight },
+                { offsetof(MeshVertex, color), 3, options.colorWeight },
+            };
+            auto component = [&](size_t v, const Source& s, int k) {
+                const float* values = reinterpret_cast<const float*>(reinterpret_cast<const char*>(&vertices[v]) + s.offset);
+                return values[k];
+            };
+            std::vector<std::pair<const Source*, int>> used;
+            for (const Source& s : sources) {
+                if (!(s.weight > 0.0f) || used.size() + s.components > MAX_ATTRIBUTES) continue;
+                bool varies = false;
+                for (size_t v = 1; v < vertexCount && !varies; ++v) {
+                    for (int k = 0; k < s.components; ++k) varies |= component(v, s, k) != component(0, s, k);
+                }
+                if (!varies) continue;
+                for (int k = 0; k < s.components; ++k) used.emplace_back(&s, k);
+            }
+            attributeCount_ = used.size();
+            for (size_t v = 0; v < vertexCount; ++v) {
+                for (size_t a = 0; a < attributeCount_; ++a) {
+                    vertices_[v].attributes[a] = component(v, *used[a].first, used[a].second) * used[a].first->weight;
+                }
+            }
+
+            // Welded positions, each a ring of its vertices
+            std::vector<uint32_t> groups = MeshOptimizer::weldPositions(&vertices[0].position, sizeof(MeshVertex), vertexCount);
+            sibling_.resize(vertexCount);
+            for (size_t v = 0; v < vertexCount; ++v) {
+                vertices_[v].group = groups[v];
+                uint32_t root = vertices_[v].group;
+                if (root == v) {
+                    sibling_[v] = static_cast<uint32_t>(v);
+                }
+                else {
+                    sibling_[v] = sibling_[root];
+                    sibling_[root] = static_cast<uint32_t>(v);
+                }
+            }
+
+            // Triangles that are degenerate once welded draw nothing: dropped
+            size_t triangleCount = indexCount / 3;
+            corners_.resize(triangleCount * 3);
+            for (size_t c = 0; c < triangleCount * 3; ++c) corners_[c].vertex = indices[c];
+            dead_.assign(triangleCount, 0);
+            for (size_t t = 0; t < triangleCount; ++t) {
+                uint32_t a = vertices_[corners_[t * 3].vertex].group, b = vertices_[corners_[t * 3 + 1].vertex].group, c = vertices_[corners_[t * 3 + 2].vertex].group;
+                dead_[t] = a == b || b == c || a == c;
+                live_ += !dead_[t];
+            }
+
+            normals_.resize(triangleCount);
+            jobs.parallelFor(triangleCount, 8192, [&](size_t begin, size_t end) {
+                for (size_t t = begin; t < end; ++t) {
+                    const glm::vec3& p0 = vertices_[corners_[t * 3].vertex].position;
+                    glm::vec3 normal = glm::cross(vertices_[corners_[t * 3 + 1].vertex].position - p0, vertices_[corners_[t * 3 + 2].vertex].position - p0);
+                    float length = glm::length(normal);
+                    normals_[t] = length > 0.0f ? normal / length : glm::vec3(0.0f);
+                }
+                });
+
+            head_.assign(vertexCount, INVALID);
+            for (size_t c = triangleCount * 3; c-- > 0;) {
+                if (dead_[c / 3]) continue;
+                uint32_t v = corners_[c].vertex;
+                corners_[c].next = head_[v];
+                head_[v] = static_cast<uint32_t>(c);
+            }
+
+            openOut_.assign(vertexCount, INVALID);
+            openIn_.assign(vertexCount, INVALID);
+            jobs.parallelFor(vertexCount, 4096, [&](size_t begin, size_t end) {
+                for (size_t v = begin; v < end; ++v) {
+                    if (vertices_[v].group == v) classify(static_cast<uint32_t>(v));
+                }
+                });
+
+            positionQuadrics_.resize(vertexCount);
+            attributeQuadrics_.resize(vertexCount);
+            gradients_.resize(vertexCount * attributeCount_);
+            jobs.parallelFor(vertexCount, 4096, [&](size_t begin, size_t end) {
+                for (size_t v = begin; v < end; ++v) accumulate(static_cast<uint32_t>(v));
+                });
+
+            version_.assign(vertexCount, 0);
+            queued_.assign(vertexCount, std::numeric_limits<float>::infinity());
+            best_.assign(vertexCount, INVALID);
+            stamp_.assign(vertexCount, 0);
+        }
+
+        bool Collapser::hasWedgeEdge(uint32_t from, uint32_t to) {
+            bool found = false;
+            forEachCorner(from, [&](uint32_t c) { found |= corners_[nextCorner(c)].vertex == to; });
+            return found;
+        }
+
+        bool Collapser::hasPositionEdge(uint32_t from, uint32_t to) {
+            uint32_t target = vertices_[to].group;
+            bool found = false;
+            uint32_t w = from;
+            do {
+                forEachCorner(w, [&](uint32_t c) { found |= vertices_[corners_[nextCorner(c)].vertex].group == target; });
+                w = sibling_[w];
+            } while (w != from && !found);
+            return found;
+        }
+
+        // Kind of the position 'root' (and of its vertices), from the open
+        // edges around it: open in position space (a border) or only
+        // between vertices (a seam)
+        void Collapser::classify(uint32_t root) {
+            size_t wedges = 0, borderOut = 0, borderIn = 0;
+            bool seamLike = true;
+            uint32_t w = root;
+            do {
+                size_t seamOut = 0, seamIn = 0;
+                forEachCorner(w, [&](uint32_t c) {
+                    uint32_t next = corners_[nextCorner(c)].vertex, prev = corners_[prevCorner(c)].vertex;
+                    if (!hasWedgeEdge(next, w)) {
+                        ++seamOut;
+                        openOut_[w] = next;
+                        borderOut += !hasPositionEdge(next, w);
+                    }
+                    if (!hasWedgeEdge(w, prev)) {
+                        ++seamIn;
+                        openIn_[w] = prev;
+                        borderIn += !hasPositionEdge(w, prev);
+                    }
+                    });
+                seamLike &= seamOut == 1 && seamIn == 1;
+                if (head_[w] == INVALID) seamLike = false;
+                ++wedges;
+                w = sibling_[w];
+            } while (w != root);
+
+            Kind kind = Kind::Locked;
+            if (wedges == 1 && head_[root] != INVALID) {
+                if (openOut_[root] == INVALID && openIn_[root] == INVALID) kind = Kind::Manifold;
+                else if (seamLike && borderOut == 1 && borderIn == 1 && !lockBorders_) kind = Kind::Border;
+            }
+            else if (wedges == 2 && seamLike && borderOut == 0 && borderIn == 0) {
+                kind = Kind::Seam;
+            }
+
+            w = root;
+            do {
+                vertices_[w].kind = kind;
+                w = sibling_[w];
+            } while (w != root);
+        }
+
+        // Quadrics of the triangles around 'v': its position's (at the
+        // group's first vertex), plus border planes, and its attributes'
+        void Collapser::accumulate(uint32_t v) {
+            bool root = vertices_[v].group == v;
+            Quadric& positionQuadric = positionQuadrics_[vertices_[v].group];
+            Quadric& attributeQuadric = attributeQuadrics_[v];
+            Gradient* gradients = attributeCount_ ? &gradients_[v * attributeCount_] : nullptr;
+
+            auto corners = [&](uint32_t w, auto&& func) {
+                for (uint32_t c = head_[w]; c != INVALID; c = corners_[c].next) func(c);
+            };
+
+            // Attributes: each triangle's linear interpolation, weighted by area
+            corners(v, [&](uint32_t c) {
+                uint32_t t = c / 3;
+                const glm::vec3& p0 = vertices_[corners_[t * 3].vertex].position;
+                glm::vec3 e1 = vertices_[corners_[t * 3 + 1].vertex].position - p0, e2 = vertices_[corners_[t * 3 + 2].vertex].position - p0;
+                float area = 0.5f * glm::length(glm::cross(e1, e2));
+                float d00 = glm::dot(e1, e1), d01 = glm::dot(e1, e2), d11 = glm::dot(e2, e2);
+                float denominator = d00 * d11 - d01 * d01;
+                if (!(area > 0.0f) || !(denominator > 0.0f) || attributeCount_ == 0) return;
+
+                attributeQuadric.w += area;
+                float inverse = 1.0f / denominator;
+                const float* a0 = vertices_[corners_[t * 3].vertex].attributes;
+                const float* a1 = vertices_[corners_[t * 3 + 1].vertex].attributes;
+                const float* a2 = vertices_[corners_[t * 3 + 2].vertex].attributes;
+                for (size_t k = 0; k < attributeCount_; ++k) {
+                    float delta1 = a1[k] - a0[k], delta2 = a2[k] - a0[k];
+                    glm::vec3 g = ((d11 * delta1 - d01 * delta2) * e1 + (d00 * delta2 - d01 * delta1) * e2) * inverse;
+                    float d = a0[k] - glm::dot(g, p0);
+                    attributeQuadric.addSquare(g, d, area);
+                    gradients[k].g += g * area;
+                    gradients[k].d += d * area;
+                }
+                });
+
+            if (!root) return;
+
+            // Position: every vertex of the position contributes its triangles
+            uint32_t w = v;
+            do {
+                corners(w, [&](uint32_t c) {
+                    uint32_t t = c / 3;
+                    const glm::vec3& p0 = vertices_[corners_[t * 3].vertex].position;
+                    glm::vec3 normal = glm::cross(vertices_[corners_[t * 3 + 1].vertex].position - p0, vertices_[corners_[t * 3 + 2].vertex].position - p0);
+                    float length = glm::length(normal);
+                    if (!(length > 0.0f)) return;
+                    normal /= length;
+                    positionQuadric.addPlane(normal, -glm::dot(normal, p0), 0.5f * length);
+
+                    // Border edges hold their line: a plane through the edge,
+                    // at right angles to the triangle
+                    if (vertices_[v].kind != Kind::Border && vertices_[v].kind != Kind::Locked) return;
+                    uint32_t next = corners_[nextCorner(c)].vertex, prev = corners_[prevCorner(c)].vertex;
+                    auto borderPlane = [&](uint32_t a, uint32_t b) {
+                        glm::vec3 edge = vertices_[b].position - vertices_[a].position;
+                        glm::vec3 perpendicular = glm::cross(edge, normal);
+                        float edgeLength = glm::length(perpendicular);
+                        if (!(edgeLength > 0.0f)) return;
+                        perpendicular /= edgeLength;
+                        positionQuadric.addPlane(perpendicular, -glm::dot(perpendicular, vertices_[a].position), BORDER_WEIGHT * edgeLength * edgeLength);
+                    };
+                    if (!hasPositionEdge(next, w)) borderPlane(w, next);
+                    if (!hasPositionEdge(w, prev)) borderPlane(prev, w);
+                    });
+                w = sibling_[w];
+            } while (w != v);
+        }
+
+        float Collapser::positionError(uint32_t from, uint32_t to) const {
+            const Quadric& q = positionQuadrics_[vertices_[from].group];
+            return q.w > 0.0f ? std::abs(q.evaluate(vertices_[to].position)) / q.w : 0.0f;
+        }
+
+        // Attributes of 'to' at its position, against the planes of 'from'
+        float Collapser::attributeError(uint32_t from, uint32_t to) const {
+            const Quadric& q = attributeQuadrics_[from];
+            if (attributeCount_ == 0 || !(q.w > 0.0f)) return 0.0f;
+
+            const glm::vec3& p = vertices_[to].position;
+            const float* a = vertices_[to].attributes;
+            const Gradient* gradients = &gradients_[from * attributeCount_];
+            float error = q.evaluate(p);
+            for (size_t k = 0; k < attributeCount_; ++k) {
+                error += a[k] * a[k] * q.w - 2.0f * a[k] * (glm::dot(gradients[k].g, p) + gradients[k].d);
+            }
+            return std::abs(error) / q.w;
+        }
+
+        bool Collapser::canCollapse(uint32_t region, uint32_t from, uint32_t to) const {
+            if (to == from || vertices_[to].kind == Kind::Removed || vertices_[to].group == vertices_[from].group || !owns(region, to)) return false;
+
+            switch (vertices_[from].kind) {
+            case Kind::Manifold:
+                return true;
+            case Kind::Border:
+                return vertices_[to].kind == Kind::Border && (openOut_[from] == to || openIn_[from] == to) && openOut_[from] != openIn_[from];
+            case Kind::Seam: {
+                if (vertices_[to].kind != Kind::Seam || (openOut_[from] != to && openIn_[from] != to)) return false;
+                uint32_t fromSibling = sibling_[from], toSibling = sibling_[to];
+                return openOut_[fromSibling] == toSibling || openIn_[fromSibling] == toSibling;
+            }
+            default:
+                return false;
+            }
+        }
+
+        float Collapser::collapseError(uint32_t from, uint32_t to) const {
+            float error = positionError(from, to) + attributeError(from, to);
+            if (vertices_[from].kind == Kind::Seam) error += attributeError(sibling_[from], sibling_[to]);
+            return error;
+        }
+
+        // Around a manifold vertex every neighbour follows it in some
+        // triangle; elsewhere the last one along an open edge only precedes
+        template<typename Func>
+        void Collapser::forEachNeighbour(uint32_t v, Func&& func) {
+            bool open = vertices_[v].kind != Kind::Manifold;
+            forEachCorner(v, [&](uint32_t c) {
+                func(corners_[nextCorner(c)].vertex);
+                if (open) func(corners_[prevCorner(c)].vertex);
+                });
+        }
+
+        float Collapser::computeCost(uint32_t region, uint32_t v, uint32_t& best) {
+            float cost = std::numeric_limits<float>::infinity();
+            best = INVALID;
+            forEachNeighbour(v, [&](uint32_t to) {
+                if (!canCollapse(region, v, to)) return;
+                float error = collapseError(v, to);
+                if (error < cost) {
+                    cost = error;
+                    best = to;
+                }
+                });
+            return cost;
+        }
+
+        // No triangle may turn far from its input normal (so turns do not
+        // add up to a fold), and the endpoints may only share the neighbours
+        // opposite the edge (or the collapse pinches two sheets)
+        bool Collapser::isValid(Pass& pass, uint32_t from, uint32_t to) {
+            uint32_t fromGroup = vertices_[from].group, toGroup = vertices_[to].group;
+            const glm::vec3& target = vertices_[to].position;
+
+            bool valid = true;
+            size_t shared = 0;
+            pass.ring.clear();
+            uint32_t w = from;
+            do {
+                forEachCorner(w, [&](uint32_t c) {
+                    uint32_t next = corners_[nextCorner(c)].vertex, prev = corners_[prevCorner(c)].vertex;
+                    pass.ring.push_back(vertices_[next].group);
+                    pass.ring.push_back(vertices_[prev].group);
+                    if (vertices_[next].group == toGroup || vertices_[prev].group == toGroup) {
+                        ++shared;
+                        return;
+                    }
+                    glm::vec3 a = vertices_[next].position, b = vertices_[prev].position;
+                    glm::vec3 after = glm::cross(a - target, b - target);
+                    if (glm::dot(after, normals_[c / 3]) <= MIN_NORMAL_DOT * glm::length(after)) valid = false;
+                    });
+                w = sibling_[w];
+            } while (w != from && valid);
+            if (!valid) return false;
+
+            std::sort(pass.ring.begin(), pass.ring.end());
+            pass.common.clear();
+            w = to;
+            do {
+                forEachCorner(w, [&](uint32_t c) {
+                    for (uint32_t n : { vertices_[corners_[nextCorner(c)].vertex].group, vertices_[corners_[prevCorner(c)].vertex].group }) {
+                        if (n != fromGroup && std::binary_search(pass.ring.begin(), pass.ring.end(), n)) pass.common.push_back(n);
+                    }
+                    });
+                w = sibling_[w];
+            } while (w != to);
+            std::sort(pass.common.begin(), pass.common.end());
+            size_t common = std::unique(pass.common.begin(), pass.common.end()) - pass.common.begin();
+            return common <= shared;
+        }
+
+        // Moves 'from' onto 'to'; returns the triangles that died
+        size_t Collapser::collapseWedge(uint32_t from, uint32_t to) {
+            // Border and seam chains skip over 'from'
+            if (vertices_[from].kind == Kind::Border || vertices_[from].kind == Kind::Seam) {
+                if (openOut_[from] == to) {
+                    uint32_t prev = openIn_[from];
+                    openIn_[to] = prev;
+                    if (prev != INVALID) openOut_[prev] = to;
+                }
+                else if (openIn_[from] == to) {
+                    uint32_t next = openOut_[from];
+                    openOut_[to] = next;
+                    if (next != INVALID) openIn_[next] = to;
+                }
+            }
+
+            size_t killed = 0;
+            uint32_t last = INVALID;
+            for (uint32_t c = head_[from]; c != INVALID; c = corners_[c].next) {
+                last = c;
+                uint32_t t = c / 3;
+                if (dead_[t]) continue;
+                if (corners_[t * 3].vertex == to || corners_[t * 3 + 1].vertex == to || corners_[t * 3 + 2].vertex == to) {
+                    dead_[t] = 1;
+                    ++killed;
+                }
+                else {
+                    corners_[c].vertex = to;
+                }
+            }
+            if (last != INVALID) {
+                corners_[last].next = head_[to];
+                head_[to] = head_[from];
+                head_[from] = INVALID;
+            }
+
+            attributeQuadrics_[to].add(attributeQuadrics_[from]);
+            for (size_t k = 0; k < attributeCount_; ++k) {
+                gradients_[to * attributeCount_ + k].g += gradients_[from * attributeCount_ + k].g;
+                gradients_[to * attributeCount_ + k].d += gradients_[from * attributeCount_ + k].d;
+            }
+            vertices_[from].kind = Kind::Removed;
+            return killed;
+        }
+
+        size_t Collapser::collapse(uint32_t from, uint32_t to) {
+            positionQuadrics_[vertices_[to].group].add(positionQuadrics_[vertices_[from].group]);
+            if (vertices_[from].kind == Kind::Seam) {
+                uint32_t fromSibling = sibling_[from], toSibling = sibling_[to];
+                return collapseWedge(from, to) + collapseWedge(fromSibling, toSibling);
+            }
+            return collapseWedge(from, to);
+        }
+
+        // After 'from' moved onto 'to'. A manifold neighbour's errors to its
+        // other neighbours stand (its quadric and their positions are as
+        // they were): only 'to' is new, unless its best was at 'from'
+        void Collapser::update(Pass& pass, uint32_t v, uint32_t from, uint32_t to) {
+            if (!isMovable(pass.region, v)) return;
+            float cost;
+            uint32_t best;
+            if (vertices_[v].kind == Kind::Manifold && best_[v] != INVALID && vertices_[best_[v]].group != vertices_[from].group && vertices_[v].group != vertices_[to].group) {
+                cost = queued_[v];
+                best = best_[v];
+                if (canCollapse(pass.region, v, to)) {
+                    float error = collapseError(v, to);
+                    if (error < cost) {
+                        cost = error;
+                        best = to;
+                    }
+                }
+            }
+            else {
+                cost = computeCost(pass.region, v, best);
+            }
+            best_[v] = best;
+            if (cost == queued_[v]) return;     // Its entry still stands
+            queued_[v] = cost;
+            ++version_[v];
+            if (cost < std::numeric_limits<float>::infinity()) pass.heap.push({ cost, v, version_[v] });
+        }
+
+        void Collapser::report(Pass& pass, bool flush) {
+            if (pass.unreported < PROGRESS_INTERVAL && !(flush && pass.unreported > 0)) return;
+            size_t removed = removed_.fetch_add(pass.unreported, std::memory_order_relaxed) + pass.unreported;
+            pass.unreported = 0;
+            if (progress_) progress_->store(std::min(1.0f, static_cast<float>(removed) / work_), std::memory_order_relaxed);
+        }
+
+        void Collapser::run(Pass& pass) {
+            while (pass.live > pass.target && !pass.heap.empty()) {
+                Entry entry = pass.heap.top();
+                pass.heap.pop();
+                uint32_t v = entry.vertex;
+                if (entry.version != version_[v] || !isMovable(pass.region, v)) continue;
+                if (entry.error > errorLimit_) break;
+                uint32_t best = best_[v];
+                queued_[v] = std::numeric_limits<float>::infinity();
+                best_[v] = INVALID;
+
+                // Usually the entry's own target; else the cheapest valid
+                // collapse, and a dearer one goes back in line
+                uint32_t target = INVALID;
+                if (best != INVALID && canCollapse(pass.region, v, best) && isValid(pass, v, best)) target = best;
+                pass.candidates.clear();
+                if (target == INVALID) {
+                    forEachNeighbour(v, [&](uint32_t to) {
+                        if (to != best && canCollapse(pass.region, v, to)) pass.candidates.push_back({ collapseError(v, to), to });
+                        });
+                    std::sort(pass.candidates.begin(), pass.candidates.end());
+                }
+
+                for (const Candidate& candidate : pass.candidates) {
+                    if (candidate.error > entry.error) {
+                        queued_[v] = candidate.error;
+                        best_[v] = candidate.target;
+                        pass.heap.push({ candidate.error, v, entry.version });
+                        break;
+                    }
+                    if (isValid(pass, v, candidate.target)) {
+                        target = candidate.target;
+                        break;
+                    }
+                }
+                if (target == INVALID) continue;
+
+                // Costs change for the target's position (its quadric grew)
+                // and for the moved vertices' neighbours (they gained the
+                // target and lost the vertex); other neighbours of the
+                // target keep theirs, a half-edge collapse moves nothing
+                pass.neighbours.clear();
+                uint32_t w = v;
+                do {
+                    forEachCorner(w, [&](uint32_t c) {
+                        pass.neighbours.push_back(corners_[nextCorner(c)].vertex);
+                        pass.neighbours.push_back(corners_[prevCorner(c)].vertex);
+                        });
+                    w = sibling_[w];
+                } while (w != v);
+                w = target;
+                do {
+                    pass.neighbours.push_back(w);
+                    w = sibling_[w];
+                } while (w != target);
+                std::sort(pass.neighbours.begin(), pass.neighbours.end());
+                pass.neighbours.erase(std::unique(pass.neighbours.begin(), pass.neighbours.end()), pass.neighbours.end());
+
+                size_t killed = collapse(v, target);
+                pass.live -= std::min(killed, pass.live);
+                pass.unreported += killed;
+                pass.maxError = std::max(pass.maxError, entry.error);
+                report(pass, false);
+
+                for (uint32_t n : pass.neighbours) update(pass, n, v, target);
+            }
+            report(pass, true);
+        }
+
+        void Collapser::runRegions(size_t target) {
+            JobSystem& jobs = JobSystem::instance();
+            if (live_ <= target || live_ < PARALLEL_TRIANGLES || jobs.getWorkerCount() == 0) return;
+
+            std::vector<uint32_t> order;
+            order.reserve(live_);
+            for (size_t t = 0; t < dead_.size(); ++t) {
+                if (!dead_[t]) order.push_back(static_cast<uint32_t>(t));
+            }
+            std::vector<glm::vec3> centroids(dead_.size());
+            jobs.parallelFor(order.size(), 8192, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    uint32_t t = order[i];
+                    centroids[t] = vertices_[corners_[t * 3].vertex].position + vertices_[corners_[t * 3 + 1].vertex].position + vertices_[corners_[t * 3 + 2].vertex].position;
+                }
+                });
+
+            // Median splits across the longest axis, two regions per thread
+            uint32_t depth = 0;
+            while ((size_t(1) << depth) < 2 * (jobs.getWorkerCount() + 1)) ++depth;
+            std::vector<size_t> bounds{ 0 };
+            auto split = [&](auto&& self, size_t begin, size_t end, uint32_t level) -> void {
+                if (level == 0 || end - begin < 2) {
+                    bounds.push_back(end);
+                    return;
+                }
+                glm::vec3 lo = centroids[order[begin]], hi = lo;
+                for (size_t i = begin + 1; i < end; ++i) {
+                    lo = glm::min(lo, centroids[order[i]]);
+                    hi = glm::max(hi, centroids[order[i]]);
+                }
+                glm::vec3 size = hi - lo;
+                int axis = size.x >= size.y && size.x >= size.z ? 0 : (size.y >= size.z ? 1 : 2);
+                size_t mid = begin + (end - begin) / 2;
+                std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+                    [&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+                self(self, begin, mid, level - 1);
+                self(self, mid, end, level - 1);
+            };
+            split(split, 0, order.size(), depth);
+            size_t regionCount = bounds.size() - 1;
+
+            // Positions with triangles in two regions wait for the whole-mesh
+            // pass (decided at the group's first vertex, then copied)
+            for (VertexState& vertex : vertices_) vertex.owner = INVALID;
+            for (size_t r = 0; r < regionCount; ++r) {
+                for (size_t i = bounds[r]; i < bounds[r + 1]; ++i) {
+                    for (int k = 0; k < 3; ++k) {
+                        uint32_t& owner = vertices_[vertices_[corners_[order[i] * 3 + k].vertex].group].owner;
+                        owner = owner == INVALID || owner == r ? static_cast<uint32_t>(r) : SHARED;
+                    }
+                }
+            }
+            jobs.parallelFor(vertexCount_, 8192, [&](size_t begin, size_t end) {
+                for (size_t v = begin; v < end; ++v) {
+                    if (vertices_[v].group != v) vertices_[v].owner = vertices_[vertices_[v].group].owner;
+                }
+                });
+
+            ++passStamp_;
+            std::vector<float> errors(regionCount, 0.0f);
+            std::vector<size_t> lives(regionCount, 0);
+            jobs.parallelFor(regionCount, 1, [&](size_t begin, size_t end) {
+                for (size_t r = begin; r < end; ++r) {
+                    Pass pass;
+                    pass.region = static_cast<uint32_t>(r);
+                    pass.live = bounds[r + 1] - bounds[r];
+                    pass.target = static_cast<size_t>(static_cast<double>(pass.live) * target / live_);
+
+                    std::vector<Entry> entries;
+                    for (size_t i = bounds[r]; i < bounds[r + 1]; ++i) {
+                        for (int k = 0; k < 3; ++k) {
+                            uint32_t v = corners_[order[i] * 3 + k].vertex;
+                            if (stamp_[v] == passStamp_ || !isMovable(pass.region, v)) continue;
+                            stamp_[v] = passStamp_;
+                            float cost = computeCost(pass.region, v, best_[v]);
+                            queued_[v] = cost;
+                            if (cost < std::numeric_limits<float>::infinity()) entries.push_back({ cost, v, ++version_[v] });
+                        }
+                    }
+                    pass.heap = std::priority_queue<Entry>(std::less<Entry>(), std::move(entries));
+
+                    run(pass);
+                    errors[r] = pass.maxError;
+                    lives[r] = pass.live;
+                }
+                });
+
+            live_ = 0;
+            for (size_t r = 0; r < regionCount; ++r) {
+                live_ += lives[r];
+                maxError_ = std::max(maxError_, errors[r]);
+            }
+            for (VertexState& vertex : vertices_) vertex.owner = WHOLE_MESH;
+        }
+
+        void Collapser::runWholeMesh(size_t target) {
+            if (live_ <= target) return;
+
+            std::vector<float> costs(vertexCount_, std::numeric_limits<float>::infinity());
+            JobSystem::instance().parallelFor(vertexCount_, 4096, [&](size_t begin, size_t end) {
+                for (size_t v = begin; v < end; ++v) {
+                    if (isMovable(WHOLE_MESH, static_cast<uint32_t>(v))) costs[v] = computeCost(WHOLE_MESH, static_cast<uint32_t>(v), best_[v]);
+                }
+                });
+
+            std::vector<Entry> entries;
+            for (size_t v = 0; v < vertexCount_; ++v) {
+                queued_[v] = costs[v];
+                if (costs[v] < std::numeric_limits<float>::infinity()) {
+                    entries.push_back({ costs[v], static_cast<uint32_t>(v), ++version_[v] });
+                }
+            }
+
+            Pass pass;
+            pass.live = live_;
+            pass.target = target;
+            pass.heap = std::priority_queue<Entry>(std::less<Entry>(), std::move(entries));
+            run(pass);
+            live_ = pass.live;
+            maxError_ = std::max(maxError_, pass.maxError);
+        }
+
+        void Collapser::snapshot(std::vector<uint32_t>& indices) const {
+            indices.clear();
+            indices.reserve(live_ * 3);
+            for (size_t t = 0; t < dead_.size(); ++t) {
+                if (dead_[t]) continue;
+                for (int k = 0; k < 3; ++k) indices.push_back(corners_[t * 3 + k].vertex);
+            }
+        }
+
+    } // namespace
+
+    std::vector<Level> simplify(const MeshVertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount,
+        const std::vector<size_t>& targetIndexCounts, const Options& options, std::atomic<float>* progress) {
+        std::vector<Level> levels;
+        if (vertexCount == 0 || indexCount < 3 || targetIndexCounts.empty()) return levels;
+        for (size_t i = 0; i < indexCount; ++i) {
+            if (indices[i] >= vertexCount) return levels;
+        }
+
+        Collapser collapser(vertices, vertexCount, indices, indexCount, options, progress);
+        size_t start = collapser.getLiveTriangles();
+        collapser.setWork(start - std::min(start, targetIndexCounts.back() / 3));
+
+        for (size_t targetIndexCount : targetIndexCounts) {
+            size_t target = targetIndexCount / 3;
+            collapser.runRegions(target);
+            collapser.runWholeMesh(target);
+
+            Level level;
+            collapser.snapshot(level.indices);
+            level.error = collapser.getError();
+            levels.push_back(std::move(level));
+        }
+        if (progress) progress->store(1.0f, std::memory_order_relaxed);
+        return levels;
+    }
+
+} // namespace Simplifier
+} // namespace libre
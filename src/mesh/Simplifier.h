@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../components/CoreComponents.h"
+
+#include <vector>
+#include <atomic>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+
+namespace libre {
+
+    // ============================================================================
+    // SIMPLIFIER - Quadric error edge collapse (Garland & Heckbert 1997)
+    // ============================================================================
+    // Every vertex carries a quadric: the sum of the squared distances to
+    // the planes of its triangles (area weighted). Collapsing a vertex into
+    // a neighbour costs its quadric evaluated there, and hands the quadric
+    // on, so the error measures distance to the original surface. The
+    // cheapest collapse always goes first (a priority queue of vertices,
+    // invalidated lazily by version).
+    //
+    // Collapses are half-edge: the vertex moves onto its neighbour, so no
+    // vertex is created or moved and every level indexes the input vertex
+    // buffer. Attributes are error too (Hoppe 1999): each triangle adds the
+    // squared difference to its linear interpolation of normal, UV and
+    // colour, scaled by the Options weights.
+    //
+    // Vertices that share a position (attribute seams) share one position
+    // quadric. Per position:
+    // - Manifold (one vertex, every edge paired): collapses anywhere.
+    // - Border (open edge in and out): only along the border, into another
+    //   border vertex. Border edges also add a plane quadric at right angles
+    //   to their triangle, so the outline keeps its shape.
+    // - Seam (two vertices, split along the seam): both collapse together,
+    //   along the seam, into another seam position.
+    // - Anything else (corners of several seams, non-manifold): locked.
+    // A collapse is also refused if it turns a triangle too far from its
+    // input normal (a fold, even over several collapses), or would join two
+    // sheets (the edge's endpoints share more neighbours than the edge's
+    // own triangles have).
+    //
+    // Large meshes are split into spatial regions simplified side by side
+    // on the JobSystem; positions shared by two regions are left for a
+    // final pass over the whole mesh, which also settles the exact count.
+
+    namespace Simplifier {
+
+        struct Options {
+            float targetError = std::numeric_limits<float>::max();  // Relative to the mesh extent
+            float normalWeight = 0.5f;      // Per attribute error scale; 0 ignores it
+            float uvWeight = 1.0f;
+            float colorWeight = 0.5f;
+            bool lockBorders = false;       // Keep open borders exactly (e.g. tiles that must meet)
+        };
+
+        struct Level {
+            std::vector<uint32_t> indices;  // Into the input vertices
+            float error = 0.0f;             // Largest collapse so far, relative to the mesh extent
+        };
+
+        // Above this many triangles the regions run in parallel
+        constexpr size_t PARALLEL_TRIANGLES = 65536;
+
+        // Collapses until each of 'targetIndexCounts' (largest first) is
+        // reached and snapshots a level there. A level stops short when the
+        // next collapse would pass targetError, or nothing collapses any
+        // more. 'progress' (when given) runs from 0 to 1.
+        std::vector<Level> simplify(const MeshVertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount,
+            const std::vector<size_t>& targetIndexCounts, const Options& options = {}, std::atomic<float>* progress = nullptr);
+
+    } // namespace Simplifier
+
+} // namespace libre
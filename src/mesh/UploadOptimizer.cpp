@@ -0,0 +1,170 @@
+#include "UploadOptimizer.h"
+#include "MeshOptimizer.h"
+#include "VertexPacking.h"
+#include "../core/JobSystem.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace libre {
+
+    namespace {
+
+        constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+        constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+
+        uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+        uint64_t mixLane(uint64_t lane, uint64_t word) {
+            return rotl(lane + word * PRIME2, 31) * PRIME1;
+        }
+
+        uint64_t finish(uint64_t hash, size_t size, int shift1, int shift2) {
+            hash ^= size;
+            hash ^= hash >> shift1;
+            hash *= PRIME2;
+            hash ^= hash >> shift2;
+            return hash;
+        }
+
+        // Four independent lanes over 8-byte words, so the multiplies
+        // overlap. 'check' folds the same lanes another way: a second 64
+        // bits that must agree when two hashes do.
+        uint64_t hashBytes(const void* data, size_t size, uint64_t seed, uint64_t& check) {
+            const char* bytes = static_cast<const char*>(data);
+            uint64_t lanes[4] = { seed + PRIME1 + PRIME2, seed + PRIME2, check, check - PRIME1 };
+
+            size_t i = 0;
+            for (; i + 32 <= size; i += 32) {
+                uint64_t words[4];
+                std::memcpy(words, bytes + i, 32);
+                for (int l = 0; l < 4; ++l) lanes[l] = mixLane(lanes[l], words[l]);
+            }
+
+            uint64_t hash = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+            uint64_t other = rotl(lanes[3], 5) ^ rotl(lanes[2], 23) ^ rotl(lanes[1], 41) ^ lanes[0];
+            for (; i < size; ++i) {
+                hash = mixLane(hash, static_cast<unsigned char>(bytes[i]));
+                other = mixLane(other, static_cast<unsigned char>(bytes[i]) + 1);
+            }
+
+            check = finish(other, size, 31, 27);
+            return finish(hash, size, 33, 29);
+        }
+
+    } // namespace
+
+    uint64_t UploadOptimizer::hashGeometry(const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices) {
+        return keyGeometry(vertices, indices).hash;
+    }
+
+    UploadOptimizer::Key UploadOptimizer::keyGeometry(const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices) {
+        Key key;
+        key.vertexCount = vertices.size();
+        key.indexCount = indices.size();
+        uint64_t hash = hashBytes(vertices.data(), vertices.size() * sizeof(MeshVertex), 0, key.check);
+        key.hash = hashBytes(indices.data(), indices.size() * sizeof(uint32_t), hash, key.check);
+        return key;
+    }
+
+    std::shared_ptr<const UploadOptimizer::Geometry> UploadOptimizer::optimize(std::vector<MeshVertex> vertices,
+        std::vector<uint32_t> indices) {
+        auto geometry = std::make_shared<Geometry>();
+        size_t vertexCount = vertices.size();
+        if (vertexCount == 0) return geometry;
+
+        geometry->acmrBefore = MeshOptimizer::computeACMR(indices.data(), indices.size(), vertexCount);
+        MeshOptimizer::optimizeVertexCache(indices.data(), indices.size(), vertexCount);
+        if (indices.size() / 3 >= MIN_MESHLET_TRIANGLES) {
+            auto meshlets = std::make_shared<MeshletData>(Meshlets::build(indices.data(), indices.size(),
+                &vertices[0].position, sizeof(MeshVertex), vertexCount));
+            if (!meshlets->meshlets.empty()) geometry->meshlets = std::move(meshlets);
+        }
+        else {
+            MeshOptimizer::optimizeOverdraw(indices.data(), indices.size(), &vertices[0].position, sizeof(MeshVertex), vertexCount);
+        }
+
+        std::vector<uint32_t> remap;
+        size_t usedCount = MeshOptimizer::optimizeVertexFetch(indices.data(), indices.size(), vertexCount, remap);
+        vertices = MeshOptimizer::remapVertices(vertices, remap, usedCount);
+        geometry->acmrAfter = MeshOptimizer::computeACMR(indices.data(), indices.size(), usedCount);
+        VertexPacking::pack(vertices.data(), vertices.size(), indices.data(), indices.size(), geometry->packed);
+        return geometry;
+    }
+
+    bool UploadOptimizer::prepare(MeshHandle handle, const std::vector<MeshVertex>& vertices,
+        const std::vector<uint32_t>& indices, uint64_t version, MeshUploadData& upload, std::shared_ptr<const MeshletData>* meshlets) {
+
+        auto known = handles_.find(handle);
+        if (known == handles_.end() || known->second.version != version ||
+            known->second.key.vertexCount != vertices.size() || known->second.key.indexCount != indices.size()) {
+            known = handles_.insert_or_assign(handle, Handle{ keyGeometry(vertices, indices), version }).first;
+        }
+        const Key& key = known->second.key;
+
+        // Different geometry under the same hash: step to the next slot
+        uint64_t slot = key.hash;
+        auto it = cache_.find(slot);
+        while (it != cache_.end() && !it->second.key.sameGeometry(key)) it = cache_.find(++slot);
+
+        if (it == cache_.end()) {
+            Entry entry;
+            entry.key = key;
+            entry.bytes = vertices.size() * sizeof(PackedVertex) + indices.size() * sizeof(uint32_t);
+            if (indices.size() < INLINE_INDEX_COUNT) {
+                std::promise<std::shared_ptr<const Geometry>> result;
+                result.set_value(optimize(vertices, indices));
+                entry.geometry = result.get_future().share();
+            }
+            else {
+                entry.geometry = JobSystem::instance().submit(
+                    [vertexCopy = vertices, indexCopy = indices]() mutable {
+                        return optimize(std::move(vertexCopy), std::move(indexCopy));
+                    }).share();
+            }
+
+            // Over budget: drop finished entries (handles still waiting on
+            // one simply start over)
+            if (cacheBytes_ + entry.bytes > MAX_CACHE_BYTES) {
+                for (auto e = cache_.begin(); e != cache_.end();) {
+                    if (e->second.geometry.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                        cacheBytes_ -= e->second.bytes;
+                        e = cache_.erase(e);
+                    }
+                    else {
+                        ++e;
+                    }
+                }
+            }
+            cacheBytes_ += entry.bytes;
+            it = cache_.emplace(slot, std::move(entry)).first;
+        }
+
+        Entry& entry = it->second;
+        if (entry.geometry.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+
+        const Geometry& geometry = *entry.geometry.get();
+        if (!entry.counted) {
+            entry.counted = true;
+            size_t triangles = geometry.packed.getIndexCount() / 3;
+            size_t total = stats_.triangles + triangles;
+            if (total > 0) {
+                stats_.acmrBefore = (stats_.acmrBefore * stats_.triangles + double(geometry.acmrBefore) * triangles) / total;
+                stats_.acmrAfter = (stats_.acmrAfter * stats_.triangles + double(geometry.acmrAfter) * triangles) / total;
+            }
+            stats_.triangles = total;
+            stats_.meshlets += geometry.meshlets ? geometry.meshlets->meshlets.size() : 0;
+            ++stats_.optimized;
+        }
+        else {
+            ++stats_.cacheHits;
+        }
+
+        upload = geometry.packed;
+        upload.entityId = handle;
+        upload.geometryKey = it->first;
+        if (meshlets) *meshlets = geometry.meshlets;
+        return true;
+    }
+
+} // namespace libre
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "../components/CoreComponents.h"
+#include "../core/FrameData.h"
+#include "Meshlets.h"
+
+#include <vector>
+#include <memory>
+#include <future>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace libre {
+
+    // ============================================================================
+    // UPLOAD OPTIMIZER - Cache-friendly index/vertex order before GPU upload
+    // ============================================================================
+    // Runs MeshOptimizer (vertex cache, overdraw, vertex fetch) on the
+    // geometry a MeshComponent or LOD level is about to upload. The CPU copy
+    // keeps its order; only the GPU buffers get the optimized one, packed
+    // by VertexPacking.
+    //
+    // Geometry is keyed by a hash of its vertex and index bytes: instances
+    // of one mesh (and the same LOD level on many entities) are optimized
+    // once. A hit must also match the counts and a second 64-bit check
+    // from the same pass; a colliding entry is stepped over, not reused. Large meshes are optimized by a JobSystem background job;
+    // prepare() returns false until it finishes, and the mesh uploads (and
+    // draws) from the frame after; an edited mesh draws its previous
+    // upload meanwhile.
+    //
+    // Meshes of MIN_MESHLET_TRIANGLES or more are also split into meshlets
+    // (for ClusterCuller). The meshlet order replaces the overdraw order:
+    // back-facing clusters of closed meshes are culled outright instead.
+
+    class UploadOptimizer {
+    public:
+        struct Stats {
+            size_t optimized = 0;           // Distinct geometries
+            size_t cacheHits = 0;           // Uploads that reused one
+            size_t triangles = 0;           // Over the optimized geometries
+            size_t meshlets = 0;
+            double acmrBefore = 0.0;        // Triangle-weighted averages
+            double acmrAfter = 0.0;
+        };
+
+        // Below this many indices the optimization runs inline
+        static constexpr size_t INLINE_INDEX_COUNT = 3 * 4096;
+
+        // Optimized cache entries are dropped (all at once) past this size
+        static constexpr size_t MAX_CACHE_BYTES = size_t(256) << 20;
+
+        // Smaller meshes draw in one call; splitting them saves nothing
+        static constexpr size_t MIN_MESHLET_TRIANGLES = 16 * Meshlets::MAX_TRIANGLES;
+
+        // Fills 'upload' for 'handle' once its optimized geometry is ready,
+        // and 'meshlets' (when given) with its meshlets or null. The
+        // geometry is hashed on the first call, and again only when
+        // 'version' (MeshComponent::geometryVersion) or a count changed,
+        // until release().
+        bool prepare(MeshHandle handle, const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices,
+            uint64_t version, MeshUploadData& upload, std::shared_ptr<const MeshletData>* meshlets = nullptr);
+
+        // The handle's upload was confirmed; its next prepare() rehashes
+        void release(MeshHandle handle) { handles_.erase(handle); }
+
+        // What a cache entry was built from, besides its hash (the map key)
+        struct Key {
+            uint64_t hash = 0;
+            uint64_t check = 0;
+            size_t vertexCount = 0;
+            size_t indexCount = 0;
+
+            bool sameGeometry(const Key& other) const {
+                return check == other.check && vertexCount == other.vertexCount && indexCount == other.indexCount;
+            }
+        };
+
+        static uint64_t hashGeometry(const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices);
+
+        // Hash, check and counts in one pass (also keys LODGenerator's chains)
+        static Key keyGeometry(const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices);
+
+        const Stats& getStats() const { return stats_; }
+
+    private:
+        struct Geometry {
+            MeshUploadData packed;          // Everything but entityId and geometryKey
+            std::shared_ptr<const MeshletData> meshlets;
+            float acmrBefore = 0.0f;
+            float acmrAfter = 0.0f;
+        };
+
+        struct Entry {
+            std::shared_future<std::shared_ptr<const Geometry>> geometry;
+            Key key;
+            size_t bytes = 0;
+            bool counted = false;
+        };
+
+        // Geometry key per handle between prepare() and release()
+        struct Handle {
+            Key key;
+            uint64_t version = 0;
+        };
+
+        static std::shared_ptr<const Geometry> optimize(std::vector<MeshVertex> vertices, std::vector<uint32_t> indices);
+
+        std::unordered_map<uint64_t, Entry> cache_;
+        std::unordered_map<MeshHandle, Handle> handles_;
+        size_t cacheBytes_ = 0;
+        Stats stats_;
+    };
+
+} // namespace libre
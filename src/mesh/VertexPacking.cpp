@@ -0,0 +1,147 @@
+#include "VertexPacking.h"
+#include "../core/JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace libre {
+namespace VertexPacking {
+
+    namespace {
+
+        float signNotZero(float v) { return v >= 0.0f ? 1.0f : -1.0f; }
+
+        int16_t toSnorm16(float v) {
+            return static_cast<int16_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f));
+        }
+
+        float fromSnorm16(int16_t v) {
+            return std::max(static_cast<float>(v) / 32767.0f, -1.0f);
+        }
+
+        uint8_t toUnorm8(float v) {
+            return static_cast<uint8_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+        }
+
+    } // namespace
+
+    void encodeNormal(const glm::vec3& normal, int16_t out[2]) {
+        float sum = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+        if (!(sum > 0.0f)) {
+            out[0] = out[1] = 0;
+            return;
+        }
+
+        // Project onto the octahedron, fold the lower half over the upper
+        glm::vec2 p(normal.x / sum, normal.y / sum);
+        if (normal.z < 0.0f) {
+            p = glm::vec2((1.0f - std::abs(p.y)) * signNotZero(p.x), (1.0f - std::abs(p.x)) * signNotZero(p.y));
+        }
+        out[0] = toSnorm16(p.x);
+        out[1] = toSnorm16(p.y);
+    }
+
+    glm::vec3 decodeNormal(const int16_t in[2]) {
+        glm::vec3 n(fromSnorm16(in[0]), fromSnorm16(in[1]), 0.0f);
+        n.z = 1.0f - std::abs(n.x) - std::abs(n.y);
+        float t = std::max(-n.z, 0.0f);
+        n.x += n.x >= 0.0f ? -t : t;
+        n.y += n.y >= 0.0f ? -t : t;
+        return glm::normalize(n);
+    }
+
+    uint16_t floatToHalf(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+        uint32_t magnitude = bits & 0x7FFFFFFF;
+
+        if (magnitude >= 0x7F800000) return sign | 0x7C00 | (magnitude > 0x7F800000 ? 0x200 : 0);   // Inf, NaN
+        if (magnitude >= 0x477FF000) return sign | 0x7C00;                                             // Rounds past 65504
+        if (magnitude < 0x38800000) {
+            // Subnormal: in units of 2^-24
+            float f;
+            std::memcpy(&f, &magnitude, sizeof(f));
+            return sign | static_cast<uint16_t>(std::lrint(f * 16777216.0f));
+        }
+
+        // Rebias the exponent (127 -> 15), round to nearest even
+        uint32_t rounded = magnitude + 0xFFF + ((magnitude >> 13) & 1);
+        return sign | static_cast<uint16_t>((rounded - 0x38000000) >> 13);
+    }
+
+    float halfToFloat(uint16_t half) {
+        float sign = (half & 0x8000) ? -1.0f : 1.0f;
+        int exponent = (half >> 10) & 0x1F;
+        int mantissa = half & 0x3FF;
+
+        if (exponent == 0) return sign * std::ldexp(static_cast<float>(mantissa), -24);
+        if (exponent == 31) return mantissa ? NAN : sign * INFINITY;
+        return sign * std::ldexp(static_cast<float>(mantissa + 1024), exponent - 25);
+    }
+
+    void pack(const MeshVertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount,
+        MeshUploadData& out) {
+
+        glm::vec3 boundsMin(0.0f), boundsMax(0.0f);
+        if (vertexCount > 0) {
+            boundsMin = boundsMax = vertices[0].position;
+            for (size_t i = 1; i < vertexCount; ++i) {
+                boundsMin = glm::min(boundsMin, vertices[i].position);
+                boundsMax = glm::max(boundsMax, vertices[i].position);
+            }
+        }
+        glm::vec3 extent = boundsMax - boundsMin;
+        glm::vec3 inverse(extent.x > 0.0f ? 65535.0f / extent.x : 0.0f,
+            extent.y > 0.0f ? 65535.0f / extent.y : 0.0f,
+            extent.z > 0.0f ? 65535.0f / extent.z : 0.0f);
+
+        out.positionOffset = boundsMin;
+        out.positionScale = extent;
+        out.vertices.resize(vertexCount);
+
+        JobSystem::instance().parallelFor(vertexCount, 8192, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const MeshVertex& v = vertices[i];
+                PackedVertex& p = out.vertices[i];
+
+                glm::vec3 q = (v.position - boundsMin) * inverse;
+                for (int a = 0; a < 3; ++a) {
+                    p.position[a] = static_cast<uint16_t>(std::lround(std::clamp(q[a], 0.0f, 65535.0f)));
+                }
+                p.position[3] = 0;
+
+                encodeNormal(v.normal, p.normal);
+
+                p.color[0] = toUnorm8(v.color.x);
+                p.color[1] = toUnorm8(v.color.y);
+                p.color[2] = toUnorm8(v.color.z);
+                p.color[3] = 255;
+
+                p.uv[0] = floatToHalf(v.uv.x);
+                p.uv[1] = floatToHalf(v.uv.y);
+            }
+            });
+
+        if (vertexCount < MAX_INDEX16_VERTICES) {
+            out.indices.clear();
+            out.indices16.assign(indices, indices + indexCount);
+        }
+        else {
+            out.indices16.clear();
+            out.indices.assign(indices, indices + indexCount);
+        }
+    }
+
+    MeshVertex unpack(const PackedVertex& vertex, const glm::vec3& positionOffset, const glm::vec3& positionScale) {
+        MeshVertex v{};
+        v.position = positionOffset + glm::vec3(vertex.position[0], vertex.position[1], vertex.position[2]) / 65535.0f * positionScale;
+        v.normal = decodeNormal(vertex.normal);
+        v.color = glm::vec3(vertex.color[0], vertex.color[1], vertex.color[2]) / 255.0f;
+        v.uv = glm::vec2(halfToFloat(vertex.uv[0]), halfToFloat(vertex.uv[1]));
+        return v;
+    }
+
+} // namespace VertexPacking
+} // namespace libre
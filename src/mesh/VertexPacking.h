@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../components/CoreComponents.h"
+#include "../core/FrameData.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace libre {
+
+    // ============================================================================
+    // VERTEX PACKING - MeshVertex to the compact GPU layout
+    // ============================================================================
+    // PackedVertex quantizes each attribute to what shading needs:
+    // - Position: 16 bits per axis across the mesh's bounding box, so the
+    //   error is at most half of 1/65535 of the box's extent on each axis.
+    //   workbench_packed.vert dequantizes with the offset/scale pushed
+    //   per draw.
+    // - Normal: octahedral map (Cigolle et al. 2014) of the unit sphere
+    //   onto a square, two snorm16 values, under 0.01 degrees of error.
+    // - Color: RGBA8 (alpha 1). UV: half floats, so tiling UVs outside
+    //   [0, 1] survive.
+    // Indices become 16-bit whenever the mesh has fewer than 65,536
+    // vertices.
+
+    namespace VertexPacking {
+
+        constexpr size_t MAX_INDEX16_VERTICES = 65536;
+
+        // Octahedral encoding of a unit vector (zero maps to +Z)
+        void encodeNormal(const glm::vec3& normal, int16_t out[2]);
+        glm::vec3 decodeNormal(const int16_t in[2]);
+
+        uint16_t floatToHalf(float value);
+        float halfToFloat(uint16_t half);
+
+        // Fills vertices, positionOffset/Scale and indices or indices16
+        void pack(const MeshVertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount,
+            MeshUploadData& out);
+
+        // What the shader reconstructs (the uv and alpha are dropped)
+        MeshVertex unpack(const PackedVertex& vertex, const glm::vec3& positionOffset, const glm::vec3& positionScale);
+
+    } // namespace VertexPacking
+
+} // namespace libre
@@ -16,7 +16,16 @@ void GraphicsPipeline::init(VulkanContext* ctx, SwapChain* swap, UniformBuffer*
     this->swapChain = swap;
     this->uniformBuffer = ubo;
 
-    createMeshPipeline();
+    auto bindingDescription = Vertex::getBindingDescription();
+    auto attributeDescriptions = Vertex::getAttributeDescriptions();
+    createMeshPipeline("shaders/compiled/workbench.vert.spv", bindingDescription,
+        attributeDescriptions.data(), static_cast<uint32_t>(attributeDescriptions.size()), meshPipeline);
+
+    auto packedBindingDescription = PackedVertexFormat::getBindingDescription();
+    auto packedAttributeDescriptions = PackedVertexFormat::getAttributeDescriptions();
+    createMeshPipeline("shaders/compiled/workbench_packed.vert.spv", packedBindingDescription,
+        packedAttributeDescriptions.data(), static_cast<uint32_t>(packedAttributeDescriptions.size()), packedMeshPipeline);
+
     createGridPipeline();
 
     std::cout << "[OK] Graphics pipelines created" << std::endl;
@@ -26,6 +35,9 @@ void GraphicsPipeline::cleanup() {
     if (meshPipeline != VK_NULL_HANDLE) {
         vkDestroyPipeline(context->getDevice(), meshPipeline, nullptr);
     }
+    if (packedMeshPipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(context->getDevice(), packedMeshPipeline, nullptr);
+    }
     if (meshPipelineLayout != VK_NULL_HANDLE) {
         vkDestroyPipelineLayout(context->getDevice(), meshPipelineLayout, nullptr);
     }
@@ -37,8 +49,11 @@ void GraphicsPipeline::cleanup() {
     }
 }
 
-void GraphicsPipeline::createMeshPipeline() {
-    auto vertShaderCode = readFile("shaders/compiled/workbench.vert.spv");
+void GraphicsPipeline::createMeshPipeline(const std::string& vertShaderPath,
+    const VkVertexInputBindingDescription& bindingDescription,
+    const VkVertexInputAttributeDescription* attributeDescriptions, uint32_t attributeCount,
+    VkPipeline& outPipeline) {
+    auto vertShaderCode = readFile(vertShaderPath);
     auto fragShaderCode = readFile("shaders/compiled/workbench.frag.spv");
 
     VkShaderModule vertShaderModule = createShaderModule(vertShaderCode);
@@ -58,15 +73,12 @@ void GraphicsPipeline::createMeshPipeline() {
 
     VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, fragShaderStageInfo };
 
-    auto bindingDescription = Vertex::getBindingDescription();
-    auto attributeDescriptions = Vertex::getAttributeDescriptions();
-
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
     vertexInputInfo.vertexBindingDescriptionCount = 1;
     vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+    vertexInputInfo.vertexAttributeDescriptionCount = attributeCount;
+    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions;
 
     VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
     inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
@@ -122,24 +134,27 @@ void GraphicsPipeline::createMeshPipeline() {
     colorBlending.attachmentCount = 1;
     colorBlending.pAttachments = &colorBlendAttachment;
 
-    VkDescriptorSetLayout setLayout = uniformBuffer->getDescriptorSetLayout();
-
-    // Push constant range for per-object model matrix
-    VkPushConstantRange pushConstantRange{};
-    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-    pushConstantRange.offset = 0;
-    pushConstantRange.size = sizeof(PushConstants);
-
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &setLayout;
-    pipelineLayoutInfo.pushConstantRangeCount = 1;
-    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
-
-    if (vkCreatePipelineLayout(context->getDevice(), &pipelineLayoutInfo, nullptr,
-        &meshPipelineLayout) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to create mesh pipeline layout!");
+    // Layout is shared by the float and packed mesh pipelines
+    if (meshPipelineLayout == VK_NULL_HANDLE) {
+        VkDescriptorSetLayout setLayout = uniformBuffer->getDescriptorSetLayout();
+
+        // Push constant range for per-object model matrix
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(PushConstants);
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &setLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+        if (vkCreatePipelineLayout(context->getDevice(), &pipelineLayoutInfo, nullptr,
+            &meshPipelineLayout) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create mesh pipeline layout!");
+        }
     }
 
     VkGraphicsPipelineCreateInfo pipelineInfo{};
@@ -159,14 +174,14 @@ void GraphicsPipeline::createMeshPipeline() {
     pipelineInfo.subpass = 0;
 
     if (vkCreateGraphicsPipelines(context->getDevice(), VK_NULL_HANDLE, 1, &pipelineInfo,
-        nullptr, &meshPipeline) != VK_SUCCESS) {
+        nullptr, &outPipeline) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create mesh graphics pipeline!");
     }
 
     vkDestroyShaderModule(context->getDevice(), fragShaderModule, nullptr);
     vkDestroyShaderModule(context->getDevice(), vertShaderModule, nullptr);
 
-    std::cout << "[OK] Mesh pipeline created with push constants" << std::endl;
+    std::cout << "[OK] Mesh pipeline created with push constants (" << vertShaderPath << ")" << std::endl;
 }
 
 void GraphicsPipeline::createGridPipeline() {
@@ -21,12 +21,18 @@ public:
     VkPipeline getMeshPipeline() const { return meshPipeline; }
     VkPipelineLayout getMeshPipelineLayout() const { return meshPipelineLayout; }
 
+    // Same shading for PackedVertex meshes (shares the mesh pipeline layout)
+    VkPipeline getPackedMeshPipeline() const { return packedMeshPipeline; }
+
     // Grid pipeline (lines)
     VkPipeline getGridPipeline() const { return gridPipeline; }
     VkPipelineLayout getGridPipelineLayout() const { return gridPipelineLayout; }
 
 private:
-    void createMeshPipeline();
+    void createMeshPipeline(const std::string& vertShaderPath,
+        const VkVertexInputBindingDescription& bindingDescription,
+        const VkVertexInputAttributeDescription* attributeDescriptions, uint32_t attributeCount,
+        VkPipeline& outPipeline);
     void createGridPipeline();
 
     VkShaderModule createShaderModule(const std::vector<char>& code);
@@ -39,6 +45,7 @@ private:
     // Mesh rendering pipeline
     VkPipelineLayout meshPipelineLayout = VK_NULL_HANDLE;
     VkPipeline meshPipeline = VK_NULL_HANDLE;
+    VkPipeline packedMeshPipeline = VK_NULL_HANDLE;
 
     // Grid/line rendering pipeline
     VkPipelineLayout gridPipelineLayout = VK_NULL_HANDLE;
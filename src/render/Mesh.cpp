@@ -2,6 +2,7 @@
 #include "VulkanContext.h"
 #include <stdexcept>
 #include <cstring>
+#include <algorithm>
 
 // Vertex methods
 VkVertexInputBindingDescription Vertex::getBindingDescription() {
@@ -36,6 +37,45 @@ std::array<VkVertexInputAttributeDescription, 3> Vertex::getAttributeDescription
     return attributeDescriptions;
 }
 
+// PackedVertexFormat methods
+VkVertexInputBindingDescription PackedVertexFormat::getBindingDescription() {
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = 0;
+    bindingDescription.stride = sizeof(libre::PackedVertex);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    return bindingDescription;
+}
+
+std::array<VkVertexInputAttributeDescription, 4> PackedVertexFormat::getAttributeDescriptions() {
+    std::array<VkVertexInputAttributeDescription, 4> attributeDescriptions{};
+
+    // Position (unorm16 across the mesh bounds)
+    attributeDescriptions[0].binding = 0;
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].format = VK_FORMAT_R16G16B16A16_UNORM;
+    attributeDescriptions[0].offset = offsetof(libre::PackedVertex, position);
+
+    // Normal (octahedral)
+    attributeDescriptions[1].binding = 0;
+    attributeDescriptions[1].location = 1;
+    attributeDescriptions[1].format = VK_FORMAT_R16G16_SNORM;
+    attributeDescriptions[1].offset = offsetof(libre::PackedVertex, normal);
+
+    // Color
+    attributeDescriptions[2].binding = 0;
+    attributeDescriptions[2].location = 2;
+    attributeDescriptions[2].format = VK_FORMAT_R8G8B8A8_UNORM;
+    attributeDescriptions[2].offset = offsetof(libre::PackedVertex, color);
+
+    // UV
+    attributeDescriptions[3].binding = 0;
+    attributeDescriptions[3].location = 3;
+    attributeDescriptions[3].format = VK_FORMAT_R16G16_SFLOAT;
+    attributeDescriptions[3].offset = offsetof(libre::PackedVertex, uv);
+
+    return attributeDescriptions;
+}
+
 // LineVertex methods
 VkVertexInputBindingDescription LineVertex::getBindingDescription() {
     VkVertexInputBindingDescription bindingDescription{};
@@ -69,10 +109,10 @@ Mesh::~Mesh() {}
 void Mesh::create(VulkanContext* ctx) {
     this->context = ctx;
 
-    if (!vertices.empty()) {
+    if (!vertices.empty() || !packedVertices.empty()) {
         createVertexBuffer();
     }
-    if (!indices.empty()) {
+    if (!indices.empty() || !indices16.empty()) {
         createIndexBuffer();
     }
 }
@@ -96,32 +136,56 @@ void Mesh::setIndices(const std::vector<uint32_t>& inds) {
     indices = inds;
 }
 
+void Mesh::setPackedVertices(const std::vector<libre::PackedVertex>& verts,
+    const glm::vec3& offset, const glm::vec3& scale) {
+    packedVertices = verts;
+    positionOffset = offset;
+    positionScale = scale;
+}
+
+void Mesh::setIndices16(const std::vector<uint16_t>& inds) {
+    indices16 = inds;
+}
+
 void Mesh::bind(VkCommandBuffer commandBuffer) {
     VkBuffer vertexBuffers[] = { vertexBuffer };
     VkDeviceSize offsets[] = { 0 };
     vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
 
     if (indexBuffer != VK_NULL_HANDLE) {
-        vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+        vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0,
+            indices16.empty() ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16);
     }
 }
 
 void Mesh::draw(VkCommandBuffer commandBuffer) {
-    if (!indices.empty()) {
-        vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
+    if (getIndexCount() > 0) {
+        vkCmdDrawIndexed(commandBuffer, getIndexCount(), 1, 0, 0, 0);
     }
     else {
-        vkCmdDraw(commandBuffer, static_cast<uint32_t>(vertices.size()), 1, 0, 0);
+        vkCmdDraw(commandBuffer, getVertexCount(), 1, 0, 0);
+    }
+}
+
+void Mesh::drawRange(VkCommandBuffer commandBuffer, uint32_t firstIndex, uint32_t indexCount) {
+    uint32_t total = getIndexCount();
+    if (firstIndex >= total) return;
+    indexCount = std::min(indexCount, total - firstIndex);
+    if (indexCount > 0) {
+        vkCmdDrawIndexed(commandBuffer, indexCount, 1, firstIndex, 0, 0);
     }
 }
 
 void Mesh::drawWireframe(VkCommandBuffer commandBuffer) {
     // Draw as lines using edge data
-    vkCmdDraw(commandBuffer, static_cast<uint32_t>(vertices.size()), 1, 0, 0);
+    vkCmdDraw(commandBuffer, getVertexCount(), 1, 0, 0);
 }
 
 void Mesh::createVertexBuffer() {
-    VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
+    const void* source = isPacked() ? static_cast<const void*>(packedVertices.data()) : vertices.data();
+    VkDeviceSize bufferSize = isPacked()
+        ? sizeof(libre::PackedVertex) * packedVertices.size()
+        : sizeof(Vertex) * vertices.size();
 
     createBuffer(bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
@@ -129,12 +193,15 @@ void Mesh::createVertexBuffer() {
 
     void* data;
     vkMapMemory(context->getDevice(), vertexBufferMemory, 0, bufferSize, 0, &data);
-    memcpy(data, vertices.data(), (size_t)bufferSize);
+    memcpy(data, source, (size_t)bufferSize);
     vkUnmapMemory(context->getDevice(), vertexBufferMemory);
 }
 
 void Mesh::createIndexBuffer() {
-    VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size();
+    const void* source = indices16.empty() ? static_cast<const void*>(indices.data()) : indices16.data();
+    VkDeviceSize bufferSize = indices16.empty()
+        ? sizeof(uint32_t) * indices.size()
+        : sizeof(uint16_t) * indices16.size();
 
     createBuffer(bufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
@@ -142,7 +209,7 @@ void Mesh::createIndexBuffer() {
 
     void* data;
     vkMapMemory(context->getDevice(), indexBufferMemory, 0, bufferSize, 0, &data);
-    memcpy(data, indices.data(), (size_t)bufferSize);
+    memcpy(data, source, (size_t)bufferSize);
     vkUnmapMemory(context->getDevice(), indexBufferMemory);
 }
 
@@ -5,6 +5,7 @@
 #include <glm/glm.hpp>
 #include <vector>
 #include <array>
+#include "../core/FrameData.h"
 
 class VulkanContext;
 
@@ -18,6 +19,12 @@ struct Vertex {
     static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions();
 };
 
+// Compact vertex (libre::PackedVertex) for workbench_packed.vert
+struct PackedVertexFormat {
+    static VkVertexInputBindingDescription getBindingDescription();
+    static std::array<VkVertexInputAttributeDescription, 4> getAttributeDescriptions();
+};
+
 // Line vertex (for grid and wireframe)
 struct LineVertex {
     glm::vec3 position;
@@ -50,17 +57,31 @@ public:
     void setVertices(const std::vector<Vertex>& verts);
     void setIndices(const std::vector<uint32_t>& inds);
 
+    // Packed geometry (drawn with the packed mesh pipeline instead)
+    void setPackedVertices(const std::vector<libre::PackedVertex>& verts,
+        const glm::vec3& offset, const glm::vec3& scale);
+    void setIndices16(const std::vector<uint16_t>& inds);
+
     // Binding for rendering
     void bind(VkCommandBuffer commandBuffer);
     void draw(VkCommandBuffer commandBuffer);
+    // Part of the index buffer (clamped to it)
+    void drawRange(VkCommandBuffer commandBuffer, uint32_t firstIndex, uint32_t indexCount);
     void drawWireframe(VkCommandBuffer commandBuffer);
 
     // Transform
     glm::mat4 modelMatrix = glm::mat4(1.0f);
 
     // Getters
-    uint32_t getVertexCount() const { return static_cast<uint32_t>(vertices.size()); }
-    uint32_t getIndexCount() const { return static_cast<uint32_t>(indices.size()); }
+    uint32_t getVertexCount() const {
+        return static_cast<uint32_t>(isPacked() ? packedVertices.size() : vertices.size());
+    }
+    uint32_t getIndexCount() const {
+        return static_cast<uint32_t>(indices16.empty() ? indices.size() : indices16.size());
+    }
+    bool isPacked() const { return !packedVertices.empty(); }
+    const glm::vec3& getPositionOffset() const { return positionOffset; }
+    const glm::vec3& getPositionScale() const { return positionScale; }
 
     // Geometry data (public for manipulation)
     std::vector<Vertex> vertices;
@@ -68,6 +89,9 @@ public:
     std::vector<Edge> edges;
     std::vector<Face> faces;
 
+    std::vector<libre::PackedVertex> packedVertices;
+    std::vector<uint16_t> indices16;
+
 private:
     void createVertexBuffer();
     void createIndexBuffer();
@@ -78,6 +102,9 @@ private:
 
     VulkanContext* context = nullptr;
 
+    glm::vec3 positionOffset = glm::vec3(0.0f);
+    glm::vec3 positionScale = glm::vec3(1.0f);
+
     VkBuffer vertexBuffer = VK_NULL_HANDLE;
     VkDeviceMemory vertexBufferMemory = VK_NULL_HANDLE;
     VkBuffer indexBuffer = VK_NULL_HANDLE;
@@ -282,21 +282,15 @@ namespace libre {
 
         // === STEP 1: Process mesh uploads FIRST ===
         for (const auto& upload : frameData.meshUploads) {
-            if (!upload.vertices.empty() && !upload.indices.empty()) {
+            if (!upload.vertices.empty() && upload.getIndexCount() > 0) {
                 // Log uploads for first few frames
                 if (frameData.frameNumber <= 5) {
                     std::cout << "[RenderThread] Uploading mesh for entity " << upload.entityId
                         << " (" << upload.vertices.size() << " verts, "
-                        << upload.indices.size() << " indices)" << std::endl;
+                        << upload.getIndexCount() << " indices)" << std::endl;
                 }
 
-                Mesh* mesh = renderer_->getOrCreateMesh(
-                    upload.entityId,
-                    upload.vertices.data(),
-                    upload.vertices.size(),
-                    upload.indices.data(),
-                    upload.indices.size()
-                );
+                Mesh* mesh = renderer_->getOrCreateMesh(upload);
 
                 if (!mesh && frameData.frameNumber <= 5) {
                     std::cerr << "[RenderThread] ERROR: Failed to create mesh " << upload.entityId << std::endl;
@@ -309,15 +303,19 @@ namespace libre {
         size_t notFound = 0;
 
         for (const auto& rm : frameData.meshes) {
-            Mesh* mesh = renderer_->getMeshFromCache(rm.entityId);
+            Mesh* mesh = renderer_->getMeshFromCache(rm.meshHandle);
             if (mesh) {
-                renderer_->submitMesh(mesh, rm.modelMatrix, glm::vec3(rm.color), rm.isSelected);
+                // Hover brightens the base color (selection is passed through as is)
+                glm::vec3 color = rm.isHovered ?
+                    glm::mix(glm::vec3(rm.color), glm::vec3(1.0f), 0.25f) : glm::vec3(rm.color);
+                const DrawRange* ranges = rm.drawRangeCount > 0 ? &frameData.drawRanges[rm.firstDrawRange] : nullptr;
+                renderer_->submitMesh(mesh, rm.modelMatrix, color, rm.isSelected, ranges, rm.drawRangeCount);
                 submitted++;
             }
             else {
                 notFound++;
                 if (frameData.frameNumber <= 10) {
-                    std::cerr << "[RenderThread] WARNING: Mesh " << rm.entityId
+                    std::cerr << "[RenderThread] WARNING: Mesh " << rm.meshHandle
                         << " not found in cache (frame " << frameData.frameNumber << ")" << std::endl;
                 }
             }
@@ -69,13 +69,14 @@ void Renderer::cleanup() {
 
     vkDeviceWaitIdle(context->getDevice());
 
-    for (auto& [id, mesh] : meshCache) {
-        if (mesh) {
-            mesh->cleanup();
-            delete mesh;
+    for (auto& [id, cached] : meshCache) {
+        if (cached.mesh) {
+            cached.mesh->cleanup();
+            delete cached.mesh;
         }
     }
     meshCache.clear();
+    destroyRetiredMeshes(true);
 
     if (grid) {
         grid->cleanup();
@@ -166,7 +167,8 @@ void Renderer::createSceneObjects() {
     std::cout << "[OK] Scene objects created" << std::endl;
 }
 
-void Renderer::submitMesh(Mesh* mesh, const glm::mat4& transform, const glm::vec3& color, bool selected) {
+void Renderer::submitMesh(Mesh* mesh, const glm::mat4& transform, const glm::vec3& color, bool selected,
+    const libre::DrawRange* ranges, uint32_t rangeCount) {
     if (!mesh) {
         std::cerr << "[Renderer] WARNING: submitMesh called with null mesh!" << std::endl;
         return;
@@ -177,60 +179,61 @@ void Renderer::submitMesh(Mesh* mesh, const glm::mat4& transform, const glm::vec
     obj.transform = transform;
     obj.color = color;
     obj.selected = selected;
+    if (ranges && rangeCount > 0) {
+        obj.firstRange = static_cast<uint32_t>(drawRanges.size());
+        obj.rangeCount = rangeCount;
+        drawRanges.insert(drawRanges.end(), ranges, ranges + rangeCount);
+    }
     renderQueue.push_back(obj);
 }
 
 void Renderer::clearSubmissions() {
     renderQueue.clear();
+    drawRanges.clear();
 }
 
-Mesh* Renderer::getOrCreateMesh(uint64_t entityId, const void* vertexData, size_t vertexCount,
-    const uint32_t* indexData, size_t indexCount) {
+Mesh* Renderer::getOrCreateMesh(const libre::MeshUploadData& upload) {
+    uint64_t entityId = upload.entityId;
 
-    // Check cache first
+    // Check cache first; an edited mesh arrives with a new key
     auto it = meshCache.find(entityId);
+    Mesh* replaced = nullptr;
     if (it != meshCache.end()) {
-        return it->second;
+        if (it->second.geometryKey == upload.geometryKey) return it->second.mesh;
+        replaced = it->second.mesh;
     }
 
     // Don't create mesh if no vertex data provided
-    if (vertexData == nullptr || vertexCount == 0) {
+    if (upload.vertices.empty()) {
         std::cerr << "[Renderer] Cannot create mesh " << entityId << ": no vertex data" << std::endl;
         return nullptr;
     }
 
-    if (indexData == nullptr || indexCount == 0) {
+    if (upload.getIndexCount() == 0) {
         std::cerr << "[Renderer] Cannot create mesh " << entityId << ": no index data" << std::endl;
         return nullptr;
     }
 
     std::cout << "[Renderer] Creating mesh for entity " << entityId
-        << " with " << vertexCount << " vertices and "
-        << indexCount << " indices" << std::endl;
+        << " with " << upload.vertices.size() << " vertices and "
+        << upload.getIndexCount() << (upload.indices16.empty() ? "" : " 16-bit") << " indices" << std::endl;
 
     Mesh* mesh = new Mesh();
 
-    // Convert UploadVertex to Vertex
-    const libre::UploadVertex* uploadVerts = static_cast<const libre::UploadVertex*>(vertexData);
-
-    std::vector<Vertex> vertices;
-    vertices.reserve(vertexCount);
-
-    for (size_t i = 0; i < vertexCount; ++i) {
-        Vertex v;
-        v.position = uploadVerts[i].position;
-        v.normal = uploadVerts[i].normal;
-        v.color = uploadVerts[i].color;
-        vertices.push_back(v);
+    mesh->setPackedVertices(upload.vertices, upload.positionOffset, upload.positionScale);
+    if (!upload.indices16.empty()) {
+        mesh->setIndices16(upload.indices16);
+    }
+    else {
+        mesh->setIndices(upload.indices);
     }
-
-    mesh->setVertices(vertices);
-    mesh->setIndices(std::vector<uint32_t>(indexData, indexData + indexCount));
     mesh->create(context);
 
-    meshCache[entityId] = mesh;
+    // Frames still in flight may draw the old buffers
+    if (replaced) retiredMeshes.push_back({ replaced, framesSubmitted });
+    meshCache[entityId] = { mesh, upload.geometryKey };
 
-    std::cout << "[Renderer] Mesh " << entityId << " created successfully. "
+    std::cout << "[Renderer] Mesh " << entityId << (replaced ? " replaced" : " created") << " successfully. "
         << "Cache size: " << meshCache.size() << std::endl;
 
     return mesh;
@@ -239,17 +242,33 @@ Mesh* Renderer::getOrCreateMesh(uint64_t entityId, const void* vertexData, size_
 Mesh* Renderer::getMeshFromCache(uint64_t entityId) {
     auto it = meshCache.find(entityId);
     if (it != meshCache.end()) {
-        return it->second;
+        return it->second.mesh;
     }
     return nullptr;
 }
 
+void Renderer::destroyRetiredMeshes(bool all) {
+    // Frame fences signal in submission order: once the current frame's
+    // fence is waited on, every submission but the last one is done
+    size_t kept = 0;
+    for (const RetiredMesh& retired : retiredMeshes) {
+        if (all || retired.frame + MAX_FRAMES_IN_FLIGHT <= framesSubmitted) {
+            retired.mesh->cleanup();
+            delete retired.mesh;
+        }
+        else {
+            retiredMeshes[kept++] = retired;
+        }
+    }
+    retiredMeshes.resize(kept);
+}
+
 void Renderer::removeMesh(uint64_t entityId) {
     auto it = meshCache.find(entityId);
     if (it != meshCache.end()) {
-        if (it->second) {
-            it->second->cleanup();
-            delete it->second;
+        if (it->second.mesh) {
+            it->second.mesh->cleanup();
+            delete it->second.mesh;
         }
         meshCache.erase(it);
         std::cout << "[Renderer] Removed mesh " << entityId << std::endl;
@@ -265,6 +284,7 @@ void Renderer::waitIdle() {
 bool Renderer::drawFrame(Camera* camera) {
     // Wait for previous frame with this index to complete
     vkWaitForFences(context->getDevice(), 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+    if (!retiredMeshes.empty()) destroyRetiredMeshes(false);
 
     // ========================================================================
     // FLUSH FONT ATLAS BEFORE ACQUIRING IMAGE (outside of any render pass)
@@ -317,6 +337,7 @@ bool Renderer::drawFrame(Camera* camera) {
     if (vkQueueSubmit(context->getGraphicsQueue(), 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS) {
         throw std::runtime_error("Failed to submit draw command buffer!");
     }
+    ++framesSubmitted;
 
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -412,19 +433,37 @@ void Renderer::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t image
     // 2. Draw meshes
     // ========================================
     if (!renderQueue.empty()) {
-        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->getMeshPipeline());
+        // Both mesh pipelines share the layout; rebind only when the
+        // vertex format changes between consecutive meshes
         vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
             pipeline->getMeshPipelineLayout(), 0, 1, &descriptorSet, 0, nullptr);
+        VkPipeline boundPipeline = VK_NULL_HANDLE;
 
         for (const auto& obj : renderQueue) {
             if (obj.mesh) {
+                VkPipeline meshPipeline = obj.mesh->isPacked() ? pipeline->getPackedMeshPipeline() : pipeline->getMeshPipeline();
+                if (meshPipeline != boundPipeline) {
+                    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, meshPipeline);
+                    boundPipeline = meshPipeline;
+                }
+
                 PushConstants push{};
                 push.model = obj.transform;
+                push.positionOffset = glm::vec4(obj.mesh->getPositionOffset(), 0.0f);
+                push.positionScale = glm::vec4(obj.mesh->getPositionScale(), 0.0f);
                 vkCmdPushConstants(commandBuffer, pipeline->getMeshPipelineLayout(),
                     VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstants), &push);
 
                 obj.mesh->bind(commandBuffer);
-                obj.mesh->draw(commandBuffer);
+                if (obj.rangeCount > 0) {
+                    for (uint32_t r = 0; r < obj.rangeCount; ++r) {
+                        const libre::DrawRange& range = drawRanges[obj.firstRange + r];
+                        obj.mesh->drawRange(commandBuffer, range.firstIndex, range.indexCount);
+                    }
+                }
+                else {
+                    obj.mesh->draw(commandBuffer);
+                }
             }
         }
     }
@@ -19,11 +19,18 @@ class Grid;
 class Mesh;
 class Camera;
 
+namespace libre {
+    struct MeshUploadData;
+    struct DrawRange;
+}
+
 struct RenderObject {
     Mesh* mesh = nullptr;
     glm::mat4 transform = glm::mat4(1.0f);
     glm::vec3 color = glm::vec3(0.8f);
     bool selected = false;
+    uint32_t firstRange = 0;        // Into Renderer::drawRanges
+    uint32_t rangeCount = 0;        // 0 = the whole mesh
 };
 
 class Renderer {
@@ -45,13 +52,17 @@ public:
     // Called after swap chain is recreated
     void onSwapChainRecreated(SwapChain* newSwapChain);
 
+    // 'ranges' (copied) limits the draw to parts of the index buffer
     void submitMesh(Mesh* mesh, const glm::mat4& transform,
-        const glm::vec3& color = glm::vec3(0.8f), bool selected = false);
+        const glm::vec3& color = glm::vec3(0.8f), bool selected = false,
+        const libre::DrawRange* ranges = nullptr, uint32_t rangeCount = 0);
     void clearSubmissions();
 
-    // Get or create mesh in cache - creates GPU buffers if vertexData provided
-    Mesh* getOrCreateMesh(uint64_t entityId, const void* vertexData, size_t vertexCount,
-        const uint32_t* indexData, size_t indexCount);
+    // Get or create mesh in cache - creates GPU buffers from the packed upload.
+    // An upload with a new geometryKey (the mesh was edited) replaces the
+    // cached mesh; the old buffers are destroyed once no frame in flight
+    // can still draw them.
+    Mesh* getOrCreateMesh(const libre::MeshUploadData& upload);
 
     // Get mesh from cache without creating (returns nullptr if not found)
     Mesh* getMeshFromCache(uint64_t entityId);
@@ -85,8 +96,23 @@ private:
     UniformBuffer* uniformBuffer = nullptr;
 
     Grid* grid = nullptr;
-    std::unordered_map<uint64_t, Mesh*> meshCache;
+    struct CachedMesh {
+        Mesh* mesh = nullptr;
+        uint64_t geometryKey = 0;
+    };
+
+    struct RetiredMesh {
+        Mesh* mesh = nullptr;
+        uint64_t frame = 0;             // framesSubmitted when it was replaced
+    };
+
+    void destroyRetiredMeshes(bool all);
+
+    std::unordered_map<uint64_t, CachedMesh> meshCache;
+    std::vector<RetiredMesh> retiredMeshes;
+    uint64_t framesSubmitted = 0;
     std::vector<RenderObject> renderQueue;
+    std::vector<libre::DrawRange> drawRanges;
 
     VkCommandPool commandPool = VK_NULL_HANDLE;
     std::vector<VkCommandBuffer> commandBuffers;
@@ -20,6 +20,8 @@ struct UniformBufferObject {
 // Per-object data sent via push constants
 struct PushConstants {
     glm::mat4 model;
+    glm::vec4 positionOffset = glm::vec4(0.0f);    // Packed meshes: dequantization (xyz)
+    glm::vec4 positionScale = glm::vec4(1.0f);
 };
 
 class UniformBuffer {
@@ -0,0 +1,385 @@
+#include "BVH.h"
+#include "../core/JobSystem.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace libre {
+
+    static constexpr uint32_t SAH_BINS = 16;
+    static constexpr float SAH_TRAVERSAL_COST = 1.0f;     // Relative to one primitive test
+
+    // Builds over this many primitives hand the subtrees found PARALLEL_BUILD_DEPTH
+    // levels down (up to 2^depth of them) to the JobSystem
+    static constexpr size_t PARALLEL_BUILD_MIN = 65536;
+    static constexpr uint32_t PARALLEL_BUILD_DEPTH = 4;
+
+    // ========================================================================
+    // BUILD
+    // ========================================================================
+
+    void BVH4::clear() {
+        nodes_.clear();
+        primitives_.clear();
+        bounds_ = AABB{};
+        parents_.clear();
+        primitiveLeaf_.clear();
+        refitStamp_.clear();
+        sahCost_ = 0.0;
+        buildCost_ = 0.0f;
+    }
+
+    void BVH4::build(const AABB* boxes, size_t count) {
+        clear();
+
+        std::vector<BuildPrimitive> prims;
+        prims.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (!boxes[i].valid()) continue;
+            prims.push_back({ boxes[i], boxes[i].center(), static_cast<uint32_t>(i) });
+            bounds_.expand(boxes[i]);
+        }
+        if (prims.empty()) return;
+
+        std::vector<BuildNode> tree;
+        tree.reserve(prims.size() / 2 + 1);
+        std::vector<DeferredSubtree> deferred;
+        uint32_t root = buildRecursive(tree, prims, 0, static_cast<uint32_t>(prims.size()),
+            prims.size() >= PARALLEL_BUILD_MIN ? &deferred : nullptr, 0);
+
+        if (!deferred.empty()) {
+            // Subtrees own disjoint primitive ranges, so they build independently
+            JobSystem::instance().parallelFor(deferred.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    DeferredSubtree& sub = deferred[i];
+                    sub.tree.reserve((sub.end - sub.begin) / 2 + 1);
+                    sub.root = buildRecursive(sub.tree, prims, sub.begin, sub.end, nullptr, 0);
+                }
+                });
+
+            // Append each subtree and put its root in the placeholder
+            for (DeferredSubtree& sub : deferred) {
+                uint32_t offset = static_cast<uint32_t>(tree.size());
+                for (BuildNode node : sub.tree) {
+                    if (node.count == 0) {
+                        node.left += offset;
+                        node.right += offset;
+                    }
+                    tree.push_back(node);
+                }
+                tree[sub.node] = tree[offset + sub.root];
+            }
+        }
+
+        primitives_.resize(prims.size());
+        for (size_t i = 0; i < prims.size(); ++i) {
+            primitives_[i] = prims[i].index;
+        }
+
+        nodes_.reserve(tree.size() / 3 + 1);
+        if (tree[root].count > 0) {
+            // Tiny scene: one node with a single leaf lane
+            Node node;
+            std::fill(std::begin(node.minX), std::end(node.minX), std::numeric_limits<float>::max());
+            std::fill(std::begin(node.minY), std::end(node.minY), std::numeric_limits<float>::max());
+            std::fill(std::begin(node.minZ), std::end(node.minZ), std::numeric_limits<float>::max());
+            std::fill(std::begin(node.maxX), std::end(node.maxX), -std::numeric_limits<float>::max());
+            std::fill(std::begin(node.maxY), std::end(node.maxY), -std::numeric_limits<float>::max());
+            std::fill(std::begin(node.maxZ), std::end(node.maxZ), -std::numeric_limits<float>::max());
+            std::fill(std::begin(node.child), std::end(node.child), INVALID);
+            std::fill(std::begin(node.count), std::end(node.count), 0u);
+
+            const AABB& b = tree[root].bounds;
+            node.minX[0] = b.min.x; node.minY[0] = b.min.y; node.minZ[0] = b.min.z;
+            node.maxX[0] = b.max.x; node.maxY[0] = b.max.y; node.maxZ[0] = b.max.z;
+            node.child[0] = tree[root].first;
+            node.count[0] = tree[root].count;
+            nodes_.push_back(node);
+        }
+        else {
+            collapse(tree, root);
+        }
+
+        linkNodes(count);
+        buildCost_ = getCost();
+    }
+
+    uint32_t BVH4::buildRecursive(std::vector<BuildNode>& tree, std::vector<BuildPrimitive>& prims,
+        uint32_t begin, uint32_t end, std::vector<DeferredSubtree>* deferred, uint32_t depth) {
+        uint32_t index = static_cast<uint32_t>(tree.size());
+        tree.emplace_back();
+
+        if (deferred && depth == PARALLEL_BUILD_DEPTH) {
+            deferred->push_back({ index, begin, end, {}, 0 });
+            return index;
+        }
+
+        AABB bounds, centroidBounds;
+        for (uint32_t i = begin; i < end; ++i) {
+            bounds.expand(prims[i].bounds);
+            centroidBounds.expand(prims[i].centroid);
+        }
+        tree[index].bounds = bounds;
+
+        uint32_t count = end - begin;
+        auto makeLeaf = [&]() {
+            tree[index].first = begin;
+            tree[index].count = count;
+            return index;
+        };
+        if (count == 1) return makeLeaf();
+
+        // Binned SAH over every axis with a non-degenerate centroid spread
+        float bestCost = std::numeric_limits<float>::max();
+        int bestAxis = -1;
+        uint32_t bestSplit = 0;
+        glm::vec3 extent = centroidBounds.max - centroidBounds.min;
+
+        // One pass bins all three axes
+        AABB binBounds[3][SAH_BINS];
+        uint32_t binCounts[3][SAH_BINS] = {};
+        glm::vec3 scale(0.0f);
+        for (int axis = 0; axis < 3; ++axis) {
+            if (extent[axis] > 0.0f) scale[axis] = SAH_BINS / extent[axis];
+        }
+
+        for (uint32_t i = begin; i < end; ++i) {
+            glm::vec3 offset = (prims[i].centroid - centroidBounds.min) * scale;
+            for (int axis = 0; axis < 3; ++axis) {
+                uint32_t bin = std::min(SAH_BINS - 1, static_cast<uint32_t>(offset[axis]));
+                ++binCounts[axis][bin];
+                binBounds[axis][bin].expand(prims[i].bounds);
+            }
+        }
+
+        for (int axis = 0; axis < 3; ++axis) {
+            if (extent[axis] <= 0.0f) continue;
+
+            // Sweep from the right, then evaluate every plane from the left
+            float rightArea[SAH_BINS];
+            uint32_t rightCount[SAH_BINS];
+            AABB acc;
+            uint32_t n = 0;
+            for (uint32_t b = SAH_BINS - 1; b > 0; --b) {
+                acc.expand(binBounds[axis][b]);
+                n += binCounts[axis][b];
+                rightArea[b] = n ? acc.surfaceArea() : 0.0f;
+                rightCount[b] = n;
+            }
+
+            acc = AABB{};
+            n = 0;
+            for (uint32_t b = 0; b + 1 < SAH_BINS; ++b) {
+                acc.expand(binBounds[axis][b]);
+                n += binCounts[axis][b];
+                if (n == 0 || rightCount[b + 1] == 0) continue;
+
+                float cost = acc.surfaceArea() * n + rightArea[b + 1] * rightCount[b + 1];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = b + 1;
+                }
+            }
+        }
+
+        float area = bounds.surfaceArea();
+        float splitCost = area > 0.0f ? SAH_TRAVERSAL_COST + bestCost / area : static_cast<float>(count);
+        if (count <= MAX_LEAF_SIZE && (bestAxis < 0 || splitCost >= static_cast<float>(count))) {
+            return makeLeaf();
+        }
+
+        uint32_t mid;
+        if (bestAxis >= 0) {
+            float axisScale = scale[bestAxis];
+            float origin = centroidBounds.min[bestAxis];
+            auto split = std::partition(prims.begin() + begin, prims.begin() + end, [&](const BuildPrimitive& prim) {
+                uint32_t bin = std::min(SAH_BINS - 1, static_cast<uint32_t>((prim.centroid[bestAxis] - origin) * axisScale));
+                return bin < bestSplit;
+                });
+            mid = static_cast<uint32_t>(split - prims.begin());
+        }
+        else {
+            // All centroids coincide - any halving is as good as another
+            mid = begin + count / 2;
+        }
+
+        uint32_t left = buildRecursive(tree, prims, begin, mid, deferred, depth + 1);
+        uint32_t right = buildRecursive(tree, prims, mid, end, deferred, depth + 1);
+        tree[index].left = left;
+        tree[index].right = right;
+        return index;
+    }
+
+    // ========================================================================
+    // COLLAPSE (binary -> 4-wide)
+    // ========================================================================
+
+    uint32_t BVH4::collapse(const std::vector<BuildNode>& tree, uint32_t binary) {
+        // Open the largest inner child until there are four
+        uint32_t children[4] = { tree[binary].left, tree[binary].right };
+        uint32_t childCount = 2;
+
+        while (childCount < 4) {
+            int widest = -1;
+            float widestArea = -1.0f;
+            for (uint32_t c = 0; c < childCount; ++c) {
+                const BuildNode& candidate = tree[children[c]];
+                if (candidate.count == 0 && candidate.bounds.surfaceArea() > widestArea) {
+                    widestArea = candidate.bounds.surfaceArea();
+                    widest = static_cast<int>(c);
+                }
+            }
+            if (widest < 0) break;
+
+            uint32_t opened = children[widest];
+            children[widest] = tree[opened].left;
+            children[childCount++] = tree[opened].right;
+        }
+
+        uint32_t index = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+
+        Node node;
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            if (lane >= childCount) {
+                // Inverted box: never hit
+                node.minX[lane] = node.minY[lane] = node.minZ[lane] = std::numeric_limits<float>::max();
+                node.maxX[lane] = node.maxY[lane] = node.maxZ[lane] = -std::numeric_limits<float>::max();
+                node.child[lane] = INVALID;
+                node.count[lane] = 0;
+                continue;
+            }
+
+            const BuildNode& child = tree[children[lane]];
+            node.minX[lane] = child.bounds.min.x; node.minY[lane] = child.bounds.min.y; node.minZ[lane] = child.bounds.min.z;
+            node.maxX[lane] = child.bounds.max.x; node.maxY[lane] = child.bounds.max.y; node.maxZ[lane] = child.bounds.max.z;
+
+            if (child.count > 0) {
+                node.child[lane] = child.first;
+                node.count[lane] = child.count;
+            }
+            else {
+                node.child[lane] = collapse(tree, children[lane]);
+                node.count[lane] = 0;
+            }
+        }
+
+        nodes_[index] = node;
+        return index;
+    }
+
+    // ========================================================================
+    // REFIT
+    // ========================================================================
+
+    float BVH4::laneArea(const Node& node, uint32_t lane) {
+        // A lane emptied by refit holds an inverted AABB{}: its extents are
+        // -inf, and counting them would turn the tracked cost into NaN
+        if (node.child[lane] == INVALID) return 0.0f;
+        float ex = node.maxX[lane] - node.minX[lane];
+        float ey = node.maxY[lane] - node.minY[lane];
+        float ez = node.maxZ[lane] - node.minZ[lane];
+        if (ex < 0.0f || ey < 0.0f || ez < 0.0f) return 0.0f;
+        return 2.0f * (ex * ey + ey * ez + ez * ex);
+    }
+
+    void BVH4::linkNodes(size_t primitiveCount) {
+        parents_.assign(nodes_.size(), INVALID);
+        primitiveLeaf_.assign(primitiveCount, INVALID);
+        refitStamp_.assign(nodes_.size(), 0);
+        refitEpoch_ = 0;
+        sahCost_ = 0.0;
+
+        for (uint32_t n = 0; n < nodes_.size(); ++n) {
+            const Node& node = nodes_[n];
+            for (uint32_t lane = 0; lane < 4; ++lane) {
+                if (node.child[lane] == INVALID) continue;
+                sahCost_ += laneCost(node, lane);
+
+                if (node.count[lane] == 0) {
+                    parents_[node.child[lane]] = (n << 2) | lane;
+                    continue;
+                }
+                for (uint32_t p = 0; p < node.count[lane]; ++p) {
+                    primitiveLeaf_[primitives_[node.child[lane] + p]] = (n << 2) | lane;
+                }
+            }
+        }
+    }
+
+    float BVH4::getCost() const {
+        float rootArea = bounds_.surfaceArea();
+        return rootArea > 0.0f ? static_cast<float>(sahCost_ / rootArea) : 0.0f;
+    }
+
+    size_t BVH4::refit(const AABB* boxes, const uint32_t* primitives, size_t count) {
+        if (nodes_.empty()) return count;
+
+        if (++refitEpoch_ == 0) {
+            std::fill(refitStamp_.begin(), refitStamp_.end(), 0);
+            refitEpoch_ = 1;
+        }
+
+        // Collect the leaf nodes and every ancestor once
+        size_t missing = 0;
+        refitNodes_.clear();
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t prim = primitives[i];
+            uint32_t link = prim < primitiveLeaf_.size() ? primitiveLeaf_[prim] : INVALID;
+            if (link == INVALID) {
+                ++missing;
+                continue;
+            }
+
+            for (uint32_t node = link >> 2; refitStamp_[node] != refitEpoch_; ) {
+                refitStamp_[node] = refitEpoch_;
+                refitNodes_.push_back(node);
+                if (parents_[node] == INVALID) break;
+                node = parents_[node] >> 2;
+            }
+        }
+
+        // Children before parents
+        std::sort(refitNodes_.begin(), refitNodes_.end(), std::greater<uint32_t>());
+
+        for (uint32_t n : refitNodes_) {
+            Node& node = nodes_[n];
+            for (uint32_t lane = 0; lane < 4; ++lane) {
+                if (node.child[lane] == INVALID) continue;
+
+                AABB box;
+                if (node.count[lane] > 0) {
+                    for (uint32_t p = 0; p < node.count[lane]; ++p) {
+                        box.expand(boxes[primitives_[node.child[lane] + p]]);
+                    }
+                }
+                else {
+                    const Node& child = nodes_[node.child[lane]];
+                    for (uint32_t c = 0; c < 4; ++c) {
+                        if (child.child[c] == INVALID) continue;
+                        box.expand(AABB{ glm::vec3(child.minX[c], child.minY[c], child.minZ[c]),
+                            glm::vec3(child.maxX[c], child.maxY[c], child.maxZ[c]) });
+                    }
+                }
+
+                sahCost_ -= laneCost(node, lane);
+                node.minX[lane] = box.min.x; node.minY[lane] = box.min.y; node.minZ[lane] = box.min.z;
+                node.maxX[lane] = box.max.x; node.maxY[lane] = box.max.y; node.maxZ[lane] = box.max.z;
+                sahCost_ += laneCost(node, lane);
+            }
+        }
+
+        if (!refitNodes_.empty()) {
+            const Node& root = nodes_[0];
+            bounds_ = AABB{};
+            for (uint32_t lane = 0; lane < 4; ++lane) {
+                if (root.child[lane] == INVALID) continue;
+                bounds_.expand(AABB{ glm::vec3(root.minX[lane], root.minY[lane], root.minZ[lane]),
+                    glm::vec3(root.maxX[lane], root.maxY[lane], root.maxZ[lane]) });
+            }
+        }
+        return missing;
+    }
+
+} // namespace libre
@@ -0,0 +1,420 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LIBRE_BVH_SSE 1
+#endif
+
+namespace libre {
+
+    // ============================================================================
+    // AABB
+    // ============================================================================
+
+    struct AABB {
+        glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+        glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+
+        void expand(const glm::vec3& p) { min = glm::min(min, p); max = glm::max(max, p); }
+        void expand(const AABB& b) { min = glm::min(min, b.min); max = glm::max(max, b.max); }
+        bool valid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+        glm::vec3 center() const { return (min + max) * 0.5f; }
+
+        float surfaceArea() const {
+            glm::vec3 e = glm::max(max - min, glm::vec3(0.0f));
+            return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+        }
+    };
+
+    // ============================================================================
+    // BVH RAY - Ray with the per-query constants precomputed once
+    // ============================================================================
+
+    struct BVHRay {
+        glm::vec3 origin;
+        glm::vec3 direction;
+        glm::vec3 invDirection;
+        float tMin = 0.0f;
+        float tMax = std::numeric_limits<float>::max();
+
+        BVHRay(const glm::vec3& o, const glm::vec3& d, float maxDistance = std::numeric_limits<float>::max())
+            : origin(o), direction(d), invDirection(1.0f / d), tMax(maxDistance) {}
+
+        // Slab test against one box; 'tNear' is the entry distance
+        bool intersects(const AABB& box, float& tNear) const {
+            glm::vec3 t0 = (box.min - origin) * invDirection;
+            glm::vec3 t1 = (box.max - origin) * invDirection;
+            glm::vec3 tSmall = glm::min(t0, t1);
+            glm::vec3 tBig = glm::max(t0, t1);
+
+            tNear = glm::max(glm::max(tSmall.x, tSmall.y), glm::max(tSmall.z, tMin));
+            float tFar = glm::min(glm::min(tBig.x, tBig.y), glm::min(tBig.z, tMax));
+            return tNear <= tFar;
+        }
+    };
+
+    // ============================================================================
+    // BVH4 - Four-wide bounding volume hierarchy over primitive boxes
+    // ============================================================================
+    // Built top-down with a binned SAH (16 bins per axis) into a binary tree,
+    // then collapsed so every node holds up to four children. Child boxes are
+    // stored SoA, so one node visit is a single 4-lane slab test (SSE2 on x86,
+    // scalar lanes elsewhere). Large builds split the top few levels serially
+    // and build the resulting subtrees on the JobSystem.
+    //
+    // The tree only knows primitive indices; callers test their own
+    // primitives (entity boxes, triangles) in the leaf callback.
+    //
+    // refit() updates the boxes of moved primitives and their ancestors
+    // without changing the topology. The SAH cost is tracked through refits;
+    // getDegradation() compares it against the cost right after the build so
+    // owners can decide when a full rebuild pays off.
+
+    class BVH4 {
+    public:
+        static constexpr uint32_t INVALID = 0xFFFFFFFF;
+        static constexpr uint32_t MAX_LEAF_SIZE = 4;
+
+        struct Node {
+            float minX[4], minY[4], minZ[4];
+            float maxX[4], maxY[4], maxZ[4];
+            uint32_t child[4];          // Node index, or first primitive slot for leaves
+            uint32_t count[4];          // 0 = inner child; INVALID child = empty lane
+        };
+
+        // Build over 'count' boxes. Invalid (empty) boxes are left out.
+        void build(const AABB* boxes, size_t count);
+        void clear();
+
+        // Re-fit after the boxes of 'primitives' changed ('boxes' is the same
+        // primitive-indexed array given to build, with new values). Returns
+        // the number of primitives that are not in the tree (left out of the
+        // build); those need a rebuild to become visible to queries.
+        size_t refit(const AABB* boxes, const uint32_t* primitives, size_t count);
+
+        // SAH cost relative to the root area, and its ratio to the post-build
+        // value (1 = as good as fresh, grows as refits loosen the tree)
+        float getCost() const;
+        float getDegradation() const { return buildCost_ > 0.0f ? getCost() / buildCost_ : 1.0f; }
+
+        bool empty() const { return nodes_.empty(); }
+        size_t getNodeCount() const { return nodes_.size(); }
+        size_t getPrimitiveCount() const { return primitives_.size(); }
+        const AABB& getBounds() const { return bounds_; }
+
+        const std::vector<Node>& getNodes() const { return nodes_; }
+
+        // Leaf slot -> original primitive index
+        uint32_t getPrimitive(uint32_t slot) const { return primitives_[slot]; }
+
+        // Whether the primitive is in a leaf (refit can move it); false for
+        // those left out of the build and indices past its count
+        bool contains(uint32_t primitive) const {
+            return primitive < primitiveLeaf_.size() && primitiveLeaf_[primitive] != INVALID;
+        }
+
+        // ========================================================================
+        // RAY TRAVERSAL
+        // ========================================================================
+        // Children are visited near to far. leaf(uint32_t primitive, BVHRay& ray)
+        // tests one primitive; it shortens ray.tMax on a hit (closest-hit) and
+        // returns true to stop the traversal early (any-hit).
+
+        template<typename LeafFunc>
+        void traverse(BVHRay& ray, LeafFunc&& leaf) const {
+            traverseLeaves(ray, [&](uint32_t first, uint32_t count, BVHRay& r) {
+                for (uint32_t p = 0; p < count; ++p) {
+                    if (leaf(primitives_[first + p], r)) return true;
+                }
+                return false;
+                });
+        }
+
+        // Same walk, one call per leaf: leaf(uint32_t firstSlot, uint32_t count,
+        // BVHRay& ray) gets the leaf's slot range (count <= MAX_LEAF_SIZE), for
+        // callers that keep primitive data in slot order and test a leaf at once.
+        template<typename LeafFunc>
+        void traverseLeaves(BVHRay& ray, LeafFunc&& leaf) const {
+            if (nodes_.empty()) return;
+
+            struct Entry { uint32_t node; float tNear; };
+            Entry stack[STACK_SIZE];
+            uint32_t top = 0;
+            stack[top++] = { 0, ray.tMin };
+
+            const int negX = ray.invDirection.x < 0.0f;
+            const int negY = ray.invDirection.y < 0.0f;
+            const int negZ = ray.invDirection.z < 0.0f;
+
+            while (top > 0) {
+                Entry entry = stack[--top];
+                if (entry.tNear > ray.tMax) continue;
+
+                const Node& node = nodes_[entry.node];
+                float tNear[4];
+                uint32_t mask = intersectNode(node, ray, negX, negY, negZ, tNear);
+                if (!mask) continue;
+
+                // Sort hit lanes near to far
+                uint32_t order[4];
+                uint32_t hits = 0;
+                for (uint32_t lane = 0; lane < 4; ++lane) {
+                    if (!(mask & (1u << lane))) continue;
+                    uint32_t k = hits++;
+                    while (k > 0 && tNear[order[k - 1]] > tNear[lane]) {
+                        order[k] = order[k - 1];
+                        --k;
+                    }
+                    order[k] = lane;
+                }
+
+                // Leaves first, nearest first: they are cheap and shrink tMax
+                // before any inner node is opened
+                for (uint32_t h = 0; h < hits; ++h) {
+                    uint32_t lane = order[h];
+                    if (node.count[lane] == 0 || tNear[lane] > ray.tMax) continue;
+                    if (leaf(node.child[lane], node.count[lane], ray)) return;
+                }
+
+                // Inner nodes far to near, so the nearest is popped next
+                for (uint32_t h = hits; h-- > 0; ) {
+                    uint32_t lane = order[h];
+                    if (node.count[lane] == 0 && node.child[lane] != INVALID && tNear[lane] <= ray.tMax) {
+                        stack[top++] = { node.child[lane], tNear[lane] };
+                    }
+                }
+            }
+        }
+
+        // ========================================================================
+        // BOX QUERIES
+        // ========================================================================
+
+        // func(uint32_t primitive) for every primitive whose leaf overlaps 'box'
+        template<typename Func>
+        void queryBox(const AABB& box, Func&& func) const {
+            if (nodes_.empty()) return;
+
+            uint32_t stack[STACK_SIZE];
+            uint32_t top = 0;
+            stack[top++] = 0;
+
+            while (top > 0) {
+                const Node& node = nodes_[stack[--top]];
+                for (uint32_t lane = 0; lane < 4; ++lane) {
+                    if (node.child[lane] == INVALID) continue;
+                    if (node.minX[lane] > box.max.x || node.maxX[lane] < box.min.x ||
+                        node.minY[lane] > box.max.y || node.maxY[lane] < box.min.y ||
+                        node.minZ[lane] > box.max.z || node.maxZ[lane] < box.min.z) continue;
+
+                    if (node.count[lane] == 0) {
+                        stack[top++] = node.child[lane];
+                    }
+                    else {
+                        for (uint32_t p = 0; p < node.count[lane]; ++p) {
+                            func(primitives_[node.child[lane] + p]);
+                        }
+                    }
+                }
+            }
+        }
+
+        // func(uint32_t primitive, bool contained) for every primitive in a
+        // leaf not entirely outside the convex volume bounded by 'planes'
+        // (inward, dot(plane.xyz, p) + plane.w >= 0 inside). 'contained' is
+        // true when the leaf or a node above it lies entirely inside, so the
+        // primitive needs no test of its own; whole subtrees are then taken
+        // without further plane tests.
+        template<typename Func>
+        void queryPlanes(const glm::vec4* planes, uint32_t planeCount, Func&& func) const {
+            if (nodes_.empty()) return;
+
+            struct Entry { uint32_t node; bool contained; };
+            Entry stack[STACK_SIZE];
+            uint32_t top = 0;
+            stack[top++] = { 0, false };
+
+            while (top > 0) {
+                Entry entry = stack[--top];
+                const Node& node = nodes_[entry.node];
+
+                uint32_t outside = 0, inside = 0xF;
+                if (!entry.contained) classifyNode(node, planes, planeCount, outside, inside);
+
+                for (uint32_t lane = 0; lane < 4; ++lane) {
+                    if (node.child[lane] == INVALID || (outside & (1u << lane))) continue;
+                    bool contained = entry.contained || (inside & (1u << lane));
+
+                    if (node.count[lane] == 0) {
+                        stack[top++] = { node.child[lane], contained };
+                    }
+                    else {
+                        for (uint32_t p = 0; p < node.count[lane]; ++p) {
+                            func(primitives_[node.child[lane] + p], contained);
+                        }
+                    }
+                }
+            }
+        }
+
+    private:
+        static constexpr uint32_t STACK_SIZE = 256;
+
+        // 4-lane slab test. Returns a lane mask of hit children and their
+        // entry distances.
+        static uint32_t intersectNode(const Node& node, const BVHRay& ray,
+            int negX, int negY, int negZ, float tNear[4]) {
+            const float* nearX = negX ? node.maxX : node.minX;
+            const float* farX = negX ? node.minX : node.maxX;
+            const float* nearY = negY ? node.maxY : node.minY;
+            const float* farY = negY ? node.minY : node.maxY;
+            const float* nearZ = negZ ? node.maxZ : node.minZ;
+            const float* farZ = negZ ? node.minZ : node.maxZ;
+
+#if LIBRE_BVH_SSE
+            const __m128 ox = _mm_set1_ps(ray.origin.x), oy = _mm_set1_ps(ray.origin.y), oz = _mm_set1_ps(ray.origin.z);
+            const __m128 ix = _mm_set1_ps(ray.invDirection.x), iy = _mm_set1_ps(ray.invDirection.y), iz = _mm_set1_ps(ray.invDirection.z);
+
+            __m128 tn = _mm_max_ps(
+                _mm_max_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(nearX), ox), ix),
+                    _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(nearY), oy), iy)),
+                _mm_max_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(nearZ), oz), iz), _mm_set1_ps(ray.tMin)));
+            __m128 tf = _mm_min_ps(
+                _mm_min_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(farX), ox), ix),
+                    _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(farY), oy), iy)),
+                _mm_min_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(farZ), oz), iz), _mm_set1_ps(ray.tMax)));
+
+            _mm_storeu_ps(tNear, tn);
+            return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(tn, tf)));
+#else
+            uint32_t mask = 0;
+            for (uint32_t lane = 0; lane < 4; ++lane) {
+                float tn = glm::max(glm::max((nearX[lane] - ray.origin.x) * ray.invDirection.x,
+                    (nearY[lane] - ray.origin.y) * ray.invDirection.y),
+                    glm::max((nearZ[lane] - ray.origin.z) * ray.invDirection.z, ray.tMin));
+                float tf = glm::min(glm::min((farX[lane] - ray.origin.x) * ray.invDirection.x,
+                    (farY[lane] - ray.origin.y) * ray.invDirection.y),
+                    glm::min((farZ[lane] - ray.origin.z) * ray.invDirection.z, ray.tMax));
+                tNear[lane] = tn;
+                if (tn <= tf) mask |= 1u << lane;
+            }
+            return mask;
+#endif
+        }
+
+        // 4-lane plane test. 'outside' gets the lanes entirely behind some
+        // plane (positive vertex behind it), 'inside' keeps the lanes entirely
+        // in front of every plane (negative vertex in front). Empty lanes'
+        // inverted boxes come out as outside.
+        static void classifyNode(const Node& node, const glm::vec4* planes, uint32_t planeCount,
+            uint32_t& outside, uint32_t& inside) {
+#if LIBRE_BVH_SSE
+            const __m128 minX = _mm_loadu_ps(node.minX), minY = _mm_loadu_ps(node.minY), minZ = _mm_loadu_ps(node.minZ);
+            const __m128 maxX = _mm_loadu_ps(node.maxX), maxY = _mm_loadu_ps(node.maxY), maxZ = _mm_loadu_ps(node.maxZ);
+            const __m128 zero = _mm_setzero_ps();
+
+            __m128 out = zero;
+            __m128 in = _mm_cmpeq_ps(zero, zero);
+            for (uint32_t p = 0; p < planeCount; ++p) {
+                const glm::vec4& plane = planes[p];
+                const __m128 nx = _mm_set1_ps(plane.x), ny = _mm_set1_ps(plane.y), nz = _mm_set1_ps(plane.z);
+                const __m128 w = _mm_set1_ps(plane.w);
+
+                __m128 dPos = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, plane.x >= 0.0f ? maxX : minX),
+                    _mm_mul_ps(ny, plane.y >= 0.0f ? maxY : minY)),
+                    _mm_add_ps(_mm_mul_ps(nz, plane.z >= 0.0f ? maxZ : minZ), w));
+                __m128 dNeg = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, plane.x >= 0.0f ? minX : maxX),
+                    _mm_mul_ps(ny, plane.y >= 0.0f ? minY : maxY)),
+                    _mm_add_ps(_mm_mul_ps(nz, plane.z >= 0.0f ? minZ : maxZ), w));
+
+                out = _mm_or_ps(out, _mm_cmplt_ps(dPos, zero));
+                in = _mm_and_ps(in, _mm_cmpge_ps(dNeg, zero));
+            }
+            outside = static_cast<uint32_t>(_mm_movemask_ps(out));
+            inside = static_cast<uint32_t>(_mm_movemask_ps(in)) & ~outside;
+#else
+            outside = 0;
+            inside = 0;
+            for (uint32_t lane = 0; lane < 4; ++lane) {
+                bool out = false, in = true;
+                for (uint32_t p = 0; p < planeCount; ++p) {
+                    const glm::vec4& plane = planes[p];
+                    float dPos = plane.x * (plane.x >= 0.0f ? node.maxX[lane] : node.minX[lane]) +
+                        plane.y * (plane.y >= 0.0f ? node.maxY[lane] : node.minY[lane]) +
+                        plane.z * (plane.z >= 0.0f ? node.maxZ[lane] : node.minZ[lane]) + plane.w;
+                    float dNeg = plane.x * (plane.x >= 0.0f ? node.minX[lane] : node.maxX[lane]) +
+                        plane.y * (plane.y >= 0.0f ? node.minY[lane] : node.maxY[lane]) +
+                        plane.z * (plane.z >= 0.0f ? node.minZ[lane] : node.maxZ[lane]) + plane.w;
+                    out |= dPos < 0.0f;
+                    in &= dNeg >= 0.0f;
+                }
+                if (out) outside |= 1u << lane;
+                else if (in) inside |= 1u << lane;
+            }
+#endif
+        }
+
+        // Binary SAH tree, collapsed into nodes_ after the build
+        struct BuildNode {
+            AABB bounds;
+            uint32_t left = INVALID;
+            uint32_t right = INVALID;
+            uint32_t first = 0;             // Leaves: range in primitives_
+            uint32_t count = 0;             // 0 = inner node
+        };
+
+        // Primitive data moved along with partitioning, so every build pass
+        // streams through memory instead of gathering by index
+        struct BuildPrimitive {
+            AABB bounds;
+            glm::vec3 centroid;
+            uint32_t index;
+        };
+
+        // A subtree left for the parallel phase of the build: its placeholder
+        // node in the shared tree and the primitive range it covers
+        struct DeferredSubtree {
+            uint32_t node;
+            uint32_t begin, end;
+            std::vector<BuildNode> tree;
+            uint32_t root = 0;
+        };
+
+        // 'deferred' != nullptr: ranges reaching PARALLEL_BUILD_DEPTH are
+        // recorded there instead of being built
+        static uint32_t buildRecursive(std::vector<BuildNode>& tree, std::vector<BuildPrimitive>& prims,
+            uint32_t begin, uint32_t end, std::vector<DeferredSubtree>* deferred, uint32_t depth);
+        uint32_t collapse(const std::vector<BuildNode>& tree, uint32_t binary);
+        void linkNodes(size_t primitiveCount);
+
+        static float laneArea(const Node& node, uint32_t lane);
+        float laneCost(const Node& node, uint32_t lane) const {
+            return laneArea(node, lane) * (node.count[lane] ? static_cast<float>(node.count[lane]) : 1.0f);
+        }
+
+        std::vector<Node> nodes_;
+        std::vector<uint32_t> primitives_;      // Leaf slot -> primitive index
+        AABB bounds_;
+
+        // Refit bookkeeping. Links are (node << 2) | lane; nodes are stored
+        // pre-order, so children always have larger indices than parents.
+        std::vector<uint32_t> parents_;         // Node -> lane in its parent
+        std::vector<uint32_t> primitiveLeaf_;   // Primitive -> leaf lane
+        std::vector<uint32_t> refitStamp_;
+        std::vector<uint32_t> refitNodes_;
+        uint32_t refitEpoch_ = 0;
+
+        double sahCost_ = 0.0;                  // Sum of lane area * cost
+        float buildCost_ = 0.0f;
+    };
+
+} // namespace libre
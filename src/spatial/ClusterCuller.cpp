@@ -0,0 +1,114 @@
+#include "ClusterCuller.h"
+#include "Frustum.h"
+
+#include <algorithm>
+
+namespace libre {
+
+    void ClusterCuller::setMeshlets(MeshHandle handle, std::shared_ptr<const MeshletData> meshlets) {
+        if (meshlets && !meshlets->meshlets.empty()) {
+            meshlets_[handle] = std::move(meshlets);
+        }
+        else {
+            meshlets_.erase(handle);
+        }
+    }
+
+    const MeshletData* ClusterCuller::getMeshlets(MeshHandle handle) const {
+        auto it = meshlets_.find(handle);
+        return it != meshlets_.end() ? it->second.get() : nullptr;
+    }
+
+    bool ClusterCuller::cull(MeshHandle handle, const glm::mat4& model, const glm::mat4& viewProjection,
+        const glm::vec3& cameraPosition, std::vector<DrawRange>& ranges) {
+        auto it = meshlets_.find(handle);
+        if (it == meshlets_.end()) return true;
+        return cullMeshlets(*it->second, model, viewProjection, cameraPosition, ranges, &stats_);
+    }
+
+    bool ClusterCuller::cullMeshlets(const MeshletData& data, const glm::mat4& model, const glm::mat4& viewProjection,
+        const glm::vec3& cameraPosition, std::vector<DrawRange>& ranges, Stats* stats) {
+        if (data.meshlets.empty()) return true;
+
+        // Object space: planes through the model matrix, camera through its inverse
+        Frustum frustum = Frustum::fromMatrix(viewProjection * model);
+        glm::vec3 viewer = glm::vec3(glm::inverse(model) * glm::vec4(cameraPosition, 1.0f));
+
+        size_t first = ranges.size();
+        size_t outside = 0, backFacing = 0, culledIndices = 0;
+        for (size_t m = 0; m < data.meshlets.size(); ++m) {
+            const Meshlet& meshlet = data.meshlets[m];
+            const MeshletBounds& bounds = data.bounds[m];
+
+            if (!frustum.intersectsSphere(bounds.center, bounds.radius)) {
+                ++outside;
+                culledIndices += meshlet.indexCount;
+                continue;
+            }
+            if (data.closed && Meshlets::isBackFacing(bounds, viewer)) {
+                ++backFacing;
+                culledIndices += meshlet.indexCount;
+                continue;
+            }
+
+            if (ranges.size() > first && ranges.back().firstIndex + ranges.back().indexCount == meshlet.firstIndex) {
+                ranges.back().indexCount += meshlet.indexCount;
+            }
+            else {
+                ranges.push_back({ meshlet.firstIndex, meshlet.indexCount });
+            }
+        }
+
+        size_t totalIndices = data.getTriangleCount() * 3;
+        if (stats) {
+            ++stats->meshes;
+            stats->meshlets += data.meshlets.size();
+            stats->outsideFrustum += outside;
+            stats->backFacing += backFacing;
+        }
+        if (ranges.size() == first) {
+            if (stats) stats->trianglesCulled += totalIndices / 3;
+            return false;
+        }
+        if (static_cast<float>(culledIndices) < MIN_CULLED_FRACTION * static_cast<float>(totalIndices)) {
+            ranges.resize(first);
+            return true;
+        }
+
+        // Too many draws: bridge every gap up to the one that brings the
+        // count down to MAX_DRAW_RANGES
+        size_t count = ranges.size() - first;
+        if (count > MAX_DRAW_RANGES) {
+            std::vector<uint32_t> gaps(count - 1);
+            for (size_t r = 0; r + 1 < count; ++r) {
+                const DrawRange& a = ranges[first + r];
+                gaps[r] = ranges[first + r + 1].firstIndex - (a.firstIndex + a.indexCount);
+            }
+            std::vector<uint32_t> sorted = gaps;
+            size_t bridges = count - MAX_DRAW_RANGES;
+            std::nth_element(sorted.begin(), sorted.begin() + (bridges - 1), sorted.end());
+            uint32_t limit = sorted[bridges - 1];
+
+            // Ties at the limit are bridged only while needed
+            size_t out = first;
+            for (size_t r = 0; r < count; ++r) {
+                if (r > 0 && bridges > 0 && gaps[r - 1] <= limit) {
+                    DrawRange& last = ranges[out - 1];
+                    culledIndices -= gaps[r - 1];
+                    last.indexCount = ranges[first + r].firstIndex + ranges[first + r].indexCount - last.firstIndex;
+                    --bridges;
+                    continue;
+                }
+                ranges[out++] = ranges[first + r];
+            }
+            ranges.resize(out);
+        }
+
+        if (stats) {
+            stats->trianglesCulled += culledIndices / 3;
+            stats->drawRanges += ranges.size() - first;
+        }
+        return true;
+    }
+
+} // namespace libre
@@ -0,0 +1,87 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include "../core/FrameData.h"
+#include "../mesh/Meshlets.h"
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace libre {
+
+    // ============================================================================
+    // CLUSTER CULLER - Per-meshlet culling inside visible meshes
+    // ============================================================================
+    // Runs after FrustumCuller/OcclusionCuller accepted a mesh, for meshes
+    // that UploadOptimizer split into meshlets. It works in the mesh's own
+    // space: the frustum planes come from viewProjection * model, and the
+    // camera position is brought in by the inverse model matrix. Both tests
+    // hold under any affine transform, including non-uniform scale and
+    // mirroring.
+    // - Frustum: the meshlet's bounding sphere against the six planes.
+    // - Back-facing: the meshlet's normal cone (closed meshes only, see
+    //   Meshlets.h).
+    //
+    // Surviving meshlets become DrawRanges. Meshlets are contiguous in the
+    // index buffer, so neighbours merge into one range. Past MAX_DRAW_RANGES
+    // the smallest gaps are bridged (drawing a few culled triangles). When
+    // the cull saves less than MIN_CULLED_FRACTION of the triangles, the
+    // whole mesh is drawn in one call instead.
+
+    class ClusterCuller {
+    public:
+        struct Stats {
+            size_t meshes = 0;              // Meshes with meshlets tested
+            size_t meshlets = 0;
+            size_t outsideFrustum = 0;
+            size_t backFacing = 0;
+            size_t trianglesCulled = 0;     // Not drawn (bridged gaps excluded)
+            size_t drawRanges = 0;
+        };
+
+        static constexpr size_t MAX_DRAW_RANGES = 64;
+        static constexpr float MIN_CULLED_FRACTION = 0.1f;
+
+        // Meshlets of the geometry uploaded under 'handle' (null removes)
+        void setMeshlets(MeshHandle handle, std::shared_ptr<const MeshletData> meshlets);
+        void remove(MeshHandle handle) { meshlets_.erase(handle); }
+
+        // Removes every handle for which stale(MeshHandle) -> bool holds
+        // (geometry destroyed without an upload to replace it)
+        template<typename Stale>
+        void prune(Stale&& stale) {
+            for (auto it = meshlets_.begin(); it != meshlets_.end();) {
+                if (stale(it->first)) it = meshlets_.erase(it);
+                else ++it;
+            }
+        }
+        const MeshletData* getMeshlets(MeshHandle handle) const;
+
+        // Resets the stats
+        void beginFrame() { stats_ = Stats{}; }
+
+        // Appends the ranges to draw for 'handle'. Returns false when every
+        // meshlet is culled. Appends nothing when the whole mesh should be
+        // drawn (no meshlets, or too little culled).
+        bool cull(MeshHandle handle, const glm::mat4& model, const glm::mat4& viewProjection,
+            const glm::vec3& cameraPosition, std::vector<DrawRange>& ranges);
+
+        // Same, usable without registering the meshlets
+        static bool cullMeshlets(const MeshletData& meshlets, const glm::mat4& model, const glm::mat4& viewProjection,
+            const glm::vec3& cameraPosition, std::vector<DrawRange>& ranges, Stats* stats = nullptr);
+
+        size_t getMeshCount() const { return meshlets_.size(); }
+        const Stats& getStats() const { return stats_; }
+
+    private:
+        std::unordered_map<MeshHandle, std::shared_ptr<const MeshletData>> meshlets_;
+        Stats stats_;
+    };
+
+} // namespace libre
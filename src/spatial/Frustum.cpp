@@ -0,0 +1,241 @@
+#include "Frustum.h"
+#include "../world/World.h"
+#include "../components/CoreComponents.h"
+#include "../core/FrameData.h"
+#include "../core/JobSystem.h"
+
+#include <chrono>
+#include <atomic>
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LIBRE_KERNEL_SSE 1
+#endif
+
+namespace libre {
+
+    // The kernel loads (center, radius), (min, max.x) and (max, center.x)
+    // as 16-byte rows straight out of BoundsComponent
+    static_assert(offsetof(BoundsComponent, worldMax) == offsetof(BoundsComponent, worldMin) + 12,
+        "BoundsComponent world box must be packed");
+    static_assert(offsetof(BoundsComponent, worldCenter) == offsetof(BoundsComponent, worldMax) + 12,
+        "BoundsComponent world box must be packed");
+    static_assert(offsetof(BoundsComponent, worldRadius) == offsetof(BoundsComponent, worldCenter) + 12,
+        "BoundsComponent center and radius must be packed");
+
+    // ========================================================================
+    // FRUSTUM
+    // ========================================================================
+
+    Frustum Frustum::fromMatrix(const glm::mat4& viewProjection) {
+        return fromClipRect(viewProjection, glm::vec2(-1.0f), glm::vec2(1.0f));
+    }
+
+    Frustum Frustum::fromClipRect(const glm::mat4& m, const glm::vec2& ndcMin, const glm::vec2& ndcMax) {
+        // Rows of the matrix (glm is column-major: m[column][row])
+        glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+        // x >= a * w  <=>  row0 - a * row3 >= 0, and so on
+        Frustum frustum;
+        frustum.planes[Left] = row0 - row3 * ndcMin.x;
+        frustum.planes[Right] = row3 * ndcMax.x - row0;
+        frustum.planes[Bottom] = row1 - row3 * ndcMin.y;
+        frustum.planes[Top] = row3 * ndcMax.y - row1;
+        frustum.planes[Near] = row2;            // 0 <= z
+        frustum.planes[Far] = row3 - row2;      // z <= w
+
+        for (glm::vec4& p : frustum.planes) {
+            float length = glm::length(glm::vec3(p));
+            if (length > 0.0f) p /= length;
+        }
+        return frustum;
+    }
+
+    Frustum Frustum::fromScreenRect(const glm::mat4& viewProjection, float x1, float y1, float x2, float y2,
+        float viewportWidth, float viewportHeight) {
+        auto toNdc = [&](float x, float y) {
+            return glm::vec2(2.0f * x / viewportWidth - 1.0f, 1.0f - 2.0f * y / viewportHeight);
+        };
+        glm::vec2 a = toNdc(x1, y1), b = toNdc(x2, y2);
+        return fromClipRect(viewProjection, glm::min(a, b), glm::max(a, b));
+    }
+
+    Frustum Frustum::fromCamera(const CameraData& camera) {
+        return fromMatrix(camera.projectionMatrix * camera.viewMatrix);
+    }
+
+    // ========================================================================
+    // CULL KERNELS
+    // ========================================================================
+
+    static bool cullOne(const Frustum& frustum, const BoundsComponent& b, FrustumTest test, size_t& boxTests) {
+        bool straddles = false;
+        for (const glm::vec4& p : frustum.planes) {
+            float d = glm::dot(glm::vec3(p), b.worldCenter) + p.w;
+            if (d < -b.worldRadius) return false;
+            straddles |= d < b.worldRadius;
+        }
+        if (!straddles) return true;
+
+        ++boxTests;
+        return frustum.testAABB(b.worldMin, b.worldMax, test);
+    }
+
+    // Writes visibility for [begin, end); returns the visible count. A sphere
+    // fully inside passes either test; one fully outside fails both.
+    static size_t cullRange(const Frustum& frustum, FrustumTest test, const BoundsComponent* bounds,
+        uint8_t* visible, size_t begin, size_t end, size_t& boxTests) {
+        size_t visibleCount = 0;
+        size_t i = begin;
+
+#if LIBRE_KERNEL_SSE
+        const bool touching = test == FrustumTest::Touching;
+        __m128 nx[Frustum::PLANE_COUNT], ny[Frustum::PLANE_COUNT], nz[Frustum::PLANE_COUNT], nw[Frustum::PLANE_COUNT];
+        for (int p = 0; p < Frustum::PLANE_COUNT; ++p) {
+            nx[p] = _mm_set1_ps(frustum.planes[p].x);
+            ny[p] = _mm_set1_ps(frustum.planes[p].y);
+            nz[p] = _mm_set1_ps(frustum.planes[p].z);
+            nw[p] = _mm_set1_ps(frustum.planes[p].w);
+        }
+        const __m128 zero = _mm_setzero_ps();
+
+        for (; i + 4 <= end; i += 4) {
+            const BoundsComponent* b = bounds + i;
+
+            // Spheres: rows (cx, cy, cz, r) -> columns
+            __m128 cx = _mm_loadu_ps(&b[0].worldCenter.x);
+            __m128 cy = _mm_loadu_ps(&b[1].worldCenter.x);
+            __m128 cz = _mm_loadu_ps(&b[2].worldCenter.x);
+            __m128 r = _mm_loadu_ps(&b[3].worldCenter.x);
+            _MM_TRANSPOSE4_PS(cx, cy, cz, r);
+            __m128 negR = _mm_sub_ps(zero, r);
+
+            __m128 outside = zero, straddle = zero;
+            for (int p = 0; p < Frustum::PLANE_COUNT; ++p) {
+                __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)),
+                    _mm_add_ps(_mm_mul_ps(nz[p], cz), nw[p]));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(d, negR));
+                straddle = _mm_or_ps(straddle, _mm_cmplt_ps(d, r));
+            }
+
+            int outMask = _mm_movemask_ps(outside);
+            int boxMask = _mm_movemask_ps(straddle) & ~outMask;
+            if (boxMask) {
+                // Boxes: rows (min, max.x) and (max, center.x) -> columns.
+                // Touching fails if the corner furthest along a plane's
+                // normal is behind it; Inside fails if the nearest one is.
+                __m128 minX = _mm_loadu_ps(&b[0].worldMin.x);
+                __m128 minY = _mm_loadu_ps(&b[1].worldMin.x);
+                __m128 minZ = _mm_loadu_ps(&b[2].worldMin.x);
+                __m128 unusedMin = _mm_loadu_ps(&b[3].worldMin.x);
+                _MM_TRANSPOSE4_PS(minX, minY, minZ, unusedMin);
+                __m128 maxX = _mm_loadu_ps(&b[0].worldMax.x);
+                __m128 maxY = _mm_loadu_ps(&b[1].worldMax.x);
+                __m128 maxZ = _mm_loadu_ps(&b[2].worldMax.x);
+                __m128 unusedMax = _mm_loadu_ps(&b[3].worldMax.x);
+                _MM_TRANSPOSE4_PS(maxX, maxY, maxZ, unusedMax);
+
+                __m128 boxOutside = zero;
+                for (int p = 0; p < Frustum::PLANE_COUNT; ++p) {
+                    const glm::vec4& plane = frustum.planes[p];
+                    __m128 px = (plane.x >= 0.0f) == touching ? maxX : minX;
+                    __m128 py = (plane.y >= 0.0f) == touching ? maxY : minY;
+                    __m128 pz = (plane.z >= 0.0f) == touching ? maxZ : minZ;
+                    __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], px), _mm_mul_ps(ny[p], py)),
+                        _mm_add_ps(_mm_mul_ps(nz[p], pz), nw[p]));
+                    boxOutside = _mm_or_ps(boxOutside, _mm_cmplt_ps(d, zero));
+                }
+                outMask |= _mm_movemask_ps(boxOutside) & boxMask;
+                for (int lane = 0; lane < 4; ++lane) boxTests += (boxMask >> lane) & 1;
+            }
+
+            for (int lane = 0; lane < 4; ++lane) {
+                uint8_t in = !((outMask >> lane) & 1);
+                visible[i + lane] = in;
+                visibleCount += in;
+            }
+        }
+#endif
+
+        for (; i < end; ++i) {
+            uint8_t in = cullOne(frustum, bounds[i], test, boxTests);
+            visible[i] = in;
+            visibleCount += in;
+        }
+        return visibleCount;
+    }
+
+    // ========================================================================
+    // CULLER
+    // ========================================================================
+
+    const char* FrustumCuller::getKernelName() {
+#if LIBRE_KERNEL_SSE
+        return "SSE2";
+#else
+        return "Scalar";
+#endif
+    }
+
+    void FrustumCuller::cull(const World& world, const Frustum& frustum, FrustumTest test) {
+        auto start = std::chrono::steady_clock::now();
+
+        const auto* storage = world.getStorage<BoundsComponent>();
+        size_t count = storage ? storage->size() : 0;
+        const BoundsComponent* bounds = storage ? storage->data() : nullptr;
+
+        visible_.resize(count);
+        storageData_ = bounds;
+
+        size_t visibleCount = 0, boxTests = 0;
+        if (count < PARALLEL_THRESHOLD) {
+            visibleCount = cullRange(frustum, test, bounds, visible_.data(), 0, count, boxTests);
+        }
+        else {
+            std::atomic<size_t> visibleTotal{ 0 }, boxTotal{ 0 };
+            JobSystem::instance().parallelFor(count, 4096, [&](size_t begin, size_t end) {
+                size_t chunkBoxTests = 0;
+                size_t chunkVisible = cullRange(frustum, test, bounds, visible_.data(), begin, end, chunkBoxTests);
+                visibleTotal.fetch_add(chunkVisible, std::memory_order_relaxed);
+                boxTotal.fetch_add(chunkBoxTests, std::memory_order_relaxed);
+                });
+            visibleCount = visibleTotal.load();
+            boxTests = boxTotal.load();
+        }
+
+        stats_.tested = count;
+        stats_.visible = visibleCount;
+        stats_.culled = count - visibleCount;
+        stats_.boxTests = boxTests;
+        stats_.lastCullMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void FrustumCuller::collectVisible(const World& world, std::vector<EntityID>& out) const {
+        const auto* storage = world.getStorage<BoundsComponent>();
+        if (!storage || storage->data() != storageData_ || storage->size() != visible_.size()) return;
+
+        const EntityID* entities = storage->entityData();
+        for (size_t i = 0; i < visible_.size(); ++i) {
+            if (visible_[i]) out.push_back(entities[i]);
+        }
+    }
+
+    bool FrustumCuller::isVisible(const World& world, EntityID entity) const {
+        const auto* storage = world.getStorage<BoundsComponent>();
+        const BoundsComponent* bounds = world.getComponent<BoundsComponent>(entity);
+        if (!storage || !bounds || storage->data() != storageData_ || storage->size() != visible_.size()) return true;
+
+        return visible_[static_cast<size_t>(bounds - storage->data())] != 0;
+    }
+
+    const uint8_t* FrustumCuller::getResults(const World& world) const {
+        const auto* storage = world.getStorage<BoundsComponent>();
+        if (!storage || storage->data() != storageData_ || storage->size() != visible_.size()) return nullptr;
+        return visible_.data();
+    }
+
+} // namespace libre
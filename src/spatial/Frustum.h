@@ -0,0 +1,130 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include "../world/Types.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace libre {
+
+    class World;
+    struct CameraData;
+
+    // How a box has to relate to a frustum to pass
+    enum class FrustumTest : uint8_t {
+        Touching,       // Any part inside (culling, touch marquee)
+        Inside,         // Entirely inside (enclose marquee)
+    };
+
+    // ============================================================================
+    // FRUSTUM - Six world-space planes of a view-projection
+    // ============================================================================
+    // Planes point inward: dot(plane.xyz, p) + plane.w >= 0 is inside.
+    // Extracted from the rows of the view-projection matrix (Gribb-Hartmann)
+    // for the [0, 1] clip depth the renderer uses. A sub-rectangle of the
+    // viewport gives the narrower frustum behind a marquee.
+
+    struct Frustum {
+        enum Plane { Left, Right, Bottom, Top, Near, Far, PLANE_COUNT };
+
+        glm::vec4 planes[PLANE_COUNT];
+
+        static Frustum fromMatrix(const glm::mat4& viewProjection);
+        static Frustum fromCamera(const CameraData& camera);
+
+        // Only the part of the view inside NDC [ndcMin, ndcMax] (x, y)
+        static Frustum fromClipRect(const glm::mat4& viewProjection, const glm::vec2& ndcMin, const glm::vec2& ndcMax);
+
+        // Screen-space rectangle in pixels (any two corners, y down, as in
+        // SelectionSystem::screenToRay)
+        static Frustum fromScreenRect(const glm::mat4& viewProjection, float x1, float y1, float x2, float y2,
+            float viewportWidth, float viewportHeight);
+
+        bool intersectsSphere(const glm::vec3& center, float radius) const {
+            for (const glm::vec4& p : planes) {
+                if (glm::dot(glm::vec3(p), center) + p.w < -radius) return false;
+            }
+            return true;
+        }
+
+        // Conservative: false only when the box is fully behind one plane
+        bool intersectsAABB(const glm::vec3& min, const glm::vec3& max) const {
+            for (const glm::vec4& p : planes) {
+                glm::vec3 positive(p.x >= 0.0f ? max.x : min.x, p.y >= 0.0f ? max.y : min.y, p.z >= 0.0f ? max.z : min.z);
+                if (glm::dot(glm::vec3(p), positive) + p.w < 0.0f) return false;
+            }
+            return true;
+        }
+
+        // True when the whole box is inside every plane
+        bool containsAABB(const glm::vec3& min, const glm::vec3& max) const {
+            for (const glm::vec4& p : planes) {
+                glm::vec3 negative(p.x >= 0.0f ? min.x : max.x, p.y >= 0.0f ? min.y : max.y, p.z >= 0.0f ? min.z : max.z);
+                if (glm::dot(glm::vec3(p), negative) + p.w < 0.0f) return false;
+            }
+            return true;
+        }
+
+        bool testAABB(const glm::vec3& min, const glm::vec3& max, FrustumTest test) const {
+            return test == FrustumTest::Inside ? containsAABB(min, max) : intersectsAABB(min, max);
+        }
+    };
+
+    // ============================================================================
+    // FRUSTUM CULLER - Visibility of every BoundsComponent for one view
+    // ============================================================================
+    // Tests the BoundsComponent array in place, four objects per step: a
+    // sphere test against all six planes first (center and radius load as
+    // one 16-byte row), then an AABB test only for objects whose sphere
+    // straddles a plane - positive vertex for Touching, negative vertex for
+    // Inside. SSE2 on x86, scalar elsewhere. Large scenes are split into
+    // chunks over the JobSystem.
+    //
+    // The result is indexed like the bounds storage, so it is valid until
+    // bounds are added or removed; isVisible() treats anything it has no
+    // result for as visible.
+
+    class FrustumCuller {
+    public:
+        struct Stats {
+            size_t tested = 0;
+            size_t visible = 0;
+            size_t culled = 0;
+            size_t boxTests = 0;        // Objects that needed the AABB stage
+            double lastCullMs = 0.0;
+        };
+
+        // Below this many objects the cull runs on the calling thread
+        static constexpr size_t PARALLEL_THRESHOLD = 16384;
+
+        // Name of the compiled-in kernel ("SSE2", "Scalar")
+        static const char* getKernelName();
+
+        void cull(const World& world, const Frustum& frustum, FrustumTest test = FrustumTest::Touching);
+
+        // Entities that passed the last cull, in storage order
+        void collectVisible(const World& world, std::vector<EntityID>& out) const;
+
+        // Whether 'entity' survived the last cull (entities without bounds,
+        // or with bounds added since, always do)
+        bool isVisible(const World& world, EntityID entity) const;
+
+        // Per dense BoundsComponent index (1 = visible), or nullptr when the
+        // last cull does not belong to the world's current bounds storage
+        const uint8_t* getResults(const World& world) const;
+
+        const Stats& getStats() const { return stats_; }
+
+    private:
+        std::vector<uint8_t> visible_;      // Per dense BoundsComponent index
+        const void* storageData_ = nullptr; // Storage the result belongs to
+
+        Stats stats_;
+    };
+
+} // namespace libre
@@ -0,0 +1,218 @@
+#include "MeshBVH.h"
+#include "../components/CoreComponents.h"
+#include "../core/JobSystem.h"
+
+#include <chrono>
+
+namespace libre {
+
+    // ========================================================================
+    // BUILD
+    // ========================================================================
+
+    std::shared_ptr<const MeshBVH> MeshBVH::get(MeshComponent& mesh) {
+        if (!mesh.pickBVH || !mesh.pickBVH->matches(mesh)) {
+            auto bvh = std::make_shared<MeshBVH>();
+            bvh->build(mesh.vertices.data(), mesh.vertices.size(), mesh.indices.data(), mesh.indices.size());
+            bvh->geometryVersion_ = mesh.geometryVersion;
+            mesh.pickBVH = std::move(bvh);
+        }
+        return mesh.pickBVH;
+    }
+
+    std::shared_ptr<const MeshBVH> MeshBVH::getAsync(MeshComponent& mesh) {
+        if (mesh.pickBVH && mesh.pickBVH->matches(mesh)) return mesh.pickBVH;
+
+        if (mesh.pickBVHBuild.valid()) {
+            if (mesh.pickBVHBuild.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return nullptr;
+
+            std::shared_ptr<const MeshBVH> built = mesh.pickBVHBuild.get();
+            mesh.pickBVHBuild = {};
+            if (built->matches(mesh)) {
+                mesh.pickBVH = std::move(built);
+                return mesh.pickBVH;
+            }
+        }
+
+        // The job builds from its own copy: the component may be edited or
+        // moved in its storage meanwhile
+        mesh.pickBVHBuild = JobSystem::instance().submit(
+            [vertices = mesh.vertices, indices = mesh.indices, version = mesh.geometryVersion]() -> std::shared_ptr<const MeshBVH> {
+                auto bvh = std::make_shared<MeshBVH>();
+                bvh->build(vertices.data(), vertices.size(), indices.data(), indices.size());
+                bvh->geometryVersion_ = version;
+                return bvh;
+            }).share();
+        return nullptr;
+    }
+
+    bool MeshBVH::matches(const MeshComponent& mesh) const {
+        return geometryVersion_ == mesh.geometryVersion &&
+            vertexCount_ == mesh.vertices.size() && indexCount_ == mesh.indices.size();
+    }
+
+    void MeshBVH::build(const MeshVertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount) {
+        vertexCount_ = vertexCount;
+        indexCount_ = indexCount;
+
+        size_t triangleCount = indexCount / 3;
+        auto& jobs = JobSystem::instance();
+
+        // Out-of-range triangles get an empty box and stay out of the tree
+        std::vector<AABB> boxes(triangleCount);
+        jobs.parallelFor(triangleCount, 4096, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t) {
+                uint32_t i0 = indices[t * 3], i1 = indices[t * 3 + 1], i2 = indices[t * 3 + 2];
+                if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount) continue;
+                boxes[t].expand(vertices[i0].position);
+                boxes[t].expand(vertices[i1].position);
+                boxes[t].expand(vertices[i2].position);
+            }
+            });
+
+        bvh_.build(boxes.data(), boxes.size());
+
+        size_t slots = bvh_.getPrimitiveCount();
+        size_t padded = slots + BVH4::MAX_LEAF_SIZE - 1;
+        for (auto* column : { &v0x_, &v0y_, &v0z_, &e1x_, &e1y_, &e1z_, &e2x_, &e2y_, &e2z_ }) {
+            column->assign(padded, 0.0f);
+        }
+        triangles_.resize(slots);
+
+        jobs.parallelFor(slots, 4096, [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; ++s) {
+                uint32_t t = bvh_.getPrimitive(static_cast<uint32_t>(s));
+                const glm::vec3& p0 = vertices[indices[t * 3]].position;
+                glm::vec3 e1 = vertices[indices[t * 3 + 1]].position - p0;
+                glm::vec3 e2 = vertices[indices[t * 3 + 2]].position - p0;
+
+                triangles_[s] = t;
+                v0x_[s] = p0.x; v0y_[s] = p0.y; v0z_[s] = p0.z;
+                e1x_[s] = e1.x; e1y_[s] = e1.y; e1z_[s] = e1.z;
+                e2x_[s] = e2.x; e2y_[s] = e2.y; e2z_[s] = e2.z;
+            }
+            });
+    }
+
+    // ========================================================================
+    // RAYCAST
+    // ========================================================================
+
+    const char* MeshBVH::getKernelName() {
+#if LIBRE_BVH_SSE
+        return "SSE2";
+#else
+        return "Scalar";
+#endif
+    }
+
+    bool MeshBVH::raycast(BVHRay& ray, Hit& hit) const {
+        uint32_t bestSlot = INVALID;
+        float bestU = 0.0f, bestV = 0.0f;
+
+        bvh_.traverseLeaves(ray, [&](uint32_t first, uint32_t count, BVHRay& r) {
+            float u, v;
+            uint32_t slot = intersectLeaf(first, count, r, u, v);
+            if (slot != INVALID) {
+                bestSlot = slot;
+                bestU = u;
+                bestV = v;
+            }
+            return false;
+            });
+
+        if (bestSlot == INVALID) return false;
+
+        hit.triangle = triangles_[bestSlot];
+        hit.distance = ray.tMax;
+        hit.u = bestU;
+        hit.v = bestV;
+        hit.normal = glm::normalize(glm::cross(
+            glm::vec3(e1x_[bestSlot], e1y_[bestSlot], e1z_[bestSlot]),
+            glm::vec3(e2x_[bestSlot], e2y_[bestSlot], e2z_[bestSlot])));
+        return true;
+    }
+
+    uint32_t MeshBVH::intersectLeaf(uint32_t first, uint32_t count, BVHRay& ray, float& u, float& v) const {
+        uint32_t best = INVALID;
+
+#if LIBRE_BVH_SSE
+        // Moller-Trumbore, one triangle per lane
+        const __m128 dx = _mm_set1_ps(ray.direction.x), dy = _mm_set1_ps(ray.direction.y), dz = _mm_set1_ps(ray.direction.z);
+        const __m128 e1x = _mm_loadu_ps(&e1x_[first]), e1y = _mm_loadu_ps(&e1y_[first]), e1z = _mm_loadu_ps(&e1z_[first]);
+        const __m128 e2x = _mm_loadu_ps(&e2x_[first]), e2y = _mm_loadu_ps(&e2y_[first]), e2z = _mm_loadu_ps(&e2z_[first]);
+
+        // p = d x e2, det = e1 . p
+        __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+        __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+        __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+        // s = o - v0
+        __m128 sx = _mm_sub_ps(_mm_set1_ps(ray.origin.x), _mm_loadu_ps(&v0x_[first]));
+        __m128 sy = _mm_sub_ps(_mm_set1_ps(ray.origin.y), _mm_loadu_ps(&v0y_[first]));
+        __m128 sz = _mm_sub_ps(_mm_set1_ps(ray.origin.z), _mm_loadu_ps(&v0z_[first]));
+        __m128 bu = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), invDet);
+
+        // q = s x e1
+        __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+        __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+        __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+        __m128 bv = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), invDet);
+        __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+
+        // Degenerate lanes (det == 0) give NaN/inf and fail the compares
+        const __m128 zero = _mm_setzero_ps();
+        __m128 inside = _mm_and_ps(_mm_cmpge_ps(bu, zero), _mm_cmpge_ps(bv, zero));
+        inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_add_ps(bu, bv), _mm_set1_ps(1.0f)));
+        inside = _mm_and_ps(inside, _mm_cmpneq_ps(det, zero));
+        inside = _mm_and_ps(inside, _mm_cmpgt_ps(t, _mm_set1_ps(ray.tMin)));
+        inside = _mm_and_ps(inside, _mm_cmplt_ps(t, _mm_set1_ps(ray.tMax)));
+
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(inside)) & ((1u << count) - 1);
+        if (!mask) return INVALID;
+
+        float ts[4], us[4], vs[4];
+        _mm_storeu_ps(ts, t);
+        _mm_storeu_ps(us, bu);
+        _mm_storeu_ps(vs, bv);
+        for (uint32_t lane = 0; lane < count; ++lane) {
+            if (!(mask & (1u << lane)) || ts[lane] >= ray.tMax) continue;
+            ray.tMax = ts[lane];
+            u = us[lane];
+            v = vs[lane];
+            best = first + lane;
+        }
+#else
+        for (uint32_t lane = 0; lane < count; ++lane) {
+            uint32_t s = first + lane;
+            glm::vec3 e1(e1x_[s], e1y_[s], e1z_[s]);
+            glm::vec3 e2(e2x_[s], e2y_[s], e2z_[s]);
+
+            glm::vec3 p = glm::cross(ray.direction, e2);
+            float det = glm::dot(e1, p);
+            if (det == 0.0f) continue;
+            float invDet = 1.0f / det;
+
+            glm::vec3 sv = ray.origin - glm::vec3(v0x_[s], v0y_[s], v0z_[s]);
+            float bu = glm::dot(sv, p) * invDet;
+            if (bu < 0.0f || bu > 1.0f) continue;
+
+            glm::vec3 q = glm::cross(sv, e1);
+            float bv = glm::dot(ray.direction, q) * invDet;
+            if (bv < 0.0f || bu + bv > 1.0f) continue;
+
+            float t = glm::dot(e2, q) * invDet;
+            if (t <= ray.tMin || t >= ray.tMax) continue;
+
+            ray.tMax = t;
+            u = bu;
+            v = bv;
+            best = s;
+        }
+#endif
+        return best;
+    }
+
+} // namespace libre
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "BVH.h"
+
+#include <vector>
+#include <memory>
+
+namespace libre {
+
+    struct MeshComponent;
+    struct MeshVertex;
+
+    // ============================================================================
+    // MESH BVH - Triangle BVH for exact ray picking of one geometry
+    // ============================================================================
+    // A BVH4 over the triangles of a mesh, in object space. After the build
+    // the triangles are copied into slot order as SoA vertex/edge arrays, so
+    // a leaf (up to four triangles) is one Moller-Trumbore test over a 4-wide
+    // packet (SSE2 on x86, scalar lanes elsewhere).
+    //
+    // Meshes hold their tree in MeshComponent::pickBVH; copies of a mesh
+    // share it. get() builds it on first use (triangle boxes, the BVH and the
+    // packets are all spread over the JobSystem), and again when the mesh's
+    // geometryVersion or a count changed. getAsync() never blocks: it starts
+    // the build as a JobSystem background job over a copy of the geometry and
+    // returns nullptr until a later call finds it done. markGeometryDirty()
+    // drops the tree and any build in flight.
+
+    class MeshBVH {
+    public:
+        static constexpr uint32_t INVALID = 0xFFFFFFFF;
+
+        struct Hit {
+            uint32_t triangle = INVALID;    // Index into indices / 3
+            float distance = std::numeric_limits<float>::max();   // In ray units
+            float u = 0.0f, v = 0.0f;       // Barycentrics of vertex 1 and 2
+            glm::vec3 normal = glm::vec3(0.0f);     // Geometric, object space, by winding
+
+            bool hit() const { return triangle != INVALID; }
+        };
+
+        // The mesh's tree, built now if it is missing or stale
+        static std::shared_ptr<const MeshBVH> get(MeshComponent& mesh);
+
+        // The mesh's tree if it is built and current; otherwise nullptr, with
+        // a background build started (or still running)
+        static std::shared_ptr<const MeshBVH> getAsync(MeshComponent& mesh);
+
+        // Name of the compiled-in triangle kernel ("SSE2", "Scalar")
+        static const char* getKernelName();
+
+        void build(const MeshVertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount);
+
+        // Closest triangle in (ray.tMin, ray.tMax), either side. Shortens
+        // ray.tMax to the hit. The direction need not be unit length; the
+        // distance is in units of it, so a world ray transformed into object
+        // space keeps its world distances.
+        bool raycast(BVHRay& ray, Hit& hit) const;
+
+        // Built from the mesh's current geometry (version and counts)
+        bool matches(const MeshComponent& mesh) const;
+
+        size_t getTriangleCount() const { return triangles_.size(); }
+        const BVH4& getTree() const { return bvh_; }
+
+    private:
+        // Test the leaf at [first, first + count); returns the closest slot hit
+        uint32_t intersectLeaf(uint32_t first, uint32_t count, BVHRay& ray, float& u, float& v) const;
+
+        BVH4 bvh_;
+
+        // Per slot (BVH leaf order), padded by MAX_LEAF_SIZE - 1 zero lanes so
+        // every leaf loads as one full packet
+        std::vector<float> v0x_, v0y_, v0z_;
+        std::vector<float> e1x_, e1y_, e1z_;
+        std::vector<float> e2x_, e2y_, e2z_;
+        std::vector<uint32_t> triangles_;   // Slot -> triangle index
+
+        size_t vertexCount_ = 0;
+        size_t indexCount_ = 0;
+        uint64_t geometryVersion_ = 0;      // MeshComponent::geometryVersion built from
+    };
+
+} // namespace libre
@@ -0,0 +1,458 @@
+#include "OcclusionCuller.h"
+#include "Frustum.h"
+#include "../world/World.h"
+#include "../components/CoreComponents.h"
+#include "../core/JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LIBRE_KERNEL_SSE 1
+#endif
+
+namespace libre {
+
+    static_assert(OcclusionCuller::WIDTH % OcclusionCuller::TILE == 0 && OcclusionCuller::HEIGHT % OcclusionCuller::TILE == 0,
+        "Depth buffer must be whole tiles");
+    static_assert(OcclusionCuller::WIDTH % 4 == 0, "Rows are rasterized four pixels at a time");
+
+    // Clip-space w below this is treated as on or behind the eye
+    static constexpr float MIN_W = 1e-6f;
+
+    static constexpr uint8_t OCCLUDER_SLOT = 2;
+
+    // Clip space -> depth buffer pixels (x, y) and depth (z)
+    static glm::vec3 toScreen(const glm::vec4& clip) {
+        float invW = 1.0f / clip.w;
+        return glm::vec3(
+            (clip.x * invW * 0.5f + 0.5f) * OcclusionCuller::WIDTH,
+            (clip.y * invW * 0.5f + 0.5f) * OcclusionCuller::HEIGHT,
+            clip.z * invW);
+    }
+
+    // Pixel index of a coordinate clamped to [-1, limit] (truncation matches
+    // floor there, except on (-1, 0), which callers clamp to 0 anyway)
+    static int toPixel(float coordinate, uint32_t limit) {
+        return static_cast<int>(std::min(std::max(coordinate, -1.0f), float(limit)));
+    }
+
+    const char* OcclusionCuller::getKernelName() {
+#if LIBRE_KERNEL_SSE
+        return "SSE2";
+#else
+        return "Scalar";
+#endif
+    }
+
+    OcclusionCuller::OcclusionCuller()
+        : bins_(TILES_Y)
+        , depth_(WIDTH * HEIGHT, 1.0f)
+        , tileDepth_(TILES_X * TILES_Y, 1.0f) {
+    }
+
+    // ========================================================================
+    // OCCLUDERS
+    // ========================================================================
+
+    void OcclusionCuller::begin(const glm::mat4& viewProjection) {
+        viewProjection_ = viewProjection;
+        occluders_.clear();
+        std::fill(depth_.begin(), depth_.end(), 1.0f);
+        std::fill(tileDepth_.begin(), tileDepth_.end(), 1.0f);
+    }
+
+    void OcclusionCuller::addOccluder(const glm::mat4& model, const glm::vec3* positions, size_t stride, size_t vertexCount,
+        const uint32_t* indices, size_t indexCount) {
+        if (vertexCount == 0 || indexCount < 3) return;
+        occluders_.push_back({ model, positions, stride, vertexCount, indices, indexCount });
+    }
+
+    void OcclusionCuller::setupOccluder(const Occluder& occluder, std::vector<Triangle>& out) const {
+        out.clear();
+
+        glm::mat4 toClip = viewProjection_ * occluder.model;
+        std::vector<glm::vec4> clip(occluder.vertexCount);
+        const char* base = reinterpret_cast<const char*>(occluder.positions);
+        for (size_t v = 0; v < occluder.vertexCount; ++v) {
+            const glm::vec3& p = *reinterpret_cast<const glm::vec3*>(base + v * occluder.stride);
+            clip[v] = toClip * glm::vec4(p, 1.0f);
+        }
+
+        auto emit = [&](const glm::vec4& c0, const glm::vec4& c1, const glm::vec4& c2) {
+            if (c0.w <= MIN_W || c1.w <= MIN_W || c2.w <= MIN_W) return;
+            glm::vec3 v[3] = { toScreen(c0), toScreen(c1), toScreen(c2) };
+
+            float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+            if (!(std::abs(area) > 1e-8f)) return;
+
+            Triangle tri;
+            float minX = std::min({ v[0].x, v[1].x, v[2].x }), maxX = std::max({ v[0].x, v[1].x, v[2].x });
+            float minY = std::min({ v[0].y, v[1].y, v[2].y }), maxY = std::max({ v[0].y, v[1].y, v[2].y });
+            if (maxX < 0.0f || maxY < 0.0f || minX >= float(WIDTH) || minY >= float(HEIGHT)) return;
+            tri.minX = std::max(0, static_cast<int>(std::floor(minX)));
+            tri.maxX = std::min(int(WIDTH) - 1, static_cast<int>(std::floor(maxX)));
+            tri.minY = std::max(0, static_cast<int>(std::floor(minY)));
+            tri.maxY = std::min(int(HEIGHT) - 1, static_cast<int>(std::floor(maxY)));
+
+            // cross(v[i+1] - v[i], p - v[i]) >= 0 inside, flipped for clockwise
+            float sign = area > 0.0f ? 1.0f : -1.0f;
+            for (int e = 0; e < 3; ++e) {
+                const glm::vec3& a = v[e];
+                const glm::vec3& b = v[(e + 1) % 3];
+                tri.edgeA[e] = -(b.y - a.y) * sign;
+                tri.edgeB[e] = (b.x - a.x) * sign;
+                tri.edgeC[e] = ((b.y - a.y) * a.x - (b.x - a.x) * a.y) * sign;
+            }
+
+            float invArea = 1.0f / area;
+            tri.depthA = ((v[1].z - v[0].z) * (v[2].y - v[0].y) - (v[2].z - v[0].z) * (v[1].y - v[0].y)) * invArea;
+            tri.depthB = ((v[2].z - v[0].z) * (v[1].x - v[0].x) - (v[1].z - v[0].z) * (v[2].x - v[0].x)) * invArea;
+            tri.depthC = v[0].z - tri.depthA * v[0].x - tri.depthB * v[0].y;
+            out.push_back(tri);
+        };
+
+        size_t triangleCount = occluder.indexCount / 3;
+        for (size_t t = 0; t < triangleCount; ++t) {
+            uint32_t i0 = occluder.indices[t * 3], i1 = occluder.indices[t * 3 + 1], i2 = occluder.indices[t * 3 + 2];
+            if (i0 >= occluder.vertexCount || i1 >= occluder.vertexCount || i2 >= occluder.vertexCount) continue;
+
+            const glm::vec4 in[3] = { clip[i0], clip[i1], clip[i2] };
+            int front = (in[0].z >= 0.0f) + (in[1].z >= 0.0f) + (in[2].z >= 0.0f);
+            if (front == 0) continue;
+            if (front == 3) {
+                emit(in[0], in[1], in[2]);
+                continue;
+            }
+
+            // Clip against the near plane (z = 0): a triangle or a quad
+            glm::vec4 poly[4];
+            int count = 0;
+            for (int e = 0; e < 3; ++e) {
+                const glm::vec4& a = in[e];
+                const glm::vec4& b = in[(e + 1) % 3];
+                if (a.z >= 0.0f) poly[count++] = a;
+                if ((a.z >= 0.0f) != (b.z >= 0.0f)) {
+                    poly[count++] = a + (b - a) * (a.z / (a.z - b.z));
+                }
+            }
+            for (int k = 1; k + 1 < count; ++k) emit(poly[0], poly[k], poly[k + 1]);
+        }
+    }
+
+    // ========================================================================
+    // RASTERIZER
+    // ========================================================================
+
+    void OcclusionCuller::rasterize() {
+        auto& jobs = JobSystem::instance();
+
+        triangles_.resize(occluders_.size());
+        jobs.parallelFor(occluders_.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t o = begin; o < end; ++o) setupOccluder(occluders_[o], triangles_[o]);
+            });
+
+        size_t triangleCount = 0;
+        for (auto& bin : bins_) bin.clear();
+        for (size_t o = 0; o < occluders_.size(); ++o) {
+            for (const Triangle& tri : triangles_[o]) {
+                for (int row = tri.minY / int(TILE); row <= tri.maxY / int(TILE); ++row) bins_[row].push_back(&tri);
+            }
+            triangleCount += triangles_[o].size();
+        }
+        stats_.occluderTriangles = triangleCount;
+
+        jobs.parallelFor(TILES_Y, 1, [&](size_t begin, size_t end) {
+            for (size_t row = begin; row < end; ++row) rasterizeTileRow(static_cast<uint32_t>(row));
+            });
+    }
+
+    void OcclusionCuller::rasterizeTileRow(uint32_t tileRow) {
+        const int rowBegin = int(tileRow * TILE), rowEnd = rowBegin + int(TILE);
+
+        for (const Triangle* tri : bins_[tileRow]) {
+            int y0 = std::max(tri->minY, rowBegin), y1 = std::min(tri->maxY, rowEnd - 1);
+            int x0 = tri->minX & ~3, x1 = tri->maxX;
+
+            for (int y = y0; y <= y1; ++y) {
+                float* row = depth_.data() + size_t(y) * WIDTH;
+                float fy = float(y) + 0.5f;
+                float e0 = tri->edgeA[0] * (float(x0) + 0.5f) + tri->edgeB[0] * fy + tri->edgeC[0];
+                float e1 = tri->edgeA[1] * (float(x0) + 0.5f) + tri->edgeB[1] * fy + tri->edgeC[1];
+                float e2 = tri->edgeA[2] * (float(x0) + 0.5f) + tri->edgeB[2] * fy + tri->edgeC[2];
+                float z = tri->depthA * (float(x0) + 0.5f) + tri->depthB * fy + tri->depthC;
+
+#if LIBRE_KERNEL_SSE
+                const __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+                const __m128 zero = _mm_setzero_ps();
+                __m128 w0 = _mm_add_ps(_mm_set1_ps(e0), _mm_mul_ps(_mm_set1_ps(tri->edgeA[0]), lanes));
+                __m128 w1 = _mm_add_ps(_mm_set1_ps(e1), _mm_mul_ps(_mm_set1_ps(tri->edgeA[1]), lanes));
+                __m128 w2 = _mm_add_ps(_mm_set1_ps(e2), _mm_mul_ps(_mm_set1_ps(tri->edgeA[2]), lanes));
+                __m128 wz = _mm_add_ps(_mm_set1_ps(z), _mm_mul_ps(_mm_set1_ps(tri->depthA), lanes));
+                const __m128 step0 = _mm_set1_ps(tri->edgeA[0] * 4.0f), step1 = _mm_set1_ps(tri->edgeA[1] * 4.0f);
+                const __m128 step2 = _mm_set1_ps(tri->edgeA[2] * 4.0f), stepZ = _mm_set1_ps(tri->depthA * 4.0f);
+
+                for (int x = x0; x <= x1; x += 4) {
+                    __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(w0, zero), _mm_cmpge_ps(w1, zero)), _mm_cmpge_ps(w2, zero));
+                    if (_mm_movemask_ps(inside)) {
+                        __m128 old = _mm_loadu_ps(row + x);
+                        __m128 nearer = _mm_min_ps(old, wz);
+                        _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+                    }
+                    w0 = _mm_add_ps(w0, step0);
+                    w1 = _mm_add_ps(w1, step1);
+                    w2 = _mm_add_ps(w2, step2);
+                    wz = _mm_add_ps(wz, stepZ);
+                }
+#else
+                for (int x = x0; x <= x1; ++x) {
+                    if (e0 >= 0.0f && e1 >= 0.0f && e2 >= 0.0f) row[x] = std::min(row[x], z);
+                    e0 += tri->edgeA[0];
+                    e1 += tri->edgeA[1];
+                    e2 += tri->edgeA[2];
+                    z += tri->depthA;
+                }
+#endif
+            }
+        }
+
+        // Farthest depth of each tile in the row
+        for (uint32_t tx = 0; tx < TILES_X; ++tx) {
+            float farthest = 0.0f;
+            for (int y = rowBegin; y < rowEnd; ++y) {
+                const float* row = depth_.data() + size_t(y) * WIDTH + tx * TILE;
+                for (uint32_t x = 0; x < TILE; ++x) farthest = std::max(farthest, row[x]);
+            }
+            tileDepth_[tileRow * TILES_X + tx] = farthest;
+        }
+    }
+
+    // ========================================================================
+    // OCCLUDEE TEST
+    // ========================================================================
+
+    // Projects world boxes to a pixel rectangle (minX, minY, maxX, maxY) and
+    // their nearest depth. Holds the view-projection broadcast to SSE lanes,
+    // so a batch of tests sets it up once.
+    class BoxProjector {
+    public:
+        explicit BoxProjector(const glm::mat4& m) : matrix_(m) {
+#if LIBRE_KERNEL_SSE
+            for (int col = 0; col < 4; ++col) {
+                for (int c = 0; c < 4; ++c) columns_[col][c] = _mm_set1_ps(m[col][c]);
+            }
+#endif
+        }
+
+        // False when a corner is on or behind the near plane
+        bool project(const glm::vec3& min, const glm::vec3& max, glm::vec4& rect, float& nearest) const {
+#if LIBRE_KERNEL_SSE
+            // Corners 0-3 at min.z and 4-7 at max.z, one corner per lane
+            const __m128 xs = _mm_setr_ps(min.x, max.x, min.x, max.x);
+            const __m128 ys = _mm_setr_ps(min.y, min.y, max.y, max.y);
+            __m128 clip[2][4];
+            for (int half = 0; half < 2; ++half) {
+                __m128 zs = _mm_set1_ps(half ? max.z : min.z);
+                for (int c = 0; c < 4; ++c) {
+                    clip[half][c] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(columns_[0][c], xs), _mm_mul_ps(columns_[1][c], ys)),
+                        _mm_add_ps(_mm_mul_ps(columns_[2][c], zs), columns_[3][c]));
+                }
+            }
+
+            const __m128 minW = _mm_set1_ps(MIN_W), zero = _mm_setzero_ps();
+            __m128 behind = _mm_or_ps(
+                _mm_or_ps(_mm_cmple_ps(clip[0][3], minW), _mm_cmplt_ps(clip[0][2], zero)),
+                _mm_or_ps(_mm_cmple_ps(clip[1][3], minW), _mm_cmplt_ps(clip[1][2], zero)));
+            if (_mm_movemask_ps(behind)) return false;
+
+            const __m128 halfW = _mm_set1_ps(0.5f * OcclusionCuller::WIDTH);
+            const __m128 halfH = _mm_set1_ps(0.5f * OcclusionCuller::HEIGHT);
+            __m128 sx[2], sy[2], sz[2];
+            for (int half = 0; half < 2; ++half) {
+                __m128 invW = _mm_div_ps(_mm_set1_ps(1.0f), clip[half][3]);
+                sx[half] = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(clip[half][0], invW), halfW), halfW);
+                sy[half] = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(clip[half][1], invW), halfH), halfH);
+                sz[half] = _mm_mul_ps(clip[half][2], invW);
+            }
+
+            // Rows (minX, minY, -maxX, -maxY) and nearest, reduced across lanes
+            __m128 lowX = _mm_min_ps(sx[0], sx[1]), lowY = _mm_min_ps(sy[0], sy[1]);
+            __m128 negHighX = _mm_sub_ps(zero, _mm_max_ps(sx[0], sx[1]));
+            __m128 negHighY = _mm_sub_ps(zero, _mm_max_ps(sy[0], sy[1]));
+            _MM_TRANSPOSE4_PS(lowX, lowY, negHighX, negHighY);
+            __m128 lows = _mm_min_ps(_mm_min_ps(lowX, lowY), _mm_min_ps(negHighX, negHighY));
+            __m128 z = _mm_min_ps(sz[0], sz[1]);
+            z = _mm_min_ps(z, _mm_shuffle_ps(z, z, _MM_SHUFFLE(2, 3, 0, 1)));
+            z = _mm_min_ps(z, _mm_shuffle_ps(z, z, _MM_SHUFFLE(1, 0, 3, 2)));
+
+            float lanes[4];
+            _mm_storeu_ps(lanes, lows);
+            rect = glm::vec4(lanes[0], lanes[1], -lanes[2], -lanes[3]);
+            nearest = _mm_cvtss_f32(z);
+#else
+            rect = glm::vec4(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+            nearest = std::numeric_limits<float>::max();
+            for (int corner = 0; corner < 8; ++corner) {
+                glm::vec3 p((corner & 1) ? max.x : min.x, (corner & 2) ? max.y : min.y, (corner & 4) ? max.z : min.z);
+                glm::vec4 clip = matrix_ * glm::vec4(p, 1.0f);
+                if (clip.w <= MIN_W || clip.z < 0.0f) return false;
+
+                glm::vec3 s = toScreen(clip);
+                rect = glm::vec4(std::min(rect.x, s.x), std::min(rect.y, s.y), std::max(rect.z, s.x), std::max(rect.w, s.y));
+                nearest = std::min(nearest, s.z);
+            }
+#endif
+            return true;
+        }
+
+    private:
+        glm::mat4 matrix_;
+#if LIBRE_KERNEL_SSE
+        __m128 columns_[4][4];
+#endif
+    };
+
+    bool OcclusionCuller::isOccluded(const glm::vec3& min, const glm::vec3& max) const {
+        glm::vec4 rect;
+        float nearest;
+        return BoxProjector(viewProjection_).project(min, max, rect, nearest) && isRectOccluded(rect, nearest);
+    }
+
+    bool OcclusionCuller::isRectOccluded(const glm::vec4& rect, float nearest) const {
+        // Off the buffer: leave it to the frustum test
+        if (rect.z < 0.0f || rect.w < 0.0f || rect.x >= float(WIDTH) || rect.y >= float(HEIGHT)) return false;
+
+        // One pixel of margin: occluders only cover the pixels whose centers
+        // they contain, so a box seen past an occluder's edge may sit in a
+        // pixel the occluder claimed
+        int px0 = std::max(0, toPixel(rect.x, WIDTH) - 1);
+        int py0 = std::max(0, toPixel(rect.y, HEIGHT) - 1);
+        int px1 = std::min(int(WIDTH) - 1, toPixel(rect.z, WIDTH) + 1);
+        int py1 = std::min(int(HEIGHT) - 1, toPixel(rect.w, HEIGHT) + 1);
+
+        for (int ty = py0 / int(TILE); ty <= py1 / int(TILE); ++ty) {
+            for (int tx = px0 / int(TILE); tx <= px1 / int(TILE); ++tx) {
+                if (tileDepth_[ty * TILES_X + tx] < nearest) continue;
+
+                // Tile not settled: only the covered pixels count
+                int y0 = std::max(py0, ty * int(TILE)), y1 = std::min(py1, ty * int(TILE) + int(TILE) - 1);
+                int x0 = std::max(px0, tx * int(TILE)), x1 = std::min(px1, tx * int(TILE) + int(TILE) - 1);
+                for (int y = y0; y <= y1; ++y) {
+                    const float* row = depth_.data() + size_t(y) * WIDTH;
+                    for (int x = x0; x <= x1; ++x) {
+                        if (row[x] >= nearest) return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    // ========================================================================
+    // WORLD PASS
+    // ========================================================================
+
+    void OcclusionCuller::cull(const World& world, const glm::mat4& viewProjection, const FrustumCuller& frustum) {
+        auto start = std::chrono::steady_clock::now();
+        begin(viewProjection);
+
+        const auto* storage = world.getStorage<BoundsComponent>();
+        size_t count = storage ? storage->size() : 0;
+        const BoundsComponent* bounds = storage ? storage->data() : nullptr;
+        const EntityID* entities = storage ? storage->entityData() : nullptr;
+        const uint8_t* inView = frustum.getResults(world);
+
+        occluded_.assign(count, 0);
+        storageData_ = bounds;
+
+        // Rank the frustum survivors by bounding radius over view depth
+        const glm::vec4 depthRow(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+        std::vector<std::pair<float, uint32_t>> candidates;
+        for (size_t i = 0; i < count; ++i) {
+            if (inView && !inView[i]) continue;
+            float w = glm::dot(depthRow, glm::vec4(bounds[i].worldCenter, 1.0f));
+            float size = bounds[i].worldRadius / std::max(w, 1e-3f);
+            if (size >= MIN_OCCLUDER_SIZE) candidates.emplace_back(size, static_cast<uint32_t>(i));
+        }
+        auto larger = [](const std::pair<float, uint32_t>& a, const std::pair<float, uint32_t>& b) { return a.first > b.first; };
+        size_t shortlist = std::min(candidates.size(), MAX_OCCLUDERS * 4);
+        std::partial_sort(candidates.begin(), candidates.begin() + shortlist, candidates.end(), larger);
+
+        // Opaque, visible meshes (or their proxies) from the top of the list
+        std::vector<uint32_t> occluderSlots;
+        for (size_t c = 0; c < shortlist && occluderSlots.size() < MAX_OCCLUDERS; ++c) {
+            uint32_t i = candidates[c].second;
+            EntityID id = entities[i];
+            if (!world.isVisible(id)) continue;
+
+            const auto* render = world.getComponent<RenderComponent>(id);
+            if (render && (!render->visible || render->opacity < 1.0f)) continue;
+            const auto* transform = world.getComponent<TransformComponent>(id);
+            if (!transform) continue;
+
+            if (const auto* proxy = world.getComponent<OccluderComponent>(id)) {
+                if (!proxy->enabled || proxy->vertices.empty()) continue;
+                addOccluder(transform->worldMatrix, proxy->vertices.data(), sizeof(glm::vec3), proxy->vertices.size(),
+                    proxy->indices.data(), proxy->indices.size());
+            }
+            else {
+                const auto* mesh = world.getComponent<MeshComponent>(id);
+                if (!mesh || mesh->vertices.empty() || mesh->getTriangleCount() > MAX_OCCLUDER_TRIANGLES) continue;
+                addOccluder(transform->worldMatrix, &mesh->vertices[0].position, sizeof(MeshVertex), mesh->vertices.size(),
+                    mesh->indices.data(), mesh->indices.size());
+            }
+            occluderSlots.push_back(i);
+        }
+
+        rasterize();
+        stats_.occluders = occluders_.size();
+
+        auto rasterEnd = std::chrono::steady_clock::now();
+        stats_.rasterMs = std::chrono::duration<double, std::milli>(rasterEnd - start).count();
+
+        // Occluders would hide themselves
+        for (uint32_t i : occluderSlots) occluded_[i] = OCCLUDER_SLOT;
+
+        std::atomic<size_t> testedTotal{ 0 }, occludedTotal{ 0 };
+        if (!occluders_.empty()) {
+            JobSystem::instance().parallelFor(count, 4096, [&](size_t begin, size_t end) {
+                BoxProjector projector(viewProjection_);
+                size_t tested = 0, hidden = 0;
+                for (size_t i = begin; i < end; ++i) {
+                    if (occluded_[i] == OCCLUDER_SLOT) {
+                        occluded_[i] = 0;
+                        continue;
+                    }
+                    if (inView && !inView[i]) continue;
+                    ++tested;
+                    glm::vec4 rect;
+                    float nearest;
+                    uint8_t isHidden = projector.project(bounds[i].worldMin, bounds[i].worldMax, rect, nearest) &&
+                        isRectOccluded(rect, nearest);
+                    occluded_[i] = isHidden;
+                    hidden += isHidden;
+                }
+                testedTotal.fetch_add(tested, std::memory_order_relaxed);
+                occludedTotal.fetch_add(hidden, std::memory_order_relaxed);
+                });
+        }
+
+        stats_.tested = testedTotal.load();
+        stats_.occluded = occludedTotal.load();
+        stats_.testMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - rasterEnd).count();
+    }
+
+    bool OcclusionCuller::isOccluded(const World& world, EntityID entity) const {
+        const auto* storage = world.getStorage<BoundsComponent>();
+        const BoundsComponent* bounds = world.getComponent<BoundsComponent>(entity);
+        if (!storage || !bounds || storage->data() != storageData_ || storage->size() != occluded_.size()) return false;
+
+        return occluded_[static_cast<size_t>(bounds - storage->data())] != 0;
+    }
+
+} // namespace libre
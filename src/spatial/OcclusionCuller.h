@@ -0,0 +1,135 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include "../world/Types.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace libre {
+
+    class World;
+    class FrustumCuller;
+
+    // ============================================================================
+    // OCCLUSION CULLER - Low-resolution CPU depth buffer for hidden objects
+    // ============================================================================
+    // Software occlusion culling after the frustum test, on the JobSystem and
+    // without the GPU:
+    // 1. Occluders: the frustum-visible opaque meshes with the largest
+    //    projected size (OccluderComponent proxies when present, otherwise
+    //    meshes up to MAX_OCCLUDER_TRIANGLES).
+    // 2. Their triangles are clipped to the near plane and rasterized into a
+    //    WIDTH x HEIGHT depth buffer, four pixels per step (SSE2 on x86,
+    //    scalar elsewhere), one job per row of TILE x TILE tiles. Depth is
+    //    clip z / w, nearest kept.
+    // 3. Each tile keeps its farthest depth (hierarchical Z). An occludee's
+    //    world box is projected to a pixel rectangle and its nearest depth;
+    //    it is hidden when that depth is behind every covered tile. Tiles
+    //    that do not settle it are checked per pixel.
+    //
+    // Depth is sampled at pixel centers. Boxes crossing the near plane and
+    // the occluders themselves are never hidden. Results are indexed like
+    // the bounds storage, as in FrustumCuller; isOccluded() is false for
+    // anything without a result.
+
+    class OcclusionCuller {
+    public:
+        static constexpr uint32_t WIDTH = 320;
+        static constexpr uint32_t HEIGHT = 192;
+        static constexpr uint32_t TILE = 8;
+        static constexpr uint32_t TILES_X = WIDTH / TILE;
+        static constexpr uint32_t TILES_Y = HEIGHT / TILE;
+
+        static constexpr size_t MAX_OCCLUDERS = 32;
+        static constexpr size_t MAX_OCCLUDER_TRIANGLES = 4096;
+
+        // Bounding radius over view depth below which a mesh never occludes
+        static constexpr float MIN_OCCLUDER_SIZE = 0.1f;
+
+        struct Stats {
+            size_t occluders = 0;
+            size_t occluderTriangles = 0;   // After near-plane clipping
+            size_t tested = 0;              // Frustum-visible boxes
+            size_t occluded = 0;
+            double rasterMs = 0.0;          // Selection, raster and hi-Z
+            double testMs = 0.0;
+        };
+
+        // Name of the compiled-in kernel ("SSE2", "Scalar")
+        static const char* getKernelName();
+
+        OcclusionCuller();
+
+        // Full pass over the survivors of 'frustum' (culled for the same
+        // view): pick occluders, rasterize them, test everything else
+        void cull(const World& world, const glm::mat4& viewProjection, const FrustumCuller& frustum);
+
+        // Whether 'entity' was hidden by the last cull
+        bool isOccluded(const World& world, EntityID entity) const;
+
+        // ====================================================================
+        // Steps of cull(), usable without a World
+        // ====================================================================
+
+        // Reset the depth buffer to the far plane and drop all occluders
+        void begin(const glm::mat4& viewProjection);
+
+        // Queue an occluder; 'positions' are object space, 'stride' in bytes.
+        // The data must stay alive until rasterize() returns.
+        void addOccluder(const glm::mat4& model, const glm::vec3* positions, size_t stride, size_t vertexCount,
+            const uint32_t* indices, size_t indexCount);
+
+        // Draw the queued occluders and build the tile depths
+        void rasterize();
+
+        // Whether a world-space box is entirely behind the rasterized depth
+        bool isOccluded(const glm::vec3& min, const glm::vec3& max) const;
+
+        // WIDTH x HEIGHT nearest depths, row-major, 1.0 where nothing was drawn
+        const float* getDepthData() const { return depth_.data(); }
+
+        const Stats& getStats() const { return stats_; }
+
+    private:
+        struct Occluder {
+            glm::mat4 model;
+            const glm::vec3* positions;
+            size_t stride;
+            size_t vertexCount;
+            const uint32_t* indices;
+            size_t indexCount;
+        };
+
+        // Screen-space setup: edge functions >= 0 inside, depth plane
+        struct Triangle {
+            float edgeA[3], edgeB[3], edgeC[3];
+            float depthA, depthB, depthC;
+            int minX, maxX, minY, maxY;
+        };
+
+        void setupOccluder(const Occluder& occluder, std::vector<Triangle>& out) const;
+        void rasterizeTileRow(uint32_t tileRow);
+
+        // Pixel rectangle (minX, minY, maxX, maxY) behind the depth buffer
+        bool isRectOccluded(const glm::vec4& rect, float nearest) const;
+
+        glm::mat4 viewProjection_ = glm::mat4(1.0f);
+        std::vector<Occluder> occluders_;
+        std::vector<std::vector<Triangle>> triangles_;     // Per occluder
+        std::vector<std::vector<const Triangle*>> bins_;   // Per tile row
+
+        std::vector<float> depth_;          // WIDTH x HEIGHT
+        std::vector<float> tileDepth_;      // Farthest depth per tile
+
+        std::vector<uint8_t> occluded_;     // Per dense BoundsComponent index
+        const void* storageData_ = nullptr; // Storage the result belongs to
+
+        Stats stats_;
+    };
+
+} // namespace libre
@@ -0,0 +1,272 @@
+#include "SceneBVH.h"
+#include "../world/World.h"
+#include "../core/JobSystem.h"
+
+#include <chrono>
+#include <algorithm>
+
+namespace libre {
+
+    SceneBVH::~SceneBVH() {
+        // The job owns its snapshot; just don't leave it running past us
+        if (pending_.valid()) pending_.wait();
+    }
+
+    // ========================================================================
+    // SYNC
+    // ========================================================================
+
+    uint32_t SceneBVH::findPrimitive(EntityID id) const {
+        uint32_t slot = getEntityIndex(id);
+        uint32_t prim = slot < slotPrimitive_.size() ? slotPrimitive_[slot] : NO_PRIMITIVE;
+        return prim != NO_PRIMITIVE && entities_[prim] == id ? prim : NO_PRIMITIVE;
+    }
+
+    const BoundsComponent* SceneBVH::findBounds(const BoundsStorage& storage, uint32_t prim) {
+        // Swap-removes shuffle the dense array; look up only when it moved
+        uint32_t index = denseIndex_[prim];
+        if (index >= storage.size() || storage.entityData()[index] != entities_[prim]) {
+            const BoundsComponent* bounds = storage.get(entities_[prim]);
+            if (!bounds) return nullptr;
+            index = denseIndex_[prim] = static_cast<uint32_t>(bounds - storage.data());
+        }
+        return storage.data() + index;
+    }
+
+    void SceneBVH::markRefit(uint32_t prim) {
+        if (refitStamp_[prim] == refitEpoch_) return;
+        refitStamp_[prim] = refitEpoch_;
+        refitList_.push_back(prim);
+
+        // A box the tree cannot place goes to the linear list (and asks for a rebuild)
+        if (isLive(prim) && boxes_[prim].valid() && !bvh_.contains(prim)) {
+            unindexed_.push_back(prim);
+            needsRebuild_ = true;
+        }
+    }
+
+    void SceneBVH::addPrimitive(const BoundsStorage& storage, EntityID id) {
+        // Gone again later in the journal, or already in
+        const BoundsComponent* bounds = storage.get(id);
+        if (!bounds || findPrimitive(id) != NO_PRIMITIVE) return;
+
+        uint32_t prim;
+        if (!freePrimitives_.empty()) {
+            prim = freePrimitives_.back();
+            freePrimitives_.pop_back();
+        }
+        else {
+            prim = static_cast<uint32_t>(entities_.size());
+            entities_.push_back(INVALID_ENTITY);
+            boxes_.emplace_back();
+            denseIndex_.push_back(0);
+            refitStamp_.push_back(0);
+        }
+
+        entities_[prim] = id;
+        boxes_[prim].min = bounds->worldMin;
+        boxes_[prim].max = bounds->worldMax;
+        denseIndex_[prim] = static_cast<uint32_t>(bounds - storage.data());
+
+        uint32_t slot = getEntityIndex(id);
+        if (slot >= slotPrimitive_.size()) {
+            slotPrimitive_.resize(static_cast<size_t>(slot) + 1, NO_PRIMITIVE);
+        }
+        slotPrimitive_[slot] = prim;
+
+        // A reused number still in the tree is placed by the refit
+        markRefit(prim);
+    }
+
+    void SceneBVH::removePrimitive(EntityID id) {
+        uint32_t prim = findPrimitive(id);
+        if (prim == NO_PRIMITIVE) return;
+
+        // The empty box shrinks its leaf on refit; the number is reused
+        entities_[prim] = INVALID_ENTITY;
+        boxes_[prim] = AABB{};
+        slotPrimitive_[getEntityIndex(id)] = NO_PRIMITIVE;
+        freePrimitives_.push_back(prim);
+        markRefit(prim);
+    }
+
+    void SceneBVH::collectUnindexed() {
+        unindexed_.clear();
+        for (uint32_t prim = 0; prim < entities_.size(); ++prim) {
+            if (isLive(prim) && boxes_[prim].valid() && !bvh_.contains(prim)) unindexed_.push_back(prim);
+        }
+    }
+
+    void SceneBVH::update(World& world, const std::vector<EntityID>& movedBounds) {
+        stats_.refitCount = 0;
+        stats_.membershipChanges = 0;
+
+        auto* storage = world.getStorage<BoundsComponent>();
+        uint64_t version = storage ? storage->getVersion() : 0;
+
+        // Membership changes since the last sync, or start over
+        const BoundsStorage::MembershipChange* changes = nullptr;
+        size_t changeCount = 0;
+        if (version != cachedStorageVersion_ &&
+            (!storage || !storage->getChangesSince(cachedStorageVersion_, changes, changeCount))) {
+            rebuild(world);
+            return;
+        }
+        cachedStorageVersion_ = version;
+        if (!storage) return;
+
+        if (++refitEpoch_ == 0) {
+            std::fill(refitStamp_.begin(), refitStamp_.end(), 0);
+            refitEpoch_ = 1;
+        }
+        refitList_.clear();
+        needsRebuild_ = false;
+
+        if (changeCount > 0) {
+            for (size_t i = 0; i < changeCount; ++i) {
+                if (changes[i].added) addPrimitive(*storage, changes[i].entity);
+                else removePrimitive(changes[i].entity);
+            }
+
+            stats_.membershipChanges = changeCount;
+        }
+
+        // Gather moved primitives once each and copy their new boxes
+        for (EntityID id : movedBounds) {
+            uint32_t prim = findPrimitive(id);
+            if (prim == NO_PRIMITIVE || refitStamp_[prim] == refitEpoch_) continue;
+
+            const BoundsComponent* bounds = findBounds(*storage, prim);
+            if (!bounds) continue;
+            boxes_[prim].min = bounds->worldMin;
+            boxes_[prim].max = bounds->worldMax;
+            markRefit(prim);
+        }
+
+        if (needsRebuild_ || changeCount > 0) {
+            // Freed numbers leave the list; others may be on it twice
+            unindexed_.erase(std::remove_if(unindexed_.begin(), unindexed_.end(),
+                [this](uint32_t prim) { return !isLive(prim) || !boxes_[prim].valid(); }), unindexed_.end());
+            std::sort(unindexed_.begin(), unindexed_.end());
+            unindexed_.erase(std::unique(unindexed_.begin(), unindexed_.end()), unindexed_.end());
+
+            if (unindexed_.size() > MAX_UNINDEXED) {
+                rebuild(world);
+                return;
+            }
+        }
+
+        if (!refitList_.empty()) {
+            bvh_.refit(boxes_.data(), refitList_.data(), refitList_.size());
+            if (pending_.valid()) {
+                movedSinceSnapshot_.insert(movedSinceSnapshot_.end(), refitList_.begin(), refitList_.end());
+            }
+            stats_.refitCount = refitList_.size();
+        }
+
+        if (pending_.valid()) {
+            if (pending_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                swapInRebuild();
+            }
+        }
+        else if (needsRebuild_ || bvh_.getDegradation() > REBUILD_DEGRADATION) {
+            // New boxes outside the tree (added, or empty at build time) are
+            // only found by the linear scan until a rebuild takes them in
+            startBackgroundRebuild();
+        }
+
+        stats_.entityCount = entities_.size() - freePrimitives_.size();
+        stats_.unindexedCount = unindexed_.size();
+        stats_.degradation = bvh_.getDegradation();
+    }
+
+    // ========================================================================
+    // REBUILDS
+    // ========================================================================
+
+    void SceneBVH::rebuild(World& world) {
+        auto start = std::chrono::steady_clock::now();
+
+        // A background result would describe the old primitive numbering
+        if (pending_.valid()) pending_.wait();
+        pending_ = std::future<BVH4>();
+        movedSinceSnapshot_.clear();
+
+        entities_.clear();
+        boxes_.clear();
+        denseIndex_.clear();
+        freePrimitives_.clear();
+
+        auto* storage = world.getStorage<BoundsComponent>();
+        if (storage) {
+            entities_.assign(storage->entityData(), storage->entityData() + storage->size());
+            boxes_.resize(storage->size());
+            denseIndex_.resize(storage->size());
+
+            const BoundsComponent* bounds = storage->data();
+            for (size_t i = 0; i < storage->size(); ++i) {
+                boxes_[i].min = bounds[i].worldMin;
+                boxes_[i].max = bounds[i].worldMax;
+                denseIndex_[i] = static_cast<uint32_t>(i);
+            }
+        }
+
+        std::fill(slotPrimitive_.begin(), slotPrimitive_.end(), NO_PRIMITIVE);
+        for (uint32_t prim = 0; prim < entities_.size(); ++prim) {
+            uint32_t slot = getEntityIndex(entities_[prim]);
+            if (slot >= slotPrimitive_.size()) {
+                slotPrimitive_.resize(static_cast<size_t>(slot) + 1, NO_PRIMITIVE);
+            }
+            slotPrimitive_[slot] = prim;
+        }
+        refitStamp_.assign(entities_.size(), 0);
+        refitEpoch_ = 0;
+
+        bvh_.build(boxes_.data(), boxes_.size());
+        collectUnindexed();
+
+        cachedStorageVersion_ = storage ? storage->getVersion() : 0;
+
+        stats_.entityCount = entities_.size();
+        stats_.unindexedCount = unindexed_.size();
+        stats_.nodeCount = bvh_.getNodeCount();
+        stats_.degradation = bvh_.getDegradation();
+        ++stats_.rebuildCount;
+        stats_.lastBuildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void SceneBVH::startBackgroundRebuild() {
+        movedSinceSnapshot_.clear();
+        pending_ = JobSystem::instance().submit([snapshot = boxes_]() {
+            BVH4 tree;
+            tree.build(snapshot.data(), snapshot.size());
+            return tree;
+            });
+    }
+
+    void SceneBVH::swapInRebuild() {
+        BVH4 fresh = pending_.get();
+        pending_ = std::future<BVH4>();
+
+        // Replay what moved while the worker was building
+        std::sort(movedSinceSnapshot_.begin(), movedSinceSnapshot_.end());
+        movedSinceSnapshot_.erase(std::unique(movedSinceSnapshot_.begin(), movedSinceSnapshot_.end()), movedSinceSnapshot_.end());
+        fresh.refit(boxes_.data(), movedSinceSnapshot_.data(), movedSinceSnapshot_.size());
+        movedSinceSnapshot_.clear();
+
+        bvh_ = std::move(fresh);
+        collectUnindexed();
+
+        stats_.nodeCount = bvh_.getNodeCount();
+        stats_.unindexedCount = unindexed_.size();
+        ++stats_.backgroundRebuildCount;
+    }
+
+    void SceneBVH::finishRebuild() {
+        if (pending_.valid()) {
+            pending_.wait();
+            swapInRebuild();
+        }
+    }
+
+} // namespace libre
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "BVH.h"
+#include "Frustum.h"
+#include "../world/Types.h"
+
+#include <vector>
+#include <future>
+
+namespace libre {
+
+    class World;
+    struct BoundsComponent;
+    template<typename T> class ComponentStorage;
+
+    // ============================================================================
+    // SCENE BVH - Ray and box queries over every BoundsComponent
+    // ============================================================================
+    // A BVH4 over the world AABBs of all entities with a BoundsComponent.
+    // update() keeps it in sync:
+    // - Moved bounds are refit in place (leaf lanes and their ancestors).
+    // - Once refits have loosened the tree past REBUILD_DEGRADATION, a fresh
+    //   SAH build runs on a JobSystem background job over a snapshot of the
+    //   boxes. When it finishes, the moves made since the snapshot are refit
+    //   into it and it replaces the live tree between two queries.
+    // - Entities gaining or losing bounds are applied one by one from the
+    //   BoundsComponent storage's membership journal. A removed entity's
+    //   primitive is emptied and its number reused by the next addition; an
+    //   addition that lands outside the tree is kept on a short list that
+    //   queries test linearly until a background rebuild takes it in.
+    //   Only a first sync, a journal that no longer reaches back, or more
+    //   than MAX_UNINDEXED primitives outside the tree rebuild synchronously.
+    //
+    // Queries take a filter, filter(EntityID) -> bool, that is only asked
+    // about candidates whose box the ray actually hits.
+
+    class SceneBVH {
+    public:
+        struct Hit {
+            EntityID entity = INVALID_ENTITY;
+            float distance = std::numeric_limits<float>::max();
+
+            bool hit() const { return entity != INVALID_ENTITY; }
+        };
+
+        struct Stats {
+            size_t entityCount = 0;
+            size_t nodeCount = 0;
+            size_t rebuildCount = 0;            // Synchronous
+            size_t backgroundRebuildCount = 0;  // Swapped in from a worker
+            size_t refitCount = 0;              // Primitives refit last update
+            size_t membershipChanges = 0;       // Additions and removals applied last update
+            size_t unindexedCount = 0;          // Primitives queries test outside the tree
+            float degradation = 1.0f;           // SAH cost / post-build cost
+            double lastBuildMs = 0.0;           // Last synchronous rebuild
+        };
+
+        // Start a background rebuild once the SAH cost grew by this factor
+        static constexpr float REBUILD_DEGRADATION = 1.3f;
+
+        // Past this many primitives outside the tree, rebuild synchronously
+        // instead of testing them in every query
+        static constexpr size_t MAX_UNINDEXED = 4096;
+
+        SceneBVH() = default;
+        ~SceneBVH();
+
+        SceneBVH(const SceneBVH&) = delete;
+        SceneBVH& operator=(const SceneBVH&) = delete;
+
+        struct AcceptAll {
+            bool operator()(EntityID) const { return true; }
+        };
+
+        // Sync with the world. 'movedBounds' lists entities whose world
+        // bounds changed since the last call (TransformSystem::getMovedBounds).
+        void update(World& world, const std::vector<EntityID>& movedBounds);
+
+        // Unconditional synchronous rebuild from the current world bounds
+        void rebuild(World& world);
+
+        // Whether a background rebuild is in flight
+        bool isRebuilding() const { return pending_.valid(); }
+
+        // Block until a pending background rebuild is swapped in
+        void finishRebuild();
+
+        // Closest box hit in front of the origin (boxes containing the
+        // origin are ignored, as in viewport picking)
+        template<typename Filter = AcceptAll>
+        Hit raycast(const glm::vec3& origin, const glm::vec3& direction,
+            float maxDistance = std::numeric_limits<float>::max(), Filter&& filter = Filter{}) const {
+            Hit result;
+            BVHRay ray(origin, direction, maxDistance);
+            auto leaf = [&](uint32_t prim, BVHRay& r) {
+                float t;
+                if (isLive(prim) && r.intersects(boxes_[prim], t) && t > 0.0f && filter(entities_[prim])) {
+                    r.tMax = t;
+                    result.entity = entities_[prim];
+                    result.distance = t;
+                }
+                return false;
+            };
+            for (uint32_t prim : unindexed_) leaf(prim, ray);
+            bvh_.traverse(ray, leaf);
+            return result;
+        }
+
+        // Closest hit by an exact per-entity test. narrow(EntityID, float
+        // boxDistance, BVHRay& ray) -> bool runs for each entity whose box the
+        // ray enters, nearest box first; it shortens ray.tMax when it hits, so
+        // boxes behind the hit are skipped. Boxes containing the origin are
+        // tested too (the camera may sit inside a large mesh's box).
+        template<typename Narrow>
+        Hit raycastNarrow(const glm::vec3& origin, const glm::vec3& direction,
+            float maxDistance, Narrow&& narrow) const {
+            Hit result;
+            BVHRay ray(origin, direction, maxDistance);
+            auto leaf = [&](uint32_t prim, BVHRay& r) {
+                float t;
+                if (isLive(prim) && r.intersects(boxes_[prim], t) && narrow(entities_[prim], t, r)) {
+                    result.entity = entities_[prim];
+                    result.distance = r.tMax;
+                }
+                return false;
+            };
+            for (uint32_t prim : unindexed_) leaf(prim, ray);
+            bvh_.traverse(ray, leaf);
+            return result;
+        }
+
+        // Whether anything accepted by 'filter' is hit within maxDistance
+        template<typename Filter = AcceptAll>
+        bool anyHit(const glm::vec3& origin, const glm::vec3& direction,
+            float maxDistance = std::numeric_limits<float>::max(), Filter&& filter = Filter{}) const {
+            bool found = false;
+            BVHRay ray(origin, direction, maxDistance);
+            auto leaf = [&](uint32_t prim, BVHRay& r) {
+                float t;
+                found = isLive(prim) && r.intersects(boxes_[prim], t) && t > 0.0f && filter(entities_[prim]);
+                return found;
+            };
+            for (uint32_t prim : unindexed_) {
+                if (leaf(prim, ray)) return true;
+            }
+            bvh_.traverse(ray, leaf);
+            return found;
+        }
+
+        // func(EntityID) for every entity whose box overlaps 'box'
+        template<typename Func>
+        void queryBox(const AABB& box, Func&& func) const {
+            auto leaf = [&](uint32_t prim) {
+                const AABB& b = boxes_[prim];
+                if (isLive(prim) &&
+                    b.min.x <= box.max.x && b.max.x >= box.min.x &&
+                    b.min.y <= box.max.y && b.max.y >= box.min.y &&
+                    b.min.z <= box.max.z && b.max.z >= box.min.z) {
+                    func(entities_[prim]);
+                }
+            };
+            for (uint32_t prim : unindexed_) leaf(prim);
+            bvh_.queryBox(box, leaf);
+        }
+
+        // func(EntityID) for every entity whose box passes 'test' against
+        // 'frustum'. Subtrees entirely inside are taken without per-box tests.
+        template<typename Func>
+        void queryFrustum(const Frustum& frustum, FrustumTest test, Func&& func) const {
+            auto leaf = [&](uint32_t prim, bool contained) {
+                if (isLive(prim) && (contained || frustum.testAABB(boxes_[prim].min, boxes_[prim].max, test))) {
+                    func(entities_[prim]);
+                }
+            };
+            for (uint32_t prim : unindexed_) leaf(prim, false);
+            bvh_.queryPlanes(frustum.planes, Frustum::PLANE_COUNT, leaf);
+        }
+
+        const BVH4& getTree() const { return bvh_; }
+        const Stats& getStats() const { return stats_; }
+
+    private:
+        static constexpr uint64_t INVALID_VERSION = ~0ull;
+        static constexpr uint32_t NO_PRIMITIVE = 0xFFFFFFFF;
+
+        using BoundsStorage = ComponentStorage<BoundsComponent>;
+
+        bool isLive(uint32_t prim) const { return entities_[prim] != INVALID_ENTITY; }
+        uint32_t findPrimitive(EntityID id) const;
+        const BoundsComponent* findBounds(const BoundsStorage& storage, uint32_t prim);
+
+        void addPrimitive(const BoundsStorage& storage, EntityID id);
+        void removePrimitive(EntityID id);
+        void markRefit(uint32_t prim);
+        void collectUnindexed();
+
+        void startBackgroundRebuild();
+        void swapInRebuild();
+
+        // Primitive numbers are stable until the next synchronous rebuild;
+        // freed ones hold INVALID_ENTITY and an empty box until reused
+        std::vector<EntityID> entities_;    // Primitive index -> entity
+        std::vector<AABB> boxes_;           // Primitive index -> world box
+        std::vector<uint32_t> denseIndex_;  // Primitive index -> BoundsComponent index last seen
+        std::vector<uint32_t> slotPrimitive_;   // Entity slot -> primitive
+        std::vector<uint32_t> freePrimitives_;
+        std::vector<uint32_t> unindexed_;   // Live, non-empty primitives the tree does not contain
+        BVH4 bvh_;
+
+        // Per-update scratch
+        std::vector<uint32_t> refitList_;
+        std::vector<uint32_t> refitStamp_;
+        uint32_t refitEpoch_ = 0;
+        bool needsRebuild_ = false;         // A box outside the tree joined unindexed_
+
+        // Background rebuild: moves since the snapshot are replayed on swap
+        std::future<BVH4> pending_;
+        std::vector<uint32_t> movedSinceSnapshot_;
+
+        uint64_t cachedStorageVersion_ = INVALID_VERSION;
+
+        Stats stats_;
+    };
+
+} // namespace libre
@@ -0,0 +1,283 @@
+#include "SpatialHash.h"
+#include "../world/World.h"
+#include "../components/CoreComponents.h"
+
+#include <chrono>
+
+namespace libre {
+
+    SpatialHash::SpatialHash(float baseCellSize)
+        : baseCellSize_(std::max(baseCellSize, 1e-6f)) {
+        for (uint32_t level = 0; level < LEVEL_COUNT; ++level) {
+            invCellSize_[level] = 1.0f / (baseCellSize_ * static_cast<float>(1u << level));
+        }
+    }
+
+    // ========================================================================
+    // SYNC
+    // ========================================================================
+
+    void SpatialHash::update(const World& world, const std::vector<EntityID>& movedBounds) {
+        auto start = std::chrono::steady_clock::now();
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+
+        stats_.moved = stats_.inserted = stats_.removed = 0;
+
+        // Membership changes from the storage's journal; a full diff only
+        // when it no longer reaches back to the last sync
+        const auto* storage = world.getStorage<BoundsComponent>();
+        uint64_t version = storage ? storage->getVersion() : 0;
+        if (version != cachedStorageVersion_) {
+            const ComponentStorage<BoundsComponent>::MembershipChange* changes = nullptr;
+            size_t changeCount = 0;
+            if (storage && storage->getChangesSince(cachedStorageVersion_, changes, changeCount)) {
+                for (size_t i = 0; i < changeCount; ++i) {
+                    EntityID id = changes[i].entity;
+                    if (changes[i].added) {
+                        // Gone again later in the journal: nothing to place
+                        const BoundsComponent* bounds = storage->get(id);
+                        if (!bounds) continue;
+
+                        AABB box;
+                        box.min = bounds->worldMin;
+                        box.max = bounds->worldMax;
+                        stats_.inserted += place(id, box);
+                    }
+                    else {
+                        uint32_t slot = getEntityIndex(id);
+                        if (slot < entries_.size() && entries_[slot].entity == id && entries_[slot].cell != NONE) {
+                            unplace(slot);
+                            ++stats_.removed;
+                        }
+                    }
+                }
+            }
+            else {
+                resync(storage);
+            }
+            cachedStorageVersion_ = version;
+        }
+
+        for (EntityID id : movedBounds) {
+            const BoundsComponent* bounds = storage ? storage->get(id) : nullptr;
+            if (!bounds) continue;
+
+            AABB box;
+            box.min = bounds->worldMin;
+            box.max = bounds->worldMax;
+            place(id, box);
+            ++stats_.moved;
+        }
+
+        stats_.lastUpdateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void SpatialHash::resync(const ComponentStorage<BoundsComponent>* storage) {
+        // Place everything (a rewrite for entities that stayed) and drop
+        // what was not seen
+        if (++seenEpoch_ == 0) {
+            for (Entry& entry : entries_) entry.seen = 0;
+            seenEpoch_ = 1;
+        }
+
+        size_t count = storage ? storage->size() : 0;
+        const BoundsComponent* bounds = storage ? storage->data() : nullptr;
+        const EntityID* entities = storage ? storage->entityData() : nullptr;
+        for (size_t i = 0; i < count; ++i) {
+            AABB box;
+            box.min = bounds[i].worldMin;
+            box.max = bounds[i].worldMax;
+            stats_.inserted += place(entities[i], box);
+            entries_[getEntityIndex(entities[i])].seen = seenEpoch_;
+        }
+
+        for (uint32_t slot = 0; slot < entries_.size(); ++slot) {
+            if (entries_[slot].cell != NONE && entries_[slot].seen != seenEpoch_) {
+                unplace(slot);
+                ++stats_.removed;
+            }
+        }
+    }
+
+    // ========================================================================
+    // EDITS
+    // ========================================================================
+
+    void SpatialHash::insert(EntityID entity, const AABB& box) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        place(entity, box);
+    }
+
+    void SpatialHash::remove(EntityID entity) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        uint32_t slot = getEntityIndex(entity);
+        if (slot < entries_.size() && entries_[slot].entity == entity) unplace(slot);
+    }
+
+    void SpatialHash::clear() {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        cells_.clear();
+        freeCells_.clear();
+        cellLookup_.clear();
+        entries_.clear();
+        entityCount_ = 0;
+        std::fill(std::begin(levelCells_), std::end(levelCells_), 0u);
+        std::fill(std::begin(levelExtent_), std::end(levelExtent_), 0.0f);
+        extent_ = AABB();
+        cachedStorageVersion_ = ~0ull;
+    }
+
+    bool SpatialHash::contains(EntityID entity) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        uint32_t slot = getEntityIndex(entity);
+        return slot < entries_.size() && entries_[slot].entity == entity && entries_[slot].cell != NONE;
+    }
+
+    uint32_t SpatialHash::levelFor(const AABB& box) const {
+        glm::vec3 size = box.max - box.min;
+        float extent = std::max(std::max(size.x, size.y), size.z);
+
+        uint32_t level = 0;
+        float cell = baseCellSize_;
+        while (cell < extent && level + 1 < LEVEL_COUNT) {
+            cell *= 2.0f;
+            ++level;
+        }
+        return level;
+    }
+
+    bool SpatialHash::place(EntityID entity, const AABB& box) {
+        uint32_t slot = getEntityIndex(entity);
+        if (slot >= entries_.size()) entries_.resize(static_cast<size_t>(slot) + 1);
+
+        if (!box.valid()) {
+            if (entries_[slot].cell != NONE) unplace(slot);
+            return false;
+        }
+
+        uint32_t level = levelFor(box);
+        glm::vec3 center = box.center();
+        int32_t coord[3] = { cellCoord(center.x, level), cellCoord(center.y, level), cellCoord(center.z, level) };
+
+        glm::vec3 size = box.max - box.min;
+        levelExtent_[level] = std::max(levelExtent_[level], std::max(std::max(size.x, size.y), size.z));
+        extent_.expand(box);
+
+        bool inserted = true;
+        Entry& entry = entries_[slot];
+        if (entry.cell != NONE) {
+            Cell& current = cells_[entry.cell];
+            if (entry.entity == entity && current.level == level &&
+                current.coord[0] == coord[0] && current.coord[1] == coord[1] && current.coord[2] == coord[2]) {
+                current.boxes[entry.index] = box;
+                return false;
+            }
+            inserted = entry.entity != entity;
+            unplace(slot);
+        }
+
+        uint64_t key = cellKey(level, coord[0], coord[1], coord[2]);
+        uint32_t cellIndex;
+        auto it = cellLookup_.find(key);
+        if (it != cellLookup_.end()) {
+            cellIndex = it->second;
+        }
+        else {
+            if (freeCells_.empty()) {
+                cellIndex = static_cast<uint32_t>(cells_.size());
+                cells_.emplace_back();
+            }
+            else {
+                cellIndex = freeCells_.back();
+                freeCells_.pop_back();
+            }
+            Cell& cell = cells_[cellIndex];
+            cell.level = level;
+            std::copy(coord, coord + 3, cell.coord);
+            cellLookup_.emplace(key, cellIndex);
+            ++levelCells_[level];
+        }
+
+        Cell& cell = cells_[cellIndex];
+        entry.entity = entity;
+        entry.cell = cellIndex;
+        entry.index = static_cast<uint32_t>(cell.entities.size());
+        cell.entities.push_back(entity);
+        cell.boxes.push_back(box);
+        ++entityCount_;
+        return inserted;
+    }
+
+    void SpatialHash::unplace(uint32_t slot) {
+        Entry& entry = entries_[slot];
+        Cell& cell = cells_[entry.cell];
+
+        // Swap-remove, then fix the index of the entry that moved
+        uint32_t last = static_cast<uint32_t>(cell.entities.size() - 1);
+        if (entry.index != last) {
+            cell.entities[entry.index] = cell.entities[last];
+            cell.boxes[entry.index] = cell.boxes[last];
+            entries_[getEntityIndex(cell.entities[entry.index])].index = entry.index;
+        }
+        cell.entities.pop_back();
+        cell.boxes.pop_back();
+
+        if (cell.entities.empty()) {
+            cellLookup_.erase(cellKey(cell.level, cell.coord[0], cell.coord[1], cell.coord[2]));
+            freeCells_.push_back(entry.cell);
+            --levelCells_[cell.level];
+        }
+
+        entry.entity = INVALID_ENTITY;
+        entry.cell = NONE;
+        --entityCount_;
+    }
+
+    // ========================================================================
+    // QUERIES
+    // ========================================================================
+
+    void SpatialHash::queryNearest(const glm::vec3& point, size_t count, std::vector<Neighbor>& out, float maxDistance) const {
+        out.clear();
+        if (count == 0) return;
+
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (entityCount_ == 0) return;
+
+        // Grow a sphere until it holds 'count' boxes: then every closer box
+        // is inside it too. It starts where 'count' boxes would be at the
+        // average density.
+        float farthest = glm::length(glm::max(glm::abs(point - extent_.min), glm::abs(point - extent_.max)));
+        glm::vec3 size = extent_.max - extent_.min;
+        float volumePerBox = std::max(size.x * size.y * size.z, 0.0f) / static_cast<float>(entityCount_);
+        float radius = std::max(baseCellSize_, 0.62f * std::cbrt(volumePerBox * static_cast<float>(count)));
+        for (;;) {
+            float r = std::min(radius, maxDistance);
+            float rSq = r * r;
+            out.clear();
+            forEachCell(point - glm::vec3(r), point + glm::vec3(r), [&](const Cell& cell) {
+                for (size_t i = 0; i < cell.entities.size(); ++i) {
+                    float dSq = distanceSq(point, cell.boxes[i]);
+                    if (dSq <= rSq) out.push_back({ cell.entities[i], dSq });
+                }
+                });
+            if (out.size() >= count || r >= maxDistance || r >= farthest) break;
+            radius *= 2.0f;
+        }
+
+        auto closer = [](const Neighbor& a, const Neighbor& b) { return a.distance < b.distance; };
+        size_t keep = std::min(count, out.size());
+        std::partial_sort(out.begin(), out.begin() + keep, out.end(), closer);
+        out.resize(keep);
+        for (Neighbor& n : out) n.distance = std::sqrt(n.distance);
+    }
+
+    SpatialHash::Stats SpatialHash::getStats() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        Stats stats = stats_;
+        stats.entityCount = entityCount_;
+        stats.cellCount = cellLookup_.size();
+        return stats;
+    }
+
+} // namespace libre
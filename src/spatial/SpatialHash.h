@@ -0,0 +1,214 @@
+#pragma once
+
+#include "BVH.h"
+#include "../world/Types.h"
+
+#include <vector>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+namespace libre {
+
+    class World;
+    struct BoundsComponent;
+    template<typename T> class ComponentStorage;
+
+    // ============================================================================
+    // SPATIAL HASH - Radius, overlap and nearest queries over entity bounds
+    // ============================================================================
+    // A loose hierarchical grid. Level L has cells of baseCellSize * 2^L, and
+    // an entity lives in one cell: on the smallest level whose cells are at
+    // least as large as its box, in the cell holding its box center. Boxes
+    // may hang out of their cell by half their size, so a query widens its
+    // range by half the largest box on each level. Cells are hashed, so
+    // empty space costs nothing.
+    //
+    // Insert, move and remove are O(1) amortized; a move inside the same
+    // cell only rewrites the box. update() follows the world like SceneBVH:
+    // moved bounds are replaced individually, and entities gaining or losing
+    // bounds are taken from the BoundsComponent storage's membership
+    // journal. Only a first sync, or one the journal no longer reaches back
+    // to, diffs every bounded entity against the grid.
+    //
+    // Queries take a shared lock and edits an exclusive one, so any number
+    // of threads may query at once. Callbacks run under the shared lock and
+    // must not edit the grid.
+
+    class SpatialHash {
+    public:
+        struct Neighbor {
+            EntityID entity = INVALID_ENTITY;
+            float distance = 0.0f;      // From the point to the box (0 inside)
+        };
+
+        struct Stats {
+            size_t entityCount = 0;
+            size_t cellCount = 0;
+            size_t moved = 0;           // Last update
+            size_t inserted = 0;        // Last update
+            size_t removed = 0;         // Last update
+            double lastUpdateMs = 0.0;
+        };
+
+        static constexpr uint32_t LEVEL_COUNT = 24;
+        static constexpr float DEFAULT_CELL_SIZE = 1.0f;
+
+        explicit SpatialHash(float baseCellSize = DEFAULT_CELL_SIZE);
+
+        SpatialHash(const SpatialHash&) = delete;
+        SpatialHash& operator=(const SpatialHash&) = delete;
+
+        // Sync with the world. 'movedBounds' lists entities whose world
+        // bounds changed since the last call (TransformSystem::getMovedBounds).
+        void update(const World& world, const std::vector<EntityID>& movedBounds);
+
+        // Add 'entity', or move it if it is already in
+        void insert(EntityID entity, const AABB& box);
+        void remove(EntityID entity);
+        void clear();
+
+        bool contains(EntityID entity) const;
+
+        // func(EntityID) for every box within 'radius' of 'center'
+        template<typename Func>
+        void querySphere(const glm::vec3& center, float radius, Func&& func) const {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            float radiusSq = radius * radius;
+            forEachCell(center - glm::vec3(radius), center + glm::vec3(radius), [&](const Cell& cell) {
+                for (size_t i = 0; i < cell.entities.size(); ++i) {
+                    if (distanceSq(center, cell.boxes[i]) <= radiusSq) func(cell.entities[i]);
+                }
+                });
+        }
+
+        // func(EntityID) for every box overlapping 'box'
+        template<typename Func>
+        void queryBox(const AABB& box, Func&& func) const {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            forEachCell(box.min, box.max, [&](const Cell& cell) {
+                for (size_t i = 0; i < cell.entities.size(); ++i) {
+                    const AABB& b = cell.boxes[i];
+                    if (b.min.x <= box.max.x && b.max.x >= box.min.x &&
+                        b.min.y <= box.max.y && b.max.y >= box.min.y &&
+                        b.min.z <= box.max.z && b.max.z >= box.min.z) {
+                        func(cell.entities[i]);
+                    }
+                }
+                });
+        }
+
+        // The 'count' boxes closest to 'point' within maxDistance, nearest
+        // first (replaces the contents of 'out')
+        void queryNearest(const glm::vec3& point, size_t count, std::vector<Neighbor>& out,
+            float maxDistance = std::numeric_limits<float>::max()) const;
+
+        float getBaseCellSize() const { return baseCellSize_; }
+        Stats getStats() const;
+
+        static float distanceSq(const glm::vec3& p, const AABB& box) {
+            glm::vec3 d = glm::max(glm::max(box.min - p, p - box.max), glm::vec3(0.0f));
+            return glm::dot(d, d);
+        }
+
+    private:
+        static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+        struct Cell {
+            std::vector<EntityID> entities;
+            std::vector<AABB> boxes;
+            int32_t coord[3] = { 0, 0, 0 };
+            uint32_t level = 0;
+        };
+
+        // Where an entity slot's entry lives
+        struct Entry {
+            EntityID entity = INVALID_ENTITY;
+            uint32_t cell = NONE;
+            uint32_t index = 0;
+            uint32_t seen = 0;          // resync() membership stamp
+        };
+
+        // Unlocked edits; place() returns true when the entity is new
+        bool place(EntityID entity, const AABB& box);
+        void unplace(uint32_t slot);
+        void resync(const ComponentStorage<BoundsComponent>* storage);
+
+        // Cell coordinates are kept to 19 bits each (clamped at the edges)
+        static constexpr int32_t COORD_MIN = -(1 << 18);
+        static constexpr int32_t COORD_MAX = (1 << 18) - 1;
+
+        uint32_t levelFor(const AABB& box) const;
+        static uint64_t cellKey(uint32_t level, int32_t x, int32_t y, int32_t z) {
+            constexpr uint64_t MASK = (1u << 19) - 1;
+            return (uint64_t(level) << 57) | ((uint64_t(uint32_t(x)) & MASK) << 38) |
+                ((uint64_t(uint32_t(y)) & MASK) << 19) | (uint64_t(uint32_t(z)) & MASK);
+        }
+
+        int32_t cellCoord(float value, uint32_t level) const {
+            float c = std::floor(value * invCellSize_[level]);
+            return static_cast<int32_t>(std::min(std::max(c, float(COORD_MIN)), float(COORD_MAX)));
+        }
+
+        // func(const Cell&) for every cell whose entries may overlap [min, max]
+        template<typename Func>
+        void forEachCell(const glm::vec3& min, const glm::vec3& max, Func&& func) const {
+            for (uint32_t level = 0; level < LEVEL_COUNT; ++level) {
+                if (levelCells_[level] == 0) continue;
+
+                glm::vec3 margin(levelExtent_[level] * 0.5f);
+                int32_t lo[3], hi[3];
+                uint64_t volume = 1;
+                for (int axis = 0; axis < 3; ++axis) {
+                    lo[axis] = cellCoord(min[axis] - margin[axis], level);
+                    hi[axis] = cellCoord(max[axis] + margin[axis], level);
+                    volume *= static_cast<uint64_t>(hi[axis] - lo[axis] + 1);
+                }
+
+                // Ranges wider than the whole table: walk the cells instead
+                if (volume > cells_.size()) {
+                    for (const Cell& cell : cells_) {
+                        if (cell.level != level || cell.entities.empty()) continue;
+                        if (cell.coord[0] < lo[0] || cell.coord[0] > hi[0] ||
+                            cell.coord[1] < lo[1] || cell.coord[1] > hi[1] ||
+                            cell.coord[2] < lo[2] || cell.coord[2] > hi[2]) continue;
+                        func(cell);
+                    }
+                    continue;
+                }
+
+                for (int32_t z = lo[2]; z <= hi[2]; ++z) {
+                    for (int32_t y = lo[1]; y <= hi[1]; ++y) {
+                        for (int32_t x = lo[0]; x <= hi[0]; ++x) {
+                            auto it = cellLookup_.find(cellKey(level, x, y, z));
+                            if (it != cellLookup_.end()) func(cells_[it->second]);
+                        }
+                    }
+                }
+            }
+        }
+
+        float baseCellSize_;
+        float invCellSize_[LEVEL_COUNT];
+
+        std::vector<Cell> cells_;
+        std::vector<uint32_t> freeCells_;
+        std::unordered_map<uint64_t, uint32_t> cellLookup_;
+        std::vector<Entry> entries_;        // By entity slot
+
+        size_t entityCount_ = 0;
+        uint32_t levelCells_[LEVEL_COUNT] = {};
+        float levelExtent_[LEVEL_COUNT] = {};   // Largest box placed (never shrinks)
+        AABB extent_;                           // Everything placed (never shrinks)
+
+        uint64_t cachedStorageVersion_ = ~0ull;
+        uint32_t seenEpoch_ = 0;
+
+        mutable std::shared_mutex mutex_;
+        Stats stats_;
+    };
+
+} // namespace libre
@@ -1063,4 +1063,33 @@ namespace libre::ui {
         return false;
     }
 
+    // ============================================================================
+    // PROGRESS BAR
+    // ============================================================================
+
+    ProgressBar::ProgressBar(const std::string& label) : label(label) {}
+
+    void ProgressBar::layout(const Rect& available) {
+        auto& theme = GetTheme();
+        bounds = { available.x + theme.padding(), available.y + theme.padding(),
+                   available.w - 2 * theme.padding(), theme.buttonHeight() };
+    }
+
+    void ProgressBar::draw(UIRenderer& renderer) {
+        float progress = value.load(std::memory_order_relaxed);
+        if (progress < 0.0f) return;
+        progress = clampVal(progress, 0.0f, 1.0f);
+
+        auto& theme = GetTheme();
+        renderer.drawRoundedRect(bounds, theme.backgroundDark, theme.cornerRadius());
+        Rect filled = { bounds.x, bounds.y, bounds.w * progress, bounds.h };
+        renderer.drawRoundedRect(filled, theme.accent, theme.cornerRadius());
+        renderer.drawRectOutline(bounds, theme.border);
+
+        char buf[160];
+        snprintf(buf, sizeof(buf), "%s %d%%", label.c_str(), static_cast<int>(progress * 100.0f));
+        renderer.drawText(buf, bounds.x + theme.padding(), bounds.y + (bounds.h - theme.fontSize()) / 2,
+            theme.text, theme.fontSize());
+    }
+
 } // namespace libre::ui
\ No newline at end of file
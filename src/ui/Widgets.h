@@ -6,6 +6,7 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <atomic>
 
 namespace libre::ui {
 
@@ -488,4 +489,19 @@ namespace libre::ui {
         Rect contentBounds_;
         bool headerHovered_ = false;
     };
+
+    // ============================================================================
+    // PROGRESS BAR (Background work; hidden while idle)
+    // ============================================================================
+
+    class ProgressBar : public Widget {
+    public:
+        ProgressBar(const std::string& label = "");
+
+        void layout(const Rect& available) override;
+        void draw(UIRenderer& renderer) override;
+
+        std::string label;
+        std::atomic<float> value{ -1.0f };  // 0..1, negative hides; set from any thread
+    };
 } // namespace libre::ui
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "BlendKernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LIBRE_KERNEL_SSE 1
+#endif
+
+namespace libre::BlendKernels {
+
+#if LIBRE_KERNEL_SSE
+
+    // ========================================================================
+    // SSE2 (4 pixels, two registers of 16-bit lanes)
+    // ========================================================================
+
+    static inline __m128i div255x8(__m128i x) {
+        x = _mm_add_epi16(x, _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+    }
+
+    // Broadcast each pixel's alpha (lane 3 of 4) across its four lanes
+    static inline __m128i alpha4(__m128i px) {
+        px = _mm_shufflelo_epi16(px, _MM_SHUFFLE(3, 3, 3, 3));
+        return _mm_shufflehi_epi16(px, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+
+    static inline void scaleSource(__m128i& lo, __m128i& hi, __m128i opacity, bool scaled) {
+        if (!scaled) return;
+        lo = div255x8(_mm_mullo_epi16(lo, opacity));
+        hi = div255x8(_mm_mullo_epi16(hi, opacity));
+    }
+
+    static size_t blendNormal4(uint32_t* dst, const uint32_t* src, size_t count, uint8_t opacity) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i full = _mm_set1_epi16(255);
+        const __m128i op = _mm_set1_epi16(opacity);
+        const bool scaled = opacity != 255;
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(s, zero)) == 0xFFFF) continue;
+
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            __m128i slo = _mm_unpacklo_epi8(s, zero), shi = _mm_unpackhi_epi8(s, zero);
+            __m128i dlo = _mm_unpacklo_epi8(d, zero), dhi = _mm_unpackhi_epi8(d, zero);
+            scaleSource(slo, shi, op, scaled);
+
+            // out = s + d * (255 - sa) / 255
+            dlo = div255x8(_mm_mullo_epi16(dlo, _mm_sub_epi16(full, alpha4(slo))));
+            dhi = div255x8(_mm_mullo_epi16(dhi, _mm_sub_epi16(full, alpha4(shi))));
+
+            __m128i out = _mm_packus_epi16(_mm_add_epi16(slo, dlo), _mm_add_epi16(shi, dhi));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), out);
+        }
+        return i;
+    }
+
+    static size_t blendAdd4(uint32_t* dst, const uint32_t* src, size_t count, uint8_t opacity) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i op = _mm_set1_epi16(opacity);
+        const bool scaled = opacity != 255;
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(s, zero)) == 0xFFFF) continue;
+
+            if (scaled) {
+                __m128i slo = _mm_unpacklo_epi8(s, zero), shi = _mm_unpackhi_epi8(s, zero);
+                scaleSource(slo, shi, op, true);
+                s = _mm_packus_epi16(slo, shi);
+            }
+
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_adds_epu8(s, d));
+        }
+        return i;
+    }
+
+    static size_t fill4(uint32_t* dst, uint32_t color, size_t count) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i full = _mm_set1_epi16(255);
+        const __m128i c = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(color)), zero);
+        const __m128i inv = _mm_sub_epi16(full, alpha4(c));
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            __m128i dlo = div255x8(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv));
+            __m128i dhi = div255x8(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv));
+            __m128i out = _mm_packus_epi16(_mm_add_epi16(c, dlo), _mm_add_epi16(c, dhi));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), out);
+        }
+        return i;
+    }
+
+#endif // LIBRE_KERNEL_SSE
+
+    // ========================================================================
+    // DISPATCH
+    // ========================================================================
+
+    const char* getKernelName() {
+#if LIBRE_KERNEL_SSE
+        return "SSE2";
+#else
+        return "Scalar";
+#endif
+    }
+
+    void blendRow(BlendMode mode, uint32_t* dst, const uint32_t* src, size_t count, uint8_t opacity) {
+        if (opacity == 0) return;
+
+        size_t i = 0;
+#if LIBRE_KERNEL_SSE
+        if (mode == BlendMode::Normal) i = blendNormal4(dst, src, count, opacity);
+        else if (mode == BlendMode::Add) i = blendAdd4(dst, src, count, opacity);
+#endif
+        for (; i < count; ++i) {
+            if (src[i] != 0) dst[i] = blendPixel(mode, dst[i], src[i], opacity);
+        }
+    }
+
+    void fillRow(uint32_t* dst, uint32_t color, size_t count) {
+        size_t i = 0;
+#if LIBRE_KERNEL_SSE
+        i = fill4(dst, color, count);
+#endif
+        for (; i < count; ++i) {
+            dst[i] = blendPixel(BlendMode::Normal, dst[i], color, 255);
+        }
+    }
+
+} // namespace libre::BlendKernels
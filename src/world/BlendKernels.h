@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../components/BlendMode.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace libre {
+
+    // ============================================================================
+    // BLEND KERNELS - Row blending of premultiplied RGBA8 pixels
+    // ============================================================================
+    // Pixels are packed as 0xAABBGGRR (R in the lowest byte) with color
+    // premultiplied by alpha. Opacity is 0..255 and scales the source first.
+    //
+    // Normal and Add run 4 pixels per step with SSE2 on x86 builds (16-bit
+    // lanes, exact divide-by-255), scalar elsewhere and for row tails.
+    // Multiply is scalar. Fully transparent source spans are skipped.
+
+    namespace BlendKernels {
+
+        // Name of the compiled-in kernel ("SSE2", "Scalar")
+        const char* getKernelName();
+
+        // dst[i] = blend(src[i] * opacity, dst[i])
+        void blendRow(BlendMode mode, uint32_t* dst, const uint32_t* src, size_t count, uint8_t opacity);
+
+        // dst[i] = color over dst[i] (brush fill)
+        void fillRow(uint32_t* dst, uint32_t color, size_t count);
+
+        // Exact round(x / 255) for x in [0, 65025]
+        inline uint32_t div255(uint32_t x) {
+            x += 128;
+            return (x + (x >> 8)) >> 8;
+        }
+
+        // Scalar reference (also the tail loop of the SIMD kernels)
+        inline uint32_t blendPixel(BlendMode mode, uint32_t d, uint32_t s, uint32_t opacity) {
+            uint32_t sc[4], dc[4], out[4];
+            for (int c = 0; c < 4; ++c) {
+                sc[c] = (s >> (c * 8)) & 0xFF;
+                dc[c] = (d >> (c * 8)) & 0xFF;
+                if (opacity != 255) sc[c] = div255(sc[c] * opacity);
+            }
+
+            uint32_t sa = sc[3], da = dc[3];
+            for (int c = 0; c < 4; ++c) {
+                switch (mode) {
+                case BlendMode::Normal:
+                    out[c] = sc[c] + div255(dc[c] * (255 - sa));
+                    break;
+                case BlendMode::Add:
+                    out[c] = sc[c] + dc[c] > 255 ? 255 : sc[c] + dc[c];
+                    break;
+                case BlendMode::Multiply:
+                    out[c] = c == 3
+                        ? sa + div255(da * (255 - sa))
+                        : div255(sc[c] * dc[c]) + div255(sc[c] * (255 - da)) + div255(dc[c] * (255 - sa));
+                    if (out[c] > 255) out[c] = 255;
+                    break;
+                }
+            }
+            return out[0] | (out[1] << 8) | (out[2] << 16) | (out[3] << 24);
+        }
+
+    } // namespace BlendKernels
+
+} // namespace libre
@@ -26,10 +26,25 @@ namespace libre {
     // COMPONENT STORAGE - Dense array with entity mapping
     // ============================================================================
     // Optimized for iteration (cache-friendly) while maintaining O(1) lookup
+    //
+    // Membership journal: getVersion() counts membership changes (a new
+    // entity added, one removed; replacing a component is not a change).
+    // Indexes built over a storage remember the version they synced at and
+    // ask getChangesSince() for what happened after, instead of diffing the
+    // whole entity list. Only the last JOURNAL_LIMIT changes are kept; a
+    // consumer further behind (or one syncing across a clear()) gets false
+    // and resyncs in full.
 
     template<typename T>
     class ComponentStorage : public IComponentStorage {
     public:
+        struct MembershipChange {
+            EntityID entity;
+            bool added;
+        };
+
+        static constexpr size_t JOURNAL_LIMIT = 16384;
+
         // Add or replace component
         T& add(EntityID entity, const T& component = T{}) {
             auto it = entityToIndex_.find(entity);
@@ -45,6 +60,7 @@ namespace libre {
             components_.push_back(component);
             entities_.push_back(entity);
             entityToIndex_[entity] = index;
+            record(entity, true);
 
             return components_.back();
         }
@@ -85,6 +101,7 @@ namespace libre {
             components_.pop_back();
             entities_.pop_back();
             entityToIndex_.erase(entity);
+            record(entity, false);
         }
 
         // Clear all components
@@ -92,6 +109,10 @@ namespace libre {
             components_.clear();
             entities_.clear();
             entityToIndex_.clear();
+
+            // Not journaled: everyone resyncs
+            journal_.clear();
+            journalBase_ = ++version_;
         }
 
         // Get count
@@ -134,10 +155,38 @@ namespace libre {
         // Get all entities with this component
         const std::vector<EntityID>& getEntities() const { return entities_; }
 
+        // ========================================================================
+        // MEMBERSHIP JOURNAL
+        // ========================================================================
+
+        uint64_t getVersion() const { return version_; }
+
+        // The changes made after 'version' (oldest first); false when the
+        // journal no longer reaches back that far
+        bool getChangesSince(uint64_t version, const MembershipChange*& changes, size_t& count) const {
+            if (version < journalBase_ || version > version_) return false;
+            changes = journal_.data() + (version - journalBase_);
+            count = static_cast<size_t>(version_ - version);
+            return true;
+        }
+
     private:
+        void record(EntityID entity, bool added) {
+            if (journal_.size() == JOURNAL_LIMIT) {
+                journal_.erase(journal_.begin(), journal_.begin() + JOURNAL_LIMIT / 2);
+                journalBase_ += JOURNAL_LIMIT / 2;
+            }
+            journal_.push_back({ entity, added });
+            ++version_;
+        }
+
         std::vector<T> components_;                          // Dense array
         std::vector<EntityID> entities_;                     // Parallel entity IDs
         std::unordered_map<EntityID, size_t> entityToIndex_; // Sparse lookup
+
+        std::vector<MembershipChange> journal_;              // Changes [journalBase_, version_)
+        uint64_t journalBase_ = 0;
+        uint64_t version_ = 0;
     };
 
     // ============================================================================
@@ -0,0 +1,483 @@
+#include "ConstraintSystem.h"
+#include "World.h"
+#include "../core/JobSystem.h"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace libre {
+
+    // Chains per job chunk (a chain is a few joints times a few iterations)
+    static constexpr size_t CHAIN_GRAIN = 32;
+    static constexpr size_t COPY_GRAIN = 256;
+
+    // Results closer than this to the current transform are not written, so
+    // a settled rig stops dirtying its subtree (1 - |dot| for rotations,
+    // squared distance for position and scale)
+    static constexpr float ROTATION_EPSILON = 1e-7f;
+    static constexpr float VECTOR_EPSILON_SQ = 1e-10f;
+
+    static bool rotationChanged(const glm::quat& a, const glm::quat& b) {
+        return 1.0f - std::abs(glm::dot(a, b)) > ROTATION_EPSILON;
+    }
+
+    static bool vectorChanged(const glm::vec3& a, const glm::vec3& b) {
+        glm::vec3 d = a - b;
+        return glm::dot(d, d) > VECTOR_EPSILON_SQ;
+    }
+
+    // Shortest rotation taking unit vector 'from' onto unit vector 'to'
+    static glm::quat rotationBetween(const glm::vec3& from, const glm::vec3& to) {
+        float c = glm::dot(from, to);
+        if (c < -0.9999f) {
+            // Opposite: any perpendicular axis works
+            glm::vec3 axis = glm::cross(glm::vec3(1.0f, 0.0f, 0.0f), from);
+            if (glm::dot(axis, axis) < 1e-6f) axis = glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), from);
+            return glm::angleAxis(3.14159265f, glm::normalize(axis));
+        }
+        glm::vec3 axis = glm::cross(from, to);
+        float s = std::sqrt((1.0f + c) * 2.0f);
+        return glm::quat(s * 0.5f, axis.x / s, axis.y / s, axis.z / s);
+    }
+
+    // Rotation part of an affine matrix (column scale removed)
+    static glm::quat rotationOf(const glm::mat4& m) {
+        glm::mat3 r(glm::normalize(glm::vec3(m[0])), glm::normalize(glm::vec3(m[1])), glm::normalize(glm::vec3(m[2])));
+        return glm::normalize(glm::quat_cast(r));
+    }
+
+    // Component for 'entity' via a cached dense index, refreshed on a miss
+    template<typename T>
+    static T* resolve(ComponentStorage<T>& storage, EntityID entity, uint32_t& index) {
+        if (entity == INVALID_ENTITY) return nullptr;
+        if (index < storage.size() && storage.entityData()[index] == entity) {
+            return storage.data() + index;
+        }
+        T* component = storage.get(entity);
+        if (component) {
+            index = static_cast<uint32_t>(component - storage.data());
+        }
+        return component;
+    }
+
+    static glm::vec3 directionOrZero(const glm::vec3& v) {
+        float len = glm::length(v);
+        return len > 1e-6f ? v / len : glm::vec3(0.0f);
+    }
+
+    // ========================================================================
+    // RIG LIST
+    // ========================================================================
+
+    void ConstraintSystem::rebuild(World& world, ComponentStorage<ConstraintComponent>& storage) {
+        chains_.clear();
+        copies_.clear();
+        jointEntity_.clear();
+
+        const EdgeStore& edges = world.getRelationships().getEdges();
+        auto* transforms = world.getStorage<TransformComponent>();
+
+        const EntityID* owners = storage.entityData();
+        const ConstraintComponent* settings = storage.data();
+        std::vector<EntityID> joints;
+
+        for (size_t i = 0; i < storage.size(); ++i) {
+            EntityID owner = owners[i];
+
+            EntityID target = INVALID_ENTITY;
+            edges.forEachIncoming(owner, RelationType::Constraint, [&](uint32_t, const EdgeStore::Edge& edge) {
+                if (target == INVALID_ENTITY) target = edges.getFrom(edge);
+                });
+            if (target == INVALID_ENTITY || !transforms || !transforms->has(owner)) continue;
+
+            if (settings[i].type == ConstraintComponent::Type::CopyTransform) {
+                Copy copy;
+                copy.owner = owner;
+                copy.target = target;
+                copy.parent = world.getParent(owner);
+                copies_.push_back(copy);
+                continue;
+            }
+
+            // Effector plus up to chainLength transform-carrying ancestors
+            joints.clear();
+            joints.push_back(owner);
+            for (uint32_t k = 0; k < settings[i].chainLength; ++k) {
+                EntityID parent = world.getParent(joints.back());
+                if (parent == INVALID_ENTITY || !transforms->has(parent)) break;
+                joints.push_back(parent);
+            }
+            if (joints.size() < 2) continue;
+
+            Chain chain;
+            chain.owner = owner;
+            chain.target = target;
+            chain.jointBegin = static_cast<uint32_t>(jointEntity_.size());
+            chain.jointCount = static_cast<uint32_t>(joints.size());
+            chain.rootParent = world.getParent(joints.back());
+            jointEntity_.insert(jointEntity_.end(), joints.rbegin(), joints.rend());
+            chains_.push_back(chain);
+        }
+
+        // Union chains that share a joint; each group is one sequential job
+        std::vector<uint32_t> groupOf(chains_.size());
+        std::iota(groupOf.begin(), groupOf.end(), 0u);
+        auto findRoot = [&](uint32_t c) {
+            while (groupOf[c] != c) {
+                groupOf[c] = groupOf[groupOf[c]];
+                c = groupOf[c];
+            }
+            return c;
+        };
+
+        std::unordered_map<EntityID, uint32_t> jointOwner;
+        jointOwner.reserve(jointEntity_.size());
+        for (uint32_t c = 0; c < chains_.size(); ++c) {
+            for (uint32_t j = 0; j < chains_[c].jointCount; ++j) {
+                auto [it, inserted] = jointOwner.emplace(jointEntity_[chains_[c].jointBegin + j], c);
+                if (!inserted) {
+                    groupOf[findRoot(c)] = findRoot(it->second);
+                }
+            }
+        }
+
+        // Bucket chains by group, keeping chain order inside a group
+        std::vector<uint32_t> groupIndex(chains_.size(), 0xFFFFFFFF);
+        std::vector<uint32_t> groupSize;
+        for (uint32_t c = 0; c < chains_.size(); ++c) {
+            uint32_t root = findRoot(c);
+            if (groupIndex[root] == 0xFFFFFFFF) {
+                groupIndex[root] = static_cast<uint32_t>(groupSize.size());
+                groupSize.push_back(0);
+            }
+            ++groupSize[groupIndex[root]];
+        }
+
+        groupStart_.assign(groupSize.size() + 1, 0);
+        for (size_t g = 0; g < groupSize.size(); ++g) {
+            groupStart_[g + 1] = groupStart_[g] + groupSize[g];
+        }
+        groupChains_.assign(chains_.size(), 0);
+        std::vector<uint32_t> cursor(groupStart_.begin(), groupStart_.end() - 1);
+        for (uint32_t c = 0; c < chains_.size(); ++c) {
+            groupChains_[cursor[groupIndex[findRoot(c)]]++] = c;
+        }
+
+        size_t jointCount = jointEntity_.size();
+        jointIndex_.assign(jointCount, 0);
+        jointTransform_.assign(jointCount, nullptr);
+        jointParent_.assign(jointCount, nullptr);
+        px_.resize(jointCount); py_.resize(jointCount); pz_.resize(jointCount);
+        ox_.resize(jointCount); oy_.resize(jointCount); oz_.resize(jointCount);
+        boneLength_.resize(jointCount);
+        tx_.resize(chains_.size()); ty_.resize(chains_.size()); tz_.resize(chains_.size());
+        residual_.assign(chains_.size(), 0.0f);
+        jointWritten_.assign(jointCount, 0);
+        copyWritten_.assign(copies_.size(), 0);
+
+        cachedEdgeVersion_ = edges.getVersion(RelationType::Constraint);
+        cachedWorldVersion_ = world.getHierarchyVersion();
+        cachedCount_ = storage.size();
+
+        stats_.chainCount = chains_.size();
+        stats_.jointCount = jointCount;
+        stats_.groupCount = groupSize.size();
+        stats_.copyCount = copies_.size();
+    }
+
+    // ========================================================================
+    // GATHER
+    // ========================================================================
+
+    void ConstraintSystem::gatherChain(ComponentStorage<TransformComponent>& transforms,
+        ComponentStorage<ConstraintComponent>& constraints, Chain& chain) {
+        chain.settings = resolve(constraints, chain.owner, chain.settingsIndex);
+        const TransformComponent* target = resolve(transforms, chain.target, chain.targetIndex);
+        if (!chain.settings || !chain.settings->enabled || chain.settings->influence <= 0.0f || !target) {
+            chain.settings = nullptr;
+            return;
+        }
+
+        uint32_t b = chain.jointBegin;
+        for (uint32_t j = 0; j < chain.jointCount; ++j) {
+            TransformComponent* t = resolve(transforms, jointEntity_[b + j], jointIndex_[b + j]);
+            if (!t) {
+                chain.settings = nullptr;
+                return;
+            }
+            jointTransform_[b + j] = t;
+
+            const glm::vec4& p = t->worldMatrix[3];
+            px_[b + j] = ox_[b + j] = p.x;
+            py_[b + j] = oy_[b + j] = p.y;
+            pz_[b + j] = oz_[b + j] = p.z;
+        }
+
+        jointParent_[b] = resolve(transforms, chain.rootParent, chain.rootParentIndex);
+        for (uint32_t j = 1; j < chain.jointCount; ++j) {
+            jointParent_[b + j] = jointTransform_[b + j - 1];
+        }
+
+        // Bone lengths from the current pose, so scaled rigs keep their shape
+        for (uint32_t j = 0; j + 1 < chain.jointCount; ++j) {
+            float dx = px_[b + j + 1] - px_[b + j];
+            float dy = py_[b + j + 1] - py_[b + j];
+            float dz = pz_[b + j + 1] - pz_[b + j];
+            boneLength_[b + j] = std::sqrt(dx * dx + dy * dy + dz * dz);
+        }
+
+        size_t c = &chain - chains_.data();
+        tx_[c] = target->worldMatrix[3].x;
+        ty_[c] = target->worldMatrix[3].y;
+        tz_[c] = target->worldMatrix[3].z;
+    }
+
+    void ConstraintSystem::gatherCopy(ComponentStorage<TransformComponent>& transforms,
+        ComponentStorage<ConstraintComponent>& constraints, Copy& copy) {
+        copy.settings = resolve(constraints, copy.owner, copy.settingsIndex);
+        copy.transform = resolve(transforms, copy.owner, copy.ownerIndex);
+        copy.targetTransform = resolve(transforms, copy.target, copy.targetIndex);
+        copy.parentTransform = resolve(transforms, copy.parent, copy.parentIndex);
+
+        if (!copy.settings || !copy.settings->enabled || copy.settings->influence <= 0.0f ||
+            !copy.transform || !copy.targetTransform) {
+            copy.settings = nullptr;
+        }
+    }
+
+    // ========================================================================
+    // SOLVERS
+    // ========================================================================
+
+    void ConstraintSystem::solveChain(uint32_t c) {
+        const Chain& chain = chains_[c];
+        uint32_t b = chain.jointBegin;
+        uint32_t n = chain.jointCount;
+        float* x = px_.data() + b;
+        float* y = py_.data() + b;
+        float* z = pz_.data() + b;
+        const float* len = boneLength_.data() + b;
+        float targetX = tx_[c], targetY = ty_[c], targetZ = tz_[c];
+
+        auto residual = [&]() {
+            float dx = x[n - 1] - targetX, dy = y[n - 1] - targetY, dz = z[n - 1] - targetZ;
+            return std::sqrt(dx * dx + dy * dy + dz * dz);
+        };
+
+        // Place joint 'to' at distance 'length' from joint 'from', along from->to
+        auto place = [&](uint32_t from, uint32_t to, float length) {
+            float dx = x[to] - x[from], dy = y[to] - y[from], dz = z[to] - z[from];
+            float d = std::sqrt(dx * dx + dy * dy + dz * dz);
+            float k = d > 1e-6f ? length / d : 0.0f;
+            x[to] = x[from] + dx * k;
+            y[to] = y[from] + dy * k;
+            z[to] = z[from] + dz * k;
+        };
+
+        const ConstraintComponent& settings = *chain.settings;
+
+        if (settings.solver == ConstraintComponent::Solver::FABRIK) {
+            float reach = 0.0f;
+            for (uint32_t j = 0; j + 1 < n; ++j) reach += len[j];
+
+            float rx = targetX - x[0], ry = targetY - y[0], rz = targetZ - z[0];
+            float rootToTarget = std::sqrt(rx * rx + ry * ry + rz * rz);
+
+            if (rootToTarget >= reach) {
+                // Out of reach: straighten the chain towards the target
+                float k = rootToTarget > 1e-6f ? 1.0f / rootToTarget : 0.0f;
+                for (uint32_t j = 0; j + 1 < n; ++j) {
+                    x[j + 1] = x[j] + rx * k * len[j];
+                    y[j + 1] = y[j] + ry * k * len[j];
+                    z[j + 1] = z[j] + rz * k * len[j];
+                }
+            }
+            else {
+                float rootX = x[0], rootY = y[0], rootZ = z[0];
+                for (uint32_t it = 0; it < settings.iterations && residual() > settings.tolerance; ++it) {
+                    // Backward: pin the effector to the target
+                    x[n - 1] = targetX; y[n - 1] = targetY; z[n - 1] = targetZ;
+                    for (uint32_t j = n - 1; j-- > 0; ) place(j + 1, j, len[j]);
+
+                    // Forward: pin the root back in place
+                    x[0] = rootX; y[0] = rootY; z[0] = rootZ;
+                    for (uint32_t j = 0; j + 1 < n; ++j) place(j, j + 1, len[j]);
+                }
+            }
+        }
+        else {
+            for (uint32_t it = 0; it < settings.iterations && residual() > settings.tolerance; ++it) {
+                // Rotate each joint (effector side first) so the effector points at the target
+                for (uint32_t j = n - 1; j-- > 0; ) {
+                    glm::vec3 pivot(x[j], y[j], z[j]);
+                    glm::vec3 toEffector = directionOrZero(glm::vec3(x[n - 1], y[n - 1], z[n - 1]) - pivot);
+                    glm::vec3 toTarget = directionOrZero(glm::vec3(targetX, targetY, targetZ) - pivot);
+                    if (toEffector == glm::vec3(0.0f) || toTarget == glm::vec3(0.0f)) continue;
+
+                    glm::quat q = rotationBetween(toEffector, toTarget);
+                    for (uint32_t k = j + 1; k < n; ++k) {
+                        glm::vec3 p = pivot + q * (glm::vec3(x[k], y[k], z[k]) - pivot);
+                        x[k] = p.x; y[k] = p.y; z[k] = p.z;
+                    }
+                }
+            }
+        }
+
+        residual_[c] = residual();
+    }
+
+    void ConstraintSystem::writeBack(uint32_t c) {
+        const Chain& chain = chains_[c];
+        uint32_t b = chain.jointBegin;
+        float influence = std::min(chain.settings->influence, 1.0f);
+
+        // Turn each bone's old->new direction change into a local rotation,
+        // walking root to tip so every joint sees its parent's new rotation
+        const TransformComponent* rootParent = jointParent_[b];
+        glm::quat parentWorld = rootParent ? rotationOf(rootParent->worldMatrix) : glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        bool parentWritten = false;
+
+        for (uint32_t j = 0; j + 1 < chain.jointCount; ++j) {
+            TransformComponent& t = *jointTransform_[b + j];
+
+            glm::vec3 oldDir = directionOrZero(glm::vec3(ox_[b + j + 1] - ox_[b + j], oy_[b + j + 1] - oy_[b + j], oz_[b + j + 1] - oz_[b + j]));
+            glm::vec3 newDir = directionOrZero(glm::vec3(px_[b + j + 1] - px_[b + j], py_[b + j + 1] - py_[b + j], pz_[b + j + 1] - pz_[b + j]));
+
+            // Bone kept its direction and nothing above it was rewritten: the
+            // local rotation is already right (recomputing it only adds the
+            // matrix round trip's rounding)
+            if (!parentWritten && !vectorChanged(oldDir, newDir)) {
+                parentWorld = parentWorld * t.rotation;
+                continue;
+            }
+
+            glm::quat world = rotationOf(t.worldMatrix);
+            if (oldDir != glm::vec3(0.0f) && newDir != glm::vec3(0.0f)) {
+                world = rotationBetween(oldDir, newDir) * world;
+            }
+
+            glm::quat local = glm::normalize(glm::inverse(parentWorld) * world);
+            if (influence < 1.0f) {
+                local = glm::slerp(t.rotation, local, influence);
+            }
+
+            if (rotationChanged(t.rotation, local)) {
+                t.rotation = local;
+                t.dirty = true;
+                jointWritten_[b + j] = 1;
+                parentWritten = true;
+            }
+            parentWorld = parentWorld * t.rotation;
+        }
+    }
+
+    bool ConstraintSystem::applyCopy(const Copy& copy) const {
+        const ConstraintComponent& settings = *copy.settings;
+        TransformComponent& t = *copy.transform;
+        float influence = std::min(settings.influence, 1.0f);
+
+        // Target world transform expressed in the owner's parent space
+        glm::mat4 local = copy.parentTransform
+            ? glm::inverse(copy.parentTransform->worldMatrix) * copy.targetTransform->worldMatrix
+            : copy.targetTransform->worldMatrix;
+
+        bool changed = false;
+        if (settings.copyPosition) {
+            glm::vec3 position = glm::mix(t.position, glm::vec3(local[3]), influence);
+            if (vectorChanged(t.position, position)) {
+                t.position = position;
+                changed = true;
+            }
+        }
+        if (settings.copyRotation) {
+            glm::quat rotation = glm::slerp(t.rotation, rotationOf(local), influence);
+            if (rotationChanged(t.rotation, rotation)) {
+                t.rotation = rotation;
+                changed = true;
+            }
+        }
+        if (settings.copyScale) {
+            glm::vec3 scale(glm::length(glm::vec3(local[0])), glm::length(glm::vec3(local[1])), glm::length(glm::vec3(local[2])));
+            scale = glm::mix(t.scale, scale, influence);
+            if (vectorChanged(t.scale, scale)) {
+                t.scale = scale;
+                changed = true;
+            }
+        }
+        if (changed) t.dirty = true;
+        return changed;
+    }
+
+    // ========================================================================
+    // SOLVE
+    // ========================================================================
+
+    bool ConstraintSystem::solve(World& world) {
+        stats_.maxResidual = 0.0f;
+
+        auto* storage = world.getStorage<ConstraintComponent>();
+        if (!storage || storage->size() == 0) return false;
+
+        const EdgeStore& edges = world.getRelationships().getEdges();
+        if (cachedEdgeVersion_ != edges.getVersion(RelationType::Constraint) ||
+            cachedWorldVersion_ != world.getHierarchyVersion() ||
+            cachedCount_ != storage->size()) {
+            rebuild(world, *storage);
+        }
+        if (chains_.empty() && copies_.empty()) return false;
+
+        auto& jobs = JobSystem::instance();
+
+        // Gather: lookups only, every chain writes its own SoA range
+        auto* transforms = world.getStorage<TransformComponent>();
+        jobs.parallelFor(chains_.size(), CHAIN_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c) gatherChain(*transforms, *storage, chains_[c]);
+            });
+        jobs.parallelFor(copies_.size(), COPY_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c) gatherCopy(*transforms, *storage, copies_[c]);
+            });
+
+        // IK: groups are independent, chains inside a group run in order.
+        // Chains sharing a joint run in the same job, so the written flags
+        // of a joint only ever see one thread.
+        std::fill(jointWritten_.begin(), jointWritten_.end(), 0);
+        size_t groupCount = groupStart_.size() - 1;
+        jobs.parallelFor(groupCount, CHAIN_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t g = begin; g < end; ++g) {
+                for (uint32_t k = groupStart_[g]; k < groupStart_[g + 1]; ++k) {
+                    uint32_t c = groupChains_[k];
+                    if (!chains_[c].settings) continue;
+                    solveChain(c);
+                    writeBack(c);
+                }
+            }
+            });
+
+        jobs.parallelFor(copies_.size(), COPY_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c) {
+                copyWritten_[c] = copies_[c].settings && applyCopy(copies_[c]);
+            }
+            });
+
+        for (const Chain& chain : chains_) {
+            if (chain.settings) stats_.maxResidual = std::max(stats_.maxResidual, residual_[&chain - chains_.data()]);
+        }
+
+        // Queue what actually changed for TransformSystem (jobs only set the
+        // flag); a settled rig writes nothing and needs no second propagate
+        bool wrote = false;
+        for (size_t j = 0; j < jointWritten_.size(); ++j) {
+            if (!jointWritten_[j]) continue;
+            wrote = true;
+            world.markTransformDirty(jointEntity_[j]);
+        }
+        for (size_t c = 0; c < copies_.size(); ++c) {
+            if (!copyWritten_[c]) continue;
+            wrote = true;
+            world.markTransformDirty(copies_[c].owner);
+        }
+        return wrote;
+    }
+
+} // namespace libre
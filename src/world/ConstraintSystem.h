@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Types.h"
+#include "ComponentStorage.h"
+#include "../components/CoreComponents.h"
+
+#include <vector>
+
+namespace libre {
+
+    class World;
+
+    // ============================================================================
+    // CONSTRAINT SYSTEM - Batched IK and copy-transform solving
+    // ============================================================================
+    // Gathers every ConstraintComponent with a Constraint relationship into
+    // flat SoA batches and solves them on the JobSystem:
+    //
+    // - IK chains (FABRIK or CCD) run on world-space joint positions. Chains
+    //   that share a joint are grouped and solved one after another inside a
+    //   single job (each from the pose gathered at the start of the solve);
+    //   independent groups run in parallel. Solved positions are converted
+    //   back to local rotations (bone lengths and root positions are kept).
+    // - Copy-transform constraints then run in parallel, one per owner.
+    //
+    // Results are written into TransformComponents and queued through
+    // World::markTransformDirty, so the caller must run transform propagation
+    // afterwards. World matrices of targets and joints must be current on
+    // entry (propagate first), so copy-transform sees targets as they were
+    // before IK moved them.
+    //
+    // The rig list is rebuilt when constraint edges, the hierarchy or the
+    // component count changes; per frame only positions are gathered.
+
+    class ConstraintSystem {
+    public:
+        struct Stats {
+            size_t chainCount = 0;
+            size_t jointCount = 0;
+            size_t groupCount = 0;      // Independent chain groups (parallel units)
+            size_t copyCount = 0;
+            float maxResidual = 0.0f;   // Worst effector-to-target distance after IK
+        };
+
+        // Solve all constraints; returns true only if a transform changed
+        // (a settled rig writes nothing)
+        bool solve(World& world);
+
+        void invalidate() { cachedEdgeVersion_ = INVALID_VERSION; }
+
+        const Stats& getStats() const { return stats_; }
+
+    private:
+        static constexpr uint64_t INVALID_VERSION = ~0ull;
+
+        // Per-chain parameters; joints are [jointBegin, jointBegin + jointCount)
+        // in the joint arrays, root first, effector last
+        // Dense storage indices are cached and revalidated on use (like
+        // TransformSystem), so a steady-state gather does no hashing
+        struct Chain {
+            EntityID owner = INVALID_ENTITY;
+            EntityID target = INVALID_ENTITY;
+            EntityID rootParent = INVALID_ENTITY;
+            uint32_t jointBegin = 0;
+            uint32_t jointCount = 0;
+            uint32_t settingsIndex = 0;
+            uint32_t targetIndex = 0;
+            uint32_t rootParentIndex = 0;
+
+            // Gathered each frame
+            const ConstraintComponent* settings = nullptr;  // nullptr = skip this frame
+        };
+
+        struct Copy {
+            EntityID owner = INVALID_ENTITY;
+            EntityID target = INVALID_ENTITY;
+            EntityID parent = INVALID_ENTITY;
+            uint32_t settingsIndex = 0;
+            uint32_t ownerIndex = 0;
+            uint32_t targetIndex = 0;
+            uint32_t parentIndex = 0;
+
+            // Gathered each frame
+            const ConstraintComponent* settings = nullptr;
+            TransformComponent* transform = nullptr;
+            const TransformComponent* parentTransform = nullptr;
+            const TransformComponent* targetTransform = nullptr;
+        };
+
+        void rebuild(World& world, ComponentStorage<ConstraintComponent>& storage);
+        void gatherChain(ComponentStorage<TransformComponent>& transforms,
+            ComponentStorage<ConstraintComponent>& constraints, Chain& chain);
+        void gatherCopy(ComponentStorage<TransformComponent>& transforms,
+            ComponentStorage<ConstraintComponent>& constraints, Copy& copy);
+        void solveChain(uint32_t chain);
+        void writeBack(uint32_t chain);
+        bool applyCopy(const Copy& copy) const;   // True if the owner's transform changed
+
+        std::vector<Chain> chains_;
+        std::vector<Copy> copies_;
+
+        // Groups of chains sharing joints: groupChains_[groupStart_[g] .. groupStart_[g + 1])
+        std::vector<uint32_t> groupStart_;
+        std::vector<uint32_t> groupChains_;
+
+        // Joint SoA (one entry per joint, chains back to back)
+        std::vector<EntityID> jointEntity_;
+        std::vector<uint32_t> jointIndex_;                  // Cached dense index
+        std::vector<TransformComponent*> jointTransform_;   // Resolved each frame
+        std::vector<const TransformComponent*> jointParent_;
+        std::vector<float> px_, py_, pz_;                   // Working positions (world)
+        std::vector<float> ox_, oy_, oz_;                   // Positions before solving
+        std::vector<float> boneLength_;                     // Joint i to i + 1
+
+        // Chain SoA (targets, gathered each frame)
+        std::vector<float> tx_, ty_, tz_;
+        std::vector<float> residual_;
+
+        // Set by the solve jobs when a result differed from the transform
+        std::vector<uint8_t> jointWritten_;
+        std::vector<uint8_t> copyWritten_;
+
+        uint64_t cachedEdgeVersion_ = INVALID_VERSION;
+        uint64_t cachedWorldVersion_ = INVALID_VERSION;
+        size_t cachedCount_ = 0;
+
+        Stats stats_;
+    };
+
+} // namespace libre
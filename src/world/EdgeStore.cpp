@@ -0,0 +1,200 @@
+#include "EdgeStore.h"
+
+namespace libre {
+
+    // Swap-remove list[pos]; returns the value that moved into 'pos' (or
+    // INVALID_EDGE if 'pos' was the last element)
+    static uint32_t swapRemove(std::vector<uint32_t>& list, uint32_t pos) {
+        uint32_t moved = list.back();
+        list.pop_back();
+        if (pos == list.size()) return EdgeStore::INVALID_EDGE;
+        list[pos] = moved;
+        return moved;
+    }
+
+    // ========================================================================
+    // EDITING
+    // ========================================================================
+
+    uint32_t EdgeStore::registerSlot(EntityID entity) {
+        uint32_t slot = getEntityIndex(entity);
+        if (slot >= slotIds_.size()) {
+            slotIds_.resize(static_cast<size_t>(slot) + 1, INVALID_ENTITY);
+            slotEdgeCount_.resize(static_cast<size_t>(slot) + 1, 0);
+        }
+
+        if (slotIds_[slot] != entity) {
+            // A stale generation left edges behind - drop them before reuse
+            if (slotIds_[slot] != INVALID_ENTITY && slotEdgeCount_[slot] > 0) {
+                removeEntity(slotIds_[slot]);
+            }
+            slotIds_[slot] = entity;
+        }
+        return slot;
+    }
+
+    uint32_t EdgeStore::add(RelationType type, EntityID from, EntityID to,
+        int32_t order, const std::string& label, float weight) {
+        if (from == INVALID_ENTITY || to == INVALID_ENTITY) return INVALID_EDGE;
+
+        uint32_t fromSlot = registerSlot(from);
+        uint32_t toSlot = registerSlot(to);
+
+        Key key{ fromSlot, toSlot, type };
+        auto it = lookup_.find(key);
+        if (it != lookup_.end()) {
+            Edge& existing = edges_[it->second];
+            existing.order = order;
+            existing.label = labels_.intern(label);
+            existing.weight = weight;
+            adjacency(type).version = ++editCounter_;
+            return it->second;
+        }
+
+        Adjacency& adj = adjacency(type);
+        size_t slotCount = slotIds_.size();
+        if (adj.out.size() < slotCount) adj.out.resize(slotCount);
+        if (adj.in.size() < slotCount) adj.in.resize(slotCount);
+
+        uint32_t index = static_cast<uint32_t>(edges_.size());
+
+        Edge edge;
+        edge.from = fromSlot;
+        edge.to = toSlot;
+        edge.label = labels_.intern(label);
+        edge.order = order;
+        edge.weight = weight;
+        edge.type = type;
+        edge.outPos = static_cast<uint32_t>(adj.out[fromSlot].size());
+        edge.inPos = static_cast<uint32_t>(adj.in[toSlot].size());
+        edge.typePos = static_cast<uint32_t>(adj.edges.size());
+
+        edges_.push_back(edge);
+        adj.out[fromSlot].push_back(index);
+        adj.in[toSlot].push_back(index);
+        adj.edges.push_back(index);
+        adj.csrValid = false;
+        adj.version = ++editCounter_;
+
+        ++slotEdgeCount_[fromSlot];
+        ++slotEdgeCount_[toSlot];
+
+        lookup_.emplace(key, index);
+        return index;
+    }
+
+    bool EdgeStore::remove(RelationType type, EntityID from, EntityID to) {
+        uint32_t index = find(type, from, to);
+        if (index == INVALID_EDGE) return false;
+        removeAt(index);
+        return true;
+    }
+
+    void EdgeStore::removeAt(uint32_t index) {
+        Edge edge = edges_[index];
+        Adjacency& adj = adjacency(edge.type);
+
+        // Unlink from the three lists; whoever fills the hole learns its new position
+        uint32_t moved = swapRemove(adj.out[edge.from], edge.outPos);
+        if (moved != INVALID_EDGE) edges_[moved].outPos = edge.outPos;
+
+        moved = swapRemove(adj.in[edge.to], edge.inPos);
+        if (moved != INVALID_EDGE) edges_[moved].inPos = edge.inPos;
+
+        moved = swapRemove(adj.edges, edge.typePos);
+        if (moved != INVALID_EDGE) edges_[moved].typePos = edge.typePos;
+
+        adj.csrValid = false;
+        adj.version = ++editCounter_;
+        --slotEdgeCount_[edge.from];
+        --slotEdgeCount_[edge.to];
+        lookup_.erase(Key{ edge.from, edge.to, edge.type });
+
+        // Fill the hole in the dense array with the last edge and patch
+        // every reference to its old index
+        uint32_t last = static_cast<uint32_t>(edges_.size() - 1);
+        if (index != last) {
+            Edge& tail = edges_[last];
+            Adjacency& tailAdj = adjacency(tail.type);
+            tailAdj.out[tail.from][tail.outPos] = index;
+            tailAdj.in[tail.to][tail.inPos] = index;
+            tailAdj.edges[tail.typePos] = index;
+            tailAdj.csrValid = false;
+            lookup_[Key{ tail.from, tail.to, tail.type }] = index;
+            edges_[index] = tail;
+        }
+        edges_.pop_back();
+    }
+
+    void EdgeStore::removeEntity(EntityID entity) {
+        uint32_t slot = slotOf(entity);
+        if (slot == INVALID_EDGE) return;
+
+        for (Adjacency& adj : types_) {
+            if (slot < adj.out.size()) {
+                // removeAt swap-removes from this list, so always take the back
+                auto& out = adj.out[slot];
+                while (!out.empty()) removeAt(out.back());
+                out.shrink_to_fit();
+            }
+            if (slot < adj.in.size()) {
+                auto& in = adj.in[slot];
+                while (!in.empty()) removeAt(in.back());
+                in.shrink_to_fit();
+            }
+        }
+
+        slotIds_[slot] = INVALID_ENTITY;
+    }
+
+    void EdgeStore::clear() {
+        edges_.clear();
+        slotIds_.clear();
+        slotEdgeCount_.clear();
+        lookup_.clear();
+        for (Adjacency& adj : types_) {
+            adj = Adjacency{};
+            adj.version = ++editCounter_;
+        }
+        labels_.clear();
+    }
+
+    // ========================================================================
+    // QUERIES
+    // ========================================================================
+
+    uint32_t EdgeStore::find(RelationType type, EntityID from, EntityID to) const {
+        uint32_t fromSlot = slotOf(from);
+        uint32_t toSlot = slotOf(to);
+        if (fromSlot == INVALID_EDGE || toSlot == INVALID_EDGE) return INVALID_EDGE;
+
+        auto it = lookup_.find(Key{ fromSlot, toSlot, type });
+        return it != lookup_.end() ? it->second : INVALID_EDGE;
+    }
+
+    const EdgeStore::CSR& EdgeStore::getCSR(RelationType type) const {
+        const Adjacency& adj = adjacency(type);
+        if (adj.csrValid) return adj.csr;
+
+        CSR& csr = adj.csr;
+        size_t slotCount = adj.out.size();
+        csr.offsets.assign(slotCount + 1, 0);
+        csr.targets.resize(adj.edges.size());
+        csr.edges.resize(adj.edges.size());
+
+        uint32_t offset = 0;
+        for (size_t s = 0; s < slotCount; ++s) {
+            csr.offsets[s] = offset;
+            for (uint32_t e : adj.out[s]) {
+                csr.targets[offset] = edges_[e].to;
+                csr.edges[offset] = e;
+                ++offset;
+            }
+        }
+        csr.offsets[slotCount] = offset;
+
+        adj.csrValid = true;
+        return csr;
+    }
+
+} // namespace libre
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "Types.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+namespace libre {
+
+    // ============================================================================
+    // LABEL POOL - Interned relationship labels
+    // ============================================================================
+    // Edges store a 32-bit label id instead of a heap string. Id 0 is the
+    // empty label. Labels are never released; the set of distinct labels in
+    // a scene (socket names, constraint names) is small.
+
+    class LabelPool {
+    public:
+        static constexpr uint32_t EMPTY = 0;
+
+        LabelPool() { strings_.emplace_back(); }
+
+        uint32_t intern(const std::string& label) {
+            if (label.empty()) return EMPTY;
+
+            auto it = ids_.find(label);
+            if (it != ids_.end()) return it->second;
+
+            uint32_t id = static_cast<uint32_t>(strings_.size());
+            strings_.push_back(label);
+            ids_.emplace(label, id);
+            return id;
+        }
+
+        const std::string& get(uint32_t id) const {
+            return id < strings_.size() ? strings_[id] : strings_[EMPTY];
+        }
+
+        void clear() {
+            strings_.resize(1);
+            ids_.clear();
+        }
+
+    private:
+        std::vector<std::string> strings_;
+        std::unordered_map<std::string, uint32_t> ids_;
+    };
+
+    // ============================================================================
+    // EDGE STORE - Typed directed edges between entities
+    // ============================================================================
+    // Storage for the generic (non-hierarchy) relationship types.
+    //
+    // - Edges are small POD records in one dense array: endpoints are 32-bit
+    //   entity slots and labels are interned ids.
+    // - (type, from, to) lookup goes through a hash map with a 64-bit mixer.
+    // - Each edge remembers its position in its source's outgoing list, its
+    //   target's incoming list and its type's edge list, so every removal is
+    //   a handful of O(1) swap-removes - no scans over an entity's edges.
+    // - getCSR() packs one type into compressed-sparse-row arrays for
+    //   read-heavy passes (graph evaluation). It is rebuilt lazily on edits.
+    //
+    // Adjacency order is not stable: swap-removal reorders siblings.
+
+    class EdgeStore {
+    public:
+        static constexpr size_t TYPE_COUNT = static_cast<size_t>(RelationType::Constraint) + 1;
+        static constexpr uint32_t INVALID_EDGE = 0xFFFFFFFF;
+
+        struct Edge {
+            uint32_t from = 0;          // Entity slots
+            uint32_t to = 0;
+            uint32_t label = LabelPool::EMPTY;
+            int32_t order = 0;
+            float weight = 1.0f;
+            uint32_t outPos = 0;        // Index in adjacency(type).out[from]
+            uint32_t inPos = 0;         // Index in adjacency(type).in[to]
+            uint32_t typePos = 0;       // Index in adjacency(type).edges
+            RelationType type = RelationType::NodeConnection;
+        };
+
+        // Compressed sparse rows for one relation type, indexed by entity slot.
+        // Outgoing edges of slot s are edges[offsets[s] .. offsets[s + 1]).
+        struct CSR {
+            std::vector<uint32_t> offsets;
+            std::vector<uint32_t> targets;  // Target slot per entry
+            std::vector<uint32_t> edges;    // Edge index per entry
+        };
+
+        // ========================================================================
+        // EDITING
+        // ========================================================================
+
+        // Insert or update (order/label/weight) an edge. Returns its index.
+        uint32_t add(RelationType type, EntityID from, EntityID to,
+            int32_t order = 0, const std::string& label = {}, float weight = 1.0f);
+
+        // Returns false if the edge did not exist
+        bool remove(RelationType type, EntityID from, EntityID to);
+
+        // Remove every edge touching 'entity'
+        void removeEntity(EntityID entity);
+
+        void clear();
+
+        // ========================================================================
+        // QUERIES
+        // ========================================================================
+
+        uint32_t find(RelationType type, EntityID from, EntityID to) const;
+        bool contains(RelationType type, EntityID from, EntityID to) const {
+            return find(type, from, to) != INVALID_EDGE;
+        }
+
+        size_t size() const { return edges_.size(); }
+        size_t size(RelationType type) const { return adjacency(type).edges.size(); }
+
+        const Edge& getEdge(uint32_t index) const { return edges_[index]; }
+        EntityID getFrom(const Edge& edge) const { return slotIds_[edge.from]; }
+        EntityID getTo(const Edge& edge) const { return slotIds_[edge.to]; }
+        const std::string& getLabel(const Edge& edge) const { return labels_.get(edge.label); }
+
+        // Visit edges as func(uint32_t edgeIndex, const Edge&)
+        template<typename Func>
+        void forEachOutgoing(EntityID entity, RelationType type, Func&& func) const {
+            forEachIn(adjacency(type).out, entity, func);
+        }
+
+        template<typename Func>
+        void forEachIncoming(EntityID entity, RelationType type, Func&& func) const {
+            forEachIn(adjacency(type).in, entity, func);
+        }
+
+        template<typename Func>
+        void forEachOfType(RelationType type, Func&& func) const {
+            for (uint32_t e : adjacency(type).edges) {
+                func(e, edges_[e]);
+            }
+        }
+
+        size_t getOutDegree(EntityID entity, RelationType type) const {
+            const auto* list = listFor(adjacency(type).out, entity);
+            return list ? list->size() : 0;
+        }
+
+        size_t getInDegree(EntityID entity, RelationType type) const {
+            const auto* list = listFor(adjacency(type).in, entity);
+            return list ? list->size() : 0;
+        }
+
+        // Bumped on every edit to edges of 'type' (systems cache topology)
+        uint64_t getVersion(RelationType type) const { return adjacency(type).version; }
+
+        // Packed outgoing adjacency for one type (rebuilt after edits)
+        const CSR& getCSR(RelationType type) const;
+
+        // Entity currently registered at a slot (INVALID_ENTITY if none)
+        EntityID getSlotEntity(uint32_t slot) const {
+            return slot < slotIds_.size() ? slotIds_[slot] : INVALID_ENTITY;
+        }
+
+    private:
+        struct Key {
+            uint32_t from;
+            uint32_t to;
+            RelationType type;
+
+            bool operator==(const Key& other) const {
+                return from == other.from && to == other.to && type == other.type;
+            }
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key& k) const {
+                uint64_t h = (static_cast<uint64_t>(k.from) << 32) | k.to;
+                h ^= static_cast<uint64_t>(k.type) * 0x9E3779B97F4A7C15ull;
+                // splitmix64 finalizer - every input bit reaches every output bit
+                h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+                h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+                return static_cast<size_t>(h ^ (h >> 31));
+            }
+        };
+
+        struct Adjacency {
+            std::vector<std::vector<uint32_t>> out;     // By source slot
+            std::vector<std::vector<uint32_t>> in;      // By target slot
+            std::vector<uint32_t> edges;
+            uint64_t version = 0;
+            mutable CSR csr;
+            mutable bool csrValid = false;
+        };
+
+        Adjacency& adjacency(RelationType type) { return types_[static_cast<size_t>(type)]; }
+        const Adjacency& adjacency(RelationType type) const { return types_[static_cast<size_t>(type)]; }
+
+        // Slot for a registered entity, or INVALID_EDGE if unknown/stale
+        uint32_t slotOf(EntityID entity) const {
+            uint32_t slot = getEntityIndex(entity);
+            if (entity == INVALID_ENTITY || slot >= slotIds_.size() || slotIds_[slot] != entity) {
+                return INVALID_EDGE;
+            }
+            return slot;
+        }
+
+        uint32_t registerSlot(EntityID entity);
+
+        const std::vector<uint32_t>* listFor(const std::vector<std::vector<uint32_t>>& lists, EntityID entity) const {
+            uint32_t slot = slotOf(entity);
+            return slot != INVALID_EDGE && slot < lists.size() ? &lists[slot] : nullptr;
+        }
+
+        template<typename Func>
+        void forEachIn(const std::vector<std::vector<uint32_t>>& lists, EntityID entity, Func& func) const {
+            if (const auto* list = listFor(lists, entity)) {
+                for (uint32_t e : *list) {
+                    func(e, edges_[e]);
+                }
+            }
+        }
+
+        void removeAt(uint32_t index);
+
+        std::vector<Edge> edges_;
+        std::vector<EntityID> slotIds_;             // Slot -> full id (generation check)
+        std::vector<uint32_t> slotEdgeCount_;       // Edges touching each slot, all types
+        std::unordered_map<Key, uint32_t, KeyHash> lookup_;
+        Adjacency types_[TYPE_COUNT];
+        uint64_t editCounter_ = 0;              // Source of Adjacency::version (never reset)
+        LabelPool labels_;
+    };
+
+} // namespace libre
@@ -0,0 +1,213 @@
+#include "GroupIndex.h"
+
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LIBRE_KERNEL_SSE 1
+#endif
+
+namespace libre {
+
+    // ========================================================================
+    // BIT HELPERS
+    // ========================================================================
+
+    uint32_t SlotSet::popCount(uint64_t bits) {
+        // SWAR count - no POPCNT requirement on older x64 targets
+        bits = bits - ((bits >> 1) & 0x5555555555555555ull);
+        bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+        bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+        return static_cast<uint32_t>((bits * 0x0101010101010101ull) >> 56);
+    }
+
+    uint32_t SlotSet::countTrailingZeros(uint64_t bits) {
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<uint32_t>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+        return static_cast<uint32_t>(__builtin_ctzll(bits));
+#else
+        return popCount((bits & (0 - bits)) - 1);
+#endif
+    }
+
+    // ========================================================================
+    // SLOT SET
+    // ========================================================================
+
+    bool SlotSet::insert(uint32_t slot) {
+        size_t word = slot >> 6;
+        if (word >= words_.size()) {
+            words_.resize(word + 1, 0);
+        }
+
+        uint64_t bit = 1ull << (slot & 63);
+        if (words_[word] & bit) return false;
+
+        words_[word] |= bit;
+        ++count_;
+        return true;
+    }
+
+    bool SlotSet::erase(uint32_t slot) {
+        size_t word = slot >> 6;
+        uint64_t bit = 1ull << (slot & 63);
+        if (word >= words_.size() || !(words_[word] & bit)) return false;
+
+        words_[word] &= ~bit;
+        --count_;
+        return true;
+    }
+
+    void SlotSet::clear() {
+        words_.clear();
+        count_ = 0;
+    }
+
+    void SlotSet::recount() {
+        count_ = 0;
+        for (uint64_t bits : words_) {
+            count_ += popCount(bits);
+        }
+    }
+
+    SlotSet& SlotSet::operator|=(const SlotSet& other) {
+        if (other.words_.size() > words_.size()) {
+            words_.resize(other.words_.size(), 0);
+        }
+        for (size_t w = 0; w < other.words_.size(); ++w) {
+            words_[w] |= other.words_[w];
+        }
+        recount();
+        return *this;
+    }
+
+    SlotSet& SlotSet::operator&=(const SlotSet& other) {
+        if (words_.size() > other.words_.size()) {
+            words_.resize(other.words_.size());
+        }
+        for (size_t w = 0; w < words_.size(); ++w) {
+            words_[w] &= other.words_[w];
+        }
+        recount();
+        return *this;
+    }
+
+    SlotSet& SlotSet::subtract(const SlotSet& other) {
+        size_t n = std::min(words_.size(), other.words_.size());
+        for (size_t w = 0; w < n; ++w) {
+            words_[w] &= ~other.words_[w];
+        }
+        recount();
+        return *this;
+    }
+
+    SlotSet SlotSet::unite(const SlotSet& a, const SlotSet& b) {
+        SlotSet result = a;
+        result |= b;
+        return result;
+    }
+
+    SlotSet SlotSet::intersect(const SlotSet& a, const SlotSet& b) {
+        SlotSet result = a.words_.size() <= b.words_.size() ? a : b;
+        result &= a.words_.size() <= b.words_.size() ? b : a;
+        return result;
+    }
+
+    void SlotSet::toSlots(std::vector<uint32_t>& out) const {
+        out.clear();
+        out.reserve(count_);
+        forEach([&](uint32_t slot) { out.push_back(slot); });
+    }
+
+    // ========================================================================
+    // FLAG MASK WRITES
+    // ========================================================================
+
+    // One 64-slot word with a mixed bit pattern: expand each bit into an
+    // all-ones/all-zeros lane mask and select
+    static void maskWord(uint32_t* f, uint64_t bits, uint32_t setBits, uint32_t clearBits) {
+#if LIBRE_KERNEL_SSE
+        const __m128i laneBits = _mm_setr_epi32(1, 2, 4, 8);
+        const __m128i set = _mm_set1_epi32(static_cast<int>(setBits));
+        const __m128i clear = _mm_set1_epi32(static_cast<int>(clearBits));
+
+        for (uint32_t i = 0; i < 64; i += 4) {
+            __m128i nibble = _mm_set1_epi32(static_cast<int>((bits >> i) & 0xF));
+            __m128i m = _mm_cmpeq_epi32(_mm_and_si128(nibble, laneBits), laneBits);
+
+            __m128i* p = reinterpret_cast<__m128i*>(f + i);
+            __m128i v = _mm_loadu_si128(p);
+            v = _mm_or_si128(_mm_andnot_si128(_mm_and_si128(clear, m), v), _mm_and_si128(set, m));
+            _mm_storeu_si128(p, v);
+        }
+#else
+        for (uint32_t i = 0; i < 64; ++i) {
+            uint32_t m = 0u - static_cast<uint32_t>((bits >> i) & 1);
+            f[i] = (f[i] & ~(clearBits & m)) | (setBits & m);
+        }
+#endif
+    }
+
+    void applyFlagMask(const SlotSet& set, uint32_t* flags, size_t flagCount,
+        uint32_t setBits, uint32_t clearBits) {
+        const auto& words = set.getWords();
+        const uint32_t keep = ~clearBits;
+
+        for (size_t w = 0; w < words.size(); ++w) {
+            uint64_t bits = words[w];
+            if (!bits) continue;
+
+            size_t base = w * 64;
+            if (base >= flagCount) break;
+            size_t n = std::min<size_t>(64, flagCount - base);
+            uint32_t* f = flags + base;
+
+            if (n < 64) {
+                for (size_t i = 0; i < n; ++i) {
+                    uint32_t m = 0u - static_cast<uint32_t>((bits >> i) & 1);
+                    f[i] = (f[i] & ~(clearBits & m)) | (setBits & m);
+                }
+            }
+            else if (bits == ~0ull) {
+                for (size_t i = 0; i < 64; ++i) {
+                    f[i] = (f[i] & keep) | setBits;
+                }
+            }
+            else {
+                maskWord(f, bits, setBits, clearBits);
+            }
+        }
+    }
+
+    // ========================================================================
+    // GROUP INDEX
+    // ========================================================================
+
+    void GroupIndex::addMember(EntityID group, EntityID member) {
+        if (group == INVALID_ENTITY || member == INVALID_ENTITY) return;
+        groups_[group].insert(getEntityIndex(member));
+    }
+
+    void GroupIndex::removeMember(EntityID group, EntityID member) {
+        auto it = groups_.find(group);
+        if (it == groups_.end()) return;
+        it->second.erase(getEntityIndex(member));
+    }
+
+    void GroupIndex::eraseGroup(EntityID group) {
+        groups_.erase(group);
+    }
+
+    const SlotSet* GroupIndex::getMembers(EntityID group) const {
+        auto it = groups_.find(group);
+        return it != groups_.end() ? &it->second : nullptr;
+    }
+
+} // namespace libre
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Types.h"
+#include <vector>
+#include <unordered_map>
+
+namespace libre {
+
+    // ============================================================================
+    // SLOT SET - Bitset over entity slots
+    // ============================================================================
+    // One bit per entity slot (getEntityIndex), 64 slots per word. Set algebra
+    // is word-wise, iteration visits slots in ascending order, and a 200k
+    // member set costs ~25 KB.
+
+    class SlotSet {
+    public:
+        // Returns true if the slot was added / removed
+        bool insert(uint32_t slot);
+        bool erase(uint32_t slot);
+
+        bool contains(uint32_t slot) const {
+            size_t word = slot >> 6;
+            return word < words_.size() && (words_[word] >> (slot & 63)) & 1;
+        }
+
+        size_t count() const { return count_; }
+        bool empty() const { return count_ == 0; }
+        void clear();
+
+        // In-place set algebra
+        SlotSet& operator|=(const SlotSet& other);
+        SlotSet& operator&=(const SlotSet& other);
+        SlotSet& subtract(const SlotSet& other);
+
+        static SlotSet unite(const SlotSet& a, const SlotSet& b);
+        static SlotSet intersect(const SlotSet& a, const SlotSet& b);
+
+        // Visit slots in ascending order as func(uint32_t slot)
+        template<typename Func>
+        void forEach(Func&& func) const {
+            for (size_t w = 0; w < words_.size(); ++w) {
+                uint64_t bits = words_[w];
+                while (bits) {
+                    func(static_cast<uint32_t>(w * 64 + countTrailingZeros(bits)));
+                    bits &= bits - 1;
+                }
+            }
+        }
+
+        // Sorted slot list
+        void toSlots(std::vector<uint32_t>& out) const;
+
+        const std::vector<uint64_t>& getWords() const { return words_; }
+
+        static uint32_t popCount(uint64_t bits);
+        static uint32_t countTrailingZeros(uint64_t bits);
+
+    private:
+        void recount();
+
+        std::vector<uint64_t> words_;
+        size_t count_ = 0;
+    };
+
+    // ============================================================================
+    // FLAG MASK WRITES
+    // ============================================================================
+    // flags[slot] = (flags[slot] & ~clearBits) | setBits for every slot in
+    // 'set' (and < flagCount). Empty words are skipped, full words are a
+    // straight 64-lane loop, and mixed words expand their bits into SSE2
+    // lane masks (scalar branchless select elsewhere).
+
+    void applyFlagMask(const SlotSet& set, uint32_t* flags, size_t flagCount,
+        uint32_t setBits, uint32_t clearBits);
+
+    // ============================================================================
+    // GROUP INDEX - Membership sets of RelationType::GroupMember
+    // ============================================================================
+    // A GroupMember relationship runs from = group, to = member. Each group
+    // keeps its members as a SlotSet, so bulk operations (hide, lock, select)
+    // are O(group) bit work instead of filtering every relationship.
+
+    class GroupIndex {
+    public:
+        void addMember(EntityID group, EntityID member);
+        void removeMember(EntityID group, EntityID member);
+
+        // Forget a group entity and its member set
+        void eraseGroup(EntityID group);
+
+        // nullptr if 'group' has never had members
+        const SlotSet* getMembers(EntityID group) const;
+
+        size_t getGroupCount() const { return groups_.size(); }
+
+        void clear() { groups_.clear(); }
+
+    private:
+        std::unordered_map<EntityID, SlotSet> groups_;
+    };
+
+} // namespace libre
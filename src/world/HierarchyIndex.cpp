@@ -0,0 +1,208 @@
+#include "HierarchyIndex.h"
+
+namespace libre {
+
+    // ========================================================================
+    // NODES
+    // ========================================================================
+
+    void HierarchyIndex::insert(EntityID entity) {
+        if (entity == INVALID_ENTITY || contains(entity)) return;
+
+        uint32_t slot = getEntityIndex(entity);
+        if (slot >= nodes_.size()) {
+            nodes_.resize(static_cast<size_t>(slot) + 1);
+        }
+
+        Node& node = nodes_[slot];
+        node = Node{};
+        node.id = entity;
+
+        node.slotInParent = static_cast<uint32_t>(roots_.size());
+        roots_.push_back(entity);
+
+        ++nodeCount_;
+        invalidateOrder();
+    }
+
+    void HierarchyIndex::erase(EntityID entity) {
+        Node* node = find(entity);
+        if (!node) return;
+
+        detach(*node);
+
+        // Orphaned children become roots
+        for (EntityID childId : node->children) {
+            Node& child = nodeOf(childId);
+            child.parent = INVALID_ENTITY;
+            child.slotInParent = static_cast<uint32_t>(roots_.size());
+            roots_.push_back(childId);
+            --edgeCount_;
+        }
+
+        *node = Node{};
+        --nodeCount_;
+        invalidateOrder();
+    }
+
+    void HierarchyIndex::setParent(EntityID child, EntityID parent) {
+        if (child == INVALID_ENTITY || child == parent) return;
+
+        insert(child);
+        if (parent != INVALID_ENTITY) {
+            insert(parent);
+        }
+
+        Node& node = nodeOf(child);
+        if (node.parent == parent) return;
+
+        detach(node);
+        attach(node, parent);
+        invalidateOrder();
+    }
+
+    void HierarchyIndex::clear() {
+        nodes_.clear();
+        roots_.clear();
+        preorder_.clear();
+        intervals_.clear();
+        nodeCount_ = 0;
+        edgeCount_ = 0;
+        invalidateOrder();
+    }
+
+    // Link into the parent's child list, or the root list
+    void HierarchyIndex::attach(Node& node, EntityID parent) {
+        node.parent = parent;
+
+        if (parent == INVALID_ENTITY) {
+            node.slotInParent = static_cast<uint32_t>(roots_.size());
+            roots_.push_back(node.id);
+            return;
+        }
+
+        auto& siblings = nodeOf(parent).children;
+        node.slotInParent = static_cast<uint32_t>(siblings.size());
+        siblings.push_back(node.id);
+        ++edgeCount_;
+    }
+
+    // Swap-remove from the parent's child list, or the root list
+    void HierarchyIndex::detach(Node& node) {
+        auto& list = node.parent != INVALID_ENTITY ? nodeOf(node.parent).children : roots_;
+
+        uint32_t slot = node.slotInParent;
+        EntityID last = list.back();
+        list[slot] = last;
+        nodeOf(last).slotInParent = slot;
+        list.pop_back();
+
+        if (node.parent != INVALID_ENTITY) {
+            --edgeCount_;
+        }
+
+        node.parent = INVALID_ENTITY;
+        node.slotInParent = INVALID_SLOT;
+    }
+
+    // ========================================================================
+    // INTERVAL NUMBERING
+    // ========================================================================
+
+    void HierarchyIndex::rebuildOrder() const {
+        std::lock_guard<std::mutex> lock(orderMutex_);
+        if (orderValid_.load(std::memory_order_relaxed)) return;   // Another reader got here first
+
+        preorder_.clear();
+        preorder_.reserve(nodeCount_);
+        intervals_.assign(nodes_.size(), Interval{});
+
+        // Explicit stack - deep imported hierarchies must not recurse
+        std::vector<EntityID> stack;
+        for (EntityID root : roots_) {
+            stack.push_back(root);
+
+            while (!stack.empty()) {
+                EntityID id = stack.back();
+                stack.pop_back();
+
+                const Node& node = nodes_[getEntityIndex(id)];
+                Interval& interval = intervals_[getEntityIndex(id)];
+                interval.enter = static_cast<uint32_t>(preorder_.size());
+                interval.depth = node.parent != INVALID_ENTITY
+                    ? intervals_[getEntityIndex(node.parent)].depth + 1 : 0;
+                preorder_.push_back(id);
+
+                for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) {
+                    stack.push_back(*it);
+                }
+            }
+        }
+
+        // Subtree sizes: children always follow their parent in pre-order,
+        // so one reverse sweep accumulates them bottom-up
+        for (size_t i = preorder_.size(); i-- > 0; ) {
+            const Node& node = nodes_[getEntityIndex(preorder_[i])];
+            if (node.parent != INVALID_ENTITY) {
+                intervals_[getEntityIndex(node.parent)].subtreeSize +=
+                    intervals_[getEntityIndex(preorder_[i])].subtreeSize;
+            }
+        }
+
+        walkSteps_.store(0, std::memory_order_relaxed);
+        orderValid_.store(true, std::memory_order_release);
+    }
+
+    // ========================================================================
+    // QUERIES
+    // ========================================================================
+
+    bool HierarchyIndex::isAncestorOf(EntityID ancestor, EntityID descendant) const {
+        if (ancestor == descendant) return false;
+
+        const Node* a = find(ancestor);
+        const Node* d = find(descendant);
+        if (!a || !d) return false;
+
+        // Leaves are never ancestors - this is every check during an import
+        if (a->children.empty()) return false;
+
+        if (!orderValid_.load(std::memory_order_acquire)) {
+            // Walk while it's cheaper than renumbering
+            if (walkSteps_.load(std::memory_order_relaxed) < nodeCount_) {
+                size_t steps = 0;
+                bool found = false;
+                for (EntityID current = d->parent; current != INVALID_ENTITY;
+                    current = nodes_[getEntityIndex(current)].parent) {
+                    ++steps;
+                    if (current == ancestor) {
+                        found = true;
+                        break;
+                    }
+                }
+                walkSteps_.fetch_add(steps, std::memory_order_relaxed);
+                return found;
+            }
+            rebuildOrder();
+        }
+
+        const Interval& ia = intervals_[getEntityIndex(ancestor)];
+        const Interval& id = intervals_[getEntityIndex(descendant)];
+        return ia.enter < id.enter && id.enter < ia.enter + ia.subtreeSize;
+    }
+
+    EntitySpan HierarchyIndex::getSubtree(EntityID root) const {
+        if (!contains(root)) return EntitySpan{};
+        prepareQueries();
+
+        const Interval& interval = intervals_[getEntityIndex(root)];
+        return EntitySpan{ preorder_.data() + interval.enter, interval.subtreeSize };
+    }
+
+    uint32_t HierarchyIndex::getDepth(EntityID entity) const {
+        if (!contains(entity)) return 0;
+        prepareQueries();
+        return intervals_[getEntityIndex(entity)].depth;
+    }
+
+} // namespace libre
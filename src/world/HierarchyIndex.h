@@ -0,0 +1,146 @@
+#pragma once
+
+#include "Types.h"
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+namespace libre {
+
+    // ============================================================================
+    // HIERARCHY INDEX - Parent/child tree with O(1) structural queries
+    // ============================================================================
+    // Dedicated storage for RelationType::ParentChild. Nodes live in a dense
+    // array indexed by entity slot (getEntityIndex), so parent/child/root
+    // lookups never hash.
+    //
+    // - Roots are kept in an incrementally maintained list (swap-removal).
+    // - Child lists use swap-removal too; sibling order is not preserved.
+    // - Ancestor and subtree queries use pre-order interval numbering:
+    //   A is an ancestor of D  <=>  enter(A) < enter(D) < enter(A) + size(A).
+    //   The numbering is rebuilt lazily after edits. Until then queries fall
+    //   back to walking parents, and the rebuild only happens once the walks
+    //   have cost as much as a rebuild would, so edit-heavy phases (imports)
+    //   never pay O(n) per edit.
+    //
+    // The lazy renumbering is guarded (atomic valid flag, rebuild under a
+    // mutex), so const queries may run from parallel jobs; only one of them
+    // rebuilds, the others wait for it. Edits still need exclusive access.
+
+    class HierarchyIndex {
+    public:
+        // ========================================================================
+        // NODES
+        // ========================================================================
+
+        // Register an entity as a new root
+        void insert(EntityID entity);
+
+        // Unregister an entity. Its children become roots.
+        void erase(EntityID entity);
+
+        bool contains(EntityID entity) const { return find(entity) != nullptr; }
+
+        // Reparent (INVALID_ENTITY makes 'child' a root). Unknown entities are
+        // registered on the fly. The caller is responsible for cycle checks.
+        void setParent(EntityID child, EntityID parent);
+
+        void clear();
+
+        // ========================================================================
+        // QUERIES
+        // ========================================================================
+
+        EntityID getParent(EntityID entity) const {
+            const Node* node = find(entity);
+            return node ? node->parent : INVALID_ENTITY;
+        }
+
+        EntitySpan getChildren(EntityID entity) const {
+            const Node* node = find(entity);
+            if (!node || node->children.empty()) return EntitySpan{};
+            return EntitySpan{ node->children.data(), node->children.size() };
+        }
+
+        size_t getChildCount(EntityID entity) const {
+            const Node* node = find(entity);
+            return node ? node->children.size() : 0;
+        }
+
+        // All registered entities without a parent
+        const std::vector<EntityID>& getRoots() const { return roots_; }
+
+        // True if 'ancestor' is a strict ancestor of 'descendant'
+        bool isAncestorOf(EntityID ancestor, EntityID descendant) const;
+
+        // True if 'entity' is 'root' or one of its descendants
+        bool isInSubtree(EntityID root, EntityID entity) const {
+            return root == entity ? contains(root) : isAncestorOf(root, entity);
+        }
+
+        // 'root' followed by all of its descendants, in pre-order
+        EntitySpan getSubtree(EntityID root) const;
+
+        // Distance from the root of the entity's tree (root = 0)
+        uint32_t getDepth(EntityID entity) const;
+
+        // Bring the interval numbering up to date now (before parallel reads)
+        void prepareQueries() const {
+            if (!orderValid_.load(std::memory_order_acquire)) rebuildOrder();
+        }
+
+        size_t getNodeCount() const { return nodeCount_; }
+        size_t getEdgeCount() const { return edgeCount_; }
+
+    private:
+        static constexpr uint32_t INVALID_SLOT = 0xFFFFFFFF;
+
+        struct Node {
+            EntityID id = INVALID_ENTITY;
+            EntityID parent = INVALID_ENTITY;
+            uint32_t slotInParent = INVALID_SLOT;   // Index in parent's children or in roots_
+            std::vector<EntityID> children;
+        };
+
+        // Interval numbering, parallel to nodes_ (valid while orderValid_)
+        struct Interval {
+            uint32_t enter = 0;
+            uint32_t subtreeSize = 1;
+            uint32_t depth = 0;
+        };
+
+        Node* find(EntityID entity) {
+            uint32_t slot = getEntityIndex(entity);
+            if (entity == INVALID_ENTITY || slot >= nodes_.size()) return nullptr;
+            Node& node = nodes_[slot];
+            return node.id == entity ? &node : nullptr;
+        }
+
+        const Node* find(EntityID entity) const {
+            return const_cast<HierarchyIndex*>(this)->find(entity);
+        }
+
+        Node& nodeOf(EntityID entity) { return nodes_[getEntityIndex(entity)]; }
+
+        void attach(Node& node, EntityID parent);
+        void detach(Node& node);
+        void invalidateOrder() {
+            orderValid_.store(false, std::memory_order_relaxed);
+            walkSteps_.store(0, std::memory_order_relaxed);
+        }
+        void rebuildOrder() const;
+
+        std::vector<Node> nodes_;               // Indexed by entity slot
+        std::vector<EntityID> roots_;
+        size_t nodeCount_ = 0;
+        size_t edgeCount_ = 0;
+
+        // Lazily rebuilt pre-order (written only under orderMutex_)
+        mutable std::vector<EntityID> preorder_;
+        mutable std::vector<Interval> intervals_;   // Indexed by entity slot
+        mutable std::mutex orderMutex_;
+        mutable std::atomic<bool> orderValid_{ false };
+        mutable std::atomic<size_t> walkSteps_{ 0 };
+    };
+
+} // namespace libre
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "HierarchyIndex.h"
+#include <vector>
+#include <iterator>
+
+namespace libre {
+
+    // ============================================================================
+    // HIERARCHY TRAVERSAL - Iterative, allocation-free subtree walks
+    // ============================================================================
+    // Pre-order and post-order iteration over a HierarchyIndex using an
+    // explicit stack, so arbitrarily deep hierarchies (imported CAD
+    // assemblies) never touch the call stack. Children are read through
+    // spans; nothing is copied per node. Keep one HierarchyTraversal around
+    // and its stack is reused by every walk.
+    //
+    // The hierarchy must not be edited while an iteration is in progress.
+    // Collect first if the visitor reparents or destroys (World::destroyEntity
+    // collects a post-order walk, then deletes in that order).
+    //
+    // There is deliberately no parallel subtree visitor: slices of a subtree
+    // do not order parents before children across jobs, so the one consumer
+    // that would want it (world matrix propagation) goes level by level in
+    // TransformSystem instead. Parallelize over getSubtree() spans when order
+    // does not matter.
+    //
+    // Usage:
+    //   HierarchyTraversal walk;
+    //   for (const auto& visit : walk.postOrder(hierarchy, root)) {
+    //       destroy(visit.entity);     // Children before parents
+    //   }
+
+    class HierarchyTraversal {
+    public:
+        struct Visit {
+            EntityID entity = INVALID_ENTITY;
+            uint32_t depth = 0;         // Relative to the traversal root
+        };
+
+        // ========================================================================
+        // ITERATORS
+        // ========================================================================
+
+        // Stack entries: the node and how many of its children were entered
+        struct Frame {
+            EntityID entity;
+            EntitySpan children;
+            uint32_t next;
+        };
+
+        class PreOrderIterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Visit;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Visit*;
+            using reference = const Visit&;
+
+            PreOrderIterator() = default;
+            PreOrderIterator(const HierarchyIndex* index, std::vector<Frame>* stack, EntityID root)
+                : index_(index), stack_(stack) {
+                stack_->clear();
+                if (index_->contains(root)) {
+                    stack_->push_back(Frame{ root, index_->getChildren(root), 0 });
+                    current_ = Visit{ root, 0 };
+                }
+            }
+
+            reference operator*() const { return current_; }
+            pointer operator->() const { return &current_; }
+
+            PreOrderIterator& operator++() {
+                // Descend into the next unvisited child of the deepest frame
+                // that still has one
+                while (!stack_->empty()) {
+                    Frame& top = stack_->back();
+                    if (top.next < top.children.size) {
+                        EntityID child = top.children[top.next++];
+                        stack_->push_back(Frame{ child, index_->getChildren(child), 0 });
+                        current_ = Visit{ child, static_cast<uint32_t>(stack_->size() - 1) };
+                        return *this;
+                    }
+                    stack_->pop_back();
+                }
+                current_ = Visit{};
+                return *this;
+            }
+
+            bool operator==(const PreOrderIterator& other) const { return current_.entity == other.current_.entity; }
+            bool operator!=(const PreOrderIterator& other) const { return !(*this == other); }
+
+        private:
+            const HierarchyIndex* index_ = nullptr;
+            std::vector<Frame>* stack_ = nullptr;
+            Visit current_;
+        };
+
+        class PostOrderIterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Visit;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Visit*;
+            using reference = const Visit&;
+
+            PostOrderIterator() = default;
+            PostOrderIterator(const HierarchyIndex* index, std::vector<Frame>* stack, EntityID root)
+                : index_(index), stack_(stack) {
+                stack_->clear();
+                if (index_->contains(root)) {
+                    descend(root);
+                }
+            }
+
+            reference operator*() const { return current_; }
+            pointer operator->() const { return &current_; }
+
+            PostOrderIterator& operator++() {
+                stack_->pop_back();
+                if (stack_->empty()) {
+                    current_ = Visit{};
+                    return *this;
+                }
+
+                Frame& parent = stack_->back();
+                if (parent.next < parent.children.size) {
+                    descend(parent.children[parent.next++]);
+                }
+                else {
+                    current_ = Visit{ parent.entity, static_cast<uint32_t>(stack_->size() - 1) };
+                }
+                return *this;
+            }
+
+            bool operator==(const PostOrderIterator& other) const { return current_.entity == other.current_.entity; }
+            bool operator!=(const PostOrderIterator& other) const { return !(*this == other); }
+
+        private:
+            // Push 'entity' and follow first children down to a leaf
+            void descend(EntityID entity) {
+                for (;;) {
+                    EntitySpan children = index_->getChildren(entity);
+                    stack_->push_back(Frame{ entity, children, 0 });
+                    if (children.empty()) break;
+                    entity = children[stack_->back().next++];
+                }
+                current_ = Visit{ entity, static_cast<uint32_t>(stack_->size() - 1) };
+            }
+
+            const HierarchyIndex* index_ = nullptr;
+            std::vector<Frame>* stack_ = nullptr;
+            Visit current_;
+        };
+
+        template<typename It>
+        struct Range {
+            It first;
+            It begin() const { return first; }
+            It end() const { return It{}; }
+        };
+
+        // ========================================================================
+        // WALKS
+        // ========================================================================
+
+        // Parents before children. Only one walk per HierarchyTraversal may be
+        // active at a time (they share the stack).
+        Range<PreOrderIterator> preOrder(const HierarchyIndex& index, EntityID root) {
+            return Range<PreOrderIterator>{ PreOrderIterator(&index, &stack_, root) };
+        }
+
+        // Children before parents (delete order)
+        Range<PostOrderIterator> postOrder(const HierarchyIndex& index, EntityID root) {
+            return Range<PostOrderIterator>{ PostOrderIterator(&index, &stack_, root) };
+        }
+
+    private:
+        std::vector<Frame> stack_;
+    };
+
+} // namespace libre
@@ -0,0 +1,202 @@
+#include "LODGenerator.h"
+#include "World.h"
+#include "../mesh/Simplifier.h"
+#include "../mesh/MeshOptimizer.h"
+#include "../mesh/UploadOptimizer.h"
+#include "../core/JobSystem.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <unordered_set>
+
+namespace libre {
+
+    namespace {
+
+        constexpr uint64_t PRIME = 0x9E3779B185EBCA87ULL;
+
+        uint64_t hashRequest(uint64_t hash, const std::vector<float>& ratios) {
+            for (float ratio : ratios) {
+                uint32_t bits;
+                std::memcpy(&bits, &ratio, sizeof(bits));
+                hash = (hash ^ bits) * PRIME;
+            }
+            return hash;
+        }
+
+    } // namespace
+
+    std::shared_ptr<const LODGenerator::Chain> LODGenerator::generate(std::vector<MeshVertex> vertices,
+        std::vector<uint32_t> indices, std::vector<float> ratios, std::atomic<float>* progress) {
+        auto start = std::chrono::steady_clock::now();
+        auto chain = std::make_shared<Chain>();
+
+        // Largest first; a ratio outside (0, 1) asks for nothing
+        size_t triangleCount = indices.size() / 3;
+        std::sort(ratios.begin(), ratios.end(), std::greater<float>());
+        std::vector<size_t> targets;
+        for (float ratio : ratios) {
+            if (ratio > 0.0f && ratio < 1.0f) targets.push_back(std::max<size_t>(1, static_cast<size_t>(triangleCount * ratio)) * 3);
+        }
+
+        std::vector<Simplifier::Level> levels;
+        if (!targets.empty() && !vertices.empty()) {
+            levels = Simplifier::simplify(vertices.data(), vertices.size(), indices.data(), indices.size(), targets, {}, progress);
+        }
+
+        // Simplifier errors are relative to the largest box side
+        glm::vec3 boundsMin(0.0f), boundsMax(0.0f);
+        if (!vertices.empty()) boundsMin = boundsMax = vertices[0].position;
+        for (const MeshVertex& vertex : vertices) {
+            boundsMin = glm::min(boundsMin, vertex.position);
+            boundsMax = glm::max(boundsMax, vertex.position);
+        }
+        glm::vec3 size = boundsMax - boundsMin;
+        float extent = std::max(size.x, std::max(size.y, size.z));
+        float diameter = glm::length(size);
+
+        float screenSize = 1.0f;
+        size_t previous = triangleCount;
+        for (Simplifier::Level& level : levels) {
+            size_t triangles = level.indices.size() / 3;
+            if (triangles == 0 || static_cast<float>(triangles) > (1.0f - MIN_REDUCTION) * previous) continue;
+
+            // Error over the projected diameter reaches TARGET_SCREEN_ERROR here
+            if (level.error > 0.0f && extent > 0.0f) {
+                screenSize = std::min(screenSize, TARGET_SCREEN_ERROR * diameter / (level.error * extent));
+            }
+
+            // Shown no sooner than its predecessor: the predecessor never would be
+            if (!chain->levels.empty() && screenSize >= chain->levels.back().screenSize) {
+                const LODLevel& dropped = chain->levels.back();
+                chain->bytes -= dropped.vertices.size() * sizeof(MeshVertex) + dropped.indices.size() * sizeof(uint32_t);
+                chain->levels.pop_back();
+            }
+
+            std::vector<uint32_t> remap;
+            size_t usedCount = MeshOptimizer::optimizeVertexFetch(level.indices.data(), level.indices.size(), vertices.size(), remap);
+
+            LODLevel out;
+            out.vertices = MeshOptimizer::remapVertices(vertices, remap, usedCount);
+            out.indices = std::move(level.indices);
+            out.screenSize = screenSize;
+            chain->bytes += out.vertices.size() * sizeof(MeshVertex) + out.indices.size() * sizeof(uint32_t);
+            chain->levels.push_back(std::move(out));
+            previous = triangles;
+        }
+
+        if (progress) progress->store(1.0f, std::memory_order_relaxed);
+        chain->generateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return chain;
+    }
+
+    void LODGenerator::update(World& world) {
+        // Finished chains go to the entities waiting on them
+        for (auto it = pending_.begin(); it != pending_.end();) {
+            LODComponent* lod = world.getComponent<LODComponent>(it->first);
+            auto entry = cache_.find(it->second);
+            if (!lod || entry == cache_.end()) {
+                it = pending_.erase(it);
+                continue;
+            }
+            if (entry->second.chain.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++it;
+                continue;
+            }
+
+            const Chain& chain = *entry->second.chain.get();
+            if (!entry->second.counted) {
+                entry->second.counted = true;
+                entry->second.bytes = chain.bytes;
+                cacheBytes_ += chain.bytes;
+                ++stats_.generated;
+                stats_.levels += chain.levels.size();
+                stats_.lastGenerateMs = chain.generateMs;
+                std::cout << "[LODGenerator] " << chain.levels.size() << " levels in "
+                    << chain.generateMs << " ms" << std::endl;
+            }
+            else {
+                ++stats_.cacheHits;
+            }
+
+            if (lod->levels.empty()) {
+                lod->levels = chain.levels;
+                lod->current = 0;
+            }
+            lod->generateRatios.clear();
+            it = pending_.erase(it);
+        }
+
+        // New requests: entities with ratios and no levels yet
+        auto* storage = world.getStorage<LODComponent>();
+        size_t count = storage ? storage->size() : 0;
+        for (size_t i = 0; i < count; ++i) {
+            LODComponent& lod = storage->data()[i];
+            EntityID id = storage->entityData()[i];
+            if (lod.generateRatios.empty() || !lod.levels.empty() || pending_.count(id)) continue;
+
+            const MeshComponent* mesh = world.getComponent<MeshComponent>(id);
+            if (!mesh || mesh->indices.size() < 3) {
+                lod.generateRatios.clear();
+                continue;
+            }
+
+            // Different request under the same hash: step to the next slot
+            UploadOptimizer::Key key = UploadOptimizer::keyGeometry(mesh->vertices, mesh->indices);
+            uint64_t slot = hashRequest(key.hash, lod.generateRatios);
+            auto it = cache_.find(slot);
+            while (it != cache_.end() && !it->second.matches(key, lod.generateRatios)) it = cache_.find(++slot);
+
+            if (it == cache_.end()) {
+                Entry entry;
+                entry.progress = std::make_shared<std::atomic<float>>(0.0f);
+                entry.geometry = key;
+                entry.ratios = lod.generateRatios;
+                entry.chain = JobSystem::instance().submit(
+                    [vertices = mesh->vertices, indices = mesh->indices, ratios = lod.generateRatios, progress = entry.progress]() mutable {
+                        return generate(std::move(vertices), std::move(indices), std::move(ratios), progress.get());
+                    }).share();
+                cache_.emplace(slot, std::move(entry));
+            }
+            pending_[id] = slot;
+        }
+
+        if (cacheBytes_ > MAX_CACHE_BYTES) evict();
+
+        stats_.pending = pending_.size();
+    }
+
+    void LODGenerator::evict() {
+        // Entries an entity still waits on stay, done or not; dropping them
+        // would only make the entity generate its chain again
+        std::unordered_set<uint64_t> waitedOn;
+        for (const auto& [entity, slot] : pending_) waitedOn.insert(slot);
+
+        for (auto e = cache_.begin(); e != cache_.end();) {
+            if (!waitedOn.count(e->first) && e->second.chain.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                cacheBytes_ -= e->second.bytes;
+                e = cache_.erase(e);
+            }
+            else {
+                ++e;
+            }
+        }
+    }
+
+    float LODGenerator::getProgress() const {
+        if (pending_.empty()) return -1.0f;
+
+        std::unordered_set<uint64_t> counted;
+        float total = 0.0f;
+        for (const auto& [entity, slot] : pending_) {
+            auto entry = cache_.find(slot);
+            if (entry == cache_.end() || !counted.insert(slot).second) continue;
+            total += entry->second.progress->load(std::memory_order_relaxed);
+        }
+        return counted.empty() ? 0.0f : total / counted.size();
+    }
+
+} // namespace libre
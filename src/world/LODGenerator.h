@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Types.h"
+#include "../components/CoreComponents.h"
+#include "../mesh/UploadOptimizer.h"
+
+#include <vector>
+#include <memory>
+#include <future>
+#include <atomic>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace libre {
+
+    class World;
+
+    // ============================================================================
+    // LOD GENERATOR - Background LOD chains from the full-detail mesh
+    // ============================================================================
+    // An entity whose LODComponent lists generateRatios (and has no levels
+    // yet) gets its chain built by Simplifier on a JobSystem worker: one
+    // level per ratio of the MeshComponent's triangles. When the job
+    // finishes, update() fills LODComponent::levels and clears the ratios,
+    // so a request is served once.
+    //
+    // Chains are keyed by a hash of the geometry and the ratios: instances
+    // of one mesh share a job and its result. A hit must also match the
+    // geometry's check and counts (UploadOptimizer::Key) and the ratios; a
+    // colliding entry is stepped over. Each level keeps only the
+    // vertices it uses (in first-use order). Its screenSize is where its
+    // error is TARGET_SCREEN_ERROR of the viewport height, so switching
+    // costs about a pixel. A level that saves under MIN_REDUCTION of its
+    // predecessor's triangles is dropped, and one that would switch in no
+    // later than its predecessor replaces it.
+
+    class LODGenerator {
+    public:
+        struct Stats {
+            size_t generated = 0;       // Distinct chains finished
+            size_t cacheHits = 0;       // Entities that reused one
+            size_t pending = 0;         // Entities waiting on a job
+            size_t levels = 0;          // Over the finished chains
+            double lastGenerateMs = 0.0;
+        };
+
+        // Largest error of a level at its screenSize, as a fraction of the viewport height
+        static constexpr float TARGET_SCREEN_ERROR = 1.0f / 1080.0f;
+
+        // A level must drop at least this fraction of the previous level's triangles
+        static constexpr float MIN_REDUCTION = 0.15f;
+
+        // Past this size of finished chains, those no entity waits on are
+        // dropped (all at once; served entities keep their copies)
+        static constexpr size_t MAX_CACHE_BYTES = size_t(256) << 20;
+
+        // Starts jobs for new requests, hands finished chains to their entities
+        void update(World& world);
+
+        // Mean progress of the pending jobs (0..1), or -1 when idle
+        float getProgress() const;
+
+        const Stats& getStats() const { return stats_; }
+
+    private:
+        struct Chain {
+            std::vector<LODLevel> levels;
+            size_t bytes = 0;
+            double generateMs = 0.0;
+        };
+
+        struct Entry {
+            std::shared_future<std::shared_ptr<const Chain>> chain;
+            std::shared_ptr<std::atomic<float>> progress;
+            UploadOptimizer::Key geometry;
+            std::vector<float> ratios;
+            size_t bytes = 0;               // The chain's, once it is done
+            bool counted = false;
+
+            bool matches(const UploadOptimizer::Key& key, const std::vector<float>& other) const {
+                return geometry.hash == key.hash && geometry.sameGeometry(key) && ratios == other;
+            }
+        };
+
+        void evict();
+
+        static std::shared_ptr<const Chain> generate(std::vector<MeshVertex> vertices, std::vector<uint32_t> indices,
+            std::vector<float> ratios, std::atomic<float>* progress);
+
+        std::unordered_map<uint64_t, Entry> cache_;
+        std::unordered_map<EntityID, uint64_t> pending_;   // Cache slot per waiting entity
+        size_t cacheBytes_ = 0;
+        Stats stats_;
+    };
+
+} // namespace libre
@@ -0,0 +1,100 @@
+#include "LODSystem.h"
+#include "World.h"
+#include "../spatial/Frustum.h"
+#include "../core/JobSystem.h"
+
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <limits>
+
+namespace libre {
+
+    float LODSystem::projectedSize(const BoundsComponent& bounds, const CameraData& camera) {
+        float distance = glm::length(bounds.worldCenter - camera.position);
+        if (distance <= bounds.worldRadius) return std::numeric_limits<float>::max();
+
+        // projection[1][1] = 1 / tan(fov / 2): half the viewport height at unit depth
+        return bounds.worldRadius * camera.projectionMatrix[1][1] / distance;
+    }
+
+    uint32_t LODSystem::chooseLevel(const LODComponent& lod, float size) {
+        uint32_t levelCount = std::min(lod.getLevelCount(), MAX_LEVELS);
+        uint32_t level = std::min(lod.current, levelCount - 1);
+
+        // levels[i] holds the threshold into level i + 1
+        while (level + 1 < levelCount && size < lod.levels[level].screenSize * (1.0f - lod.hysteresis)) ++level;
+        while (level > 0 && size > lod.levels[level - 1].screenSize * (1.0f + lod.hysteresis)) --level;
+        return level;
+    }
+
+    void LODSystem::select(World& world, const CameraData& camera, const FrustumCuller* culler) {
+        auto start = std::chrono::steady_clock::now();
+
+        auto* storage = world.getStorage<LODComponent>();
+        size_t count = storage ? storage->size() : 0;
+        LODComponent* lods = storage ? storage->data() : nullptr;
+        const EntityID* entities = storage ? storage->entityData() : nullptr;
+
+        // Storages are looked up once; per entity only the id maps are
+        const auto* boundsStorage = world.getStorage<BoundsComponent>();
+        const auto* meshStorage = world.getStorage<MeshComponent>();
+        const BoundsComponent* boundsData = boundsStorage ? boundsStorage->data() : nullptr;
+        const uint8_t* visible = culler ? culler->getResults(world) : nullptr;
+        if (!boundsStorage) count = 0;
+
+        struct Totals {
+            size_t entities = 0, selected = 0, switches = 0, fullTriangles = 0, drawnTriangles = 0;
+        };
+
+        auto selectRange = [&](size_t begin, size_t end, Totals& totals) {
+            for (size_t i = begin; i < end; ++i) {
+                const BoundsComponent* bounds = boundsStorage->get(entities[i]);
+                if (!bounds) continue;
+                ++totals.entities;
+                if (visible && !visible[bounds - boundsData]) continue;
+
+                LODComponent& lod = lods[i];
+                uint32_t level = chooseLevel(lod, projectedSize(*bounds, camera));
+                totals.switches += level != lod.current;
+                lod.current = level;
+
+                const MeshComponent* mesh = meshStorage ? meshStorage->get(entities[i]) : nullptr;
+                size_t full = mesh ? mesh->getTriangleCount() : 0;
+                ++totals.selected;
+                totals.fullTriangles += full;
+                totals.drawnTriangles += level > 0 ? lod.levels[level - 1].getTriangleCount() : full;
+            }
+        };
+
+        Totals totals;
+        if (count < PARALLEL_THRESHOLD) {
+            selectRange(0, count, totals);
+        }
+        else {
+            std::atomic<size_t> entityTotal{ 0 }, selectedTotal{ 0 }, switchTotal{ 0 }, fullTotal{ 0 }, drawnTotal{ 0 };
+            JobSystem::instance().parallelFor(count, 1024, [&](size_t begin, size_t end) {
+                Totals chunk;
+                selectRange(begin, end, chunk);
+                entityTotal.fetch_add(chunk.entities, std::memory_order_relaxed);
+                selectedTotal.fetch_add(chunk.selected, std::memory_order_relaxed);
+                switchTotal.fetch_add(chunk.switches, std::memory_order_relaxed);
+                fullTotal.fetch_add(chunk.fullTriangles, std::memory_order_relaxed);
+                drawnTotal.fetch_add(chunk.drawnTriangles, std::memory_order_relaxed);
+                });
+            totals.entities = entityTotal.load();
+            totals.selected = selectedTotal.load();
+            totals.switches = switchTotal.load();
+            totals.fullTriangles = fullTotal.load();
+            totals.drawnTriangles = drawnTotal.load();
+        }
+
+        stats_.entities = totals.entities;
+        stats_.selected = totals.selected;
+        stats_.switches = totals.switches;
+        stats_.fullTriangles = totals.fullTriangles;
+        stats_.drawnTriangles = totals.drawnTriangles;
+        stats_.lastSelectMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+} // namespace libre
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Types.h"
+#include "../components/CoreComponents.h"
+#include "../core/FrameData.h"
+
+#include <cstddef>
+
+namespace libre {
+
+    class World;
+    class FrustumCuller;
+
+    // ============================================================================
+    // LOD SYSTEM - Per-frame level selection by projected screen size
+    // ============================================================================
+    // For every entity with a LODComponent and a BoundsComponent, the world
+    // bounding sphere is projected with the frame's camera: its diameter over
+    // the viewport height, from the camera distance (so turning the camera
+    // never switches levels). LODComponent::current then moves one threshold
+    // at a time, and only once the size is 'hysteresis' past the threshold,
+    // so an object resting near a boundary does not flicker between levels.
+    //
+    // With a FrustumCuller, only entities that survived it are selected (and
+    // counted); the others keep their level until they come back into view.
+    //
+    // Each level > 0 is its own GPU mesh: getMeshHandle() packs the level
+    // into the top four bits of the entity id (generations stay far below
+    // 2^28), and the render thread looks meshes up by that handle.
+
+    class LODSystem {
+    public:
+        struct Stats {
+            size_t entities = 0;        // With LODComponent and bounds
+            size_t selected = 0;        // In view this frame
+            size_t switches = 0;        // Level changes this frame
+            size_t fullTriangles = 0;   // Selected entities at level 0
+            size_t drawnTriangles = 0;  // Selected entities at their level
+            double lastSelectMs = 0.0;
+
+            size_t trianglesSaved() const { return fullTriangles - drawnTriangles; }
+        };
+
+        static constexpr uint32_t MAX_LEVELS = 16;
+
+        // Below this many LOD entities the pass runs on the calling thread
+        static constexpr size_t PARALLEL_THRESHOLD = 8192;
+
+        void select(World& world, const CameraData& camera, const FrustumCuller* culler = nullptr);
+
+        // Bounding sphere diameter over viewport height (>= 1 around the camera)
+        static float projectedSize(const BoundsComponent& bounds, const CameraData& camera);
+
+        // Level for 'size', starting from lod.current (applies hysteresis)
+        static uint32_t chooseLevel(const LODComponent& lod, float size);
+
+        static MeshHandle getMeshHandle(EntityID entity, uint32_t level) {
+            return static_cast<MeshHandle>(entity) | (static_cast<uint64_t>(level) << LEVEL_SHIFT);
+        }
+        static EntityID getHandleEntity(MeshHandle handle) {
+            return static_cast<EntityID>(handle & ~(uint64_t(MAX_LEVELS - 1) << LEVEL_SHIFT));
+        }
+        static uint32_t getHandleLevel(MeshHandle handle) {
+            return static_cast<uint32_t>(handle >> LEVEL_SHIFT);
+        }
+
+        const Stats& getStats() const { return stats_; }
+
+    private:
+        static constexpr uint32_t LEVEL_SHIFT = 60;
+
+        Stats stats_;
+    };
+
+} // namespace libre
@@ -0,0 +1,397 @@
+#include "LayerCompositor.h"
+#include "World.h"
+#include "../core/JobSystem.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace libre {
+
+    static constexpr uint32_t TS = TiledImage::TILE_SIZE;
+
+    // ========================================================================
+    // TILED IMAGE
+    // ========================================================================
+
+    void TiledImage::resize(uint32_t width, uint32_t height) {
+        uint32_t tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+        uint32_t tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+        // The grid starts at the origin either way: kept tiles move over whole
+        std::vector<std::unique_ptr<uint32_t[]>> tiles(static_cast<size_t>(tilesX) * tilesY);
+        for (uint32_t ty = 0; ty < std::min(tilesY, tilesY_); ++ty) {
+            for (uint32_t tx = 0; tx < std::min(tilesX, tilesX_); ++tx) {
+                tiles[ty * tilesX + tx] = std::move(tiles_[ty * tilesX_ + tx]);
+            }
+        }
+
+        // Pixels cropped off inside the new edge tiles must not come back
+        // if the image grows again
+        uint32_t edgeX = width - (tilesX ? tilesX - 1 : 0) * TILE_SIZE;
+        uint32_t edgeY = height - (tilesY ? tilesY - 1 : 0) * TILE_SIZE;
+        for (uint32_t ty = 0; ty < tilesY; ++ty) {
+            for (uint32_t tx = 0; tx < tilesX; ++tx) {
+                uint32_t* pixels = tiles[ty * tilesX + tx].get();
+                if (!pixels) continue;
+                uint32_t columns = tx == tilesX - 1 ? edgeX : TILE_SIZE;
+                uint32_t rows = ty == tilesY - 1 ? edgeY : TILE_SIZE;
+                if (columns < TILE_SIZE) {
+                    for (uint32_t y = 0; y < rows; ++y) {
+                        std::memset(pixels + y * TILE_SIZE + columns, 0, sizeof(uint32_t) * (TILE_SIZE - columns));
+                    }
+                }
+                if (rows < TILE_SIZE) {
+                    std::memset(pixels + rows * TILE_SIZE, 0, sizeof(uint32_t) * (TILE_SIZE - rows) * TILE_SIZE);
+                }
+            }
+        }
+
+        width_ = width;
+        height_ = height;
+        tilesX_ = tilesX;
+        tilesY_ = tilesY;
+        tiles_ = std::move(tiles);
+    }
+
+    void TiledImage::clear() {
+        for (auto& tile : tiles_) tile.reset();
+    }
+
+    size_t TiledImage::getAllocatedTileCount() const {
+        return std::count_if(tiles_.begin(), tiles_.end(), [](const auto& tile) { return tile != nullptr; });
+    }
+
+    uint32_t* TiledImage::ensureTile(uint32_t tile) {
+        auto& pixels = tiles_[tile];
+        if (!pixels) {
+            pixels.reset(new uint32_t[TILE_PIXELS]());
+        }
+        return pixels.get();
+    }
+
+    void TiledImage::releaseTile(uint32_t tile) {
+        tiles_[tile].reset();
+    }
+
+    uint32_t TiledImage::getPixel(uint32_t x, uint32_t y) const {
+        if (x >= width_ || y >= height_) return 0;
+        const uint32_t* pixels = tiles_[(y / TILE_SIZE) * tilesX_ + x / TILE_SIZE].get();
+        return pixels ? pixels[(y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE] : 0;
+    }
+
+    // ========================================================================
+    // DOCUMENTS AND LAYERS
+    // ========================================================================
+
+    LayerCompositor::Document* LayerCompositor::findDocument(World& world, EntityID document) {
+        const CanvasComponent* canvas = world.getComponent<CanvasComponent>(document);
+        if (!canvas) return nullptr;
+
+        Document& doc = documents_[document];
+        if (doc.composite.getWidth() != canvas->width || doc.composite.getHeight() != canvas->height) {
+            doc.composite.resize(canvas->width, canvas->height);
+            doc.dirty.assign(doc.composite.getTileCount(), TileRect{});
+            doc.dirtyTiles.clear();
+            markDirty(doc, 0, 0, static_cast<int>(canvas->width), static_cast<int>(canvas->height));
+        }
+        return &doc;
+    }
+
+    LayerCompositor::LayerState* LayerCompositor::findLayer(World& world, EntityID layer) {
+        EntityID document = INVALID_ENTITY;
+        const EdgeStore& edges = world.getRelationships().getEdges();
+        edges.forEachIncoming(layer, RelationType::LayerStack, [&](uint32_t, const EdgeStore::Edge& edge) {
+            if (document == INVALID_ENTITY) document = edges.getFrom(edge);
+            });
+
+        Document* doc = findDocument(world, document);
+        if (!doc) return nullptr;
+
+        LayerState& state = layers_[layer];
+        state.document = document;
+        fitLayer(state, doc->composite);
+        return &state;
+    }
+
+    void LayerCompositor::fitLayer(LayerState& state, const TiledImage& composite) {
+        if (state.image.getWidth() != composite.getWidth() || state.image.getHeight() != composite.getHeight()) {
+            state.image.resize(composite.getWidth(), composite.getHeight());
+        }
+    }
+
+    void LayerCompositor::rebuildStacks(World& world) {
+        // Forget deleted documents and layers
+        for (auto it = documents_.begin(); it != documents_.end(); ) {
+            it = world.entityExists(it->first) ? std::next(it) : documents_.erase(it);
+        }
+        for (auto it = layers_.begin(); it != layers_.end(); ) {
+            it = world.entityExists(it->first) ? std::next(it) : layers_.erase(it);
+        }
+
+        auto* canvases = world.getStorage<CanvasComponent>();
+        if (!canvases) return;
+
+        const EdgeStore& edges = world.getRelationships().getEdges();
+        std::vector<std::pair<int32_t, EntityID>> ordered;
+        std::vector<EntityID> layers;
+
+        for (size_t i = 0; i < canvases->size(); ++i) {
+            EntityID document = canvases->entityData()[i];
+            Document* doc = findDocument(world, document);
+
+            ordered.clear();
+            edges.forEachOutgoing(document, RelationType::LayerStack, [&](uint32_t, const EdgeStore::Edge& edge) {
+                ordered.emplace_back(edge.order, edges.getTo(edge));
+                });
+            std::sort(ordered.begin(), ordered.end());
+
+            layers.clear();
+            for (const auto& entry : ordered) layers.push_back(entry.second);
+
+            // Any change in stacking can change every pixel
+            if (layers != doc->layers) {
+                doc->layers = layers;
+                markDirty(*doc, 0, 0, static_cast<int>(doc->composite.getWidth()), static_cast<int>(doc->composite.getHeight()));
+            }
+        }
+
+        // Layers that moved to another document are cropped or padded to
+        // its size (a layer in no stack keeps its image as it was)
+        for (auto& [layer, state] : layers_) {
+            EntityID document = INVALID_ENTITY;
+            edges.forEachIncoming(layer, RelationType::LayerStack, [&](uint32_t, const EdgeStore::Edge& edge) {
+                if (document == INVALID_ENTITY) document = edges.getFrom(edge);
+                });
+            if (document != state.document) {
+                state.document = document;
+                auto doc = documents_.find(document);
+                if (doc != documents_.end()) fitLayer(state, doc->second.composite);
+            }
+        }
+
+        cachedEdgeVersion_ = edges.getVersion(RelationType::LayerStack);
+        cachedWorldVersion_ = world.getHierarchyVersion();
+    }
+
+    // ========================================================================
+    // DIRTY TRACKING
+    // ========================================================================
+
+    void LayerCompositor::markDirty(Document& doc, int x, int y, int width, int height) {
+        int x0 = std::max(x, 0), y0 = std::max(y, 0);
+        int x1 = std::min(x + width, static_cast<int>(doc.composite.getWidth()));
+        int y1 = std::min(y + height, static_cast<int>(doc.composite.getHeight()));
+        if (x0 >= x1 || y0 >= y1) return;
+
+        for (int ty = y0 / static_cast<int>(TS); ty <= (y1 - 1) / static_cast<int>(TS); ++ty) {
+            for (int tx = x0 / static_cast<int>(TS); tx <= (x1 - 1) / static_cast<int>(TS); ++tx) {
+                uint32_t tile = ty * doc.composite.getTilesX() + tx;
+                int ox = tx * TS, oy = ty * TS;
+
+                TileRect r;
+                r.x0 = static_cast<uint16_t>(std::max(x0 - ox, 0));
+                r.y0 = static_cast<uint16_t>(std::max(y0 - oy, 0));
+                r.x1 = static_cast<uint16_t>(std::min(x1 - ox, static_cast<int>(TS)));
+                r.y1 = static_cast<uint16_t>(std::min(y1 - oy, static_cast<int>(TS)));
+
+                TileRect& d = doc.dirty[tile];
+                if (d.empty()) {
+                    d = r;
+                    doc.dirtyTiles.push_back(tile);
+                }
+                else {
+                    d.x0 = std::min(d.x0, r.x0); d.y0 = std::min(d.y0, r.y0);
+                    d.x1 = std::max(d.x1, r.x1); d.y1 = std::max(d.y1, r.y1);
+                }
+            }
+        }
+    }
+
+    void LayerCompositor::markLayerTiles(Document& doc, const TiledImage& image) {
+        for (uint32_t tile = 0; tile < image.getTileCount(); ++tile) {
+            if (!image.getTile(tile)) continue;
+            int tx = static_cast<int>(tile % image.getTilesX()) * TS;
+            int ty = static_cast<int>(tile / image.getTilesX()) * TS;
+            markDirty(doc, tx, ty, TS, TS);
+        }
+    }
+
+    // ========================================================================
+    // PAINTING
+    // ========================================================================
+
+    void LayerCompositor::fillRect(World& world, EntityID layer, int x, int y, int width, int height, uint32_t color) {
+        LayerState* state = findLayer(world, layer);
+        if (!state) return;
+        TiledImage& image = state->image;
+
+        int x0 = std::max(x, 0), y0 = std::max(y, 0);
+        int x1 = std::min(x + width, static_cast<int>(image.getWidth()));
+        int y1 = std::min(y + height, static_cast<int>(image.getHeight()));
+        if (x0 >= x1 || y0 >= y1 || (color >> 24) == 0) return;
+
+        for (int py = y0; py < y1; ++py) {
+            for (int px = x0; px < x1; ) {
+                // Run of pixels inside one tile
+                int tileEnd = std::min(x1, (px / static_cast<int>(TS) + 1) * static_cast<int>(TS));
+                uint32_t tile = (py / TS) * image.getTilesX() + px / TS;
+                uint32_t* row = image.ensureTile(tile) + (py % TS) * TS + px % TS;
+                BlendKernels::fillRow(row, color, tileEnd - px);
+                px = tileEnd;
+            }
+        }
+
+        markDirty(documents_[state->document], x0, y0, x1 - x0, y1 - y0);
+    }
+
+    void LayerCompositor::writePixels(World& world, EntityID layer, int x, int y, int width, int height,
+        const uint32_t* pixels, size_t stride) {
+        LayerState* state = findLayer(world, layer);
+        if (!state) return;
+        TiledImage& image = state->image;
+
+        int x0 = std::max(x, 0), y0 = std::max(y, 0);
+        int x1 = std::min(x + width, static_cast<int>(image.getWidth()));
+        int y1 = std::min(y + height, static_cast<int>(image.getHeight()));
+        if (x0 >= x1 || y0 >= y1) return;
+
+        for (int py = y0; py < y1; ++py) {
+            const uint32_t* srcRow = pixels + static_cast<size_t>(py - y) * stride + (x0 - x);
+            for (int px = x0; px < x1; ) {
+                int tileEnd = std::min(x1, (px / static_cast<int>(TS) + 1) * static_cast<int>(TS));
+                uint32_t tile = (py / TS) * image.getTilesX() + px / TS;
+                uint32_t* row = image.ensureTile(tile) + (py % TS) * TS + px % TS;
+                std::memcpy(row, srcRow + (px - x0), sizeof(uint32_t) * (tileEnd - px));
+                px = tileEnd;
+            }
+        }
+
+        markDirty(documents_[state->document], x0, y0, x1 - x0, y1 - y0);
+    }
+
+    void LayerCompositor::clearLayer(World& world, EntityID layer) {
+        LayerState* state = findLayer(world, layer);
+        if (!state) return;
+
+        markLayerTiles(documents_[state->document], state->image);
+        state->image.clear();
+    }
+
+    // ========================================================================
+    // COMPOSITING
+    // ========================================================================
+
+    void LayerCompositor::compositeTile(Document& doc, uint32_t tile) {
+        const TileRect& r = doc.dirty[tile];
+
+        bool anyLayer = false;
+        for (const StackEntry& entry : doc.stack) {
+            if (entry.image->getTile(tile)) {
+                anyLayer = true;
+                break;
+            }
+        }
+
+        bool wholeTile = r.x0 == 0 && r.y0 == 0 && r.x1 == TS && r.y1 == TS;
+        if (!anyLayer && (wholeTile || !doc.composite.getTile(tile))) {
+            doc.composite.releaseTile(tile);
+            return;
+        }
+
+        uint32_t* out = doc.composite.ensureTile(tile);
+        size_t span = r.x1 - r.x0;
+
+        for (uint32_t y = r.y0; y < r.y1; ++y) {
+            std::memset(out + y * TS + r.x0, 0, span * sizeof(uint32_t));
+        }
+
+        // Bottom to top, only inside the dirty rect
+        for (const StackEntry& entry : doc.stack) {
+            const uint32_t* src = entry.image->getTile(tile);
+            if (!src) continue;
+            for (uint32_t y = r.y0; y < r.y1; ++y) {
+                size_t offset = y * TS + r.x0;
+                BlendKernels::blendRow(entry.blendMode, out + offset, src + offset, span, entry.opacity);
+            }
+        }
+    }
+
+    void LayerCompositor::update(World& world) {
+        stats_.tilesComposited = 0;
+        stats_.pixelsComposited = 0;
+
+        const EdgeStore& edges = world.getRelationships().getEdges();
+        if (cachedEdgeVersion_ != edges.getVersion(RelationType::LayerStack) ||
+            cachedWorldVersion_ != world.getHierarchyVersion()) {
+            rebuildStacks(world);
+        }
+
+        auto& jobs = JobSystem::instance();
+
+        for (auto& [document, doc] : documents_) {
+            findDocument(world, document);     // Picks up canvas resizes
+
+            // Resolve the stack; settings changes dirty that layer's tiles
+            doc.stack.clear();
+            for (EntityID layer : doc.layers) {
+                auto it = layers_.find(layer);
+                if (it == layers_.end()) continue;
+                LayerState& state = it->second;
+                fitLayer(state, doc.composite);     // Canvas resized since the layer was painted
+
+                LayerComponent settings;
+                if (const LayerComponent* component = world.getComponent<LayerComponent>(layer)) {
+                    settings = *component;
+                }
+                uint8_t opacity = settings.visible
+                    ? static_cast<uint8_t>(std::clamp(settings.opacity, 0.0f, 1.0f) * 255.0f + 0.5f) : 0;
+
+                if (opacity != state.opacity || settings.blendMode != state.blendMode || settings.visible != state.visible) {
+                    markLayerTiles(doc, state.image);
+                    state.opacity = opacity;
+                    state.blendMode = settings.blendMode;
+                    state.visible = settings.visible;
+                }
+
+                if (opacity > 0) {
+                    doc.stack.push_back(StackEntry{ &state.image, settings.blendMode, opacity });
+                }
+            }
+
+            if (doc.dirtyTiles.empty()) continue;
+
+            for (uint32_t tile : doc.dirtyTiles) {
+                const TileRect& r = doc.dirty[tile];
+                stats_.pixelsComposited += static_cast<size_t>(r.x1 - r.x0) * (r.y1 - r.y0);
+            }
+            stats_.tilesComposited += doc.dirtyTiles.size();
+
+            // Tiles never share pixels
+            Document* docPtr = &doc;
+            jobs.parallelFor(doc.dirtyTiles.size(), 4, [this, docPtr](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    compositeTile(*docPtr, docPtr->dirtyTiles[i]);
+                }
+                });
+
+            for (uint32_t tile : doc.dirtyTiles) {
+                doc.dirty[tile] = TileRect{};
+            }
+            doc.dirtyTiles.clear();
+        }
+
+        stats_.documentCount = documents_.size();
+        stats_.layerCount = layers_.size();
+    }
+
+    const TiledImage* LayerCompositor::getComposite(EntityID document) const {
+        auto it = documents_.find(document);
+        return it != documents_.end() ? &it->second.composite : nullptr;
+    }
+
+    const TiledImage* LayerCompositor::getLayerImage(EntityID layer) const {
+        auto it = layers_.find(layer);
+        return it != layers_.end() ? &it->second.image : nullptr;
+    }
+
+} // namespace libre
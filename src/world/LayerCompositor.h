@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Types.h"
+#include "BlendKernels.h"
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+namespace libre {
+
+    class World;
+
+    // ============================================================================
+    // TILED IMAGE - Sparse premultiplied RGBA8 image in fixed-size tiles
+    // ============================================================================
+    // Unallocated tiles are fully transparent, so a 16k x 16k layer with a
+    // few strokes costs a few tiles, not a gigabyte.
+
+    class TiledImage {
+    public:
+        static constexpr uint32_t TILE_SIZE = 256;
+        static constexpr uint32_t TILE_PIXELS = TILE_SIZE * TILE_SIZE;
+
+        // Re-tiles to the new size: pixels that still fit keep their place
+        // (anchored at the top-left corner), cropped ones are gone and new
+        // area is transparent
+        void resize(uint32_t width, uint32_t height);
+
+        // Frees every tile; all pixels become transparent
+        void clear();
+
+        uint32_t getWidth() const { return width_; }
+        uint32_t getHeight() const { return height_; }
+        uint32_t getTilesX() const { return tilesX_; }
+        uint32_t getTilesY() const { return tilesY_; }
+        size_t getTileCount() const { return tiles_.size(); }
+        size_t getAllocatedTileCount() const;
+
+        // nullptr = transparent tile (or outside the image's tile grid)
+        const uint32_t* getTile(uint32_t tile) const { return tile < tiles_.size() ? tiles_[tile].get() : nullptr; }
+        uint32_t* getTile(uint32_t tile) { return tile < tiles_.size() ? tiles_[tile].get() : nullptr; }
+
+        // Allocates a cleared tile on first use. Distinct tiles may be
+        // ensured from different threads.
+        uint32_t* ensureTile(uint32_t tile);
+        void releaseTile(uint32_t tile);
+
+        // Pixel in the full image (0 outside or in a transparent tile)
+        uint32_t getPixel(uint32_t x, uint32_t y) const;
+
+    private:
+        uint32_t width_ = 0;
+        uint32_t height_ = 0;
+        uint32_t tilesX_ = 0;
+        uint32_t tilesY_ = 0;
+        std::vector<std::unique_ptr<uint32_t[]>> tiles_;
+    };
+
+    // ============================================================================
+    // LAYER COMPOSITOR - Incremental tiled compositing of LayerStack canvases
+    // ============================================================================
+    // Every entity with a CanvasComponent is a document; its layers are its
+    // outgoing LayerStack relationships (bottom to top by order), each with
+    // a LayerComponent for blend mode, opacity and visibility.
+    //
+    // - Painting goes through the compositor, which records a dirty rect per
+    //   tile of the document.
+    // - update() recomposites only the dirty rect of each dirty tile, bottom
+    //   to top, with the SIMD blend kernels. Tiles are independent, so they
+    //   are spread over the JobSystem.
+    // - Changing a layer's settings dirties just the tiles that layer has
+    //   pixels in; reordering layers dirties the whole document.
+    // - Layer images always have their document's size and tile grid.
+    //   Resizing a canvas, or moving a layer to another document, crops or
+    //   pads the layer to the new size (anchored at the top-left corner). A
+    //   layer taken out of every stack keeps its pixels.
+
+    class LayerCompositor {
+    public:
+        struct Stats {
+            size_t documentCount = 0;
+            size_t layerCount = 0;
+            size_t tilesComposited = 0;     // Last update
+            size_t pixelsComposited = 0;    // Last update (dirty-rect area)
+        };
+
+        // ========================================================================
+        // PAINTING (premultiplied 0xAABBGGRR)
+        // ========================================================================
+
+        // Composite a solid color over a rectangle of a layer
+        void fillRect(World& world, EntityID layer, int x, int y, int width, int height, uint32_t color);
+
+        // Replace a rectangle of a layer with 'pixels' (row stride in pixels)
+        void writePixels(World& world, EntityID layer, int x, int y, int width, int height,
+            const uint32_t* pixels, size_t stride);
+
+        // Clear a whole layer (frees its tiles)
+        void clearLayer(World& world, EntityID layer);
+
+        // ========================================================================
+        // COMPOSITING
+        // ========================================================================
+
+        // Recomposite the dirty parts of every document
+        void update(World& world);
+
+        // Composited result (nullptr if the document was never updated)
+        const TiledImage* getComposite(EntityID document) const;
+        const TiledImage* getLayerImage(EntityID layer) const;
+
+        const Stats& getStats() const { return stats_; }
+
+    private:
+        static constexpr uint64_t INVALID_VERSION = ~0ull;
+
+        // Dirty region of one tile, tile-local pixels [x0, x1) x [y0, y1)
+        struct TileRect {
+            uint16_t x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+            bool empty() const { return x0 >= x1 || y0 >= y1; }
+        };
+
+        struct LayerState {
+            EntityID document = INVALID_ENTITY;
+            TiledImage image;
+
+            // Settings at the last composite (changes dirty the layer's tiles)
+            BlendMode blendMode = BlendMode::Normal;
+            uint8_t opacity = 255;
+            bool visible = true;
+        };
+
+        // Resolved per update: layer image and effective settings, bottom to top
+        struct StackEntry {
+            const TiledImage* image;
+            BlendMode blendMode;
+            uint8_t opacity;
+        };
+
+        struct Document {
+            TiledImage composite;
+            std::vector<EntityID> layers;           // Bottom to top
+            std::vector<TileRect> dirty;            // Per tile
+            std::vector<uint32_t> dirtyTiles;       // Tiles with a non-empty rect
+            std::vector<StackEntry> stack;
+        };
+
+        Document* findDocument(World& world, EntityID document);
+        LayerState* findLayer(World& world, EntityID layer);
+        void rebuildStacks(World& world);
+        void markDirty(Document& doc, int x, int y, int width, int height);
+        void markLayerTiles(Document& doc, const TiledImage& image);
+        static void fitLayer(LayerState& state, const TiledImage& composite);
+        void compositeTile(Document& doc, uint32_t tile);
+
+        std::unordered_map<EntityID, Document> documents_;
+        std::unordered_map<EntityID, LayerState> layers_;
+
+        uint64_t cachedEdgeVersion_ = INVALID_VERSION;
+        uint64_t cachedWorldVersion_ = INVALID_VERSION;
+
+        Stats stats_;
+    };
+
+} // namespace libre
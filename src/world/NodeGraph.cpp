@@ -0,0 +1,339 @@
+#include "NodeGraph.h"
+#include "World.h"
+#include "../core/JobSystem.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace libre {
+
+    // Node evaluations per job chunk (ops are usually heavier than a transform)
+    static constexpr size_t NODE_GRAIN = 16;
+
+    static uint64_t mixKey(uint64_t h, uint64_t v) {
+        h ^= v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        return h ^ (h >> 31);
+    }
+
+    // ========================================================================
+    // OPS
+    // ========================================================================
+
+    NodeGraphSystem::NodeGraphSystem() {
+        registerOp("Constant", [](const NodeContext& ctx, NodeValue& out) {
+            out = ctx.params;
+            });
+
+        registerOp("Add", [](const NodeContext& ctx, NodeValue& out) {
+            out.clear();
+            for (size_t i = 0; i < ctx.inputCount; ++i) {
+                const NodeValue& in = *ctx.inputs[i];
+                if (out.size() < in.size()) out.resize(in.size(), 0.0f);
+                for (size_t c = 0; c < in.size(); ++c) out[c] += in[c];
+            }
+            });
+
+        registerOp("Multiply", [](const NodeContext& ctx, NodeValue& out) {
+            out.clear();
+            for (size_t i = 0; i < ctx.inputCount; ++i) {
+                const NodeValue& in = *ctx.inputs[i];
+                if (out.size() < in.size()) out.resize(in.size(), 1.0f);
+                for (size_t c = 0; c < in.size(); ++c) out[c] *= in[c];
+            }
+            });
+
+        registerOp("Scale", [](const NodeContext& ctx, NodeValue& out) {
+            float factor = ctx.params.empty() ? 1.0f : ctx.params[0];
+            out = ctx.inputCount > 0 ? *ctx.inputs[0] : NodeValue{};
+            for (float& v : out) v *= factor;
+            });
+    }
+
+    uint32_t NodeGraphSystem::registerOp(const std::string& name, NodeOp op) {
+        opNames_.push_back(name);
+        ops_.push_back(std::move(op));
+        invalidate();
+        return static_cast<uint32_t>(ops_.size() - 1);
+    }
+
+    uint32_t NodeGraphSystem::findOp(const std::string& name) const {
+        auto it = std::find(opNames_.begin(), opNames_.end(), name);
+        return it != opNames_.end() ? static_cast<uint32_t>(it - opNames_.begin()) : 0xFFFFFFFF;
+    }
+
+    // ========================================================================
+    // TOPOLOGY
+    // ========================================================================
+
+    void NodeGraphSystem::rebuild(World& world, ComponentStorage<GraphNodeComponent>& storage) {
+        // Keep cached outputs of surviving nodes, so a re-sort after an edit
+        // only re-cooks what the edit actually affects
+        std::unordered_map<EntityID, Cache> previous;
+        previous.reserve(nodes_.size());
+        for (uint32_t i = 0; i < nodes_.size(); ++i) {
+            if (cache_[i].valid) {
+                previous.emplace(nodes_[i].entity, std::move(cache_[i]));
+            }
+        }
+
+        const EntityID* entities = storage.entityData();
+        size_t count = storage.size();
+
+        nodes_.assign(count, Node{});
+        cache_.assign(count, Cache{});
+        nodeIndex_.clear();
+        nodeIndex_.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            nodes_[i].entity = entities[i];
+            nodeIndex_[entities[i]] = i;
+
+            auto it = previous.find(entities[i]);
+            if (it != previous.end()) {
+                cache_[i] = std::move(it->second);
+            }
+        }
+
+        // Inputs in socket order; edges from entities that aren't nodes are ignored
+        const EdgeStore& edges = world.getRelationships().getEdges();
+        std::vector<std::pair<int32_t, uint32_t>> sockets;
+        std::vector<uint32_t> outputCounts(count, 0);
+
+        inputs_.clear();
+        for (uint32_t i = 0; i < count; ++i) {
+            sockets.clear();
+            edges.forEachIncoming(nodes_[i].entity, RelationType::NodeConnection,
+                [&](uint32_t, const EdgeStore::Edge& edge) {
+                    auto it = nodeIndex_.find(edges.getFrom(edge));
+                    if (it != nodeIndex_.end()) {
+                        sockets.emplace_back(edge.order, it->second);
+                    }
+                });
+            std::sort(sockets.begin(), sockets.end());
+
+            nodes_[i].inputBegin = static_cast<uint32_t>(inputs_.size());
+            nodes_[i].inputCount = static_cast<uint32_t>(sockets.size());
+            for (const auto& socket : sockets) {
+                inputs_.push_back(socket.second);
+                ++outputCounts[socket.second];
+            }
+        }
+
+        // Downstream lists (CSR by upstream node)
+        uint32_t offset = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            nodes_[i].outputBegin = offset;
+            offset += outputCounts[i];
+        }
+        outputs_.assign(offset, 0);
+        std::fill(outputCounts.begin(), outputCounts.end(), 0);
+        for (uint32_t i = 0; i < count; ++i) {
+            const Node& node = nodes_[i];
+            for (uint32_t k = 0; k < node.inputCount; ++k) {
+                uint32_t up = inputs_[node.inputBegin + k];
+                outputs_[nodes_[up].outputBegin + outputCounts[up]++] = i;
+            }
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            nodes_[i].outputCount = outputCounts[i];
+        }
+
+        // Kahn's algorithm; a node's level is its longest path from a source
+        std::vector<uint32_t> remaining(count);
+        std::vector<uint32_t> queue;
+        queue.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            remaining[i] = nodes_[i].inputCount;
+            if (remaining[i] == 0) {
+                nodes_[i].level = 0;
+                queue.push_back(i);
+            }
+        }
+
+        uint32_t levelCount = 0;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const Node& node = nodes_[queue[head]];
+            levelCount = std::max(levelCount, node.level + 1);
+            for (uint32_t k = 0; k < node.outputCount; ++k) {
+                Node& down = nodes_[outputs_[node.outputBegin + k]];
+                down.level = down.level == NO_LEVEL ? node.level + 1 : std::max(down.level, node.level + 1);
+                if (--remaining[outputs_[node.outputBegin + k]] == 0) {
+                    queue.push_back(outputs_[node.outputBegin + k]);
+                }
+            }
+        }
+
+        stats_.cyclicCount = count - queue.size();
+        if (stats_.cyclicCount > 0) {
+            std::cerr << "[NodeGraph] " << stats_.cyclicCount
+                << " nodes are on (or fed by) a cycle and will not be evaluated" << std::endl;
+            for (uint32_t i = 0; i < count; ++i) {
+                if (remaining[i] != 0) {
+                    nodes_[i].level = NO_LEVEL;
+                    cache_[i] = Cache{};
+                }
+            }
+        }
+
+        dirtyByLevel_.resize(levelCount);
+        visitStamp_.assign(count, 0);
+        changed_.assign(count, 0);
+        epoch_ = 0;
+
+        cachedEdgeVersion_ = edges.getVersion(RelationType::NodeConnection);
+        cachedStorageVersion_ = storage.getVersion();
+        fullPass_ = true;
+
+        stats_.nodeCount = count;
+        stats_.levelCount = levelCount;
+    }
+
+    // ========================================================================
+    // EVALUATION
+    // ========================================================================
+
+    void NodeGraphSystem::schedule(ComponentStorage<GraphNodeComponent>& storage, uint32_t index) {
+        if (visitStamp_[index] == epoch_ || nodes_[index].level == NO_LEVEL) return;
+        visitStamp_[index] = epoch_;
+
+        const GraphNodeComponent* component = storage.get(nodes_[index].entity);
+        if (component) {
+            work_.push_back(WorkItem{ index, component });
+        }
+    }
+
+    void NodeGraphSystem::evaluate(const WorkItem& item) {
+        const Node& node = nodes_[item.node];
+        const GraphNodeComponent& component = *item.component;
+        Cache& cache = cache_[item.node];
+
+        // Key = op, params and the keys of the inputs (in socket order)
+        uint64_t key = mixKey(0, component.op);
+        key = mixKey(key, component.params.size());
+        for (float p : component.params) {
+            uint32_t bits;
+            std::memcpy(&bits, &p, sizeof(bits));
+            key = mixKey(key, bits);
+        }
+        key = mixKey(key, node.inputCount);
+        for (uint32_t k = 0; k < node.inputCount; ++k) {
+            key = mixKey(key, cache_[inputs_[node.inputBegin + k]].key);
+        }
+
+        if (cache.valid && cache.key == key) {
+            changed_[item.node] = 0;
+            return;
+        }
+
+        // Inputs live in lower levels, which are finished and read-only now
+        constexpr size_t INLINE_INPUTS = 16;
+        const NodeValue* inlineInputs[INLINE_INPUTS];
+        std::vector<const NodeValue*> heapInputs;
+        const NodeValue** inputs = inlineInputs;
+        if (node.inputCount > INLINE_INPUTS) {
+            heapInputs.resize(node.inputCount);
+            inputs = heapInputs.data();
+        }
+        for (uint32_t k = 0; k < node.inputCount; ++k) {
+            inputs[k] = &cache_[inputs_[node.inputBegin + k]].value;
+        }
+
+        if (component.op < ops_.size() && ops_[component.op]) {
+            ops_[component.op](NodeContext{ inputs, node.inputCount, component.params }, cache.value);
+        }
+        else {
+            cache.value.clear();
+        }
+
+        cache.key = key;
+        cache.valid = true;
+        changed_[item.node] = 1;
+    }
+
+    void NodeGraphSystem::update(World& world) {
+        stats_.visitedCount = 0;
+        stats_.evaluatedCount = 0;
+
+        auto* storage = world.getStorage<GraphNodeComponent>();
+        if (!storage || storage->size() == 0) {
+            dirtyNodes_.clear();
+            return;
+        }
+
+        // Node i mirrors dense slot i, which only moves when nodes are
+        // added or removed (a membership change)
+        const EdgeStore& edges = world.getRelationships().getEdges();
+        if (cachedEdgeVersion_ != edges.getVersion(RelationType::NodeConnection) ||
+            cachedStorageVersion_ != storage->getVersion()) {
+            rebuild(world, *storage);
+        }
+
+        if (++epoch_ == 0) {
+            std::fill(visitStamp_.begin(), visitStamp_.end(), 0);
+            epoch_ = 1;
+        }
+
+        // Seeds: every node after a re-sort (the key check filters out the
+        // unchanged ones), otherwise only the nodes queued by markDirty
+        for (auto& level : dirtyByLevel_) {
+            level.clear();
+        }
+        if (fullPass_) {
+            for (uint32_t i = 0; i < nodes_.size(); ++i) {
+                if (nodes_[i].level != NO_LEVEL) dirtyByLevel_[nodes_[i].level].push_back(i);
+            }
+            fullPass_ = false;
+        }
+        else {
+            for (EntityID id : dirtyNodes_) {
+                auto it = nodeIndex_.find(id);
+                if (it != nodeIndex_.end() && nodes_[it->second].level != NO_LEVEL) {
+                    dirtyByLevel_[nodes_[it->second].level].push_back(it->second);
+                }
+            }
+        }
+        dirtyNodes_.clear();
+
+        auto& jobs = JobSystem::instance();
+
+        for (size_t level = 0; level < dirtyByLevel_.size(); ++level) {
+            work_.clear();
+            for (uint32_t index : dirtyByLevel_[level]) {
+                schedule(*storage, index);
+            }
+            if (work_.empty()) continue;
+
+            // Nodes within a level are independent branches
+            jobs.parallelFor(work_.size(), NODE_GRAIN, [this](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    evaluate(work_[i]);
+                }
+                });
+
+            // Only a changed output makes downstream nodes worth visiting;
+            // they always sit on a deeper level
+            for (const WorkItem& item : work_) {
+                if (!changed_[item.node]) continue;
+                ++stats_.evaluatedCount;
+
+                const Node& node = nodes_[item.node];
+                for (uint32_t k = 0; k < node.outputCount; ++k) {
+                    uint32_t down = outputs_[node.outputBegin + k];
+                    if (nodes_[down].level != NO_LEVEL) {
+                        dirtyByLevel_[nodes_[down].level].push_back(down);
+                    }
+                }
+            }
+            stats_.visitedCount += work_.size();
+        }
+    }
+
+    const NodeValue* NodeGraphSystem::getOutput(EntityID node) const {
+        auto it = nodeIndex_.find(node);
+        if (it == nodeIndex_.end() || !cache_[it->second].valid) return nullptr;
+        return &cache_[it->second].value;
+    }
+
+} // namespace libre
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "Types.h"
+#include "ComponentStorage.h"
+#include "../components/CoreComponents.h"
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <unordered_map>
+
+namespace libre {
+
+    class World;
+
+    // ============================================================================
+    // NODE GRAPH - Incremental evaluation of NodeConnection graphs
+    // ============================================================================
+    // Every entity with a GraphNodeComponent is a node. A node's inputs are its
+    // incoming NodeConnection edges, ordered by the edge's 'order' (socket).
+    //
+    // - Nodes are sorted into topological levels (longest path from a
+    //   source). Nodes within a level never feed each other, so each level
+    //   is evaluated in parallel on the JobSystem. The sort is redone only
+    //   when the NodeConnection edges or the set of nodes change.
+    // - Each node caches its output together with a key hashed from its op,
+    //   its params and the keys of its inputs. A node whose key did not
+    //   change is not re-run, and its downstream nodes are not even visited.
+    // - Editing a node (markDirty after changing its op or params) re-cooks
+    //   only that node and whatever downstream nodes actually see a
+    //   different input. Nothing scans the nodes for edits.
+    // - Nodes on a cycle are never evaluated (reported in Stats::cyclicCount).
+    //
+    // Ops run on worker threads and must be pure functions of their inputs
+    // and params.
+
+    using NodeValue = std::vector<float>;
+
+    struct NodeContext {
+        const NodeValue* const* inputs;     // One per connected socket, in socket order
+        size_t inputCount;
+        const std::vector<float>& params;
+    };
+
+    using NodeOp = std::function<void(const NodeContext&, NodeValue& out)>;
+
+    class NodeGraphSystem {
+    public:
+        struct Stats {
+            size_t nodeCount = 0;
+            size_t levelCount = 0;
+            size_t cyclicCount = 0;     // Nodes on or fed by a cycle (never evaluated)
+            size_t visitedCount = 0;    // Nodes whose key was checked last update
+            size_t evaluatedCount = 0;  // Nodes whose op actually ran last update
+        };
+
+        // Built-in ops, registered in this order by the constructor
+        enum BuiltinOp : uint32_t {
+            OP_CONSTANT = 0,    // out = params
+            OP_ADD,             // out = sum of inputs (component-wise)
+            OP_MULTIPLY,        // out = product of inputs (component-wise)
+            OP_SCALE,           // out = input0 * params[0]
+        };
+
+        NodeGraphSystem();
+
+        // Register an op; returns the id to store in GraphNodeComponent::op
+        uint32_t registerOp(const std::string& name, NodeOp op);
+        uint32_t findOp(const std::string& name) const;
+
+        // Re-cook whatever changed since the last update
+        void update(World& world);
+
+        // Queue a node whose op or params were edited
+        void markDirty(EntityID node) { dirtyNodes_.push_back(node); }
+
+        // Output of a node after the last update (nullptr if never evaluated)
+        const NodeValue* getOutput(EntityID node) const;
+
+        // Force a re-sort on the next update (cached outputs are kept)
+        void invalidate() { cachedEdgeVersion_ = INVALID_VERSION; }
+
+        const Stats& getStats() const { return stats_; }
+
+    private:
+        static constexpr uint64_t INVALID_VERSION = ~0ull;
+        static constexpr uint32_t NO_LEVEL = 0xFFFFFFFF;
+
+        struct Node {
+            EntityID entity = INVALID_ENTITY;
+            uint32_t level = NO_LEVEL;
+            uint32_t inputBegin = 0;        // Range in inputs_
+            uint32_t inputCount = 0;
+            uint32_t outputBegin = 0;       // Range in outputs_
+            uint32_t outputCount = 0;
+        };
+
+        // Cached result, carried across re-sorts by entity
+        struct Cache {
+            uint64_t key = 0;
+            bool valid = false;
+            NodeValue value;
+        };
+
+        struct WorkItem {
+            uint32_t node;
+            const GraphNodeComponent* component;
+        };
+
+        void rebuild(World& world, ComponentStorage<GraphNodeComponent>& storage);
+        void schedule(ComponentStorage<GraphNodeComponent>& storage, uint32_t index);
+        void evaluate(const WorkItem& item);
+
+        std::vector<std::string> opNames_;
+        std::vector<NodeOp> ops_;
+
+        std::vector<Node> nodes_;               // Parallel to the dense GraphNodeComponent storage
+        std::vector<uint32_t> inputs_;          // Upstream node indices, socket order
+        std::vector<uint32_t> outputs_;         // Downstream node indices
+        std::vector<Cache> cache_;
+        std::unordered_map<EntityID, uint32_t> nodeIndex_;
+
+        std::vector<EntityID> dirtyNodes_;      // Queued by markDirty since the last update (may repeat)
+
+        // Per-update scratch
+        std::vector<std::vector<uint32_t>> dirtyByLevel_;   // Seeds plus downstream of changed nodes
+        std::vector<uint32_t> visitStamp_;
+        std::vector<uint8_t> changed_;
+        std::vector<WorkItem> work_;
+        uint32_t epoch_ = 0;
+
+        uint64_t cachedEdgeVersion_ = INVALID_VERSION;
+        uint64_t cachedStorageVersion_ = INVALID_VERSION;  // GraphNodeComponent membership
+        bool fullPass_ = true;
+
+        Stats stats_;
+    };
+
+} // namespace libre
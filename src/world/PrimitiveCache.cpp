@@ -0,0 +1,336 @@
+#include "PrimitiveCache.h"
+#include "../core/JobSystem.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+namespace libre {
+
+    namespace {
+
+        constexpr double TWO_PI = 6.28318530717958647692;
+        constexpr uint64_t PRIME = 0x9E3779B185EBCA87ULL;
+
+        const glm::vec3 BASE_COLOR(0.8f);
+
+        uint32_t floatBits(float value) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        // Equal requests must land on one key
+        PrimitiveCache::Key normalize(PrimitiveCache::Key key) {
+            switch (key.type) {
+            case PrimitiveCache::Type::Cube:
+                key.height = 0.0f;
+                key.segments = key.rings = 0;
+                break;
+            case PrimitiveCache::Type::Sphere:
+                key.height = 0.0f;
+                key.segments = std::max<uint32_t>(key.segments, 3);
+                key.rings = std::max<uint32_t>(key.rings, 2);
+                break;
+            case PrimitiveCache::Type::Cylinder:
+                key.segments = std::max<uint32_t>(key.segments, 3);
+                key.rings = 0;
+                break;
+            }
+            return key;
+        }
+
+        size_t rowGrain(size_t verticesPerRow) {
+            return std::max<size_t>(1, PrimitiveCache::PARALLEL_VERTICES / std::max<size_t>(1, verticesPerRow));
+        }
+
+        void generateCube(MeshComponent& mesh, float size) {
+            float h = size * 0.5f;
+            glm::vec3 baseColor = BASE_COLOR;
+
+            mesh.vertices = {
+                // Front face (Z+)
+                {{-h, -h,  h}, {0, 0, 1}, baseColor, {0, 0}},
+                {{ h, -h,  h}, {0, 0, 1}, baseColor, {1, 0}},
+                {{ h,  h,  h}, {0, 0, 1}, baseColor, {1, 1}},
+                {{-h,  h,  h}, {0, 0, 1}, baseColor, {0, 1}},
+                // Back face (Z-)
+                {{ h, -h, -h}, {0, 0, -1}, baseColor, {0, 0}},
+                {{-h, -h, -h}, {0, 0, -1}, baseColor, {1, 0}},
+                {{-h,  h, -h}, {0, 0, -1}, baseColor, {1, 1}},
+                {{ h,  h, -h}, {0, 0, -1}, baseColor, {0, 1}},
+                // Top face (Y+)
+                {{-h,  h,  h}, {0, 1, 0}, baseColor, {0, 0}},
+                {{ h,  h,  h}, {0, 1, 0}, baseColor, {1, 0}},
+                {{ h,  h, -h}, {0, 1, 0}, baseColor, {1, 1}},
+                {{-h,  h, -h}, {0, 1, 0}, baseColor, {0, 1}},
+                // Bottom face (Y-)
+                {{-h, -h, -h}, {0, -1, 0}, baseColor, {0, 0}},
+                {{ h, -h, -h}, {0, -1, 0}, baseColor, {1, 0}},
+                {{ h, -h,  h}, {0, -1, 0}, baseColor, {1, 1}},
+                {{-h, -h,  h}, {0, -1, 0}, baseColor, {0, 1}},
+                // Right face (X+)
+                {{ h, -h,  h}, {1, 0, 0}, baseColor, {0, 0}},
+                {{ h, -h, -h}, {1, 0, 0}, baseColor, {1, 0}},
+                {{ h,  h, -h}, {1, 0, 0}, baseColor, {1, 1}},
+                {{ h,  h,  h}, {1, 0, 0}, baseColor, {0, 1}},
+                // Left face (X-)
+                {{-h, -h, -h}, {-1, 0, 0}, baseColor, {0, 0}},
+                {{-h, -h,  h}, {-1, 0, 0}, baseColor, {1, 0}},
+                {{-h,  h,  h}, {-1, 0, 0}, baseColor, {1, 1}},
+                {{-h,  h, -h}, {-1, 0, 0}, baseColor, {0, 1}},
+            };
+
+            mesh.indices = {
+                0, 1, 2, 2, 3, 0,       // Front
+                4, 5, 6, 6, 7, 4,       // Back
+                8, 9, 10, 10, 11, 8,    // Top
+                12, 13, 14, 14, 15, 12, // Bottom
+                16, 17, 18, 18, 19, 16, // Right
+                20, 21, 22, 22, 23, 20  // Left
+            };
+        }
+
+        // 'around' has segments + 1 entries; 'pole' has 2 * rings + 1, of
+        // which the first rings + 1 run from the top pole to the bottom one.
+        // Counter-clockwise from outside (the pipeline's front face).
+        void generateSphere(MeshComponent& mesh, float radius, uint32_t segments, uint32_t rings,
+            const std::vector<glm::vec2>& around, const std::vector<glm::vec2>& pole) {
+            uint32_t row = segments + 1;
+            mesh.vertices.resize(size_t(rings + 1) * row);
+            mesh.indices.resize(size_t(rings) * segments * 6);
+
+            JobSystem& jobs = JobSystem::instance();
+            jobs.parallelFor(rings + 1, rowGrain(row), [&](size_t begin, size_t end) {
+                for (size_t y = begin; y < end; ++y) {
+                    float cosTheta = pole[y].x;
+                    float sinTheta = pole[y].y;
+                    float v = static_cast<float>(y) / rings;
+                    MeshVertex* out = mesh.vertices.data() + y * row;
+                    for (uint32_t x = 0; x <= segments; ++x) {
+                        glm::vec3 normal(around[x].x * sinTheta, cosTheta, around[x].y * sinTheta);
+                        out[x].position = normal * radius;
+                        out[x].normal = normal;
+                        out[x].color = BASE_COLOR;
+                        out[x].uv = glm::vec2(static_cast<float>(x) / segments, v);
+                    }
+                }
+            });
+
+            jobs.parallelFor(rings, rowGrain(row), [&](size_t begin, size_t end) {
+                for (size_t y = begin; y < end; ++y) {
+                    uint32_t* out = mesh.indices.data() + y * segments * 6;
+                    for (uint32_t x = 0; x < segments; ++x) {
+                        uint32_t i0 = static_cast<uint32_t>(y) * row + x;
+                        uint32_t i1 = i0 + 1;
+                        uint32_t i2 = i0 + row;
+                        uint32_t i3 = i2 + 1;
+
+                        *out++ = i0; *out++ = i1; *out++ = i2;
+                        *out++ = i1; *out++ = i3; *out++ = i2;
+                    }
+                }
+            });
+        }
+
+        // Layout: side pairs (top, bottom) per step, the two cap centres,
+        // then cap rim pairs (top, bottom) per step. Counter-clockwise from
+        // outside, like the cube and the sphere.
+        void generateCylinder(MeshComponent& mesh, float radius, float height, uint32_t segments,
+            const std::vector<glm::vec2>& around) {
+            float halfH = height * 0.5f;
+            uint32_t steps = segments + 1;
+            uint32_t topCenter = steps * 2;
+            uint32_t botCenter = topCenter + 1;
+            uint32_t capStart = botCenter + 1;
+
+            mesh.vertices.resize(size_t(steps) * 4 + 2);
+            mesh.indices.resize(size_t(segments) * 12);
+
+            MeshVertex& top = mesh.vertices[topCenter];
+            top.position = glm::vec3(0.0f, halfH, 0.0f);
+            top.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+            top.color = BASE_COLOR;
+            top.uv = glm::vec2(0.5f);
+
+            MeshVertex& bottom = mesh.vertices[botCenter];
+            bottom.position = glm::vec3(0.0f, -halfH, 0.0f);
+            bottom.normal = glm::vec3(0.0f, -1.0f, 0.0f);
+            bottom.color = BASE_COLOR;
+            bottom.uv = glm::vec2(0.5f);
+
+            JobSystem& jobs = JobSystem::instance();
+            jobs.parallelFor(steps, rowGrain(4), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    glm::vec2 c = around[i];
+                    float x = c.x * radius;
+                    float z = c.y * radius;
+                    float u = static_cast<float>(i) / segments;
+                    glm::vec2 capUV(0.5f + 0.5f * c.x, 0.5f + 0.5f * c.y);
+
+                    MeshVertex* side = mesh.vertices.data() + i * 2;
+                    side[0] = { glm::vec3(x, halfH, z), glm::vec3(c.x, 0.0f, c.y), BASE_COLOR, glm::vec2(u, 1.0f) };
+                    side[1] = { glm::vec3(x, -halfH, z), glm::vec3(c.x, 0.0f, c.y), BASE_COLOR, glm::vec2(u, 0.0f) };
+
+                    MeshVertex* cap = mesh.vertices.data() + capStart + i * 2;
+                    cap[0] = { glm::vec3(x, halfH, z), glm::vec3(0.0f, 1.0f, 0.0f), BASE_COLOR, capUV };
+                    cap[1] = { glm::vec3(x, -halfH, z), glm::vec3(0.0f, -1.0f, 0.0f), BASE_COLOR, capUV };
+                }
+            });
+
+            uint32_t* capIndices = mesh.indices.data() + size_t(segments) * 6;
+            jobs.parallelFor(segments, rowGrain(4), [&](size_t begin, size_t end) {
+                for (size_t s = begin; s < end; ++s) {
+                    uint32_t i = static_cast<uint32_t>(s);
+                    uint32_t* out = mesh.indices.data() + s * 6;
+                    uint32_t i0 = i * 2;
+                    *out++ = i0; *out++ = i0 + 2; *out++ = i0 + 1;
+                    *out++ = i0 + 2; *out++ = i0 + 3; *out++ = i0 + 1;
+
+                    out = capIndices + s * 6;
+                    *out++ = topCenter; *out++ = capStart + (i + 1) * 2; *out++ = capStart + i * 2;
+                    *out++ = botCenter; *out++ = capStart + i * 2 + 1; *out++ = capStart + (i + 1) * 2 + 1;
+                }
+            });
+        }
+
+        size_t meshBytes(const MeshComponent& mesh) {
+            return mesh.vertices.size() * sizeof(MeshVertex) + mesh.indices.size() * sizeof(uint32_t);
+        }
+
+    } // namespace
+
+    size_t PrimitiveCache::KeyHash::operator()(const Key& key) const {
+        uint64_t hash = static_cast<uint64_t>(key.type);
+        hash = (hash ^ floatBits(key.size)) * PRIME;
+        hash = (hash ^ floatBits(key.height)) * PRIME;
+        hash = (hash ^ key.segments) * PRIME;
+        hash = (hash ^ key.rings) * PRIME;
+        return static_cast<size_t>(hash ^ (hash >> 32));
+    }
+
+    PrimitiveCache::CircleTable PrimitiveCache::makeCircle(uint32_t steps) {
+        CircleTable table(size_t(steps) + 1);
+        for (uint32_t i = 0; i <= steps; ++i) {
+            double angle = TWO_PI * i / steps;
+            table[i] = glm::vec2(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+        }
+        return table;
+    }
+
+    std::shared_ptr<const PrimitiveCache::CircleTable> PrimitiveCache::getCircle(uint32_t steps) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = circles_.find(steps);
+            if (it != circles_.end()) return it->second;
+        }
+
+        auto table = std::make_shared<const CircleTable>(makeCircle(steps));
+        std::lock_guard<std::mutex> lock(mutex_);
+        return circles_.try_emplace(steps, std::move(table)).first->second;
+    }
+
+    MeshComponent PrimitiveCache::generate(const Key& key, const CircleTable& around, const CircleTable& pole) {
+        MeshComponent mesh;
+        switch (key.type) {
+        case Type::Cube:
+            generateCube(mesh, key.size);
+            break;
+        case Type::Sphere:
+            generateSphere(mesh, key.size, key.segments, key.rings, around, pole);
+            break;
+        case Type::Cylinder:
+            generateCylinder(mesh, key.size, key.height, key.segments, around);
+            break;
+        }
+        mesh.calculateBounds();
+        return mesh;
+    }
+
+    MeshComponent PrimitiveCache::generate(const Key& key) {
+        Key normalized = normalize(key);
+        CircleTable around, pole;
+        if (normalized.type != Type::Cube) around = makeCircle(normalized.segments);
+        if (normalized.type == Type::Sphere) pole = makeCircle(normalized.rings * 2);
+        return generate(normalized, around, pole);
+    }
+
+    std::shared_ptr<const MeshComponent> PrimitiveCache::get(const Key& request) {
+        Key key = normalize(request);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = meshes_.find(key);
+            if (it != meshes_.end()) {
+                ++stats_.cacheHits;
+                return it->second;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::shared_ptr<const CircleTable> around, pole;
+        if (key.type != Type::Cube) around = getCircle(key.segments);
+        if (key.type == Type::Sphere) pole = getCircle(key.rings * 2);
+
+        static const CircleTable NONE;
+        auto mesh = std::make_shared<const MeshComponent>(generate(key, around ? *around : NONE, pole ? *pole : NONE));
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto [it, inserted] = meshes_.try_emplace(key, mesh);
+        if (!inserted) {
+            ++stats_.cacheHits;
+            return it->second;
+        }
+
+        // Over budget: drop the rest (entities hold their own copies)
+        size_t bytes = meshBytes(*mesh);
+        if (stats_.bytes + bytes > MAX_CACHE_BYTES) {
+            meshes_.clear();
+            meshes_.emplace(key, mesh);
+            stats_.bytes = 0;
+        }
+        stats_.bytes += bytes;
+        ++stats_.generated;
+        stats_.lastGenerateMs = ms;
+        return mesh;
+    }
+
+    std::shared_ptr<const MeshComponent> PrimitiveCache::getCube(float size) {
+        Key key;
+        key.type = Type::Cube;
+        key.size = size;
+        return get(key);
+    }
+
+    std::shared_ptr<const MeshComponent> PrimitiveCache::getSphere(float radius, int segments, int rings) {
+        Key key;
+        key.type = Type::Sphere;
+        key.size = radius;
+        key.segments = static_cast<uint32_t>(std::max(segments, 0));
+        key.rings = static_cast<uint32_t>(std::max(rings, 0));
+        return get(key);
+    }
+
+    std::shared_ptr<const MeshComponent> PrimitiveCache::getCylinder(float radius, float height, int segments) {
+        Key key;
+        key.type = Type::Cylinder;
+        key.size = radius;
+        key.height = height;
+        key.segments = static_cast<uint32_t>(std::max(segments, 0));
+        return get(key);
+    }
+
+    PrimitiveCache::Stats PrimitiveCache::getStats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+    void PrimitiveCache::clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        meshes_.clear();
+        circles_.clear();
+        stats_.bytes = 0;
+    }
+
+} // namespace libre
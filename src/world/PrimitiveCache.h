@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../components/CoreComponents.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace libre {
+
+    // ============================================================================
+    // PRIMITIVE CACHE - Shared geometry for parametric primitives
+    // ============================================================================
+    // Primitives asks here for its meshes. Geometry is keyed by its
+    // parameters (type, size, height, segments, rings) and generated once:
+    // 10k identical spheres cost one tessellation and 10k copies. Entities
+    // get their own MeshComponent (copied from the shared one), so editing
+    // one never touches the cache.
+    //
+    // Sin/cos tables are kept per step count, so the angles are evaluated
+    // once per segment count, not once per vertex. Large tessellations fill
+    // their rows (sphere) or segments (cylinder) in JobSystem chunks of
+    // about PARALLEL_VERTICES vertices; small ones run inline.
+    //
+    // Thread-safe: generation runs outside the lock, so two threads asking
+    // for the same new key may both build it (the first insert wins).
+
+    class PrimitiveCache {
+    public:
+        enum class Type : uint8_t {
+            Cube,
+            Sphere,
+            Cylinder
+        };
+
+        struct Key {
+            Type type = Type::Cube;
+            float size = 1.0f;          // Cube edge, or sphere/cylinder radius
+            float height = 0.0f;        // Cylinder only
+            uint32_t segments = 0;      // Around the Y axis (sphere, cylinder)
+            uint32_t rings = 0;         // Pole to pole (sphere)
+
+            bool operator==(const Key& other) const {
+                return type == other.type && size == other.size && height == other.height &&
+                    segments == other.segments && rings == other.rings;
+            }
+        };
+
+        struct Stats {
+            size_t generated = 0;       // Distinct geometries built
+            size_t cacheHits = 0;       // Requests that reused one
+            size_t bytes = 0;           // Held by the cache now
+            double lastGenerateMs = 0.0;
+        };
+
+        // Vertices per JobSystem chunk; a mesh of one chunk or less runs inline
+        static constexpr size_t PARALLEL_VERTICES = 16384;
+
+        // Cached geometry is dropped (all at once) past this size
+        static constexpr size_t MAX_CACHE_BYTES = size_t(64) << 20;
+
+        static PrimitiveCache& instance() {
+            static PrimitiveCache cache;
+            return cache;
+        }
+
+        PrimitiveCache(const PrimitiveCache&) = delete;
+        PrimitiveCache& operator=(const PrimitiveCache&) = delete;
+
+        std::shared_ptr<const MeshComponent> getCube(float size);
+        std::shared_ptr<const MeshComponent> getSphere(float radius, int segments, int rings);
+        std::shared_ptr<const MeshComponent> getCylinder(float radius, float height, int segments);
+        std::shared_ptr<const MeshComponent> get(const Key& key);
+
+        // Builds the geometry without the cache (and without its tables)
+        static MeshComponent generate(const Key& key);
+
+        Stats getStats() const;
+        void clear();
+
+    private:
+        struct KeyHash {
+            size_t operator()(const Key& key) const;
+        };
+
+        // (cos, sin) of 2 pi i / steps for i in [0, steps]
+        using CircleTable = std::vector<glm::vec2>;
+
+        PrimitiveCache() = default;
+
+        static MeshComponent generate(const Key& key, const CircleTable& around, const CircleTable& pole);
+        static CircleTable makeCircle(uint32_t steps);
+        std::shared_ptr<const CircleTable> getCircle(uint32_t steps);
+
+        mutable std::mutex mutex_;
+        std::unordered_map<Key, std::shared_ptr<const MeshComponent>, KeyHash> meshes_;
+        std::unordered_map<uint32_t, std::shared_ptr<const CircleTable>> circles_;
+        Stats stats_;
+    };
+
+} // namespace libre
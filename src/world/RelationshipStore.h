@@ -1,11 +1,10 @@
 #pragma once
 
 #include "Types.h"
+#include "HierarchyIndex.h"
+#include "EdgeStore.h"
+#include "GroupIndex.h"
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
-#include <algorithm>
-#include <functional>
 
 namespace libre {
 
@@ -28,105 +27,78 @@ namespace libre {
         }
     };
 
-    // Hash for Relationship
-    struct RelationshipHash {
-        size_t operator()(const Relationship& r) const {
-            size_t h1 = std::hash<uint8_t>{}(static_cast<uint8_t>(r.type));
-            size_t h2 = std::hash<EntityID>{}(r.from);
-            size_t h3 = std::hash<EntityID>{}(r.to);
-            return h1 ^ (h2 << 1) ^ (h3 << 2);
-        }
-    };
-
     // ============================================================================
     // RELATIONSHIP STORE
     // ============================================================================
+    // ParentChild edges live in a dedicated HierarchyIndex (O(1) parent, child,
+    // root and ancestor queries). Every other type lives in an EdgeStore
+    // (slot-indexed adjacency with O(1) removal). GroupMember edges are also
+    // mirrored into a GroupIndex for bulk group operations. getFrom/getTo/
+    // getByType never return ParentChild edges.
 
     class RelationshipStore {
     public:
+        // ========================================================================
+        // ENTITIES
+        // ========================================================================
+
+        // Register a new entity (it starts out as a hierarchy root)
+        void addEntity(EntityID entity) {
+            hierarchy_.insert(entity);
+        }
+
         // ========================================================================
         // ADD/REMOVE RELATIONSHIPS
         // ========================================================================
 
         // Add a relationship
         void add(const Relationship& rel) {
-            relationships_.insert(rel);
-
-            // Index by 'from' entity
-            fromIndex_[rel.from].push_back(rel);
+            if (rel.type == RelationType::ParentChild) {
+                setParent(rel.to, rel.from);
+                return;
+            }
 
-            // Index by 'to' entity
-            toIndex_[rel.to].push_back(rel);
+            edges_.add(rel.type, rel.from, rel.to, rel.order, rel.label, rel.weight);
 
-            // Index by type
-            typeIndex_[rel.type].push_back(rel);
+            if (rel.type == RelationType::GroupMember) {
+                groups_.addMember(rel.from, rel.to);
+            }
         }
 
-        // Add parent-child relationship (convenience)
+        // Add parent-child relationship (replaces any existing parent)
         void setParent(EntityID child, EntityID parent) {
-            // Remove existing parent relationship
-            removeParent(child);
-
-            if (parent != INVALID_ENTITY) {
-                Relationship rel;
-                rel.type = RelationType::ParentChild;
-                rel.from = parent;
-                rel.to = child;
-                add(rel);
-            }
+            hierarchy_.setParent(child, parent);
         }
 
         // Remove a relationship
         void remove(const Relationship& rel) {
-            relationships_.erase(rel);
+            if (rel.type == RelationType::ParentChild) {
+                if (hierarchy_.getParent(rel.to) == rel.from) {
+                    removeParent(rel.to);
+                }
+                return;
+            }
 
-            // Remove from indices
-            removeFromVector(fromIndex_[rel.from], rel);
-            removeFromVector(toIndex_[rel.to], rel);
-            removeFromVector(typeIndex_[rel.type], rel);
+            if (edges_.remove(rel.type, rel.from, rel.to) && rel.type == RelationType::GroupMember) {
+                groups_.removeMember(rel.from, rel.to);
+            }
         }
 
-        // Remove parent relationship
+        // Remove parent relationship (child becomes a root)
         void removeParent(EntityID child) {
-            auto it = toIndex_.find(child);
-            if (it != toIndex_.end()) {
-                auto& rels = it->second;
-                for (auto rit = rels.begin(); rit != rels.end(); ) {
-                    if (rit->type == RelationType::ParentChild) {
-                        Relationship rel = *rit;
-                        relationships_.erase(rel);
-                        removeFromVector(fromIndex_[rel.from], rel);
-                        removeFromVector(typeIndex_[rel.type], rel);
-                        rit = rels.erase(rit);
-                    }
-                    else {
-                        ++rit;
-                    }
-                }
-            }
+            hierarchy_.setParent(child, INVALID_ENTITY);
         }
 
         // Remove all relationships involving an entity
         void removeEntity(EntityID entity) {
-            // Remove where entity is 'from'
-            if (auto it = fromIndex_.find(entity); it != fromIndex_.end()) {
-                for (const auto& rel : it->second) {
-                    relationships_.erase(rel);
-                    removeFromVector(toIndex_[rel.to], rel);
-                    removeFromVector(typeIndex_[rel.type], rel);
-                }
-                fromIndex_.erase(it);
-            }
+            hierarchy_.erase(entity);
 
-            // Remove where entity is 'to'
-            if (auto it = toIndex_.find(entity); it != toIndex_.end()) {
-                for (const auto& rel : it->second) {
-                    relationships_.erase(rel);
-                    removeFromVector(fromIndex_[rel.from], rel);
-                    removeFromVector(typeIndex_[rel.type], rel);
-                }
-                toIndex_.erase(it);
-            }
+            edges_.forEachIncoming(entity, RelationType::GroupMember, [&](uint32_t, const EdgeStore::Edge& edge) {
+                groups_.removeMember(edges_.getFrom(edge), entity);
+                });
+            groups_.eraseGroup(entity);
+
+            edges_.removeEntity(entity);
         }
 
         // ========================================================================
@@ -135,92 +107,93 @@ namespace libre {
 
         // Get parent of entity
         EntityID getParent(EntityID child) const {
-            auto it = toIndex_.find(child);
-            if (it != toIndex_.end()) {
-                for (const auto& rel : it->second) {
-                    if (rel.type == RelationType::ParentChild) {
-                        return rel.from;
-                    }
-                }
-            }
-            return INVALID_ENTITY;
+            return hierarchy_.getParent(child);
         }
 
         // Get children of entity
         std::vector<EntityID> getChildren(EntityID parent) const {
-            std::vector<EntityID> children;
-            auto it = fromIndex_.find(parent);
-            if (it != fromIndex_.end()) {
-                for (const auto& rel : it->second) {
-                    if (rel.type == RelationType::ParentChild) {
-                        children.push_back(rel.to);
-                    }
-                }
-            }
-            return children;
+            EntitySpan children = hierarchy_.getChildren(parent);
+            return std::vector<EntityID>(children.begin(), children.end());
         }
 
-        // Get all root entities (no parent)
-        std::vector<EntityID> getRoots(const std::unordered_set<EntityID>& allEntities) const {
-            std::vector<EntityID> roots;
-            for (EntityID id : allEntities) {
-                if (getParent(id) == INVALID_ENTITY) {
-                    roots.push_back(id);
-                }
-            }
-            return roots;
+        // Get all root entities (registered entities with no parent)
+        const std::vector<EntityID>& getRoots() const {
+            return hierarchy_.getRoots();
         }
 
-        // Get relationships from entity
-        const std::vector<Relationship>& getFrom(EntityID entity) const {
-            static std::vector<Relationship> empty;
-            auto it = fromIndex_.find(entity);
-            return (it != fromIndex_.end()) ? it->second : empty;
+        const HierarchyIndex& getHierarchy() const { return hierarchy_; }
+
+        const EdgeStore& getEdges() const { return edges_; }
+
+        // Members of a group (from = group, to = member); nullptr if none yet
+        const SlotSet* getGroupMembers(EntityID group) const {
+            return groups_.getMembers(group);
+        }
+
+        // Get relationships from entity (all non-hierarchy types)
+        std::vector<Relationship> getFrom(EntityID entity) const {
+            std::vector<Relationship> result;
+            for (size_t t = 0; t < EdgeStore::TYPE_COUNT; ++t) {
+                edges_.forEachOutgoing(entity, static_cast<RelationType>(t), [&](uint32_t, const EdgeStore::Edge& edge) {
+                    result.push_back(toRelationship(edge));
+                    });
+            }
+            return result;
         }
 
-        // Get relationships to entity
-        const std::vector<Relationship>& getTo(EntityID entity) const {
-            static std::vector<Relationship> empty;
-            auto it = toIndex_.find(entity);
-            return (it != toIndex_.end()) ? it->second : empty;
+        // Get relationships to entity (all non-hierarchy types)
+        std::vector<Relationship> getTo(EntityID entity) const {
+            std::vector<Relationship> result;
+            for (size_t t = 0; t < EdgeStore::TYPE_COUNT; ++t) {
+                edges_.forEachIncoming(entity, static_cast<RelationType>(t), [&](uint32_t, const EdgeStore::Edge& edge) {
+                    result.push_back(toRelationship(edge));
+                    });
+            }
+            return result;
         }
 
         // Get relationships by type
-        const std::vector<Relationship>& getByType(RelationType type) const {
-            static std::vector<Relationship> empty;
-            auto it = typeIndex_.find(type);
-            return (it != typeIndex_.end()) ? it->second : empty;
+        std::vector<Relationship> getByType(RelationType type) const {
+            std::vector<Relationship> result;
+            result.reserve(edges_.size(type));
+            edges_.forEachOfType(type, [&](uint32_t, const EdgeStore::Edge& edge) {
+                result.push_back(toRelationship(edge));
+                });
+            return result;
         }
 
         // Check if relationship exists
         bool exists(EntityID from, EntityID to, RelationType type) const {
-            Relationship rel;
-            rel.type = type;
-            rel.from = from;
-            rel.to = to;
-            return relationships_.find(rel) != relationships_.end();
+            if (type == RelationType::ParentChild) {
+                return to != INVALID_ENTITY && hierarchy_.getParent(to) == from;
+            }
+
+            return edges_.contains(type, from, to);
         }
 
         // ========================================================================
         // HIERARCHY TRAVERSAL
         // ========================================================================
 
-        // Traverse hierarchy depth-first
+        // Traverse hierarchy depth-first (pre-order). Iterates the numbered
+        // subtree span - no recursion, no per-node allocation. 'func' must not
+        // edit the hierarchy; see HierarchyTraversal for post-order walks.
         template<typename Func>
-        void traverseDepthFirst(EntityID root, Func&& func, int depth = 0) const {
-            func(root, depth);
-            for (EntityID child : getChildren(root)) {
-                traverseDepthFirst(child, func, depth + 1);
+        void traverseDepthFirst(EntityID root, Func&& func) const {
+            EntitySpan subtree = hierarchy_.getSubtree(root);
+            if (subtree.empty()) return;
+
+            uint32_t rootDepth = hierarchy_.getDepth(root);
+            for (EntityID id : subtree) {
+                func(id, static_cast<int>(hierarchy_.getDepth(id) - rootDepth));
             }
         }
 
-        // Get all descendants
+        // Get all descendants (pre-order, excluding 'ancestor')
         std::vector<EntityID> getDescendants(EntityID ancestor) const {
-            std::vector<EntityID> result;
-            traverseDepthFirst(ancestor, [&result, ancestor](EntityID id, int) {
-                if (id != ancestor) result.push_back(id);
-                });
-            return result;
+            EntitySpan subtree = hierarchy_.getSubtree(ancestor);
+            if (subtree.empty()) return {};
+            return std::vector<EntityID>(subtree.begin() + 1, subtree.end());
         }
 
         // Get all ancestors (path to root)
@@ -234,38 +207,44 @@ namespace libre {
             return ancestors;
         }
 
-        // Check if 'ancestor' is ancestor of 'descendant'
+        // Check if 'ancestor' is ancestor of 'descendant' (O(1) once numbered)
         bool isAncestorOf(EntityID ancestor, EntityID descendant) const {
-            EntityID current = getParent(descendant);
-            while (current != INVALID_ENTITY) {
-                if (current == ancestor) return true;
-                current = getParent(current);
-            }
-            return false;
+            return hierarchy_.isAncestorOf(ancestor, descendant);
+        }
+
+        // 'root' and all of its descendants, pre-order ("select hierarchy")
+        EntitySpan getSubtree(EntityID root) const {
+            return hierarchy_.getSubtree(root);
+        }
+
+        bool isInSubtree(EntityID root, EntityID entity) const {
+            return hierarchy_.isInSubtree(root, entity);
         }
 
         // Clear all relationships
         void clear() {
-            relationships_.clear();
-            fromIndex_.clear();
-            toIndex_.clear();
-            typeIndex_.clear();
+            hierarchy_.clear();
+            edges_.clear();
+            groups_.clear();
         }
 
-        size_t size() const { return relationships_.size(); }
+        size_t size() const { return edges_.size() + hierarchy_.getEdgeCount(); }
 
     private:
-        void removeFromVector(std::vector<Relationship>& vec, const Relationship& rel) {
-            vec.erase(
-                std::remove(vec.begin(), vec.end(), rel),
-                vec.end()
-            );
-        }
-
-        std::unordered_set<Relationship, RelationshipHash> relationships_;
-        std::unordered_map<EntityID, std::vector<Relationship>> fromIndex_;
-        std::unordered_map<EntityID, std::vector<Relationship>> toIndex_;
-        std::unordered_map<RelationType, std::vector<Relationship>> typeIndex_;
+        Relationship toRelationship(const EdgeStore::Edge& edge) const {
+            Relationship rel;
+            rel.type = edge.type;
+            rel.from = edges_.getFrom(edge);
+            rel.to = edges_.getTo(edge);
+            rel.order = edge.order;
+            rel.label = edges_.getLabel(edge);
+            rel.weight = edge.weight;
+            return rel;
+        }
+
+        HierarchyIndex hierarchy_;
+        EdgeStore edges_;
+        GroupIndex groups_;
     };
 
 } // namespace libre
\ No newline at end of file
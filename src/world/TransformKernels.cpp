@@ -0,0 +1,236 @@
+#include "TransformKernels.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LIBRE_KERNEL_AVX2 1
+#define LIBRE_KERNEL_SSE 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LIBRE_KERNEL_SSE 1
+#endif
+
+namespace libre {
+namespace TransformKernels {
+
+    // ========================================================================
+    // SCALAR
+    // ========================================================================
+
+    static void composeTRSScalar(const TRSBatch& in, glm::mat4* out, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            out[i] = composeTRS(
+                glm::vec3(in.px[i], in.py[i], in.pz[i]),
+                glm::quat(in.qw[i], in.qx[i], in.qy[i], in.qz[i]),
+                glm::vec3(in.sx[i], in.sy[i], in.sz[i]));
+        }
+    }
+
+    static void transformAABBsScalar(const glm::mat4* matrices, const AABBBatch& in, const AABBBatchOut& out,
+        size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            glm::vec3 worldMin, worldMax;
+            transformAABB(matrices[i],
+                glm::vec3(in.minX[i], in.minY[i], in.minZ[i]),
+                glm::vec3(in.maxX[i], in.maxY[i], in.maxZ[i]),
+                worldMin, worldMax);
+
+            out.minX[i] = worldMin.x; out.minY[i] = worldMin.y; out.minZ[i] = worldMin.z;
+            out.maxX[i] = worldMax.x; out.maxY[i] = worldMax.y; out.maxZ[i] = worldMax.z;
+        }
+    }
+
+#if LIBRE_KERNEL_SSE
+
+    // ========================================================================
+    // SSE - 4 entities per iteration
+    // ========================================================================
+
+    // Lanes hold one matrix element for 4 entities. A 4x4 transpose turns
+    // (m0, m1, m2, m3) element vectors into one column per entity.
+    static inline void storeColumns4(glm::mat4* out, int column,
+        __m128 e0, __m128 e1, __m128 e2, __m128 e3) {
+        _MM_TRANSPOSE4_PS(e0, e1, e2, e3);
+        _mm_storeu_ps(&out[0][column][0], e0);
+        _mm_storeu_ps(&out[1][column][0], e1);
+        _mm_storeu_ps(&out[2][column][0], e2);
+        _mm_storeu_ps(&out[3][column][0], e3);
+    }
+
+    static inline void loadColumns4(const glm::mat4* m, int column,
+        __m128& e0, __m128& e1, __m128& e2, __m128& e3) {
+        e0 = _mm_loadu_ps(&m[0][column][0]);
+        e1 = _mm_loadu_ps(&m[1][column][0]);
+        e2 = _mm_loadu_ps(&m[2][column][0]);
+        e3 = _mm_loadu_ps(&m[3][column][0]);
+        _MM_TRANSPOSE4_PS(e0, e1, e2, e3);
+    }
+
+    static inline __m128 abs4(__m128 v) {
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+    }
+
+    static void composeTRS4(const TRSBatch& in, glm::mat4* out, size_t i) {
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 two = _mm_set1_ps(2.0f);
+        const __m128 zero = _mm_setzero_ps();
+
+        __m128 qx = _mm_loadu_ps(in.qx + i), qy = _mm_loadu_ps(in.qy + i);
+        __m128 qz = _mm_loadu_ps(in.qz + i), qw = _mm_loadu_ps(in.qw + i);
+        __m128 sx = _mm_loadu_ps(in.sx + i), sy = _mm_loadu_ps(in.sy + i), sz = _mm_loadu_ps(in.sz + i);
+
+        __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+        __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+        __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+        __m128 m00 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+        __m128 m01 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+        __m128 m02 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+
+        __m128 m10 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+        __m128 m11 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+        __m128 m12 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+
+        __m128 m20 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+        __m128 m21 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+        __m128 m22 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+
+        glm::mat4* dst = out + i;
+        storeColumns4(dst, 0, m00, m01, m02, zero);
+        storeColumns4(dst, 1, m10, m11, m12, zero);
+        storeColumns4(dst, 2, m20, m21, m22, zero);
+        storeColumns4(dst, 3, _mm_loadu_ps(in.px + i), _mm_loadu_ps(in.py + i), _mm_loadu_ps(in.pz + i), one);
+    }
+
+    static void transformAABBs4(const glm::mat4* matrices, const AABBBatch& in, const AABBBatchOut& out, size_t i) {
+        const __m128 half = _mm_set1_ps(0.5f);
+
+        __m128 m00, m01, m02, m03, m10, m11, m12, m13;
+        __m128 m20, m21, m22, m23, tx, ty, tz, tw;
+        loadColumns4(matrices + i, 0, m00, m01, m02, m03);
+        loadColumns4(matrices + i, 1, m10, m11, m12, m13);
+        loadColumns4(matrices + i, 2, m20, m21, m22, m23);
+        loadColumns4(matrices + i, 3, tx, ty, tz, tw);
+
+        __m128 minX = _mm_loadu_ps(in.minX + i), maxX = _mm_loadu_ps(in.maxX + i);
+        __m128 minY = _mm_loadu_ps(in.minY + i), maxY = _mm_loadu_ps(in.maxY + i);
+        __m128 minZ = _mm_loadu_ps(in.minZ + i), maxZ = _mm_loadu_ps(in.maxZ + i);
+
+        __m128 cx = _mm_mul_ps(_mm_add_ps(minX, maxX), half);
+        __m128 cy = _mm_mul_ps(_mm_add_ps(minY, maxY), half);
+        __m128 cz = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+        __m128 ex = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+        __m128 ey = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+        __m128 ez = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+        // Row r of the world center: t_r + sum_j m[j][r] * c_j
+        __m128 wcx = _mm_add_ps(tx, _mm_add_ps(_mm_mul_ps(m00, cx), _mm_add_ps(_mm_mul_ps(m10, cy), _mm_mul_ps(m20, cz))));
+        __m128 wcy = _mm_add_ps(ty, _mm_add_ps(_mm_mul_ps(m01, cx), _mm_add_ps(_mm_mul_ps(m11, cy), _mm_mul_ps(m21, cz))));
+        __m128 wcz = _mm_add_ps(tz, _mm_add_ps(_mm_mul_ps(m02, cx), _mm_add_ps(_mm_mul_ps(m12, cy), _mm_mul_ps(m22, cz))));
+
+        __m128 wex = _mm_add_ps(_mm_mul_ps(abs4(m00), ex), _mm_add_ps(_mm_mul_ps(abs4(m10), ey), _mm_mul_ps(abs4(m20), ez)));
+        __m128 wey = _mm_add_ps(_mm_mul_ps(abs4(m01), ex), _mm_add_ps(_mm_mul_ps(abs4(m11), ey), _mm_mul_ps(abs4(m21), ez)));
+        __m128 wez = _mm_add_ps(_mm_mul_ps(abs4(m02), ex), _mm_add_ps(_mm_mul_ps(abs4(m12), ey), _mm_mul_ps(abs4(m22), ez)));
+
+        _mm_storeu_ps(out.minX + i, _mm_sub_ps(wcx, wex));
+        _mm_storeu_ps(out.minY + i, _mm_sub_ps(wcy, wey));
+        _mm_storeu_ps(out.minZ + i, _mm_sub_ps(wcz, wez));
+        _mm_storeu_ps(out.maxX + i, _mm_add_ps(wcx, wex));
+        _mm_storeu_ps(out.maxY + i, _mm_add_ps(wcy, wey));
+        _mm_storeu_ps(out.maxZ + i, _mm_add_ps(wcz, wez));
+    }
+
+#endif // LIBRE_KERNEL_SSE
+
+#if LIBRE_KERNEL_AVX2
+
+    // ========================================================================
+    // AVX2 - 8 entities per iteration
+    // ========================================================================
+
+    static inline void storeColumns8(glm::mat4* out, int column,
+        __m256 e0, __m256 e1, __m256 e2, __m256 e3) {
+        storeColumns4(out, column,
+            _mm256_castps256_ps128(e0), _mm256_castps256_ps128(e1),
+            _mm256_castps256_ps128(e2), _mm256_castps256_ps128(e3));
+        storeColumns4(out + 4, column,
+            _mm256_extractf128_ps(e0, 1), _mm256_extractf128_ps(e1, 1),
+            _mm256_extractf128_ps(e2, 1), _mm256_extractf128_ps(e3, 1));
+    }
+
+    static void composeTRS8(const TRSBatch& in, glm::mat4* out, size_t i) {
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 two = _mm256_set1_ps(2.0f);
+        const __m256 zero = _mm256_setzero_ps();
+
+        __m256 qx = _mm256_loadu_ps(in.qx + i), qy = _mm256_loadu_ps(in.qy + i);
+        __m256 qz = _mm256_loadu_ps(in.qz + i), qw = _mm256_loadu_ps(in.qw + i);
+        __m256 sx = _mm256_loadu_ps(in.sx + i), sy = _mm256_loadu_ps(in.sy + i), sz = _mm256_loadu_ps(in.sz + i);
+
+        __m256 xx = _mm256_mul_ps(qx, qx), yy = _mm256_mul_ps(qy, qy), zz = _mm256_mul_ps(qz, qz);
+        __m256 xy = _mm256_mul_ps(qx, qy), xz = _mm256_mul_ps(qx, qz), yz = _mm256_mul_ps(qy, qz);
+        __m256 wx = _mm256_mul_ps(qw, qx), wy = _mm256_mul_ps(qw, qy), wz = _mm256_mul_ps(qw, qz);
+
+        __m256 m00 = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), sx);
+        __m256 m01 = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx);
+        __m256 m02 = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx);
+
+        __m256 m10 = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy);
+        __m256 m11 = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), sy);
+        __m256 m12 = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy);
+
+        __m256 m20 = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz);
+        __m256 m21 = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz);
+        __m256 m22 = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))), sz);
+
+        glm::mat4* dst = out + i;
+        storeColumns8(dst, 0, m00, m01, m02, zero);
+        storeColumns8(dst, 1, m10, m11, m12, zero);
+        storeColumns8(dst, 2, m20, m21, m22, zero);
+        storeColumns8(dst, 3, _mm256_loadu_ps(in.px + i), _mm256_loadu_ps(in.py + i), _mm256_loadu_ps(in.pz + i), one);
+    }
+
+#endif // LIBRE_KERNEL_AVX2
+
+    // ========================================================================
+    // DISPATCH
+    // ========================================================================
+
+    const char* getKernelName() {
+#if LIBRE_KERNEL_AVX2
+        return "AVX2";
+#elif LIBRE_KERNEL_SSE
+        return "SSE";
+#else
+        return "Scalar";
+#endif
+    }
+
+    void composeTRS(const TRSBatch& in, glm::mat4* out) {
+        size_t i = 0;
+#if LIBRE_KERNEL_AVX2
+        for (; i + 8 <= in.count; i += 8) {
+            composeTRS8(in, out, i);
+        }
+#endif
+#if LIBRE_KERNEL_SSE
+        for (; i + 4 <= in.count; i += 4) {
+            composeTRS4(in, out, i);
+        }
+#endif
+        composeTRSScalar(in, out, i, in.count);
+    }
+
+    void transformAABBs(const glm::mat4* matrices, const AABBBatch& in, const AABBBatchOut& out) {
+        size_t i = 0;
+#if LIBRE_KERNEL_SSE
+        // Matrix columns come in AoS, so the transpose dominates - 8 lanes
+        // buys nothing over two 4-lane passes here
+        for (; i + 4 <= in.count; i += 4) {
+            transformAABBs4(matrices, in, out, i);
+        }
+#endif
+        transformAABBsScalar(matrices, in, out, i, in.count);
+    }
+
+} // namespace TransformKernels
+} // namespace libre
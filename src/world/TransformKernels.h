@@ -0,0 +1,87 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstddef>
+#include <cmath>
+
+namespace libre {
+
+    // ============================================================================
+    // TRANSFORM KERNELS - Batched TRS and AABB math over SoA input
+    // ============================================================================
+    // Builds world matrices straight from quaternion + scale + translation (no
+    // intermediate mat4s, no 4x4 multiplies) and transforms AABBs with the
+    // center/extent method (Arvo) instead of pushing 8 corners through a mat4.
+    //
+    // The kernel is picked at compile time: AVX2 (8 lanes) when the compiler
+    // targets it (/arch:AVX2, -mavx2), SSE (4 lanes) on any x86-64 build, and
+    // a scalar loop everywhere else and for the tail of each batch.
+
+    // Translation, rotation (unit quaternion) and scale, one array per field
+    struct TRSBatch {
+        const float* px; const float* py; const float* pz;
+        const float* qx; const float* qy; const float* qz; const float* qw;
+        const float* sx; const float* sy; const float* sz;
+        size_t count = 0;
+    };
+
+    // Object-space boxes in, world-space boxes out, one array per axis
+    struct AABBBatch {
+        const float* minX; const float* minY; const float* minZ;
+        const float* maxX; const float* maxY; const float* maxZ;
+        size_t count = 0;
+    };
+
+    struct AABBBatchOut {
+        float* minX; float* minY; float* minZ;
+        float* maxX; float* maxY; float* maxZ;
+    };
+
+    namespace TransformKernels {
+
+        // Name of the compiled-in kernel ("AVX2", "SSE", "Scalar")
+        const char* getKernelName();
+
+        // out[i] = T(p[i]) * R(q[i]) * S(s[i])
+        void composeTRS(const TRSBatch& in, glm::mat4* out);
+
+        // World AABB of each local box under matrices[i]
+        void transformAABBs(const glm::mat4* matrices, const AABBBatch& in, const AABBBatchOut& out);
+
+        // ====================================================================
+        // SINGLE ENTITY (scalar, used by the components directly)
+        // ====================================================================
+
+        // Same result as translate(p) * mat4_cast(q) * scale(s)
+        inline glm::mat4 composeTRS(const glm::vec3& p, const glm::quat& q, const glm::vec3& s) {
+            float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+            float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+            float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+            glm::mat4 m;
+            m[0] = glm::vec4((1.0f - 2.0f * (yy + zz)) * s.x, 2.0f * (xy + wz) * s.x, 2.0f * (xz - wy) * s.x, 0.0f);
+            m[1] = glm::vec4(2.0f * (xy - wz) * s.y, (1.0f - 2.0f * (xx + zz)) * s.y, 2.0f * (yz + wx) * s.y, 0.0f);
+            m[2] = glm::vec4(2.0f * (xz + wy) * s.z, 2.0f * (yz - wx) * s.z, (1.0f - 2.0f * (xx + yy)) * s.z, 0.0f);
+            m[3] = glm::vec4(p, 1.0f);
+            return m;
+        }
+
+        // Arvo: transform the center, and the extent by |M|
+        inline void transformAABB(const glm::mat4& m, const glm::vec3& localMin, const glm::vec3& localMax,
+            glm::vec3& worldMin, glm::vec3& worldMax) {
+            glm::vec3 c = (localMin + localMax) * 0.5f;
+            glm::vec3 e = (localMax - localMin) * 0.5f;
+
+            glm::vec3 wc = glm::vec3(m[3]) + glm::vec3(m[0]) * c.x + glm::vec3(m[1]) * c.y + glm::vec3(m[2]) * c.z;
+            glm::vec3 we = glm::abs(glm::vec3(m[0])) * e.x + glm::abs(glm::vec3(m[1])) * e.y + glm::abs(glm::vec3(m[2])) * e.z;
+
+            worldMin = wc - we;
+            worldMax = wc + we;
+        }
+
+    } // namespace TransformKernels
+
+} // namespace libre
@@ -0,0 +1,249 @@
+#include "TransformSystem.h"
+#include "World.h"
+#include "../core/JobSystem.h"
+
+#include <algorithm>
+
+namespace libre {
+
+    // Items per job chunk - one item is a TRS build, a mat4 multiply and an AABB
+    static constexpr size_t TRANSFORM_GRAIN = 256;
+
+    // ========================================================================
+    // HIERARCHY ORDER
+    // ========================================================================
+
+    void TransformSystem::rebuild(World& world, ComponentStorage<TransformComponent>& storage) {
+        nodes_.clear();
+        levelStart_.clear();
+        nodeIndex_.clear();
+
+        nodes_.reserve(storage.size());
+        nodeIndex_.reserve(storage.size());
+
+        // Level 0: transforms without a parent transform
+        const EntityID* entities = storage.entityData();
+        for (size_t i = 0; i < storage.size(); ++i) {
+            EntityID parent = world.getParent(entities[i]);
+            if (parent == INVALID_ENTITY || !storage.has(parent)) {
+                Node node;
+                node.entity = entities[i];
+                node.storageIndex = static_cast<uint32_t>(i);
+                nodes_.push_back(node);
+            }
+        }
+
+        // Breadth-first expansion keeps each level contiguous and puts
+        // siblings next to each other
+        levelStart_.push_back(0);
+        size_t levelBegin = 0;
+        uint32_t depth = 0;
+        while (levelBegin < nodes_.size()) {
+            size_t levelEnd = nodes_.size();
+            levelStart_.push_back(static_cast<uint32_t>(levelEnd));
+
+            for (size_t i = levelBegin; i < levelEnd; ++i) {
+                uint32_t firstChild = static_cast<uint32_t>(nodes_.size());
+
+                for (EntityID child : world.getHierarchy().getChildren(nodes_[i].entity)) {
+                    const TransformComponent* childTransform = storage.get(child);
+                    if (!childTransform) continue;
+
+                    Node node;
+                    node.entity = child;
+                    node.parent = static_cast<uint32_t>(i);
+                    node.depth = depth + 1;
+                    node.storageIndex = static_cast<uint32_t>(childTransform - storage.data());
+                    nodes_.push_back(node);
+                }
+
+                nodes_[i].firstChild = firstChild;
+                nodes_[i].childCount = static_cast<uint32_t>(nodes_.size()) - firstChild;
+            }
+
+            levelBegin = levelEnd;
+            ++depth;
+        }
+
+        for (uint32_t i = 0; i < nodes_.size(); ++i) {
+            nodeIndex_[nodes_[i].entity] = i;
+        }
+
+        dirtyByLevel_.resize(levelStart_.size() - 1);
+        visitStamp_.assign(nodes_.size(), 0);
+        epoch_ = 0;
+
+        cachedVersion_ = world.getHierarchyVersion();
+        cachedCount_ = storage.size();
+
+        stats_.nodeCount = nodes_.size();
+        stats_.levelCount = levelStart_.size() - 1;
+    }
+
+    TransformComponent* TransformSystem::resolve(ComponentStorage<TransformComponent>& storage, Node& node) {
+        // Dense indices only move when a component is swap-removed, so the
+        // cached index is almost always still right
+        if (node.storageIndex < storage.size() &&
+            storage.entityData()[node.storageIndex] == node.entity) {
+            return storage.data() + node.storageIndex;
+        }
+
+        TransformComponent* transform = storage.get(node.entity);
+        if (transform) {
+            node.storageIndex = static_cast<uint32_t>(transform - storage.data());
+        }
+        return transform;
+    }
+
+    void TransformSystem::schedule(World& world, ComponentStorage<TransformComponent>& storage, uint32_t index) {
+        if (visitStamp_[index] == epoch_) return;
+        visitStamp_[index] = epoch_;
+
+        Node& node = nodes_[index];
+        TransformComponent* transform = resolve(storage, node);
+        if (!transform) return;
+
+        WorkItem item;
+        item.node = index;
+        item.transform = transform;
+        item.parent = node.parent != NO_PARENT ? resolve(storage, nodes_[node.parent]) : nullptr;
+        item.bounds = world.getComponent<BoundsComponent>(node.entity);
+        work_.push_back(item);
+    }
+
+    // ========================================================================
+    // BATCH KERNELS
+    // ========================================================================
+
+    void TransformSystem::updateBlock(size_t begin, size_t end) const {
+        // Gather the scattered components into SoA so the SIMD kernels can
+        // run 4-8 entities per instruction stream
+        float px[KERNEL_BLOCK], py[KERNEL_BLOCK], pz[KERNEL_BLOCK];
+        float qx[KERNEL_BLOCK], qy[KERNEL_BLOCK], qz[KERNEL_BLOCK], qw[KERNEL_BLOCK];
+        float sx[KERNEL_BLOCK], sy[KERNEL_BLOCK], sz[KERNEL_BLOCK];
+        glm::mat4 local[KERNEL_BLOCK];
+
+        size_t count = end - begin;
+        for (size_t i = 0; i < count; ++i) {
+            const TransformComponent& t = *work_[begin + i].transform;
+            px[i] = t.position.x; py[i] = t.position.y; pz[i] = t.position.z;
+            qx[i] = t.rotation.x; qy[i] = t.rotation.y; qz[i] = t.rotation.z; qw[i] = t.rotation.w;
+            sx[i] = t.scale.x; sy[i] = t.scale.y; sz[i] = t.scale.z;
+        }
+
+        TRSBatch trs{ px, py, pz, qx, qy, qz, qw, sx, sy, sz, count };
+        TransformKernels::composeTRS(trs, local);
+
+        // World matrices, and the subset of items that carry bounds
+        glm::mat4 boundsMatrix[KERNEL_BLOCK];
+        float minX[KERNEL_BLOCK], minY[KERNEL_BLOCK], minZ[KERNEL_BLOCK];
+        float maxX[KERNEL_BLOCK], maxY[KERNEL_BLOCK], maxZ[KERNEL_BLOCK];
+        size_t boundsIndex[KERNEL_BLOCK];
+        size_t boundsCount = 0;
+
+        for (size_t i = 0; i < count; ++i) {
+            const WorkItem& item = work_[begin + i];
+            TransformComponent& t = *item.transform;
+
+            t.worldMatrix = item.parent ? item.parent->worldMatrix * local[i] : local[i];
+            t.dirty = false;
+
+            if (item.bounds) {
+                size_t b = boundsCount++;
+                boundsIndex[b] = begin + i;
+                boundsMatrix[b] = t.worldMatrix;
+                minX[b] = item.bounds->localMin.x; minY[b] = item.bounds->localMin.y; minZ[b] = item.bounds->localMin.z;
+                maxX[b] = item.bounds->localMax.x; maxY[b] = item.bounds->localMax.y; maxZ[b] = item.bounds->localMax.z;
+            }
+        }
+
+        if (boundsCount == 0) return;
+
+        // Transform in place - each lane reads its inputs before writing
+        AABBBatch in{ minX, minY, minZ, maxX, maxY, maxZ, boundsCount };
+        AABBBatchOut out{ minX, minY, minZ, maxX, maxY, maxZ };
+        TransformKernels::transformAABBs(boundsMatrix, in, out);
+
+        for (size_t b = 0; b < boundsCount; ++b) {
+            work_[boundsIndex[b]].bounds->setWorldBounds(
+                glm::vec3(minX[b], minY[b], minZ[b]),
+                glm::vec3(maxX[b], maxY[b], maxZ[b]));
+        }
+    }
+
+    // ========================================================================
+    // UPDATE
+    // ========================================================================
+
+    void TransformSystem::update(World& world) {
+        stats_.updatedCount = 0;
+
+        auto* storage = world.getStorage<TransformComponent>();
+        if (!storage || storage->size() == 0) {
+            world.clearDirtyTransforms();
+            return;
+        }
+
+        if (cachedVersion_ != world.getHierarchyVersion() || cachedCount_ != storage->size()) {
+            rebuild(world, *storage);
+        }
+
+        // New pass - visit stamps from the previous pass become stale
+        if (++epoch_ == 0) {
+            std::fill(visitStamp_.begin(), visitStamp_.end(), 0);
+            epoch_ = 1;
+        }
+
+        // Bucket the transforms queued through World::markTransformDirty by
+        // depth - work is proportional to the changes, not the scene
+        for (auto& level : dirtyByLevel_) {
+            level.clear();
+        }
+
+        for (EntityID entity : world.getDirtyTransforms()) {
+            auto it = nodeIndex_.find(entity);
+            if (it != nodeIndex_.end()) {
+                dirtyByLevel_[nodes_[it->second].depth].push_back(it->second);
+            }
+        }
+        world.clearDirtyTransforms();
+
+        auto& jobs = JobSystem::instance();
+        pendingChildren_.clear();
+
+        for (size_t level = 0; level + 1 < levelStart_.size(); ++level) {
+            // Children of everything recomputed one level up, plus anything
+            // dirty in its own right at this level
+            work_.clear();
+            for (uint32_t index : pendingChildren_) {
+                schedule(world, *storage, index);
+            }
+            for (uint32_t index : dirtyByLevel_[level]) {
+                schedule(world, *storage, index);
+            }
+
+            pendingChildren_.clear();
+            if (work_.empty()) continue;
+
+            // Nodes within a level never depend on each other
+            jobs.parallelFor(work_.size(), TRANSFORM_GRAIN, [this](size_t begin, size_t end) {
+                for (size_t block = begin; block < end; block += KERNEL_BLOCK) {
+                    updateBlock(block, std::min(end, block + KERNEL_BLOCK));
+                }
+                });
+
+            for (const WorkItem& item : work_) {
+                const Node& node = nodes_[item.node];
+                for (uint32_t c = 0; c < node.childCount; ++c) {
+                    pendingChildren_.push_back(node.firstChild + c);
+                }
+                if (item.bounds) {
+                    movedBounds_.push_back(node.entity);
+                }
+            }
+
+            stats_.updatedCount += work_.size();
+        }
+    }
+
+} // namespace libre
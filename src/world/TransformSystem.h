@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Types.h"
+#include "ComponentStorage.h"
+#include "../components/CoreComponents.h"
+
+#include <vector>
+#include <unordered_map>
+
+namespace libre {
+
+    class World;
+
+    // ============================================================================
+    // TRANSFORM SYSTEM - Hierarchy-aware world matrix propagation
+    // ============================================================================
+    // Keeps every TransformComponent in breadth-first (depth-sorted) order so a
+    // parent is always finished before any of its children are touched. Each
+    // update walks the levels top-down; a node is recomputed when it was queued
+    // through World::markTransformDirty or when its parent was recomputed this
+    // pass, so moving a parent carries through the whole subtree in a single
+    // update. Only the queued entities are looked at, never every transform.
+    // Local matrices and world bounds go through the batched TransformKernels.
+    //
+    // Matrix work is proportional to the size of the dirty subtrees. Each depth
+    // level is independent and is split across the JobSystem in chunks.
+
+    class TransformSystem {
+    public:
+        struct Stats {
+            size_t nodeCount = 0;       // Transforms in the sorted hierarchy
+            size_t levelCount = 0;      // Hierarchy depth
+            size_t updatedCount = 0;    // World matrices recomputed last update
+        };
+
+        // Recompute world matrices (and world bounds) for dirty subtrees
+        void update(World& world);
+
+        // Force a full re-sort on the next update
+        void invalidate() { cachedVersion_ = INVALID_VERSION; }
+
+        const Stats& getStats() const { return stats_; }
+
+        // Entities whose world bounds were rewritten since the last
+        // clearMovedBounds() (may repeat). Spatial indices consume this.
+        const std::vector<EntityID>& getMovedBounds() const { return movedBounds_; }
+        void clearMovedBounds() { movedBounds_.clear(); }
+
+    private:
+        static constexpr uint32_t NO_PARENT = 0xFFFFFFFF;
+        static constexpr uint64_t INVALID_VERSION = ~0ull;
+        static constexpr size_t KERNEL_BLOCK = 64;  // SoA gather size for the SIMD kernels
+
+        // One entry per transform, stored in depth order. Children of a node
+        // are contiguous in the next level: [firstChild, firstChild + childCount)
+        struct Node {
+            EntityID entity = INVALID_ENTITY;
+            uint32_t parent = NO_PARENT;
+            uint32_t firstChild = 0;
+            uint32_t childCount = 0;
+            uint32_t depth = 0;
+            uint32_t storageIndex = 0;  // Cached dense index, revalidated on use
+        };
+
+        // Resolved pointers for one node scheduled this pass
+        struct WorkItem {
+            uint32_t node;
+            TransformComponent* transform;
+            const TransformComponent* parent;
+            BoundsComponent* bounds;
+        };
+
+        void rebuild(World& world, ComponentStorage<TransformComponent>& storage);
+        TransformComponent* resolve(ComponentStorage<TransformComponent>& storage, Node& node);
+        void schedule(World& world, ComponentStorage<TransformComponent>& storage, uint32_t index);
+        void updateBlock(size_t begin, size_t end) const;
+
+        std::vector<Node> nodes_;
+        std::vector<uint32_t> levelStart_;  // Level d is [levelStart_[d], levelStart_[d + 1])
+        std::unordered_map<EntityID, uint32_t> nodeIndex_;
+
+        // Per-update scratch (kept to avoid reallocating every frame)
+        std::vector<std::vector<uint32_t>> dirtyByLevel_;
+        std::vector<uint32_t> visitStamp_;
+        std::vector<uint32_t> pendingChildren_;
+        std::vector<WorkItem> work_;
+        std::vector<EntityID> movedBounds_;
+        uint32_t epoch_ = 0;
+
+        uint64_t cachedVersion_ = INVALID_VERSION;
+        size_t cachedCount_ = 0;
+
+        Stats stats_;
+    };
+
+} // namespace libre
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <limits>
 #include <string>
+#include <typeinfo>
 
 namespace libre {
 
@@ -28,6 +29,22 @@ namespace libre {
         return (static_cast<uint64_t>(generation) << 32) | index;
     }
 
+    // ============================================================================
+    // ENTITY SPAN - Non-owning view over contiguous entity IDs
+    // ============================================================================
+    // Returned by queries that can expose internal arrays directly (roots,
+    // subtrees, child lists). Invalidated by the next edit of the owner.
+
+    struct EntitySpan {
+        const EntityID* data = nullptr;
+        size_t size = 0;
+
+        const EntityID* begin() const { return data; }
+        const EntityID* end() const { return data + size; }
+        bool empty() const { return size == 0; }
+        EntityID operator[](size_t i) const { return data[i]; }
+    };
+
     // ============================================================================
     // ENTITY FLAGS
     // ============================================================================
@@ -69,15 +86,12 @@ namespace libre {
     // ENTITY METADATA
     // ============================================================================
 
+    // Flags are not metadata: World keeps them densely per entity slot so
+    // group-wide changes are mask writes (see World::getFlags).
     struct EntityMetadata {
         std::string name;
         std::string type;           // "mesh", "light", "camera", etc.
-        EntityFlags flags = EntityFlags::Default;
         uint32_t layer = 0;         // Layer for organization
-
-        bool isVisible() const { return hasFlag(flags, EntityFlags::Visible); }
-        bool isSelectable() const { return hasFlag(flags, EntityFlags::Selectable); }
-        bool isLocked() const { return hasFlag(flags, EntityFlags::Locked); }
     };
 
     // ============================================================================
@@ -1,9 +1,13 @@
 #include "World.h"
+#include "../core/JobSystem.h"
 #include <iostream>
 #include <algorithm>
 
 namespace libre {
 
+    // Subtrees at least this large sweep component storages in parallel
+    static constexpr size_t PARALLEL_DESTROY_THRESHOLD = 4096;
+
     // ============================================================================
     // ENTITY HANDLE IMPLEMENTATIONS
     // ============================================================================
@@ -28,7 +32,7 @@ namespace libre {
     std::vector<EntityHandle> EntityHandle::getChildren() const {
         std::vector<EntityHandle> result;
         if (world_) {
-            for (EntityID childId : world_->getChildren(id_)) {
+            for (EntityID childId : world_->getHierarchy().getChildren(id_)) {
                 result.emplace_back(world_, childId);
             }
         }
@@ -67,16 +71,23 @@ namespace libre {
     EntityHandle World::createEntity(const std::string& name, const std::string& type) {
         EntityID id = generateEntityID();
         entities_.insert(id);
+        relationships_.addEntity(id);
 
         // Create metadata
         EntityMetadata meta;
         meta.name = name;
         meta.type = type;
-        meta.flags = EntityFlags::Default;
         entityMetadata_[id] = meta;
 
+        uint32_t slot = getEntityIndex(id);
+        if (slot >= flags_.size()) {
+            flags_.resize(static_cast<size_t>(slot) + 1, 0);
+        }
+        flags_[slot] = static_cast<uint32_t>(EntityFlags::Default);
+
         // Always add TransformComponent
         addComponent<TransformComponent>(id);
+        ++hierarchyVersion_;
 
         return EntityHandle(this, id);
     }
@@ -84,26 +95,41 @@ namespace libre {
     void World::destroyEntity(EntityID id) {
         if (!entityExists(id)) return;
 
-        // Remove from selection
-        deselect(id);
-
-        // Remove all children first (cascade delete)
-        auto children = getChildren(id);
-        for (EntityID childId : children) {
-            destroyEntity(childId);
+        // Snapshot the subtree (cascade delete), children before parents -
+        // the hierarchy changes below. The walk reads child lists directly,
+        // so it costs O(subtree) even right after edits, where getSubtree
+        // would renumber the whole hierarchy first.
+        std::vector<EntityID> doomed;
+        for (const auto& visit : traversal_.postOrder(relationships_.getHierarchy(), id)) {
+            doomed.push_back(visit.entity);
         }
 
-        // Remove relationships
-        relationships_.removeEntity(id);
-
-        // Remove all components
+        // Remove all components. Storages are independent of each other, so
+        // big deletes sweep them in parallel, each over the whole subtree.
+        std::vector<IComponentStorage*> storages;
+        storages.reserve(componentStorages_.size());
         for (auto& [typeIndex, storage] : componentStorages_) {
-            storage->remove(id);
+            storages.push_back(storage.get());
         }
 
-        // Remove metadata and entity
-        entityMetadata_.erase(id);
-        entities_.erase(id);
+        size_t grain = doomed.size() >= PARALLEL_DESTROY_THRESHOLD ? 1 : storages.size();
+        JobSystem::instance().parallelFor(storages.size(), grain, [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; ++s) {
+                for (EntityID entity : doomed) {
+                    storages[s]->remove(entity);
+                }
+            }
+            });
+
+        // Children before parents, so no orphan is ever promoted to a root
+        for (EntityID entity : doomed) {
+            deselect(entity);
+            relationships_.removeEntity(entity);
+            entityMetadata_.erase(entity);
+            entities_.erase(entity);
+            flags_[getEntityIndex(entity)] = 0;
+        }
+        ++hierarchyVersion_;
     }
 
     bool World::entityExists(EntityID id) const {
@@ -136,6 +162,57 @@ namespace libre {
         return (it != entityMetadata_.end()) ? &it->second : nullptr;
     }
 
+    // ========================================================================
+    // FLAGS
+    // ========================================================================
+
+    EntityFlags World::getFlags(EntityID id) const {
+        if (!entityExists(id)) return EntityFlags::None;
+        return static_cast<EntityFlags>(flags_[getEntityIndex(id)]);
+    }
+
+    void World::setFlags(EntityID id, EntityFlags flags) {
+        if (!entityExists(id)) return;
+        flags_[getEntityIndex(id)] = static_cast<uint32_t>(flags);
+    }
+
+    void World::setFlag(EntityID id, EntityFlags flag, bool enabled) {
+        if (!entityExists(id)) return;
+        uint32_t& flags = flags_[getEntityIndex(id)];
+        flags = enabled ? (flags | static_cast<uint32_t>(flag)) : (flags & ~static_cast<uint32_t>(flag));
+    }
+
+    bool World::isVisible(EntityID id) const {
+        EntityFlags flags = getFlags(id);
+        return hasFlag(flags, EntityFlags::Visible) && !hasFlag(flags, EntityFlags::Hidden);
+    }
+
+    // ========================================================================
+    // GROUPS
+    // ========================================================================
+
+    const SlotSet* World::getGroupMembers(EntityID group) const {
+        return relationships_.getGroupMembers(group);
+    }
+
+    std::vector<EntityID> World::getGroupEntities(EntityID group) const {
+        std::vector<EntityID> result;
+        if (const SlotSet* members = getGroupMembers(group)) {
+            result.reserve(members->count());
+            const EdgeStore& edges = relationships_.getEdges();
+            members->forEach([&](uint32_t slot) { result.push_back(edges.getSlotEntity(slot)); });
+        }
+        return result;
+    }
+
+    void World::setGroupFlag(EntityID group, EntityFlags flag, bool enabled) {
+        const SlotSet* members = getGroupMembers(group);
+        if (!members || members->empty()) return;
+
+        uint32_t bits = static_cast<uint32_t>(flag);
+        applyFlagMask(*members, flags_.data(), flags_.size(), enabled ? bits : 0, enabled ? 0 : bits);
+    }
+
     // ========================================================================
     // RELATIONSHIPS / HIERARCHY
     // ========================================================================
@@ -143,6 +220,7 @@ namespace libre {
     void World::setParent(EntityID child, EntityID parent) {
         if (!entityExists(child)) return;
         if (parent != INVALID_ENTITY && !entityExists(parent)) return;
+        if (parent == child) return;
 
         // Prevent circular relationships
         if (parent != INVALID_ENTITY && relationships_.isAncestorOf(child, parent)) {
@@ -152,10 +230,15 @@ namespace libre {
 
         // Use RelationshipStore's setParent which handles removal of old parent
         relationships_.setParent(child, parent);
+        ++hierarchyVersion_;
+
+        markTransformDirty(child);
+    }
 
-        // Mark transform as dirty
-        if (auto* transform = getComponent<TransformComponent>(child)) {
+    void World::markTransformDirty(EntityID entity) {
+        if (auto* transform = getComponent<TransformComponent>(entity)) {
             transform->dirty = true;
+            dirtyTransforms_.push_back(entity);
         }
     }
 
@@ -167,8 +250,16 @@ namespace libre {
         return relationships_.getChildren(parent);
     }
 
-    std::vector<EntityID> World::getRootEntities() const {
-        return relationships_.getRoots(entities_);
+    const std::vector<EntityID>& World::getRootEntities() const {
+        return relationships_.getRoots();
+    }
+
+    bool World::isInSubtree(EntityID root, EntityID entity) const {
+        return relationships_.isInSubtree(root, entity);
+    }
+
+    EntitySpan World::getSubtree(EntityID root) const {
+        return relationships_.getSubtree(root);
     }
 
     // ========================================================================
@@ -230,6 +321,9 @@ namespace libre {
 
         entityMetadata_.clear();
         entities_.clear();
+        flags_.clear();
+        dirtyTransforms_.clear();
+        ++hierarchyVersion_;
 
         // Reset ID generation but keep generations for safety
         nextIndex_ = 1;
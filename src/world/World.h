@@ -3,6 +3,7 @@
 #include "Types.h"
 #include "ComponentStorage.h"
 #include "RelationshipStore.h"
+#include "HierarchyTraversal.h"
 #include "../components/CoreComponents.h"
 
 #include <unordered_map>
@@ -12,6 +13,7 @@
 #include <vector>
 #include <string>
 #include <functional>
+#include <type_traits>
 
 namespace libre {
 
@@ -83,6 +85,40 @@ namespace libre {
         EntityMetadata* getMetadata(EntityID id);
         const EntityMetadata* getMetadata(EntityID id) const;
 
+        // ========================================================================
+        // FLAGS
+        // ========================================================================
+
+        // EntityFlags::None for unknown entities
+        EntityFlags getFlags(EntityID id) const;
+        void setFlags(EntityID id, EntityFlags flags);
+        void setFlag(EntityID id, EntityFlags flag, bool enabled);
+
+        // Visible and not Hidden
+        bool isVisible(EntityID id) const;
+        bool isSelectable(EntityID id) const { return hasFlag(getFlags(id), EntityFlags::Selectable); }
+        bool isLocked(EntityID id) const { return hasFlag(getFlags(id), EntityFlags::Locked); }
+
+        // Flags straight from the entity's slot, skipping the existence
+        // lookup. Only for ids known to be live (e.g. taken from component
+        // storage) in loops over many entities.
+        EntityFlags getSlotFlags(EntityID id) const {
+            uint32_t slot = getEntityIndex(id);
+            return slot < flags_.size() ? static_cast<EntityFlags>(flags_[slot]) : EntityFlags::None;
+        }
+
+        // ========================================================================
+        // GROUPS (GroupMember: from = group, to = member)
+        // ========================================================================
+
+        // Member set of a group (nullptr if it has no members yet)
+        const SlotSet* getGroupMembers(EntityID group) const;
+        std::vector<EntityID> getGroupEntities(EntityID group) const;
+
+        // Set or clear a flag on every member of a group (one mask write
+        // per 64 slots, no per-member lookups)
+        void setGroupFlag(EntityID group, EntityFlags flag, bool enabled);
+
         // ========================================================================
         // COMPONENT MANAGEMENT
         // ========================================================================
@@ -90,7 +126,11 @@ namespace libre {
         template<typename T>
         T& addComponent(EntityID entity, const T& component = T{}) {
             auto& storage = getOrCreateStorage<T>();
-            return storage.add(entity, component);
+            T& added = storage.add(entity, component);
+            if constexpr (std::is_same_v<T, TransformComponent>) {
+                markTransformDirty(entity);
+            }
+            return added;
         }
 
         template<typename T>
@@ -141,6 +181,20 @@ namespace libre {
             return static_cast<const ComponentStorage<T>*>(it->second.get());
         }
 
+        // ========================================================================
+        // TRANSFORM CHANGES
+        // ========================================================================
+
+        // Flags the entity's transform dirty and queues it for the next
+        // TransformSystem update. Any write to position, rotation or scale
+        // of an existing TransformComponent must be followed by this call;
+        // the dirty flag alone is not scanned for.
+        void markTransformDirty(EntityID entity);
+
+        // Queued since the last clearDirtyTransforms() (may repeat)
+        const std::vector<EntityID>& getDirtyTransforms() const { return dirtyTransforms_; }
+        void clearDirtyTransforms() { dirtyTransforms_.clear(); }
+
         // ========================================================================
         // RELATIONSHIPS / HIERARCHY
         // ========================================================================
@@ -148,8 +202,17 @@ namespace libre {
         void setParent(EntityID child, EntityID parent);
         EntityID getParent(EntityID child) const;
         std::vector<EntityID> getChildren(EntityID parent) const;
-        std::vector<EntityID> getRootEntities() const;
+        const std::vector<EntityID>& getRootEntities() const;
+
+        // Subtree queries (O(1) / output-sensitive via interval numbering)
+        bool isInSubtree(EntityID root, EntityID entity) const;
+        EntitySpan getSubtree(EntityID root) const;
 
+        // Bumped whenever entities are created/destroyed or reparented.
+        // Systems that cache hierarchy order compare against this.
+        uint64_t getHierarchyVersion() const { return hierarchyVersion_; }
+
+        const HierarchyIndex& getHierarchy() const { return relationships_.getHierarchy(); }
         RelationshipStore& getRelationships() { return relationships_; }
         const RelationshipStore& getRelationships() const { return relationships_; }
 
@@ -196,12 +259,18 @@ namespace libre {
         // Entity storage
         std::unordered_set<EntityID> entities_;
         std::unordered_map<EntityID, EntityMetadata> entityMetadata_;
+        std::vector<uint32_t> flags_;       // EntityFlags by entity slot
 
         // Component storages
         std::unordered_map<std::type_index, std::unique_ptr<IComponentStorage>> componentStorages_;
 
         // Relationships
         RelationshipStore relationships_;
+        uint64_t hierarchyVersion_ = 0;
+        HierarchyTraversal traversal_;      // Reused stack for subtree walks
+
+        // Transforms changed since TransformSystem last ran
+        std::vector<EntityID> dirtyTransforms_;
 
         // Selection
         std::vector<EntityID> selection_;